@@ -2029,7 +2029,8 @@ void unchecked_linear_insert(RandomIter last, const T& value) {
 template <typename RandomIter>
 void unchecked_insertion_sort(RandomIter first, RandomIter last) {
     for (auto i = first; i != last; ++i) {
-        mystl::unchecked_linear_insert(i, *i);
+        auto value = *i;    // 先复制一份，避免被移动过程覆盖
+        mystl::unchecked_linear_insert(i, value);
     }
 }
 
@@ -2098,7 +2099,7 @@ void intro_sort(RandomIter first, RandomIter last,
             return;
         }
         --depth_limit;
-        auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1));
+        auto mid = mystl::median(*(first), *(first + (last - first) / 2), *(last - 1), comp);
         auto cut = mystl::unchecked_partition(first, last, mid, comp);
         mystl::intro_sort(cut, last, depth_limit, comp);
         last = cut;
@@ -2123,7 +2124,8 @@ template <typename RandomIter, typename Compared>
 void unchecked_insertion_sort(RandomIter first, RandomIter last,
 	Compared comp) {
     for (auto i = first; i != last; ++i) {
-        mystl::unchecked_linear_insert(i, *i, comp);
+        auto value = *i;
+        mystl::unchecked_linear_insert(i, value, comp);
     }
 }
 
@@ -2193,7 +2195,7 @@ void nth_element(RandomIter first, RandomIter nth,
     while (last - first > 3) {
         auto cut = mystl::unchecked_partition(first, last, mystl::median(*first, 
 			*(first + (last - first) / 2),
-			*(last - 1)), comp);
+			*(last - 1), comp), comp);
         if (cut <= nth)    // 如果 nth 位于右段
             first = cut;     // 对右段进行分割
         else
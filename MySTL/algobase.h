@@ -91,10 +91,11 @@ unchecked_copy(InputIter first, InputIter last, OutputIter result) {
   	return unchecked_copy_cat(first, last, result, iterator_category(first));
 }
 
-// 为 trivially_copy_assignable 类型提供特化版本
+// 为 trivially_copyable 且可平凡赋值的类型提供特化版本，按字节整块移动
 template <typename Tp, typename Up>
 typename std::enable_if<
   	std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+  	std::is_trivially_copyable<Up>::value &&
   	std::is_trivially_copy_assignable<Up>::value,
   	Up*>::type
 unchecked_copy(Tp* first, Tp* last, Up* result) {
@@ -141,10 +142,11 @@ unchecked_copy_backward(BidirectionalIter1 first, BidirectionalIter1 last,
 		iterator_category(first));
 }
 
-// 为 trivially_copy_assignable 类型提供特化版本
+// 为 trivially_copyable 且可平凡赋值的类型提供特化版本，按字节整块移动
 template <typename Tp, typename Up>
 typename std::enable_if<
 	std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+	std::is_trivially_copyable<Up>::value &&
 	std::is_trivially_copy_assignable<Up>::value,
 	Up*>::type
 unchecked_copy_backward(Tp* first, Tp* last, Up* result) {
@@ -236,10 +238,11 @@ unchecked_move(InputIter first, InputIter last, OutputIter result) {
 	return unchecked_move_cat(first, last, result, iterator_category(first));
 }
 
-// 为 trivially_copy_assignable 类型提供特化版本
+// 为 trivially_copyable 且可平凡赋值的类型提供特化版本，按字节整块移动
 template <typename Tp, typename Up>
 typename std::enable_if<
 	std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+	std::is_trivially_copyable<Up>::value &&
 	std::is_trivially_move_assignable<Up>::value,
 	Up*>::type
 unchecked_move(Tp* first, Tp* last, Up* result) {
@@ -286,10 +289,11 @@ unchecked_move_backward(BidirectionalIter1 first, BidirectionalIter1 last,
 		iterator_category(first));
 }
 
-// 为 trivially_copy_assignable 类型提供特化版本
+// 为 trivially_copyable 且可平凡赋值的类型提供特化版本，按字节整块移动
 template <typename Tp, typename Up>
 typename std::enable_if<
 	std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
+	std::is_trivially_copyable<Up>::value &&
 	std::is_trivially_move_assignable<Up>::value,
   	Up*>::type
 unchecked_move_backward(Tp* first, Tp* last, Up* result) {
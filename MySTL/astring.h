@@ -1,7 +1,7 @@
 ﻿#ifndef MYSTL_ASTRING_H_
 #define MYSTL_ASTRING_H_
 
-// 定义了 string, wstring, u16string, u32string 类型
+// 定义了 string, wstring, u16string, u32string 类型，以及对应的透明哈希函数对象
 
 #include "basic_string.h"
 
@@ -12,6 +12,11 @@ using wstring   = mystl::basic_string<wchar_t>;
 using u16string = mystl::basic_string<char16_t>;
 using u32string = mystl::basic_string<char32_t>;
 
+using string_hash    = mystl::basic_string_hash<char>;
+using wstring_hash   = mystl::basic_string_hash<wchar_t>;
+using u16string_hash = mystl::basic_string_hash<char16_t>;
+using u32string_hash = mystl::basic_string_hash<char32_t>;
+
 }
 #endif // !MYSTL_ASTRING_H_
 
@@ -470,6 +470,13 @@ public:
     { resize(count, value_type()); }
     void resize(size_type count, value_type ch);
 
+    // 新增的字符不做填充，适合随后整体覆盖的缓冲区
+    void resize_default_init(size_type count);
+
+    // 容量扩到至少 count 后调用 op(data, count)，op 写入前 r 个字符并返回 r(r <= count)，之后 size() == r
+    template <typename Operation>
+    void resize_and_overwrite(size_type count, Operation op);
+
     void         clear() noexcept
     { size_ = 0; }
 
@@ -750,6 +757,7 @@ reserve(size_type n)
                                                     "in basic_string<Char,Traits>::reserve(n)");
         auto new_buffer = data_allocator::allocate(n);
         char_traits::move(new_buffer, buffer_, size_);
+        data_allocator::deallocate(buffer_);
         buffer_ = new_buffer;
         cap_ = n;
     }
@@ -934,6 +942,33 @@ resize(size_type count, value_type ch)
     }
 }
 
+// 重置容器大小，新增字符不填充
+template <typename CharType, typename CharTraits>
+void basic_string<CharType, CharTraits>::
+resize_default_init(size_type count)
+{
+    if (count >= cap_)
+    {  // 保留结尾空字符的位置
+        reallocate(count - size_ + 1);
+    }
+    size_ = count;
+}
+
+// 由 op 直接写入字符并决定新的大小
+template <typename CharType, typename CharTraits>
+template <typename Operation>
+void basic_string<CharType, CharTraits>::
+resize_and_overwrite(size_type count, Operation op)
+{
+    if (count >= cap_)
+    {
+        reallocate(count - size_ + 1);
+    }
+    const auto r = static_cast<size_type>(op(buffer_, count));
+    MYSTL_DEBUG(r <= count);
+    size_ = r;
+}
+
 // 比较两个 basic_string，小于返回 -1，大于返回 1，等于返回 0
 template <typename CharType, typename CharTraits>
 int basic_string<CharType, CharTraits>::
@@ -2007,6 +2042,79 @@ bool operator>=(const basic_string<CharType, CharTraits>& lhs,
     return lhs.compare(rhs) >= 0;
 }
 
+// 与以空字符结尾的字符数组比较，不构造临时的 basic_string
+template <typename CharType, typename CharTraits>
+bool operator==(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) == 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator==(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+    return rhs.compare(lhs) == 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator!=(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) != 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator!=(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+    return rhs.compare(lhs) != 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator<(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) < 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator<(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+    return rhs.compare(lhs) > 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator<=(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) <= 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator<=(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+    return rhs.compare(lhs) >= 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator>(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) > 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator>(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+    return rhs.compare(lhs) < 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator>=(const basic_string<CharType, CharTraits>& lhs, const CharType* rhs)
+{
+    return lhs.compare(rhs) >= 0;
+}
+
+template <typename CharType, typename CharTraits>
+bool operator>=(const CharType* lhs, const basic_string<CharType, CharTraits>& rhs)
+{
+    return rhs.compare(lhs) <= 0;
+}
+
 // 重载 mystl 的 swap
 template <typename CharType, typename CharTraits>
 void swap(basic_string<CharType, CharTraits>& lhs,
@@ -2019,13 +2127,37 @@ void swap(basic_string<CharType, CharTraits>& lhs,
 template <typename CharType, typename CharTraits>
 struct hash<basic_string<CharType, CharTraits>>
 {
-    size_t operator()(const basic_string<CharType, CharTraits>& str)
+    size_t operator()(const basic_string<CharType, CharTraits>& str) const
+    {
+        return bitwise_hash((const unsigned char*)str.c_str(),
+                                                str.size() * sizeof(CharType));
+    }
+};
+
+// 透明的字符串哈希函数对象，basic_string 与以空字符结尾的字符数组得到相同的哈希值
+// 与 equal_to<> 一起使用时，unordered 容器可以直接用 C 风格字符串查找
+template <typename CharType, typename CharTraits = mystl::char_traits<CharType>>
+struct basic_string_hash
+{
+    typedef int is_transparent;
+
+    size_t operator()(const basic_string<CharType, CharTraits>& str) const
     {
         return bitwise_hash((const unsigned char*)str.c_str(),
                                                 str.size() * sizeof(CharType));
     }
+
+    size_t operator()(const CharType* s) const
+    {
+        return bitwise_hash((const unsigned char*)s,
+                                                CharTraits::length(s) * sizeof(CharType));
+    }
 };
 
+// basic_string 只保存指向堆内存的指针，可以按字节搬移
+template <typename CharType, typename CharTraits>
+struct is_trivially_relocatable<basic_string<CharType, CharTraits>> : std::true_type {};
+
 } // namespace mystl
 #endif // !MYSTL_BASIC_STRING_H_
 
@@ -0,0 +1,1169 @@
+﻿#ifndef MYSTL_BTREE_H_
+#define MYSTL_BTREE_H_
+
+// 这个头文件包含一个模板类 btree
+// btree : B+ 树，所有元素存放在叶子节点中，叶子节点之间以双向链表相连
+
+// notes:
+//
+// 1. rb_tree 每个节点只保存一个元素，查找时每下降一层就要访问一块新的内存；
+//    btree 的每个节点约占 kBtreeNodeBytes 字节，一次读入若干个 cache line 就能比较多个键值，
+//    树高只有 rb_tree 的几分之一，顺序遍历时沿叶子链表前进，访存几乎是连续的。
+// 2. 节点内先用二分查找缩小范围，剩余元素不超过 kBtreeLinearSearch 个时改为线性查找。
+// 3. 内部节点保存键值的副本作为分隔键，要求 key_type 可复制。
+//    对任意分隔键 k[i]，children[i] 中的元素都不大于 k[i]，children[i + 1] 中的元素都不小于 k[i]。
+// 4. 插入、删除时节点内的元素会被移动，叶子也可能分裂或合并，因此任何插入、删除操作
+//    都会使所有迭代器失效，这一点与 rb_tree 不同。
+// 5. 插入、删除要求元素的移动构造和键值的复制不抛出异常，分裂所需的节点会在修改树之前全部分配好。
+
+#include <initializer_list>
+
+#include <cstddef>
+#include <type_traits>
+
+#include "functional.h"
+#include "iterator.h"
+#include "memory.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// btree 节点的目标大小(字节)，取四个 cache line
+static constexpr size_t kBtreeNodeBytes    = 256;
+// 节点内剩余元素不超过该值时改用线性查找
+static constexpr size_t kBtreeLinearSearch = 8;
+// 树的最大高度，扇出至少为 3，足以容纳任意 size_t 个元素
+static constexpr size_t kBtreeMaxHeight    = 64;
+
+// forward declaration
+
+template <typename T> struct btree_node_base;
+template <typename T> struct btree_leaf_node;
+template <typename T> struct btree_inner_node;
+
+template <typename T> struct btree_iterator;
+template <typename T> struct btree_const_iterator;
+
+// btree value traits
+
+template <typename T, bool>
+struct btree_value_traits_imp {	// 泛化
+	typedef T key_type;
+	typedef T mapped_type;
+	typedef T value_type;
+
+	template <typename Ty>
+	static const key_type& get_key(const Ty& value) {
+		return value;
+	}
+
+	template <typename Ty>
+	static const value_type& get_value(const Ty& value) {
+		return value;
+	}
+};
+
+template <typename T>
+struct btree_value_traits_imp<T, true> {	// 偏特化
+	typedef typename std::remove_cv<typename T::first_type>::type key_type;
+	typedef typename T::second_type                               mapped_type;
+	typedef T                                                     value_type;
+
+	template <typename Ty>
+	static const key_type& get_key(const Ty& value) {
+		return value.first;
+	}
+
+	template <typename Ty>
+	static const value_type& get_value(const Ty& value) {
+		return value;
+	}
+};
+
+template <typename T>
+struct btree_value_traits {
+	static constexpr bool is_map = mystl::is_pair<T>::value;
+
+	typedef btree_value_traits_imp<T, is_map> value_traits_type;
+
+	typedef typename value_traits_type::key_type    key_type;
+	typedef typename value_traits_type::mapped_type mapped_type;
+	typedef typename value_traits_type::value_type  value_type;
+
+	template <typename Ty>
+	static const key_type& get_key(const Ty& value) {
+		return value_traits_type::get_key(value);
+	}
+
+	template <typename Ty>
+	static const value_type& get_value(const Ty& value) {
+		return value_traits_type::get_value(value);
+	}
+};
+
+// btree node traits
+// 根据 kBtreeNodeBytes 计算每种节点能容纳的元素个数
+
+template <typename T>
+struct btree_node_traits {
+	typedef btree_value_traits<T>              value_traits;
+	typedef typename value_traits::key_type    key_type;
+	typedef typename value_traits::value_type  value_type;
+
+	// 节点头部：父节点指针、元素个数、叶子标记、前后叶子指针
+	static constexpr size_t header_bytes = sizeof(void*) * 5;
+	static constexpr size_t leaf_fit     = (kBtreeNodeBytes - header_bytes) / sizeof(value_type);
+	static constexpr size_t inner_fit    = (kBtreeNodeBytes - header_bytes) /
+	                                       (sizeof(key_type) + sizeof(void*));
+
+	// 每个节点额外预留一个槽位，插入时先放入再分裂；每个节点至少容纳 4 个元素
+	static constexpr size_t leaf_slots   = leaf_fit > 5 ? leaf_fit - 1 : 4;
+	static constexpr size_t inner_slots  = inner_fit > 5 ? inner_fit - 1 : 4;
+
+	// 非根节点的最少元素个数，低于该值时向兄弟借元素或与兄弟合并
+	static constexpr size_t leaf_min     = leaf_slots / 2;
+	static constexpr size_t inner_min    = inner_slots / 2;
+};
+
+// btree 的节点设计
+
+template <typename T>
+struct btree_node_base {
+	typedef btree_inner_node<T>* inner_ptr;
+
+	inner_ptr parent;  // 父节点，根节点为 nullptr
+	size_t    count;   // 叶子节点为元素个数，内部节点为分隔键个数
+	bool      leaf;    // 是否为叶子节点
+};
+
+template <typename T>
+struct btree_leaf_node :public btree_node_base<T> {
+	typedef btree_node_traits<T>                   node_traits;
+	typedef typename node_traits::value_traits     value_traits;
+	typedef typename node_traits::key_type         key_type;
+	typedef typename node_traits::value_type       value_type;
+	typedef btree_leaf_node<T>*                    leaf_ptr;
+
+	leaf_ptr prev;  // 前一个叶子
+	leaf_ptr next;  // 后一个叶子
+	typename std::aligned_storage<sizeof(value_type), alignof(value_type)>::type
+	         slots[node_traits::leaf_slots + 1];
+
+	value_type*     value_ptr(size_t i)       { return reinterpret_cast<value_type*>(&slots[i]); }
+	value_type&     value(size_t i)           { return *value_ptr(i); }
+	const key_type& key(size_t i)       const
+	{ return value_traits::get_key(*reinterpret_cast<const value_type*>(&slots[i])); }
+};
+
+template <typename T>
+struct btree_inner_node :public btree_node_base<T> {
+	typedef btree_node_traits<T>                   node_traits;
+	typedef typename node_traits::key_type         key_type;
+	typedef btree_node_base<T>*                    base_ptr;
+
+	typename std::aligned_storage<sizeof(key_type), alignof(key_type)>::type
+	         keys[node_traits::inner_slots + 1];
+	base_ptr children[node_traits::inner_slots + 2];
+
+	key_type*       key_ptr(size_t i)       { return reinterpret_cast<key_type*>(&keys[i]); }
+	const key_type& key(size_t i)     const { return *reinterpret_cast<const key_type*>(&keys[i]); }
+};
+
+// btree 的迭代器设计
+// 迭代器由叶子节点和节点内下标组成，end() 为最后一个叶子的尾后位置，空树时两者都为空
+
+template <typename T>
+struct btree_iterator_base :public mystl::iterator<mystl::bidirectional_iterator_tag, T> {
+	typedef btree_leaf_node<T>* leaf_ptr;
+
+	leaf_ptr node;  // 所在的叶子节点
+	size_t   pos;   // 节点内的下标
+
+	btree_iterator_base() : node(nullptr), pos(0) {}
+
+	// 使迭代器前进，到达叶子末尾时转到下一个叶子
+	void inc() {
+		if (++pos == node->count && node->next != nullptr) {
+			node = node->next;
+			pos = 0;
+		}
+	}
+
+	// 使迭代器后退，位于叶子开头时转到上一个叶子的末尾
+	void dec() {
+		if (pos == 0) {
+			node = node->prev;
+			pos = node->count - 1;
+		} else {
+			--pos;
+		}
+	}
+
+	bool operator==(const btree_iterator_base& rhs) const { return node == rhs.node && pos == rhs.pos; }
+	bool operator!=(const btree_iterator_base& rhs) const { return !(*this == rhs); }
+};
+
+// B+ 树迭代器
+template <typename T>
+struct btree_iterator :public btree_iterator_base<T> {
+	typedef btree_value_traits<T>            value_traits;
+
+	typedef typename value_traits::value_type value_type;
+	typedef value_type*                       pointer;
+	typedef value_type&                       reference;
+	typedef btree_leaf_node<T>*               leaf_ptr;
+
+	typedef btree_iterator<T>                 iterator;
+	typedef btree_const_iterator<T>           const_iterator;
+	typedef iterator                          self;
+
+	using btree_iterator_base<T>::node;
+	using btree_iterator_base<T>::pos;
+
+	// 构造函数
+	btree_iterator() {}
+	btree_iterator(leaf_ptr x, size_t n) { node = x; pos = n; }
+	btree_iterator(const const_iterator& rhs) { node = rhs.node; pos = rhs.pos; }
+
+	// 重载操作符
+	reference operator*()  const { return node->value(pos); }
+	pointer   operator->() const { return &(operator*()); }
+
+	self& operator++() {
+		this->inc();
+		return *this;
+	}
+	self operator++(int) {
+		self tmp(*this);
+		this->inc();
+		return tmp;
+	}
+	self& operator--() {
+		this->dec();
+		return *this;
+	}
+	self operator--(int) {
+		self tmp(*this);
+		this->dec();
+		return tmp;
+	}
+};
+
+// B+ 树常量迭代器
+template <typename T>
+struct btree_const_iterator :public btree_iterator_base<T> {
+	typedef btree_value_traits<T>             value_traits;
+
+	typedef typename value_traits::value_type value_type;
+	typedef const value_type*                 pointer;
+	typedef const value_type&                 reference;
+	typedef btree_leaf_node<T>*               leaf_ptr;
+
+	typedef btree_iterator<T>                 iterator;
+	typedef btree_const_iterator<T>           const_iterator;
+	typedef const_iterator                    self;
+
+	using btree_iterator_base<T>::node;
+	using btree_iterator_base<T>::pos;
+
+	// 构造函数
+	btree_const_iterator() {}
+	btree_const_iterator(leaf_ptr x, size_t n) { node = x; pos = n; }
+	btree_const_iterator(const iterator& rhs) { node = rhs.node; pos = rhs.pos; }
+
+	// 重载操作符
+	reference operator*()  const { return node->value(pos); }
+	pointer   operator->() const { return &(operator*()); }
+
+	self& operator++() {
+		this->inc();
+		return *this;
+	}
+	self operator++(int) {
+		self tmp(*this);
+		this->inc();
+		return tmp;
+	}
+	self& operator--() {
+		this->dec();
+		return *this;
+	}
+	self operator--(int) {
+		self tmp(*this);
+		this->dec();
+		return tmp;
+	}
+};
+
+// 模板类 btree
+// 参数一代表数据类型，参数二代表键值比较类型
+template <typename T, typename Compare>
+class btree {
+public:
+	// btree 的嵌套型别定义
+
+	typedef btree_node_traits<T>                     node_traits;
+	typedef btree_value_traits<T>                    value_traits;
+
+	typedef btree_node_base<T>                       base_type;
+	typedef btree_node_base<T>*                      base_ptr;
+	typedef btree_leaf_node<T>                       leaf_type;
+	typedef btree_leaf_node<T>*                      leaf_ptr;
+	typedef btree_inner_node<T>                      inner_type;
+	typedef btree_inner_node<T>*                     inner_ptr;
+	typedef typename value_traits::key_type          key_type;
+	typedef typename value_traits::mapped_type       mapped_type;
+	typedef typename value_traits::value_type        value_type;
+	typedef Compare                                  key_compare;
+
+	typedef mystl::allocator<T>                      allocator_type;
+	typedef mystl::allocator<T>                      data_allocator;
+	typedef mystl::allocator<key_type>               key_allocator;
+	typedef mystl::allocator<leaf_type>              leaf_allocator;
+	typedef mystl::allocator<inner_type>             inner_allocator;
+
+	typedef typename allocator_type::pointer         pointer;
+	typedef typename allocator_type::const_pointer   const_pointer;
+	typedef typename allocator_type::reference       reference;
+	typedef typename allocator_type::const_reference const_reference;
+	typedef typename allocator_type::size_type       size_type;
+	typedef typename allocator_type::difference_type difference_type;
+
+	typedef btree_iterator<T>                        iterator;
+	typedef btree_const_iterator<T>                  const_iterator;
+	typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+	typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+	allocator_type get_allocator() const { return allocator_type(); }
+	key_compare    key_comp()      const { return key_comp_; }
+
+	// 每种节点的容量
+	static constexpr size_type leaf_slots  = node_traits::leaf_slots;
+	static constexpr size_type inner_slots = node_traits::inner_slots;
+
+private:
+	// 用以下五个数据表现 btree
+	base_ptr    root_;        // 根节点
+	leaf_ptr    head_;        // 最左的叶子
+	leaf_ptr    tail_;        // 最右的叶子
+	size_type   node_count_;  // 元素个数
+	key_compare key_comp_;    // 键值比较的准则
+
+public:
+	// 构造、复制、析构函数
+	btree() :root_(nullptr), head_(nullptr), tail_(nullptr), node_count_(0), key_comp_() {}
+
+	btree(const btree& rhs);
+	btree(btree&& rhs) noexcept;
+
+	btree& operator=(const btree& rhs);
+	btree& operator=(btree&& rhs);
+
+	~btree() { clear(); }
+
+public:
+	// 迭代器相关操作
+
+	iterator               begin()         noexcept
+	{ return iterator(head_, 0); }
+	const_iterator         begin()   const noexcept
+	{ return const_iterator(head_, 0); }
+	iterator               end()           noexcept
+	{ return tail_ ? iterator(tail_, tail_->count) : iterator(); }
+	const_iterator         end()     const noexcept
+	{ return tail_ ? const_iterator(tail_, tail_->count) : const_iterator(); }
+
+	reverse_iterator       rbegin()        noexcept
+	{ return reverse_iterator(end()); }
+	const_reverse_iterator rbegin()  const noexcept
+	{ return const_reverse_iterator(end()); }
+	reverse_iterator       rend()          noexcept
+	{ return reverse_iterator(begin()); }
+	const_reverse_iterator rend()    const noexcept
+	{ return const_reverse_iterator(begin()); }
+
+	const_iterator         cbegin()  const noexcept
+	{ return begin(); }
+	const_iterator         cend()    const noexcept
+	{ return end(); }
+	const_reverse_iterator crbegin() const noexcept
+	{ return rbegin(); }
+	const_reverse_iterator crend()   const noexcept
+	{ return rend(); }
+
+	// 容量相关操作
+
+	bool      empty()    const noexcept { return node_count_ == 0; }
+	size_type size()     const noexcept { return node_count_; }
+	size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+	// 插入删除相关操作
+
+	// emplace
+
+	template <typename ...Args>
+	iterator  emplace_multi(Args&& ...args);
+
+	template <typename ...Args>
+	mystl::pair<iterator, bool> emplace_unique(Args&& ...args);
+
+	template <typename ...Args>
+	iterator  emplace_multi_use_hint(iterator hint, Args&& ...args);
+
+	template <typename ...Args>
+	iterator  emplace_unique_use_hint(iterator hint, Args&& ...args);
+
+	// insert
+
+	iterator  insert_multi(const value_type& value) {
+		return emplace_multi(value);
+	}
+	iterator  insert_multi(value_type&& value) {
+		return emplace_multi(mystl::move(value));
+	}
+
+	iterator  insert_multi(iterator hint, const value_type& value) {
+		return emplace_multi_use_hint(hint, value);
+	}
+	iterator  insert_multi(iterator hint, value_type&& value) {
+		return emplace_multi_use_hint(hint, mystl::move(value));
+	}
+
+	// 以 end() 为提示逐个插入，有序输入时直接追加到最右侧的叶子
+	template <typename InputIterator>
+	void      insert_multi(InputIterator first, InputIterator last) {
+		for (; first != last; ++first)
+			insert_multi(end(), *first);
+	}
+
+	mystl::pair<iterator, bool> insert_unique(const value_type& value) {
+		return emplace_unique(value);
+	}
+	mystl::pair<iterator, bool> insert_unique(value_type&& value) {
+		return emplace_unique(mystl::move(value));
+	}
+
+	iterator  insert_unique(iterator hint, const value_type& value) {
+		return emplace_unique_use_hint(hint, value);
+	}
+	iterator  insert_unique(iterator hint, value_type&& value) {
+		return emplace_unique_use_hint(hint, mystl::move(value));
+	}
+
+	template <typename InputIterator>
+	void      insert_unique(InputIterator first, InputIterator last) {
+		for (; first != last; ++first)
+			insert_unique(end(), *first);
+	}
+
+	// erase
+
+	iterator  erase(iterator hint);
+
+	size_type erase_multi(const key_type& key);
+	size_type erase_unique(const key_type& key);
+
+	void      erase(iterator first, iterator last);
+
+	void      clear();
+
+	// btree 相关操作
+
+	iterator       find(const key_type& key) {
+		iterator it = bound<false>(key);
+		return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+	}
+	const_iterator find(const key_type& key) const {
+		const_iterator it = bound<false>(key);
+		return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+	}
+
+	size_type      count_multi(const key_type& key) const {
+		auto p = equal_range_multi(key);
+		return static_cast<size_type>(mystl::distance(p.first, p.second));
+	}
+	size_type      count_unique(const key_type& key) const {
+		return find(key) != end() ? 1 : 0;
+	}
+
+	iterator       lower_bound(const key_type& key)       { return bound<false>(key); }
+	const_iterator lower_bound(const key_type& key) const { return bound<false>(key); }
+
+	iterator       upper_bound(const key_type& key)       { return bound<true>(key); }
+	const_iterator upper_bound(const key_type& key) const { return bound<true>(key); }
+
+	mystl::pair<iterator, iterator>
+	equal_range_multi(const key_type& key) {
+		return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+	}
+	mystl::pair<const_iterator, const_iterator>
+	equal_range_multi(const key_type& key) const {
+		return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+	}
+
+	mystl::pair<iterator, iterator>
+	equal_range_unique(const key_type& key) {
+		iterator it = find(key);
+		auto next = it;
+		return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+	}
+	mystl::pair<const_iterator, const_iterator>
+	equal_range_unique(const key_type& key) const {
+		const_iterator it = find(key);
+		auto next = it;
+		return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
+	}
+
+	void swap(btree& rhs) noexcept;
+
+private:
+
+	// node related
+	leaf_ptr  create_leaf();
+	inner_ptr create_inner();
+	void      destroy_subtree(base_ptr x);
+
+	// 把 src 节点第 si 个元素 / 键值移动到 dst 节点的第 di 个槽位
+	static void move_value(leaf_ptr dst, size_type di, leaf_ptr src, size_type si) {
+		data_allocator::construct(dst->value_ptr(di), mystl::move(src->value(si)));
+		data_allocator::destroy(src->value_ptr(si));
+	}
+	static void move_key(inner_ptr dst, size_type di, inner_ptr src, size_type si) {
+		key_allocator::construct(dst->key_ptr(di), mystl::move(*src->key_ptr(si)));
+		key_allocator::destroy(src->key_ptr(si));
+	}
+
+	// search
+	template <bool Upper, typename NodePtr>
+	size_type search(NodePtr x, const key_type& key) const;
+	template <bool Upper>
+	leaf_ptr  descend(const key_type& key) const;
+	template <bool Upper>
+	iterator  bound(const key_type& key) const;
+
+	// insert / erase
+	iterator  insert_value(leaf_ptr x, size_type pos, value_type&& value);
+	void      insert_parent(base_ptr left, const key_type& key, base_ptr right,
+	                        inner_ptr* spare, size_type& used);
+	iterator  erase_at(leaf_ptr x, size_type pos);
+	void      rebalance_inner(inner_ptr x);
+	void      remove_slot(inner_ptr x, size_type i);
+	void      unlink_leaf(leaf_ptr x);
+	size_type child_index(inner_ptr p, base_ptr x) const;
+};
+
+/*****************************************************************************************/
+
+// 复制构造函数
+// 源树的元素已经有序，逐个追加到最右侧的叶子，得到的叶子都是满的
+template <typename T, typename Compare>
+btree<T, Compare>::
+btree(const btree& rhs)
+	:root_(nullptr), head_(nullptr), tail_(nullptr), node_count_(0), key_comp_(rhs.key_comp_)
+{
+	try {
+		for (auto it = rhs.begin(); it != rhs.end(); ++it)
+			insert_value(tail_, tail_ ? tail_->count : 0, value_type(*it));
+	} catch (...) {
+		clear();
+		throw;
+	}
+}
+
+// 移动构造函数
+template <typename T, typename Compare>
+btree<T, Compare>::
+btree(btree&& rhs) noexcept
+	:root_(rhs.root_), head_(rhs.head_), tail_(rhs.tail_),
+	 node_count_(rhs.node_count_), key_comp_(rhs.key_comp_)
+{
+	rhs.root_ = nullptr;
+	rhs.head_ = nullptr;
+	rhs.tail_ = nullptr;
+	rhs.node_count_ = 0;
+}
+
+// 复制赋值操作符
+template <typename T, typename Compare>
+btree<T, Compare>&
+btree<T, Compare>::
+operator=(const btree& rhs) {
+	if (this != &rhs) {
+		btree tmp(rhs);
+		swap(tmp);
+	}
+	return *this;
+}
+
+// 移动赋值操作符
+template <typename T, typename Compare>
+btree<T, Compare>&
+btree<T, Compare>::
+operator=(btree&& rhs) {
+	if (this != &rhs) {
+		clear();
+		swap(rhs);
+	}
+	return *this;
+}
+
+// 就地插入元素，键值允许重复，新元素位于相等元素之后
+template <typename T, typename Compare>
+template <typename ...Args>
+typename btree<T, Compare>::iterator
+btree<T, Compare>::
+emplace_multi(Args&& ...args) {
+	value_type value(mystl::forward<Args>(args)...);
+	const key_type& key = value_traits::get_key(value);
+	leaf_ptr x = descend<true>(key);
+	const size_type pos = x ? search<true>(x, key) : 0;
+	return insert_value(x, pos, mystl::move(value));
+}
+
+// 就地插入元素，键值不允许重复
+template <typename T, typename Compare>
+template <typename ...Args>
+mystl::pair<typename btree<T, Compare>::iterator, bool>
+btree<T, Compare>::
+emplace_unique(Args&& ...args) {
+	value_type value(mystl::forward<Args>(args)...);
+	const key_type& key = value_traits::get_key(value);
+	leaf_ptr x = descend<false>(key);
+	if (x == nullptr)
+		return mystl::make_pair(insert_value(x, 0, mystl::move(value)), true);
+	const size_type pos = search<false>(x, key);
+	// 与分隔键相等的元素可能位于下一个叶子的开头
+	if (pos < x->count) {
+		if (!key_comp_(key, x->key(pos)))
+			return mystl::make_pair(iterator(x, pos), false);
+	} else if (x->next != nullptr && !key_comp_(key, x->next->key(0))) {
+		return mystl::make_pair(iterator(x->next, 0), false);
+	}
+	return mystl::make_pair(insert_value(x, pos, mystl::move(value)), true);
+}
+
+// 就地插入元素，键值允许重复
+// 只利用 end() 提示：新元素不小于最大元素时直接追加到最右侧的叶子，否则从根节点查找
+template <typename T, typename Compare>
+template <typename ...Args>
+typename btree<T, Compare>::iterator
+btree<T, Compare>::
+emplace_multi_use_hint(iterator hint, Args&& ...args) {
+	value_type value(mystl::forward<Args>(args)...);
+	if (hint == end() && tail_ != nullptr &&
+	    !key_comp_(value_traits::get_key(value), tail_->key(tail_->count - 1)))
+		return insert_value(tail_, tail_->count, mystl::move(value));
+	return emplace_multi(mystl::move(value));
+}
+
+// 就地插入元素，键值不允许重复
+template <typename T, typename Compare>
+template <typename ...Args>
+typename btree<T, Compare>::iterator
+btree<T, Compare>::
+emplace_unique_use_hint(iterator hint, Args&& ...args) {
+	value_type value(mystl::forward<Args>(args)...);
+	if (hint == end() && tail_ != nullptr &&
+	    key_comp_(tail_->key(tail_->count - 1), value_traits::get_key(value)))
+		return insert_value(tail_, tail_->count, mystl::move(value));
+	return emplace_unique(mystl::move(value)).first;
+}
+
+// 删除 hint 位置的元素，返回下一个元素的迭代器
+template <typename T, typename Compare>
+typename btree<T, Compare>::iterator
+btree<T, Compare>::
+erase(iterator hint) {
+	return erase_at(hint.node, hint.pos);
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <typename T, typename Compare>
+typename btree<T, Compare>::size_type
+btree<T, Compare>::
+erase_multi(const key_type& key) {
+	const size_type n = count_multi(key);
+	iterator it = lower_bound(key);
+	for (size_type i = 0; i < n; ++i)
+		it = erase(it);
+	return n;
+}
+
+// 删除键值等于 key 的元素，返回删除的个数
+template <typename T, typename Compare>
+typename btree<T, Compare>::size_type
+btree<T, Compare>::
+erase_unique(const key_type& key) {
+	iterator it = find(key);
+	if (it == end())
+		return 0;
+	erase(it);
+	return 1;
+}
+
+// 删除[first, last)区间内的元素
+// 每次删除都会使迭代器失效，因此先求出个数，再从 first 开始逐个删除
+template <typename T, typename Compare>
+void btree<T, Compare>::
+erase(iterator first, iterator last) {
+	if (first == begin() && last == end()) {
+		clear();
+	} else {
+		size_type n = static_cast<size_type>(mystl::distance(first, last));
+		for (; n > 0; --n)
+			first = erase(first);
+	}
+}
+
+// 清空 btree
+template <typename T, typename Compare>
+void btree<T, Compare>::
+clear() {
+	if (root_ != nullptr) {
+		destroy_subtree(root_);
+		root_ = nullptr;
+		head_ = nullptr;
+		tail_ = nullptr;
+		node_count_ = 0;
+	}
+}
+
+// 交换 btree
+template <typename T, typename Compare>
+void btree<T, Compare>::
+swap(btree& rhs) noexcept {
+	if (this != &rhs) {
+		mystl::swap(root_, rhs.root_);
+		mystl::swap(head_, rhs.head_);
+		mystl::swap(tail_, rhs.tail_);
+		mystl::swap(node_count_, rhs.node_count_);
+		mystl::swap(key_comp_, rhs.key_comp_);
+	}
+}
+
+/*****************************************************************************************/
+// helper function
+
+// 创建一个空的叶子节点
+template <typename T, typename Compare>
+typename btree<T, Compare>::leaf_ptr
+btree<T, Compare>::
+create_leaf() {
+	leaf_ptr x = leaf_allocator::allocate(1);
+	x->parent = nullptr;
+	x->count = 0;
+	x->leaf = true;
+	x->prev = nullptr;
+	x->next = nullptr;
+	return x;
+}
+
+// 创建一个空的内部节点
+template <typename T, typename Compare>
+typename btree<T, Compare>::inner_ptr
+btree<T, Compare>::
+create_inner() {
+	inner_ptr x = inner_allocator::allocate(1);
+	x->parent = nullptr;
+	x->count = 0;
+	x->leaf = false;
+	return x;
+}
+
+// 销毁以 x 为根的子树
+template <typename T, typename Compare>
+void btree<T, Compare>::
+destroy_subtree(base_ptr x) {
+	if (x->leaf) {
+		leaf_ptr l = static_cast<leaf_ptr>(x);
+		for (size_type i = 0; i < l->count; ++i)
+			data_allocator::destroy(l->value_ptr(i));
+		leaf_allocator::deallocate(l);
+	} else {
+		inner_ptr p = static_cast<inner_ptr>(x);
+		for (size_type i = 0; i <= p->count; ++i)
+			destroy_subtree(p->children[i]);
+		for (size_type i = 0; i < p->count; ++i)
+			key_allocator::destroy(p->key_ptr(i));
+		inner_allocator::deallocate(p);
+	}
+}
+
+// 在节点 x 内查找
+// Upper 为 false 时返回第一个不小于 key 的位置，为 true 时返回第一个大于 key 的位置
+template <typename T, typename Compare>
+template <bool Upper, typename NodePtr>
+typename btree<T, Compare>::size_type
+btree<T, Compare>::
+search(NodePtr x, const key_type& key) const {
+	size_type lo = 0, hi = x->count;
+	while (hi - lo > kBtreeLinearSearch) {
+		const size_type mid = lo + (hi - lo) / 2;
+		if (Upper ? !key_comp_(key, x->key(mid)) : key_comp_(x->key(mid), key))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	while (lo < hi && (Upper ? !key_comp_(key, x->key(lo)) : key_comp_(x->key(lo), key)))
+		++lo;
+	return lo;
+}
+
+// 从根节点下降到 key 所在的叶子，空树返回 nullptr
+template <typename T, typename Compare>
+template <bool Upper>
+typename btree<T, Compare>::leaf_ptr
+btree<T, Compare>::
+descend(const key_type& key) const {
+	base_ptr x = root_;
+	if (x == nullptr)
+		return nullptr;
+	while (!x->leaf) {
+		inner_ptr p = static_cast<inner_ptr>(x);
+		x = p->children[search<Upper>(p, key)];
+	}
+	return static_cast<leaf_ptr>(x);
+}
+
+// lower_bound / upper_bound 的实现，落在叶子末尾时转到下一个叶子的开头
+template <typename T, typename Compare>
+template <bool Upper>
+typename btree<T, Compare>::iterator
+btree<T, Compare>::
+bound(const key_type& key) const {
+	leaf_ptr x = descend<Upper>(key);
+	if (x == nullptr)
+		return iterator();
+	size_type pos = search<Upper>(x, key);
+	if (pos == x->count && x->next != nullptr) {
+		x = x->next;
+		pos = 0;
+	}
+	return iterator(x, pos);
+}
+
+// 把 value 插入到叶子 x 的 pos 位置，x 为 nullptr 时创建根节点
+// 叶子已满时先放入预留槽位再分裂，分裂可能一直向上传递到根节点
+template <typename T, typename Compare>
+typename btree<T, Compare>::iterator
+btree<T, Compare>::
+insert_value(leaf_ptr x, size_type pos, value_type&& value) {
+	THROW_LENGTH_ERROR_IF(node_count_ == max_size(), "btree<T, Comp>'s size too big");
+	if (x == nullptr) {
+		x = create_leaf();
+		try {
+			data_allocator::construct(x->value_ptr(0), mystl::move(value));
+		} catch (...) {
+			leaf_allocator::deallocate(x);
+			throw;
+		}
+		x->count = 1;
+		root_ = head_ = tail_ = x;
+		node_count_ = 1;
+		return iterator(x, 0);
+	}
+
+	// 预先分配分裂所需的全部节点：新的叶子，每个已满的祖先一个，祖先全满时再加一个新根
+	leaf_ptr right = nullptr;
+	inner_ptr spare[kBtreeMaxHeight];
+	size_type need = 0, used = 0;
+	if (x->count == leaf_slots) {
+		inner_ptr p = x->parent;
+		for (; p != nullptr && p->count == inner_slots; p = p->parent)
+			++need;
+		if (p == nullptr)
+			++need;
+		right = create_leaf();
+		try {
+			for (; used < need; ++used)
+				spare[used] = create_inner();
+		} catch (...) {
+			while (used > 0)
+				inner_allocator::deallocate(spare[--used]);
+			leaf_allocator::deallocate(right);
+			throw;
+		}
+		used = 0;
+	}
+
+	for (size_type i = x->count; i > pos; --i)
+		move_value(x, i, x, i - 1);
+	data_allocator::construct(x->value_ptr(pos), mystl::move(value));
+	++x->count;
+	++node_count_;
+	if (right == nullptr)
+		return iterator(x, pos);
+
+	// 在最右侧叶子的末尾追加时(有序插入)，左边保持全满，只把新元素分到右边
+	const size_type lc = (x == tail_ && pos == leaf_slots) ? leaf_slots : (leaf_slots + 1) / 2;
+	for (size_type i = lc; i < x->count; ++i)
+		move_value(right, i - lc, x, i);
+	right->count = x->count - lc;
+	x->count = lc;
+
+	right->prev = x;
+	right->next = x->next;
+	if (x->next != nullptr)
+		x->next->prev = right;
+	else
+		tail_ = right;
+	x->next = right;
+
+	insert_parent(x, right->key(0), right, spare, used);
+	return pos < lc ? iterator(x, pos) : iterator(right, pos - lc);
+}
+
+// 在 left 的父节点中插入分隔键 key 和右子节点 right，父节点溢出时分裂并继续向上
+template <typename T, typename Compare>
+void btree<T, Compare>::
+insert_parent(base_ptr left, const key_type& key, base_ptr right,
+              inner_ptr* spare, size_type& used) {
+	inner_ptr p = left->parent;
+	if (p == nullptr) {
+		p = spare[used++];
+		key_allocator::construct(p->key_ptr(0), key);
+		p->children[0] = left;
+		p->children[1] = right;
+		p->count = 1;
+		left->parent = p;
+		right->parent = p;
+		root_ = p;
+		return;
+	}
+
+	const size_type i = child_index(p, left);
+	for (size_type j = p->count; j > i; --j)
+		move_key(p, j, p, j - 1);
+	for (size_type j = p->count + 1; j > i + 1; --j)
+		p->children[j] = p->children[j - 1];
+	key_allocator::construct(p->key_ptr(i), key);
+	p->children[i + 1] = right;
+	right->parent = p;
+	if (++p->count <= inner_slots)
+		return;
+
+	// 节点溢出，后一半移到新节点，中间的分隔键上移到父节点
+	inner_ptr q = spare[used++];
+	const size_type mid = p->count / 2;
+	for (size_type j = mid + 1; j < p->count; ++j)
+		move_key(q, j - mid - 1, p, j);
+	for (size_type j = mid + 1; j <= p->count; ++j) {
+		q->children[j - mid - 1] = p->children[j];
+		p->children[j]->parent = q;
+	}
+	q->count = p->count - mid - 1;
+	p->count = mid;
+	insert_parent(p, p->key(mid), q, spare, used);
+	key_allocator::destroy(p->key_ptr(mid));
+}
+
+// 删除叶子 x 中 pos 位置的元素，返回下一个元素的迭代器
+// 叶子的元素少于 leaf_min 时，先尝试向兄弟借一个元素，否则与兄弟合并
+template <typename T, typename Compare>
+typename btree<T, Compare>::iterator
+btree<T, Compare>::
+erase_at(leaf_ptr x, size_type pos) {
+	data_allocator::destroy(x->value_ptr(pos));
+	for (size_type i = pos + 1; i < x->count; ++i)
+		move_value(x, i - 1, x, i);
+	--x->count;
+	--node_count_;
+
+	leaf_ptr  rn = x;    // 返回位置所在的叶子
+	size_type rp = pos;  // 返回位置的下标
+	if (x == root_) {
+		if (x->count == 0) {
+			leaf_allocator::deallocate(x);
+			root_ = head_ = tail_ = nullptr;
+			return end();
+		}
+	} else if (x->count < node_traits::leaf_min) {
+		inner_ptr p = x->parent;
+		const size_type i = child_index(p, x);
+		leaf_ptr l = i > 0 ? static_cast<leaf_ptr>(p->children[i - 1]) : nullptr;
+		leaf_ptr r = i < p->count ? static_cast<leaf_ptr>(p->children[i + 1]) : nullptr;
+		if (l != nullptr && l->count > node_traits::leaf_min) {
+			// 借左兄弟的最后一个元素
+			for (size_type j = x->count; j > 0; --j)
+				move_value(x, j, x, j - 1);
+			move_value(x, 0, l, --l->count);
+			++x->count;
+			key_allocator::destroy(p->key_ptr(i - 1));
+			key_allocator::construct(p->key_ptr(i - 1), x->key(0));
+			++rp;
+		} else if (r != nullptr && r->count > node_traits::leaf_min) {
+			// 借右兄弟的第一个元素
+			move_value(x, x->count++, r, 0);
+			for (size_type j = 1; j < r->count; ++j)
+				move_value(r, j - 1, r, j);
+			--r->count;
+			key_allocator::destroy(p->key_ptr(i));
+			key_allocator::construct(p->key_ptr(i), r->key(0));
+		} else if (l != nullptr) {
+			// 并入左兄弟
+			for (size_type j = 0; j < x->count; ++j)
+				move_value(l, l->count + j, x, j);
+			rp += l->count;
+			l->count += x->count;
+			rn = l;
+			unlink_leaf(x);
+			leaf_allocator::deallocate(x);
+			key_allocator::destroy(p->key_ptr(i - 1));
+			remove_slot(p, i - 1);
+			rebalance_inner(p);
+		} else {
+			// 右兄弟并入
+			for (size_type j = 0; j < r->count; ++j)
+				move_value(x, x->count + j, r, j);
+			x->count += r->count;
+			unlink_leaf(r);
+			leaf_allocator::deallocate(r);
+			key_allocator::destroy(p->key_ptr(i));
+			remove_slot(p, i);
+			rebalance_inner(p);
+		}
+	}
+	if (rp == rn->count && rn->next != nullptr) {
+		rn = rn->next;
+		rp = 0;
+	}
+	return iterator(rn, rp);
+}
+
+// 内部节点 x 的分隔键少于 inner_min 时，经由父节点向兄弟借一个子节点，否则与兄弟合并
+// 合并会使父节点减少一个分隔键，因此需要继续向上检查
+template <typename T, typename Compare>
+void btree<T, Compare>::
+rebalance_inner(inner_ptr x) {
+	while (x != root_ && x->count < node_traits::inner_min) {
+		inner_ptr p = x->parent;
+		const size_type i = child_index(p, x);
+		inner_ptr l = i > 0 ? static_cast<inner_ptr>(p->children[i - 1]) : nullptr;
+		inner_ptr r = i < p->count ? static_cast<inner_ptr>(p->children[i + 1]) : nullptr;
+		if (l != nullptr && l->count > node_traits::inner_min) {
+			for (size_type j = x->count; j > 0; --j)
+				move_key(x, j, x, j - 1);
+			for (size_type j = x->count + 1; j > 0; --j)
+				x->children[j] = x->children[j - 1];
+			move_key(x, 0, p, i - 1);
+			x->children[0] = l->children[l->count];
+			x->children[0]->parent = x;
+			move_key(p, i - 1, l, l->count - 1);
+			--l->count;
+			++x->count;
+			return;
+		}
+		if (r != nullptr && r->count > node_traits::inner_min) {
+			move_key(x, x->count, p, i);
+			x->children[x->count + 1] = r->children[0];
+			x->children[x->count + 1]->parent = x;
+			move_key(p, i, r, 0);
+			for (size_type j = 1; j < r->count; ++j)
+				move_key(r, j - 1, r, j);
+			for (size_type j = 1; j <= r->count; ++j)
+				r->children[j - 1] = r->children[j];
+			--r->count;
+			++x->count;
+			return;
+		}
+		// 合并：左节点 + 父节点的分隔键 + 右节点
+		inner_ptr a = l != nullptr ? l : x;
+		inner_ptr b = l != nullptr ? x : r;
+		const size_type k = l != nullptr ? i - 1 : i;
+		move_key(a, a->count, p, k);
+		for (size_type j = 0; j < b->count; ++j)
+			move_key(a, a->count + 1 + j, b, j);
+		for (size_type j = 0; j <= b->count; ++j) {
+			a->children[a->count + 1 + j] = b->children[j];
+			b->children[j]->parent = a;
+		}
+		a->count += b->count + 1;
+		inner_allocator::deallocate(b);
+		remove_slot(p, k);
+		x = p;
+	}
+	if (x == root_ && x->count == 0) {
+		// 根节点只剩一个子节点，树高减一
+		root_ = x->children[0];
+		root_->parent = nullptr;
+		inner_allocator::deallocate(x);
+	}
+}
+
+// 移除内部节点 x 的第 i 个分隔键(已销毁)和第 i + 1 个子节点
+template <typename T, typename Compare>
+void btree<T, Compare>::
+remove_slot(inner_ptr x, size_type i) {
+	for (size_type j = i + 1; j < x->count; ++j)
+		move_key(x, j - 1, x, j);
+	for (size_type j = i + 2; j <= x->count; ++j)
+		x->children[j - 1] = x->children[j];
+	--x->count;
+}
+
+// 把叶子 x 从叶子链表中摘下
+template <typename T, typename Compare>
+void btree<T, Compare>::
+unlink_leaf(leaf_ptr x) {
+	if (x->prev != nullptr)
+		x->prev->next = x->next;
+	else
+		head_ = x->next;
+	if (x->next != nullptr)
+		x->next->prev = x->prev;
+	else
+		tail_ = x->prev;
+}
+
+// 返回 x 在父节点 p 中的下标
+template <typename T, typename Compare>
+typename btree<T, Compare>::size_type
+btree<T, Compare>::
+child_index(inner_ptr p, base_ptr x) const {
+	size_type i = 0;
+	while (p->children[i] != x)
+		++i;
+	return i;
+}
+
+// 重载比较操作符
+template <typename T, typename Compare>
+bool operator==(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+	return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, typename Compare>
+bool operator<(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+	return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, typename Compare>
+bool operator!=(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename T, typename Compare>
+bool operator>(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+	return rhs < lhs;
+}
+
+template <typename T, typename Compare>
+bool operator<=(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+	return !(rhs < lhs);
+}
+
+template <typename T, typename Compare>
+bool operator>=(const btree<T, Compare>& lhs, const btree<T, Compare>& rhs) {
+	return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <typename T, typename Compare>
+void swap(btree<T, Compare>& lhs, btree<T, Compare>& rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYSTL_BTREE_H_
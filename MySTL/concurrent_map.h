@@ -0,0 +1,642 @@
+﻿#ifndef MYSTL_CONCURRENT_MAP_H_
+#define MYSTL_CONCURRENT_MAP_H_
+
+// 这个头文件包含一个模板类 concurrent_map
+// concurrent_map : 可并发访问的有序映射，基于跳表，键值不允许重复
+
+// notes:
+//
+// 底层为 optimistic (lazy) skip list：
+//   * 查找、lower_bound / upper_bound 与迭代都不加锁
+//   * insert / erase 先无锁地定位，再只锁住各层的前驱节点并校验，校验失败则重试
+//   * 节点带有 marked (已逻辑删除) 与 fully_linked (各层均已链接) 两个标志，
+//     读者只把 fully_linked 且未 marked 的节点视为存在
+// 被删除的节点由两阶段 epoch 计数回收。每个迭代器都持有一个读者计数，
+// 因此迭代器存活期间它能走到的节点都不会被释放；迭代是弱一致的，不保证看到迭代期间的修改
+// 元素发布后只读，迭代器解引用得到 const value_type&
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "algo.h"
+#include "functional.h"
+#include "vector.h"
+#include "concurrent_queue.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+template <typename Key, typename T, typename Compare>
+class concurrent_map;
+
+namespace concurrent_detail {
+
+// 跳表节点的公共部分，表头只有这一部分
+struct skip_node_base {
+	std::atomic<skip_node_base*>* next;     // 指向紧跟在节点之后的 level 个指针
+	int                           level;
+	std::atomic<bool>             marked;
+	std::atomic<bool>             fully_linked;
+	std::atomic<bool>             locked;
+
+	void lock() {
+		size_t spins = 0;
+		while (locked.exchange(true, std::memory_order_acquire))
+			spin_wait(spins);
+	}
+	void unlock() { locked.store(false, std::memory_order_release); }
+};
+
+template <typename T>
+struct skip_node :public skip_node_base {
+	T value;
+};
+
+// 读者计数分散到若干条缓存行上，线程按 id 选择其中一条
+constexpr static size_t kReaderStripes = 16;
+
+struct alignas(kCacheLineSize) reader_stripe {
+	std::atomic<size_t> count[2];
+};
+
+inline size_t this_thread_stripe() {
+	static thread_local size_t stripe =
+		std::hash<std::thread::id>()(std::this_thread::get_id()) % kReaderStripes;
+	return stripe;
+}
+
+} // namespace concurrent_detail
+
+// concurrent_map 的迭代器，只读
+template <typename Key, typename T, typename Compare>
+struct concurrent_map_iterator
+	:public mystl::iterator<mystl::forward_iterator_tag, mystl::pair<const Key, T>> {
+	typedef mystl::pair<const Key, T>                    value_type;
+	typedef const value_type*                            pointer;
+	typedef const value_type&                            reference;
+	typedef concurrent_detail::skip_node_base*           base_ptr;
+	typedef concurrent_detail::skip_node<value_type>*    node_ptr;
+	typedef concurrent_map<Key, T, Compare>              map_type;
+	typedef concurrent_map_iterator<Key, T, Compare>     self;
+
+	base_ptr  node;   // 当前节点，nullptr 表示 end
+	map_type* m;      // 所属容器
+	size_t    stripe; // 持有的读者计数
+	size_t    slot;
+
+	concurrent_map_iterator() :node(nullptr), m(nullptr), stripe(0), slot(0) {}
+	concurrent_map_iterator(base_ptr n, map_type* c, size_t st, size_t sl)
+		:node(n), m(c), stripe(st), slot(sl) {
+		pin();
+	}
+	concurrent_map_iterator(const self& rhs)
+		:node(rhs.node), m(rhs.m), stripe(rhs.stripe), slot(rhs.slot) {
+		pin();
+	}
+	self& operator=(const self& rhs) {
+		if (this != &rhs) {
+			self tmp(rhs);
+			unpin();
+			node = tmp.node;
+			m = tmp.m;
+			stripe = tmp.stripe;
+			slot = tmp.slot;
+			pin();
+		}
+		return *this;
+	}
+	~concurrent_map_iterator() { unpin(); }
+
+	reference operator*()  const { return static_cast<node_ptr>(node)->value; }
+	pointer   operator->() const { return &(operator*()); }
+
+	self& operator++() {
+		MYSTL_DEBUG(node != nullptr);
+		base_ptr next = m->next_live(node->next[0].load(std::memory_order_acquire));
+		if (next == nullptr)  // 走到 end 后不再需要读者计数
+			unpin();
+		node = next;
+		return *this;
+	}
+	self operator++(int) {
+		self tmp(*this);
+		++*this;
+		return tmp;
+	}
+
+	bool operator==(const self& rhs) const { return node == rhs.node; }
+	bool operator!=(const self& rhs) const { return node != rhs.node; }
+
+private:
+	void pin() {
+		if (node)
+			m->readers_[stripe].count[slot].fetch_add(1);
+	}
+	void unpin() {
+		if (node)
+			m->readers_[stripe].count[slot].fetch_sub(1, std::memory_order_release);
+	}
+};
+
+// 模板类 concurrent_map
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
+template <typename Key, typename T, typename Compare = mystl::less<Key>>
+class concurrent_map {
+	friend struct concurrent_map_iterator<Key, T, Compare>;
+
+public:
+	typedef Key                                          key_type;
+	typedef T                                            mapped_type;
+	typedef mystl::pair<const Key, T>                    value_type;
+	typedef Compare                                      key_compare;
+	typedef const value_type&                            reference;
+	typedef const value_type&                            const_reference;
+	typedef size_t                                       size_type;
+	typedef ptrdiff_t                                    difference_type;
+
+	typedef concurrent_map_iterator<Key, T, Compare>     iterator;
+	typedef concurrent_map_iterator<Key, T, Compare>     const_iterator;
+
+private:
+	typedef concurrent_detail::skip_node_base            base_type;
+	typedef concurrent_detail::skip_node<value_type>     node_type;
+	typedef base_type*                                   base_ptr;
+	typedef node_type*                                   node_ptr;
+	typedef std::atomic<base_ptr>                        link_type;
+
+	// 等待回收的节点，tag 为摘除时的 epoch
+	struct retired {
+		node_ptr  np;
+		size_type tag;
+	};
+
+	// 最大层数，每升一层的概率为 1/4
+	constexpr static int kMaxLevel = 16;
+	// 回收列表超过这个长度时尝试回收
+	constexpr static size_type kReclaimThreshold = 64;
+
+	// 读者在容器中的保护区间
+	class read_guard {
+	public:
+		explicit read_guard(const concurrent_map& m)
+			:m_(m), stripe_(concurrent_detail::this_thread_stripe()) {
+			slot_ = m_.epoch_.load() & 1;
+			m_.readers_[stripe_].count[slot_].fetch_add(1);
+		}
+		~read_guard() {
+			m_.readers_[stripe_].count[slot_].fetch_sub(1, std::memory_order_release);
+		}
+
+		read_guard(const read_guard&) = delete;
+		read_guard& operator=(const read_guard&) = delete;
+
+		size_type stripe() const { return stripe_; }
+		size_type slot()   const { return slot_; }
+
+	private:
+		const concurrent_map& m_;
+		size_type             stripe_;
+		size_type             slot_;
+	};
+
+private:
+	base_ptr                                 head_;
+	key_compare                              comp_;
+	alignas(kCacheLineSize) std::atomic<size_type> size_;
+	mutable concurrent_detail::reader_stripe readers_[concurrent_detail::kReaderStripes];
+	alignas(kCacheLineSize) std::atomic<size_type> epoch_;
+	std::mutex                               retire_mutex_;
+	mystl::vector<retired>                   garbage_;
+
+public:
+	// 构造、析构函数，容器不可复制
+	concurrent_map() :concurrent_map(Compare()) {}
+	explicit concurrent_map(const Compare& comp);
+
+	concurrent_map(const concurrent_map&) = delete;
+	concurrent_map& operator=(const concurrent_map&) = delete;
+
+	~concurrent_map();
+
+public:
+	// 迭代器相关操作，迭代器存活期间会推迟节点的回收
+	iterator       begin()  const;
+	iterator       end()    const noexcept { return iterator(); }
+	const_iterator cbegin() const { return begin(); }
+	const_iterator cend()   const noexcept { return end(); }
+
+	// 容量相关操作，并发修改时只是一个近似值
+	bool      empty()    const noexcept { return size() == 0; }
+	size_type size()     const noexcept { return size_.load(std::memory_order_relaxed); }
+	size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+	key_compare key_comp() const { return comp_; }
+
+	// 修改容器相关操作
+
+	template <typename ...Args>
+	mystl::pair<iterator, bool> emplace(Args&& ...args);
+
+	mystl::pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+	mystl::pair<iterator, bool> insert(value_type&& value) { return emplace(mystl::move(value)); }
+
+	template <typename InputIter>
+	void insert(InputIter first, InputIter last) {
+		for (; first != last; ++first)
+			emplace(*first);
+	}
+
+	size_type erase(const key_type& key);
+
+	// 逐个删除所有元素，可与其它操作并发
+	void clear();
+
+	// 查找相关操作，均不加锁
+
+	iterator  find(const key_type& key) const;
+	size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+	bool      contains(const key_type& key) const;
+
+	iterator  lower_bound(const key_type& key) const;
+	iterator  upper_bound(const key_type& key) const;
+
+	mystl::pair<iterator, iterator> equal_range(const key_type& key) const {
+		return mystl::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+private:
+	// helper functions
+
+	const key_type& key_of(base_ptr p) const { return static_cast<node_ptr>(p)->value.first; }
+
+	// node
+	template <typename ...Args>
+	node_ptr create_node(int level, Args&& ...args);
+	void     destroy_node(node_ptr np);
+	static int random_level();
+
+	// 定位 key 在每一层的前驱与后继，返回最高的命中层，未命中时返回 -1
+	int      find_node(const key_type& key, base_ptr* preds, base_ptr* succs) const;
+	// 第一个不小于 key 或大于 key 的存活节点
+	base_ptr lower_node(const key_type& key, bool upper) const;
+	// 从 p 开始第一个存活节点
+	base_ptr next_live(base_ptr p) const;
+
+	// 锁住 preds[0, level) 中不同的节点并校验，返回是否成功；失败时已全部解锁
+	template <typename Valid>
+	bool     lock_preds(base_ptr* preds, int level, Valid valid);
+	void     unlock_preds(base_ptr* preds, int level);
+
+	void     retire(node_ptr np);
+	void     reclaim();
+};
+
+/*****************************************************************************************/
+
+template <typename Key, typename T, typename Compare>
+concurrent_map<Key, T, Compare>::
+concurrent_map(const Compare& comp)
+	:head_(nullptr), comp_(comp), size_(0), epoch_(0) {
+	for (auto& r : readers_) {
+		r.count[0].store(0);
+		r.count[1].store(0);
+	}
+	void* p = ::operator new(sizeof(base_type) + kMaxLevel * sizeof(link_type));
+	head_ = new (p) base_type();
+	head_->next = reinterpret_cast<link_type*>(static_cast<char*>(p) + sizeof(base_type));
+	for (int i = 0; i < kMaxLevel; ++i)
+		new (head_->next + i) link_type(nullptr);
+	head_->level = kMaxLevel;
+	head_->marked.store(false);
+	head_->fully_linked.store(true);
+	head_->locked.store(false);
+}
+
+template <typename Key, typename T, typename Compare>
+concurrent_map<Key, T, Compare>::
+~concurrent_map() {
+	for (auto& r : garbage_)
+		destroy_node(r.np);
+	base_ptr p = head_->next[0].load(std::memory_order_relaxed);
+	while (p) {
+		base_ptr next = p->next[0].load(std::memory_order_relaxed);
+		destroy_node(static_cast<node_ptr>(p));
+		p = next;
+	}
+	head_->~base_type();
+	::operator delete(head_);
+}
+
+// 第一个元素
+template <typename Key, typename T, typename Compare>
+typename concurrent_map<Key, T, Compare>::iterator
+concurrent_map<Key, T, Compare>::
+begin() const {
+	read_guard guard(*this);
+	return iterator(next_live(head_->next[0].load(std::memory_order_acquire)),
+		const_cast<concurrent_map*>(this), guard.stripe(), guard.slot());
+}
+
+// 就地构造元素，键值已存在时返回已有元素
+template <typename Key, typename T, typename Compare>
+template <typename ...Args>
+mystl::pair<typename concurrent_map<Key, T, Compare>::iterator, bool>
+concurrent_map<Key, T, Compare>::
+emplace(Args&& ...args) {
+	const int level = random_level();
+	node_ptr np = create_node(level, mystl::forward<Args>(args)...);
+	const key_type& key = np->value.first;
+	read_guard guard(*this);
+	auto self = const_cast<concurrent_map*>(this);
+	base_ptr preds[kMaxLevel], succs[kMaxLevel];
+	size_type spins = 0;
+	while (true) {
+		const int found = find_node(key, preds, succs);
+		if (found != -1) {
+			base_ptr p = succs[found];
+			if (!p->marked.load(std::memory_order_acquire)) {
+				// 已存在，等待它插入完成
+				while (!p->fully_linked.load(std::memory_order_acquire))
+					concurrent_detail::spin_wait(spins);
+				destroy_node(np);
+				return mystl::make_pair(iterator(p, self, guard.stripe(), guard.slot()), false);
+			}
+			concurrent_detail::spin_wait(spins);  // 正在被删除，重试
+			continue;
+		}
+		const bool ok = lock_preds(preds, level, [&](int l) {
+			return !preds[l]->marked.load(std::memory_order_relaxed) &&
+				(succs[l] == nullptr || !succs[l]->marked.load(std::memory_order_relaxed)) &&
+				preds[l]->next[l].load(std::memory_order_relaxed) == succs[l];
+		});
+		if (!ok)
+			continue;
+		for (int l = 0; l < level; ++l)
+			np->next[l].store(succs[l], std::memory_order_relaxed);
+		for (int l = 0; l < level; ++l)
+			preds[l]->next[l].store(np, std::memory_order_release);
+		np->fully_linked.store(true, std::memory_order_release);
+		unlock_preds(preds, level);
+		size_.fetch_add(1, std::memory_order_relaxed);
+		return mystl::make_pair(iterator(np, self, guard.stripe(), guard.slot()), true);
+	}
+}
+
+// 删除键值为 key 的元素
+template <typename Key, typename T, typename Compare>
+typename concurrent_map<Key, T, Compare>::size_type
+concurrent_map<Key, T, Compare>::
+erase(const key_type& key) {
+	read_guard guard(*this);
+	base_ptr preds[kMaxLevel], succs[kMaxLevel];
+	base_ptr victim = nullptr;
+	while (true) {
+		const int found = find_node(key, preds, succs);
+		if (victim == nullptr) {
+			if (found == -1)
+				return 0;
+			base_ptr p = succs[found];
+			// 只删除插入已完成、且在其最高层被找到的节点
+			if (!p->fully_linked.load(std::memory_order_acquire) || p->level - 1 != found ||
+				p->marked.load(std::memory_order_acquire))
+				return 0;
+			p->lock();
+			if (p->marked.load(std::memory_order_relaxed)) {  // 已被其它线程删除
+				p->unlock();
+				return 0;
+			}
+			p->marked.store(true, std::memory_order_release);
+			victim = p;
+		}
+		const int level = victim->level;
+		const bool ok = lock_preds(preds, level, [&](int l) {
+			return !preds[l]->marked.load(std::memory_order_relaxed) &&
+				preds[l]->next[l].load(std::memory_order_relaxed) == victim;
+		});
+		if (!ok)
+			continue;
+		for (int l = level - 1; l >= 0; --l)
+			preds[l]->next[l].store(victim->next[l].load(std::memory_order_relaxed),
+				std::memory_order_release);
+		victim->unlock();
+		unlock_preds(preds, level);
+		size_.fetch_sub(1, std::memory_order_relaxed);
+		retire(static_cast<node_ptr>(victim));
+		return 1;
+	}
+}
+
+// 清空容器
+template <typename Key, typename T, typename Compare>
+void concurrent_map<Key, T, Compare>::
+clear() {
+	for (auto it = begin(); it != end(); ++it)
+		erase(it->first);
+}
+
+// 查找键值为 key 的元素
+template <typename Key, typename T, typename Compare>
+typename concurrent_map<Key, T, Compare>::iterator
+concurrent_map<Key, T, Compare>::
+find(const key_type& key) const {
+	read_guard guard(*this);
+	base_ptr p = lower_node(key, false);
+	if (p == nullptr || comp_(key, key_of(p)))
+		return end();
+	return iterator(p, const_cast<concurrent_map*>(this), guard.stripe(), guard.slot());
+}
+
+template <typename Key, typename T, typename Compare>
+bool concurrent_map<Key, T, Compare>::
+contains(const key_type& key) const {
+	read_guard guard(*this);
+	base_ptr p = lower_node(key, false);
+	return p != nullptr && !comp_(key, key_of(p));
+}
+
+// 第一个不小于 key 的元素
+template <typename Key, typename T, typename Compare>
+typename concurrent_map<Key, T, Compare>::iterator
+concurrent_map<Key, T, Compare>::
+lower_bound(const key_type& key) const {
+	read_guard guard(*this);
+	return iterator(lower_node(key, false), const_cast<concurrent_map*>(this),
+		guard.stripe(), guard.slot());
+}
+
+// 第一个大于 key 的元素
+template <typename Key, typename T, typename Compare>
+typename concurrent_map<Key, T, Compare>::iterator
+concurrent_map<Key, T, Compare>::
+upper_bound(const key_type& key) const {
+	read_guard guard(*this);
+	return iterator(lower_node(key, true), const_cast<concurrent_map*>(this),
+		guard.stripe(), guard.slot());
+}
+
+/*****************************************************************************************/
+// helper function
+
+// create_node 函数，level 个 next 指针紧跟在节点之后
+template <typename Key, typename T, typename Compare>
+template <typename ...Args>
+typename concurrent_map<Key, T, Compare>::node_ptr
+concurrent_map<Key, T, Compare>::
+create_node(int level, Args&& ...args) {
+	void* p = ::operator new(sizeof(node_type) + level * sizeof(link_type));
+	node_ptr np = static_cast<node_ptr>(p);
+	try {
+		mystl::construct(mystl::address_of(np->value), mystl::forward<Args>(args)...);
+	}catch (...) {
+		::operator delete(p);
+		throw;
+	}
+	np->next = reinterpret_cast<link_type*>(static_cast<char*>(p) + sizeof(node_type));
+	for (int i = 0; i < level; ++i)
+		new (np->next + i) link_type(nullptr);
+	np->level = level;
+	new (&np->marked) std::atomic<bool>(false);
+	new (&np->fully_linked) std::atomic<bool>(false);
+	new (&np->locked) std::atomic<bool>(false);
+	return np;
+}
+
+// destroy_node 函数
+template <typename Key, typename T, typename Compare>
+void concurrent_map<Key, T, Compare>::
+destroy_node(node_ptr np) {
+	mystl::destroy(mystl::address_of(np->value));
+	::operator delete(np);
+}
+
+// random_level 函数，每升一层的概率为 1/4
+template <typename Key, typename T, typename Compare>
+int concurrent_map<Key, T, Compare>::
+random_level() {
+	static thread_local uint32_t state =
+		static_cast<uint32_t>(concurrent_detail::this_thread_stripe() * 2654435761u + 1);
+	// xorshift32
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	uint32_t r = state;
+	int level = 1;
+	while (level < kMaxLevel && (r & 3) == 0) {
+		++level;
+		r >>= 2;
+	}
+	return level;
+}
+
+// find_node 函数
+template <typename Key, typename T, typename Compare>
+int concurrent_map<Key, T, Compare>::
+find_node(const key_type& key, base_ptr* preds, base_ptr* succs) const {
+	int found = -1;
+	base_ptr pred = head_;
+	for (int l = kMaxLevel - 1; l >= 0; --l) {
+		base_ptr cur = pred->next[l].load(std::memory_order_acquire);
+		while (cur && comp_(key_of(cur), key)) {
+			pred = cur;
+			cur = pred->next[l].load(std::memory_order_acquire);
+		}
+		if (found == -1 && cur && !comp_(key, key_of(cur)))
+			found = l;
+		preds[l] = pred;
+		succs[l] = cur;
+	}
+	return found;
+}
+
+// lower_node 函数
+template <typename Key, typename T, typename Compare>
+typename concurrent_map<Key, T, Compare>::base_ptr
+concurrent_map<Key, T, Compare>::
+lower_node(const key_type& key, bool upper) const {
+	base_ptr pred = head_;
+	base_ptr cur = nullptr;
+	for (int l = kMaxLevel - 1; l >= 0; --l) {
+		cur = pred->next[l].load(std::memory_order_acquire);
+		while (cur && (upper ? !comp_(key, key_of(cur)) : comp_(key_of(cur), key))) {
+			pred = cur;
+			cur = pred->next[l].load(std::memory_order_acquire);
+		}
+	}
+	return next_live(cur);
+}
+
+// next_live 函数，跳过已删除和尚未插入完成的节点
+template <typename Key, typename T, typename Compare>
+typename concurrent_map<Key, T, Compare>::base_ptr
+concurrent_map<Key, T, Compare>::
+next_live(base_ptr p) const {
+	while (p && (p->marked.load(std::memory_order_acquire) ||
+		!p->fully_linked.load(std::memory_order_acquire)))
+		p = p->next[0].load(std::memory_order_acquire);
+	return p;
+}
+
+// lock_preds 函数，自底向上加锁，相同的前驱只锁一次
+template <typename Key, typename T, typename Compare>
+template <typename Valid>
+bool concurrent_map<Key, T, Compare>::
+lock_preds(base_ptr* preds, int level, Valid valid) {
+	base_ptr prev = nullptr;
+	for (int l = 0; l < level; ++l) {
+		if (preds[l] != prev) {
+			preds[l]->lock();
+			prev = preds[l];
+		}
+		if (!valid(l)) {
+			unlock_preds(preds, l + 1);
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename Key, typename T, typename Compare>
+void concurrent_map<Key, T, Compare>::
+unlock_preds(base_ptr* preds, int level) {
+	base_ptr prev = nullptr;
+	for (int l = 0; l < level; ++l) {
+		if (preds[l] != prev) {
+			preds[l]->unlock();
+			prev = preds[l];
+		}
+	}
+}
+
+// 把已摘除的节点放入回收列表
+template <typename Key, typename T, typename Compare>
+void concurrent_map<Key, T, Compare>::
+retire(node_ptr np) {
+	std::lock_guard<std::mutex> lock(retire_mutex_);
+	garbage_.push_back(retired{ np, epoch_.load(std::memory_order_relaxed) });
+	if (garbage_.size() >= kReclaimThreshold)
+		reclaim();
+}
+
+// 两阶段 epoch 回收，需持有 retire_mutex_
+// 只有另一奇偶位的读者全部退出时 epoch 才前进，标记为 tag 的节点在 epoch >= tag + 2 时可以释放
+template <typename Key, typename T, typename Compare>
+void concurrent_map<Key, T, Compare>::
+reclaim() {
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	size_type epoch = epoch_.load(std::memory_order_relaxed);
+	size_type readers = 0;
+	for (auto& r : readers_)
+		readers += r.count[(epoch + 1) & 1].load();
+	if (readers == 0)
+		epoch_.store(++epoch);
+	size_type n = 0;
+	for (; n < garbage_.size() && garbage_[n].tag + 2 <= epoch; ++n)
+		destroy_node(garbage_[n].np);
+	if (n != 0)
+		garbage_.erase(garbage_.begin(), garbage_.begin() + n);
+}
+
+} // namespace mystl
+#endif // !MYSTL_CONCURRENT_MAP_H_
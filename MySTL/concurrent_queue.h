@@ -0,0 +1,313 @@
+﻿#ifndef MYSTL_CONCURRENT_QUEUE_H_
+#define MYSTL_CONCURRENT_QUEUE_H_
+
+// 这个头文件包含两个无锁有界队列 mpmc_queue 和 spsc_queue
+// mpmc_queue : 多生产者多消费者队列，基于每个槽位的序号 (Dmitry Vyukov 的有界 MPMC 队列)
+// spsc_queue : 单生产者单消费者队列，只用一对 acquire / release 原子变量同步
+
+// notes:
+//
+// 两者均为固定容量的环形缓冲区，容量在构造时向上取整为 2 的幂，之后不再增长
+// try_push / try_pop 不会阻塞，队列满 / 空时返回 false
+// push / pop 在队列满 / 空时自旋等待，自旋若干次后让出时间片
+// head 与 tail 分别按缓存行对齐，避免生产者和消费者之间的伪共享
+
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+#include "util.h"
+#include "allocator.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+// 缓存行大小
+constexpr static size_t kCacheLineSize = 64;
+
+namespace concurrent_detail {
+
+// 将 n 向上取整为 2 的幂
+inline size_t round_up_pow2(size_t n) {
+	size_t cap = 1;
+	while (cap < n)
+		cap <<= 1;
+	return cap;
+}
+
+// 自旋等待：先忙等若干次，之后让出时间片
+inline void spin_wait(size_t& spins) {
+	if (++spins > 64)
+		std::this_thread::yield();
+}
+
+} // namespace concurrent_detail
+
+/*****************************************************************************************/
+
+// 模板类 mpmc_queue
+// 参数一代表数据类型
+template <typename T>
+class mpmc_queue {
+public:
+	typedef T            value_type;
+	typedef T&           reference;
+	typedef const T&     const_reference;
+	typedef size_t       size_type;
+
+private:
+	// 槽位：seq 表示该槽位当前允许哪一轮的读写
+	// seq == pos       : 空槽，等待位置为 pos 的生产者写入
+	// seq == pos + 1   : 已写入，等待位置为 pos 的消费者读取
+	struct slot {
+		std::atomic<size_type> seq;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+		T* value() { return reinterpret_cast<T*>(&storage); }
+	};
+
+	typedef mystl::allocator<slot> slot_allocator;
+
+private:
+	slot*     buffer_;  // 环形缓冲区
+	size_type mask_;    // 容量 - 1
+
+	alignas(kCacheLineSize) std::atomic<size_type> head_;  // 下一个入队位置
+	alignas(kCacheLineSize) std::atomic<size_type> tail_;  // 下一个出队位置
+
+public:
+	// 构造、析构函数，队列不可复制、移动
+	explicit mpmc_queue(size_type capacity);
+
+	mpmc_queue(const mpmc_queue&) = delete;
+	mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+	~mpmc_queue();
+
+public:
+	// 容量相关操作，并发访问时只是一个近似值
+	size_type capacity() const noexcept { return mask_ + 1; }
+	size_type size() const noexcept {
+		const size_type head = head_.load(std::memory_order_acquire);
+		const size_type tail = tail_.load(std::memory_order_acquire);
+		return head > tail ? head - tail : 0;
+	}
+	bool empty() const noexcept { return size() == 0; }
+
+	// 修改容器相关操作
+	template <typename... Args>
+	bool try_emplace(Args&& ...args);
+
+	bool try_push(const value_type& value) { return try_emplace(value); }
+	bool try_push(value_type&& value) { return try_emplace(mystl::move(value)); }
+
+	bool try_pop(value_type& value);
+
+	template <typename... Args>
+	void emplace(Args&& ...args) {
+		size_type spins = 0;
+		while (!try_emplace(mystl::forward<Args>(args)...))
+			concurrent_detail::spin_wait(spins);
+	}
+
+	void push(const value_type& value) { emplace(value); }
+	void push(value_type&& value) { emplace(mystl::move(value)); }
+
+	void pop(value_type& value) {
+		size_type spins = 0;
+		while (!try_pop(value))
+			concurrent_detail::spin_wait(spins);
+	}
+};
+
+/*****************************************************************************************/
+
+template <typename T>
+mpmc_queue<T>::mpmc_queue(size_type capacity)
+	:buffer_(nullptr), mask_(0), head_(0), tail_(0) {
+	THROW_LENGTH_ERROR_IF(capacity == 0, "mpmc_queue<T>'s capacity can not be zero");
+	const size_type cap = concurrent_detail::round_up_pow2(capacity);
+	buffer_ = slot_allocator::allocate(cap);
+	for (size_type i = 0; i < cap; ++i)
+		new (&buffer_[i].seq) std::atomic<size_type>(i);
+	mask_ = cap - 1;
+}
+
+template <typename T>
+mpmc_queue<T>::~mpmc_queue() {
+	const size_type head = head_.load(std::memory_order_relaxed);
+	for (size_type i = tail_.load(std::memory_order_relaxed); i != head; ++i)
+		mystl::destroy(buffer_[i & mask_].value());
+	for (size_type i = 0; i <= mask_; ++i)
+		buffer_[i].seq.~atomic();
+	slot_allocator::deallocate(buffer_, mask_ + 1);
+}
+
+// 尝试在队尾就地构造元素，队列已满则返回 false
+template <typename T>
+template <typename... Args>
+bool mpmc_queue<T>::try_emplace(Args&& ...args) {
+	size_type pos = head_.load(std::memory_order_relaxed);
+	slot* cell;
+	while (true) {
+		cell = &buffer_[pos & mask_];
+		const size_type seq = cell->seq.load(std::memory_order_acquire);
+		const auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+		if (diff == 0) {	// 槽位空闲，尝试占用
+			if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}else if (diff < 0) {	// 槽位仍被上一轮占用，队列已满
+			return false;
+		}else {	// 其他生产者抢先，重新读取 head
+			pos = head_.load(std::memory_order_relaxed);
+		}
+	}
+	mystl::construct(cell->value(), mystl::forward<Args>(args)...);
+	cell->seq.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+// 尝试从队头取出元素，队列为空则返回 false
+template <typename T>
+bool mpmc_queue<T>::try_pop(value_type& value) {
+	size_type pos = tail_.load(std::memory_order_relaxed);
+	slot* cell;
+	while (true) {
+		cell = &buffer_[pos & mask_];
+		const size_type seq = cell->seq.load(std::memory_order_acquire);
+		const auto diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos + 1);
+		if (diff == 0) {	// 槽位已写入，尝试占用
+			if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}else if (diff < 0) {	// 槽位尚未写入，队列为空
+			return false;
+		}else {	// 其他消费者抢先，重新读取 tail
+			pos = tail_.load(std::memory_order_relaxed);
+		}
+	}
+	value = mystl::move(*cell->value());
+	mystl::destroy(cell->value());
+	cell->seq.store(pos + mask_ + 1, std::memory_order_release);	// 交给下一轮的生产者
+	return true;
+}
+
+/*****************************************************************************************/
+
+// 模板类 spsc_queue
+// 参数一代表数据类型
+// 只允许一个线程入队、一个线程出队，每一侧缓存对侧的位置，只有在看起来满 / 空时才重新读取
+template <typename T>
+class spsc_queue {
+public:
+	typedef T            value_type;
+	typedef T&           reference;
+	typedef const T&     const_reference;
+	typedef size_t       size_type;
+
+	typedef mystl::allocator<T> data_allocator;
+
+private:
+	T*        buffer_;  // 环形缓冲区
+	size_type mask_;    // 容量 - 1
+
+	alignas(kCacheLineSize) std::atomic<size_type> head_;  // 生产者写入位置
+	size_type tail_cache_;                                 // 生产者缓存的 tail
+	alignas(kCacheLineSize) std::atomic<size_type> tail_;  // 消费者读取位置
+	size_type head_cache_;                                 // 消费者缓存的 head
+
+public:
+	// 构造、析构函数，队列不可复制、移动
+	explicit spsc_queue(size_type capacity);
+
+	spsc_queue(const spsc_queue&) = delete;
+	spsc_queue& operator=(const spsc_queue&) = delete;
+
+	~spsc_queue();
+
+public:
+	// 容量相关操作，并发访问时只是一个近似值
+	size_type capacity() const noexcept { return mask_ + 1; }
+	size_type size() const noexcept {
+		return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+	}
+	bool empty() const noexcept { return size() == 0; }
+
+	// 修改容器相关操作，只能由生产者调用
+	template <typename... Args>
+	bool try_emplace(Args&& ...args);
+
+	bool try_push(const value_type& value) { return try_emplace(value); }
+	bool try_push(value_type&& value) { return try_emplace(mystl::move(value)); }
+
+	template <typename... Args>
+	void emplace(Args&& ...args) {
+		size_type spins = 0;
+		while (!try_emplace(mystl::forward<Args>(args)...))
+			concurrent_detail::spin_wait(spins);
+	}
+
+	void push(const value_type& value) { emplace(value); }
+	void push(value_type&& value) { emplace(mystl::move(value)); }
+
+	// 修改容器相关操作，只能由消费者调用
+	bool try_pop(value_type& value);
+
+	void pop(value_type& value) {
+		size_type spins = 0;
+		while (!try_pop(value))
+			concurrent_detail::spin_wait(spins);
+	}
+};
+
+/*****************************************************************************************/
+
+template <typename T>
+spsc_queue<T>::spsc_queue(size_type capacity)
+	:buffer_(nullptr), mask_(0), head_(0), tail_cache_(0), tail_(0), head_cache_(0) {
+	THROW_LENGTH_ERROR_IF(capacity == 0, "spsc_queue<T>'s capacity can not be zero");
+	const size_type cap = concurrent_detail::round_up_pow2(capacity);
+	buffer_ = data_allocator::allocate(cap);
+	mask_ = cap - 1;
+}
+
+template <typename T>
+spsc_queue<T>::~spsc_queue() {
+	const size_type head = head_.load(std::memory_order_relaxed);
+	for (size_type i = tail_.load(std::memory_order_relaxed); i != head; ++i)
+		data_allocator::destroy(buffer_ + (i & mask_));
+	data_allocator::deallocate(buffer_, mask_ + 1);
+}
+
+// 尝试在队尾就地构造元素，队列已满则返回 false
+template <typename T>
+template <typename... Args>
+bool spsc_queue<T>::try_emplace(Args&& ...args) {
+	const size_type head = head_.load(std::memory_order_relaxed);
+	if (head - tail_cache_ > mask_) {
+		tail_cache_ = tail_.load(std::memory_order_acquire);
+		if (head - tail_cache_ > mask_)
+			return false;
+	}
+	data_allocator::construct(buffer_ + (head & mask_), mystl::forward<Args>(args)...);
+	head_.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+// 尝试从队头取出元素，队列为空则返回 false
+template <typename T>
+bool spsc_queue<T>::try_pop(value_type& value) {
+	const size_type tail = tail_.load(std::memory_order_relaxed);
+	if (tail == head_cache_) {
+		head_cache_ = head_.load(std::memory_order_acquire);
+		if (tail == head_cache_)
+			return false;
+	}
+	T* p = buffer_ + (tail & mask_);
+	value = mystl::move(*p);
+	data_allocator::destroy(p);
+	tail_.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+} // namespace mystl
+#endif // !MYSTL_CONCURRENT_QUEUE_H_
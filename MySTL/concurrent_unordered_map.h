@@ -0,0 +1,589 @@
+﻿#ifndef MYSTL_CONCURRENT_UNORDERED_MAP_H_
+#define MYSTL_CONCURRENT_UNORDERED_MAP_H_
+
+// 这个头文件包含一个模板类 concurrent_unordered_map
+// concurrent_unordered_map : 可并发访问的哈希表，键值不允许重复
+
+// notes:
+//
+// 整张表按哈希值分成若干个 shard，每个 shard 拥有独立的 bucket 数组和互斥量：
+//   * 写操作 (insert / insert_or_assign / erase / clear) 只锁住键所在的 shard
+//   * 读操作 (find / contains / count / visit) 不加锁，也不会等待写者，扩容期间同样如此
+// 节点一旦发布，其值不再修改：insert_or_assign 用新节点替换旧节点，erase 只摘除节点，
+// 被摘除的节点与旧 bucket 数组先放入回收列表，由 shard 内的两阶段 epoch 计数保证
+// 所有可能看到它们的读者退出后才真正释放
+// 扩容按 shard 独立进行，并且是渐进式的：读者始终只看到一张完整的表，新表在旁边建立。
+// 每个节点有两个 next 链接，当前表与新表各用其一，迁移只写新表使用的链接，读者遍历的链接不变；
+// 每次写操作把若干个 bucket 链入新表，写入已迁移的 bucket 时同时修改两张表，
+// 全部迁移后以一次原子指针交换发布新表，旧表按 epoch 回收。
+// 旧表回收之前不开始下一次扩容，以免改写仍可能有读者在遍历的那一组链接
+// 由于读者拿不到节点的长期引用，查找接口以复制值或回调的方式返回结果
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "functional.h"
+#include "hashtable.h"
+#include "concurrent_queue.h"
+#include "exceptdef.h"
+
+namespace mystl {
+
+// 模板类 concurrent_unordered_map
+// 参数一代表键值类型，参数二代表实值类型，参数三代表哈希函数，缺省使用 mystl::hash
+// 参数四代表键值比较方式，缺省使用 mystl::equal_to
+template <typename Key, typename T, typename Hash = mystl::hash<Key>,
+	typename KeyEqual = mystl::equal_to<Key>>
+class concurrent_unordered_map {
+public:
+	typedef Key                                 key_type;
+	typedef T                                   mapped_type;
+	typedef mystl::pair<const Key, T>           value_type;
+	typedef Hash                                hasher;
+	typedef KeyEqual                            key_equal;
+	typedef size_t                              size_type;
+
+private:
+	// 节点：value 发布后只读，next[0] / next[1] 分别供相邻两代的 bucket 数组使用
+	struct node {
+		std::atomic<node*> next[2];
+		value_type         value;
+
+		template <typename ...Args>
+		node(Args&& ...args)
+			:value(mystl::forward<Args>(args)...) {
+			next[0].store(nullptr, std::memory_order_relaxed);
+			next[1].store(nullptr, std::memory_order_relaxed);
+		}
+	};
+
+	// bucket 数组，链表经节点的 next[link] 相连
+	struct table {
+		size_type           size;
+		std::atomic<node*>* buckets;
+		unsigned            link;
+	};
+
+	// 等待回收的节点或表，tag 为摘除时的 epoch
+	struct retired {
+		node*     np;
+		table*    tp;
+		size_type tag;
+	};
+
+	typedef mystl::allocator<node>               node_allocator;
+	typedef mystl::allocator<table>              table_allocator;
+	typedef mystl::allocator<std::atomic<node*>> bucket_allocator;
+
+	// 每个 shard 独立加锁、独立扩容，按缓存行对齐避免相邻 shard 的伪共享
+	struct alignas(kCacheLineSize) shard {
+		std::mutex                      mutex;
+		std::atomic<table*>             head;     // 当前表，读写都从这里开始，始终完整
+		std::atomic<size_type>          epoch;    // 回收用的 epoch
+		std::atomic<size_type>          readers[2];
+		std::atomic<size_type>          count;    // 元素个数
+		table*                          grow;     // 正在建立、尚未发布的新表，没有扩容时为 nullptr
+		table*                          retiring; // 上次扩容换下、尚未回收的旧表
+		size_type                       migrate_pos;  // 当前表中这之前的 bucket 已链入新表
+		mystl::vector<retired>          garbage;
+	};
+
+	// 读者在 shard 中的保护区间
+	class read_guard {
+	public:
+		explicit read_guard(shard& s)
+			:s_(s) {
+			slot_ = s_.epoch.load() & 1;
+			s_.readers[slot_].fetch_add(1);
+		}
+		~read_guard() { s_.readers[slot_].fetch_sub(1, std::memory_order_release); }
+
+		read_guard(const read_guard&) = delete;
+		read_guard& operator=(const read_guard&) = delete;
+
+	private:
+		shard&    s_;
+		size_type slot_;
+	};
+
+	// 每次写操作顺带迁移的 bucket 数
+	constexpr static size_type kMigrateStep = 8;
+
+private:
+	void*       storage_;   // shards_ 所在的原始内存
+	shard*      shards_;
+	size_type   shard_count_;
+	size_type   shard_shift_;
+	float       mlf_;
+	hasher      hash_;
+	key_equal   equal_;
+
+public:
+	// 构造、析构函数，容器不可复制
+	// shard_count 为 0 时取 hardware_concurrency 的 4 倍，并向上取整为 2 的幂
+	explicit concurrent_unordered_map(size_type bucket_count = 100,
+		size_type shard_count = 0,
+		const Hash& hash = Hash(),
+		const KeyEqual& equal = KeyEqual());
+
+	concurrent_unordered_map(const concurrent_unordered_map&) = delete;
+	concurrent_unordered_map& operator=(const concurrent_unordered_map&) = delete;
+
+	~concurrent_unordered_map();
+
+public:
+	// 容量相关操作，并发修改时只是一个近似值
+	bool      empty() const noexcept { return size() == 0; }
+	size_type size()  const noexcept;
+
+	size_type shard_count()  const noexcept { return shard_count_; }
+	size_type bucket_count() const noexcept;
+
+	float max_load_factor() const noexcept { return mlf_; }
+	void  max_load_factor(float ml) {
+		THROW_OUT_OF_RANGE_IF(ml != ml || ml <= 0, "invalid hash load factor");
+		mlf_ = ml;
+	}
+
+	// 查找相关操作，均不加锁，也不等待写者
+
+	// 找到 key 时把实值复制到 value 并返回 true
+	bool find(const key_type& key, mapped_type& value) const {
+		return visit(key, [&value](const value_type& v) { value = v.second; });
+	}
+	bool      contains(const key_type& key) const {
+		return visit(key, [](const value_type&) {});
+	}
+	size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+	// 找到 key 时以 f(const value_type&) 访问元素并返回 true
+	// 元素可能同时被其他线程访问，f 应当只读取元素
+	template <typename Func>
+	bool visit(const key_type& key, Func f) const;
+
+	// 修改容器相关操作，只锁住键所在的 shard
+
+	// 键值不存在时插入，返回是否插入成功
+	template <typename ...Args>
+	bool emplace(Args&& ...args);
+
+	bool insert(const value_type& value) { return emplace(value); }
+	bool insert(value_type&& value) { return emplace(mystl::move(value)); }
+
+	// 键值存在时替换实值，否则插入，返回是否为新插入
+	template <typename M>
+	bool insert_or_assign(const key_type& key, M&& obj);
+
+	size_type erase(const key_type& key);
+	void      clear();
+
+private:
+	// helper functions
+
+	size_type hash_code(const key_type& key) const { return hash_(key); }
+	shard&    shard_of(size_type code) const {
+		// 用 Fibonacci hashing 取高位，使 shard 的选择与 bucket 下标相互独立
+		// 分两次移位，只有一个 shard 时移位数为字长
+		const size_type h = code * static_cast<size_type>(0x9E3779B97F4A7C15ull);
+		return shards_[(h >> 1) >> (shard_shift_ - 1)];
+	}
+
+	// node / table
+	template <typename ...Args>
+	node*  create_node(Args&& ...args);
+	void   destroy_node(node* np);
+	table* create_table(size_type n, unsigned link);
+	void   destroy_table(table* tp);
+
+	// 以下函数均需持有 shard 的锁
+	void   retire(shard& s, node* np, table* tp);
+	void   reclaim(shard& s);
+	bool   migrated(shard& s, table* cur, size_type code) const {
+		return s.grow != nullptr && code % cur->size < s.migrate_pos;
+	}
+	void   push_front(table* tp, size_type code, node* np);
+	void   link_node(shard& s, size_type code, node* np);
+	node*  replace_node(shard& s, size_type code, const key_type& key, node* np);
+	void   migrate_some(shard& s);
+	void   grow_if_need(shard& s);
+	node*  find_in(table* tp, size_type code, const key_type& key, std::atomic<node*>*& link);
+};
+
+/*****************************************************************************************/
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+concurrent_unordered_map(size_type bucket_count, size_type shard_count,
+	const Hash& hash, const KeyEqual& equal)
+	:storage_(nullptr), shards_(nullptr), shard_count_(1), shard_shift_(sizeof(size_type) * 8),
+	mlf_(1.0f), hash_(hash), equal_(equal) {
+	if (shard_count == 0)
+		shard_count = mystl::max(static_cast<size_type>(std::thread::hardware_concurrency()) * 4,
+			static_cast<size_type>(4));
+	while (shard_count_ < shard_count) {
+		shard_count_ <<= 1;
+		--shard_shift_;
+	}
+	const size_type per_shard = ht_next_prime(bucket_count / shard_count_ + 1);
+	// ::operator new 不保证缓存行对齐，多分配一行后手动对齐
+	storage_ = ::operator new(sizeof(shard) * shard_count_ + kCacheLineSize);
+	shards_ = reinterpret_cast<shard*>((reinterpret_cast<uintptr_t>(storage_) + kCacheLineSize - 1)
+		& ~static_cast<uintptr_t>(kCacheLineSize - 1));
+	for (size_type i = 0; i < shard_count_; ++i) {
+		shard* s = new (shards_ + i) shard();
+		s->grow = nullptr;
+		s->retiring = nullptr;
+		s->migrate_pos = 0;
+		s->head.store(create_table(per_shard, 0));
+		s->epoch.store(0);
+		s->readers[0].store(0);
+		s->readers[1].store(0);
+		s->count.store(0);
+	}
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+~concurrent_unordered_map() {
+	for (size_type i = 0; i < shard_count_; ++i) {
+		shard& s = shards_[i];
+		for (auto& r : s.garbage) {
+			if (r.np)
+				destroy_node(r.np);
+			else
+				destroy_table(r.tp);
+		}
+		if (s.grow != nullptr)	// 新表中的节点同时在当前表中
+			destroy_table(s.grow);
+		table* tp = s.head.load(std::memory_order_relaxed);
+		for (size_type b = 0; b < tp->size; ++b) {
+			node* np = tp->buckets[b].load(std::memory_order_relaxed);
+			while (np) {
+				node* next = np->next[tp->link].load(std::memory_order_relaxed);
+				destroy_node(np);
+				np = next;
+			}
+		}
+		destroy_table(tp);
+		s.~shard();
+	}
+	::operator delete(storage_);
+}
+
+// 元素个数
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::size_type
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+size() const noexcept {
+	size_type n = 0;
+	for (size_type i = 0; i < shard_count_; ++i)
+		n += shards_[i].count.load(std::memory_order_relaxed);
+	return n;
+}
+
+// bucket 总数
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::size_type
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+bucket_count() const noexcept {
+	size_type n = 0;
+	for (size_type i = 0; i < shard_count_; ++i) {
+		std::lock_guard<std::mutex> lock(shards_[i].mutex);
+		n += shards_[i].head.load(std::memory_order_relaxed)->size;
+	}
+	return n;
+}
+
+// 不加锁的查找
+// 只遍历 head 表经 next[link] 相连的链表，这组链接在表被回收之前不会被迁移改写，因此不需要重试
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+template <typename Func>
+bool concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+visit(const key_type& key, Func f) const {
+	const size_type code = hash_code(key);
+	shard& s = shard_of(code);
+	read_guard guard(s);
+	table* tp = s.head.load(std::memory_order_acquire);
+	const unsigned link = tp->link;
+	node* np = tp->buckets[code % tp->size].load(std::memory_order_acquire);
+	for (; np; np = np->next[link].load(std::memory_order_acquire)) {
+		if (equal_(np->value.first, key)) {
+			f(np->value);
+			return true;
+		}
+	}
+	return false;
+}
+
+// 就地构造元素，键值不允许重复
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+template <typename ...Args>
+bool concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+emplace(Args&& ...args) {
+	node* np = create_node(mystl::forward<Args>(args)...);
+	const size_type code = hash_code(np->value.first);
+	shard& s = shard_of(code);
+	std::lock_guard<std::mutex> lock(s.mutex);
+	migrate_some(s);
+	std::atomic<node*>* link;
+	if (find_in(s.head.load(std::memory_order_relaxed), code, np->value.first, link)) {
+		destroy_node(np);
+		return false;
+	}
+	link_node(s, code, np);
+	s.count.fetch_add(1, std::memory_order_relaxed);
+	grow_if_need(s);
+	return true;
+}
+
+// 键值存在时以新节点替换旧节点，否则插入
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+template <typename M>
+bool concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+insert_or_assign(const key_type& key, M&& obj) {
+	node* np = create_node(key, mystl::forward<M>(obj));
+	const size_type code = hash_code(key);
+	shard& s = shard_of(code);
+	std::lock_guard<std::mutex> lock(s.mutex);
+	migrate_some(s);
+	node* old = replace_node(s, code, key, np);
+	if (old) {
+		retire(s, old, nullptr);
+		return false;
+	}
+	link_node(s, code, np);
+	s.count.fetch_add(1, std::memory_order_relaxed);
+	grow_if_need(s);
+	return true;
+}
+
+// 删除键值为 key 的节点
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::size_type
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+erase(const key_type& key) {
+	const size_type code = hash_code(key);
+	shard& s = shard_of(code);
+	std::lock_guard<std::mutex> lock(s.mutex);
+	migrate_some(s);
+	node* np = replace_node(s, code, key, nullptr);
+	if (np == nullptr)
+		return 0;
+	s.count.fetch_sub(1, std::memory_order_relaxed);
+	retire(s, np, nullptr);
+	return 1;
+}
+
+// 清空容器，逐个 shard 进行
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+clear() {
+	for (size_type i = 0; i < shard_count_; ++i) {
+		shard& s = shards_[i];
+		std::lock_guard<std::mutex> lock(s.mutex);
+		if (s.grow != nullptr) {	// 新表尚未发布，没有读者，直接放弃
+			destroy_table(s.grow);
+			s.grow = nullptr;
+		}
+		table* tp = s.head.load(std::memory_order_relaxed);
+		for (size_type b = 0; b < tp->size; ++b) {
+			node* np = tp->buckets[b].exchange(nullptr, std::memory_order_acq_rel);
+			const size_type tag = s.epoch.load(std::memory_order_relaxed);
+			for (; np; np = np->next[tp->link].load(std::memory_order_relaxed))
+				s.garbage.push_back(retired{ np, nullptr, tag });
+		}
+		s.count.store(0, std::memory_order_relaxed);
+		reclaim(s);
+	}
+}
+
+/*****************************************************************************************/
+// helper function
+
+// create_node 函数
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+template <typename ...Args>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::node*
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+create_node(Args&& ...args) {
+	node* np = node_allocator::allocate(1);
+	try {
+		mystl::construct(np, mystl::forward<Args>(args)...);
+	}catch (...) {
+		node_allocator::deallocate(np);
+		throw;
+	}
+	return np;
+}
+
+// destroy_node 函数
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+destroy_node(node* np) {
+	mystl::destroy(np);
+	node_allocator::deallocate(np);
+}
+
+// create_table 函数
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::table*
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+create_table(size_type n, unsigned link) {
+	table* tp = table_allocator::allocate(1);
+	tp->size = n;
+	tp->link = link;
+	try {
+		tp->buckets = bucket_allocator::allocate(n);
+	}catch (...) {
+		table_allocator::deallocate(tp);
+		throw;
+	}
+	for (size_type i = 0; i < n; ++i)
+		new (tp->buckets + i) std::atomic<node*>(nullptr);
+	return tp;
+}
+
+// destroy_table 函数，只释放 bucket 数组，不释放节点
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+destroy_table(table* tp) {
+	bucket_allocator::deallocate(tp->buckets, tp->size);
+	table_allocator::deallocate(tp);
+}
+
+// 把摘除的节点或表放入回收列表，并尝试回收
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+retire(shard& s, node* np, table* tp) {
+	s.garbage.push_back(retired{ np, tp, s.epoch.load(std::memory_order_relaxed) });
+	reclaim(s);
+}
+
+// 两阶段 epoch 回收
+// 读者进入时在 readers[epoch & 1] 上计数；只有当另一奇偶位的读者全部退出时 epoch 才能前进，
+// 因此一个读者存活期间 epoch 至多前进一次，标记为 tag 的对象在 epoch >= tag + 2 时不再被任何读者引用
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+reclaim(shard& s) {
+	if (s.garbage.empty())
+		return;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	size_type epoch = s.epoch.load(std::memory_order_relaxed);
+	if (s.readers[(epoch + 1) & 1].load() == 0)
+		s.epoch.store(++epoch);
+	size_type n = 0;
+	for (; n < s.garbage.size() && s.garbage[n].tag + 2 <= epoch; ++n) {
+		if (s.garbage[n].np) {
+			destroy_node(s.garbage[n].np);
+		}else {
+			if (s.garbage[n].tp == s.retiring)
+				s.retiring = nullptr;
+			destroy_table(s.garbage[n].tp);
+		}
+	}
+	if (n != 0)
+		s.garbage.erase(s.garbage.begin(), s.garbage.begin() + n);
+}
+
+// 把 np 插入表 tp 中对应 bucket 的头部，经 next[tp->link] 相连
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+push_front(table* tp, size_type code, node* np) {
+	auto& bucket = tp->buckets[code % tp->size];
+	np->next[tp->link].store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	bucket.store(np, std::memory_order_release);
+}
+
+// 插入新节点：所在 bucket 已迁移时先链入未发布的新表，再链入当前表
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+link_node(shard& s, size_type code, node* np) {
+	table* cur = s.head.load(std::memory_order_relaxed);
+	if (migrated(s, cur, code))
+		push_front(s.grow, code, np);
+	push_front(cur, code, np);
+}
+
+// 在当前表(以及已迁移时的新表)中把键值为 key 的节点替换为 np，np 为 nullptr 时只摘除
+// 返回被替换的节点，没有找到时返回 nullptr 且不做修改
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::node*
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+replace_node(shard& s, size_type code, const key_type& key, node* np) {
+	table* cur = s.head.load(std::memory_order_relaxed);
+	std::atomic<node*>* link;
+	node* old = find_in(cur, code, key, link);
+	if (old == nullptr)
+		return nullptr;
+	const bool both = migrated(s, cur, code);
+	for (table* tp = cur; tp != nullptr; tp = (tp == cur && both) ? s.grow : nullptr) {
+		if (tp != cur)
+			find_in(tp, code, key, link);
+		node* next = old->next[tp->link].load(std::memory_order_relaxed);
+		if (np) {
+			np->next[tp->link].store(next, std::memory_order_relaxed);
+			next = np;
+		}
+		link->store(next, std::memory_order_release);
+	}
+	return old;
+}
+
+// 写操作前推进扩容：把当前表的 kMigrateStep 个 bucket 链入新表，只写新表使用的链接
+// 全部链入后发布新表，当前表交给回收列表
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+migrate_some(shard& s) {
+	if (s.grow == nullptr)
+		return;
+	table* cur = s.head.load(std::memory_order_relaxed);
+	for (size_type k = 0; k < kMigrateStep && s.migrate_pos < cur->size; ++k) {
+		node* np = cur->buckets[s.migrate_pos++].load(std::memory_order_relaxed);
+		for (; np; np = np->next[cur->link].load(std::memory_order_relaxed))
+			push_front(s.grow, hash_code(np->value.first), np);
+	}
+	if (s.migrate_pos == cur->size) {
+		s.head.store(s.grow, std::memory_order_release);
+		s.grow = nullptr;
+		s.retiring = cur;
+		retire(s, nullptr, cur);
+	}
+}
+
+// 负载过高时开始一次新的扩容
+// 新表使用上上代表的那组链接，上次换下的表尚未回收时可能还有读者在遍历它们，此时暂缓扩容
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+void concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+grow_if_need(shard& s) {
+	table* cur = s.head.load(std::memory_order_relaxed);
+	const size_type count = s.count.load(std::memory_order_relaxed);
+	if (s.grow != nullptr || static_cast<float>(count) <= static_cast<float>(cur->size) * mlf_)
+		return;
+	if (s.retiring != nullptr)
+		reclaim(s);
+	if (s.retiring != nullptr)
+		return;
+	s.grow = create_table(ht_next_prime(cur->size + 1), cur->link ^ 1);
+	s.migrate_pos = 0;
+	migrate_some(s);
+}
+
+// 在表 tp 中查找 key，link 返回指向该节点的链接
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+typename concurrent_unordered_map<Key, T, Hash, KeyEqual>::node*
+concurrent_unordered_map<Key, T, Hash, KeyEqual>::
+find_in(table* tp, size_type code, const key_type& key, std::atomic<node*>*& link) {
+	link = &tp->buckets[code % tp->size];
+	for (node* np = link->load(std::memory_order_relaxed); np;
+		np = np->next[tp->link].load(std::memory_order_relaxed)) {
+		if (equal_(np->value.first, key))
+			return np;
+		link = &np->next[tp->link];
+	}
+	return nullptr;
+}
+
+} // namespace mystl
+#endif // !MYSTL_CONCURRENT_UNORDERED_MAP_H_
@@ -44,18 +44,6 @@ void construct(Ty* ptr, Args&&... args)
 // destroy 将对象析构
 
 
-template <typename ForwardIter>
-void __destroy(ForwardIter , ForwardIter , std::true_type) {}
-
-template <typename ForwardIter>
-void __destroy(ForwardIter first, ForwardIter last, std::false_type)
-{
-  	for (; first != last; ++first) {
-    	destroy(&*first);
-    }
-}
-
-
 // destroy 发生在operator delete 之前，调用析构函数
 // destroy 的第一个版本，接受一个指针
 template <typename Ty>
@@ -72,6 +60,18 @@ void destroy(Ty* pointer)
 	
 }
 
+template <typename ForwardIter>
+void __destroy(ForwardIter , ForwardIter , std::true_type) {}
+
+template <typename ForwardIter>
+void __destroy(ForwardIter first, ForwardIter last, std::false_type)
+{
+  	for (; first != last; ++first) {
+    	destroy(&*first);
+    }
+}
+
+
 // 第二个版本，接受两个迭代其
 template <typename ForwardIter>
 void destroy(ForwardIter first, ForwardIter last)
@@ -81,8 +81,8 @@ void destroy(ForwardIter first, ForwardIter last)
 }
 
 // 第二个版本对char*和wchar_t*的特化
-void destroy(char*, char*);
-void destroy(wchar_t*, wchar_t*);
+inline void destroy(char*, char*) {}
+inline void destroy(wchar_t*, wchar_t*) {}
 
 
 } // namespace mystl
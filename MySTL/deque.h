@@ -37,18 +37,34 @@ namespace mystl{
 #endif
 // #e DEQUE_MAP_INIT_SIZE
 
-// 缓冲区大小
-template <typename T>
+// 每个缓冲区的目标字节数，默认为一个内存页
+#ifndef DEQUE_BUF_BYTES
+#define DEQUE_BUF_BYTES 4096
+#endif
+
+// 每个缓冲区至少容纳的元素个数
+#ifndef DEQUE_BUF_MIN_ELEMS
+#define DEQUE_BUF_MIN_ELEMS 16
+#endif
+
+// 缓冲区大小(元素个数)
+// BufSize 不为 0 时由使用者指定，例如 deque<T, 64>；为 0 时按元素大小决定：
+//   * 小元素: 一个缓冲区占 DEQUE_BUF_BYTES 字节
+//   * 大元素: 至少放 DEQUE_BUF_MIN_ELEMS 个，缓冲区向上取整到 DEQUE_BUF_BYTES 的整数倍，
+//     多出的空间也放上元素，不让最后一页只用了一部分
+template <typename T, size_t BufSize = 0>
 struct deque_buf_size{
-    // T小于256就设为4096/sizeof(T),大于就设为16  这里的4096是块大小?
-    static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T): 16;
+    static constexpr size_t min_bytes = sizeof(T) * DEQUE_BUF_MIN_ELEMS;
+    static constexpr size_t value = BufSize != 0 ? BufSize
+        : min_bytes <= DEQUE_BUF_BYTES ? DEQUE_BUF_BYTES / sizeof(T)
+        : (min_bytes + DEQUE_BUF_BYTES - 1) / DEQUE_BUF_BYTES * DEQUE_BUF_BYTES / sizeof(T);
 };
 
 // deque迭代器设计
-template <typename T, typename Ref, typename Ptr>
+template <typename T, typename Ref, typename Ptr, size_t BufSize = 0>
 struct deque_iterator : public iterator<random_access_iterator_tag, T>{
-    typedef deque_iterator<T, T&, T*>               iterator;
-    typedef deque_iterator<T, const T&, const T*>   const_iterator;
+    typedef deque_iterator<T, T&, T*, BufSize>             iterator;
+    typedef deque_iterator<T, const T&, const T*, BufSize> const_iterator;
     typedef deque_iterator                          self;
 
     typedef T           value_type;
@@ -60,7 +76,7 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>{
     typedef T**         map_pointer;
 
     // buffer_size 缓冲区数量
-    static const size_type buffer_size = deque_buf_size<T>::value;
+    static const size_type buffer_size = deque_buf_size<T, BufSize>::value;
 
     // 迭代器所含成员数据(16byte)
     // 指向所在缓冲区的当前元素 T*
@@ -205,14 +221,112 @@ struct deque_iterator : public iterator<random_access_iterator_tag, T>{
     }
 };
 
+// 针对 deque 迭代器的分段算法
+// deque 的元素分布在若干个缓冲区中，逐个元素移动迭代器时每一步都要检查是否到达缓冲区边界。
+// 下面的重载把区间按缓冲区切成若干段，每一段内直接使用原生指针，
+// copy / fill 因此会落到指针版本上(平凡类型为 memmove / memset)
+
+// copy: 源区间为原生指针，目的区间为 deque
+template <typename U, typename T, size_t BufSize>
+deque_iterator<T, T&, T*, BufSize>
+copy(U* first, U* last, deque_iterator<T, T&, T*, BufSize> result) {
+    auto n = last - first;
+    while (n > 0) {
+        const auto room = result.last - result.cur;   // 目的缓冲区剩余的空间
+        const auto len = n < room ? n : room;
+        mystl::copy(first, first + len, result.cur);
+        first += len;
+        n -= len;
+        result += len;
+    }
+    return result;
+}
+
+// copy: 源区间为 deque
+template <typename T, typename Ref, typename Ptr, size_t BufSize, typename OutputIter>
+OutputIter copy(deque_iterator<T, Ref, Ptr, BufSize> first,
+                deque_iterator<T, Ref, Ptr, BufSize> last, OutputIter result) {
+    if (first.node == last.node)
+        return mystl::copy(first.cur, last.cur, result);
+    result = mystl::copy(first.cur, first.last, result);
+    for (auto node = first.node + 1; node != last.node; ++node)
+        result = mystl::copy(*node, *node + first.buffer_size, result);
+    return mystl::copy(last.first, last.cur, result);
+}
+
+// fill
+template <typename T, size_t BufSize, typename U>
+void fill(deque_iterator<T, T&, T*, BufSize> first,
+          deque_iterator<T, T&, T*, BufSize> last, const U& value) {
+    if (first.node == last.node) {
+        mystl::fill(first.cur, last.cur, value);
+        return;
+    }
+    mystl::fill(first.cur, first.last, value);
+    for (auto node = first.node + 1; node != last.node; ++node)
+        mystl::fill(*node, *node + first.buffer_size, value);
+    mystl::fill(last.first, last.cur, value);
+}
+
+// find
+template <typename T, typename Ref, typename Ptr, size_t BufSize, typename U>
+deque_iterator<T, Ref, Ptr, BufSize>
+find(deque_iterator<T, Ref, Ptr, BufSize> first,
+     deque_iterator<T, Ref, Ptr, BufSize> last, const U& value) {
+    typedef deque_iterator<T, Ref, Ptr, BufSize> iter;
+    if (first.node == last.node) {
+        for (auto p = first.cur; p != last.cur; ++p) {
+            if (*p == value)
+                return iter(p, first.node);
+        }
+        return last;
+    }
+    for (auto p = first.cur; p != first.last; ++p) {
+        if (*p == value)
+            return iter(p, first.node);
+    }
+    for (auto node = first.node + 1; node != last.node; ++node) {
+        for (auto p = *node, e = *node + first.buffer_size; p != e; ++p) {
+            if (*p == value)
+                return iter(p, node);
+        }
+    }
+    for (auto p = last.first; p != last.cur; ++p) {
+        if (*p == value)
+            return iter(p, last.node);
+    }
+    return last;
+}
+
+// for_each
+template <typename T, typename Ref, typename Ptr, size_t BufSize, typename Function>
+Function for_each(deque_iterator<T, Ref, Ptr, BufSize> first,
+                  deque_iterator<T, Ref, Ptr, BufSize> last, Function f) {
+    if (first.node == last.node) {
+        for (auto p = first.cur; p != last.cur; ++p)
+            f(*p);
+        return f;
+    }
+    for (auto p = first.cur; p != first.last; ++p)
+        f(*p);
+    for (auto node = first.node + 1; node != last.node; ++node) {
+        for (auto p = *node, e = *node + first.buffer_size; p != e; ++p)
+            f(*p);
+    }
+    for (auto p = last.first; p != last.cur; ++p)
+        f(*p);
+    return f;
+}
+
 // 模板类deque
-// 模板参数代表数据类型
-template <typename T>
+// 模板参数 T 代表数据类型，BufSize 代表每个缓冲区的元素个数，为 0 时见 deque_buf_size
+// Alloc 代表缓冲区的空间配置器(静态接口，同 mystl::allocator)，map 仍由 mystl::allocator 管理
+template <typename T, size_t BufSize = 0, typename Alloc = mystl::allocator<T>>
 class deque{
 public:
     // deque的型别定义
-    typedef mystl::allocator<T>                 allocator_type;
-    typedef mystl::allocator<T>                 data_allocator;
+    typedef Alloc                               allocator_type;
+    typedef Alloc                               data_allocator;
     typedef mystl::allocator<T*>                map_allocator;
 
     typedef typename allocator_type::value_type      value_type;
@@ -225,8 +339,8 @@ public:
     typedef pointer*                                 map_pointer;
     typedef const_pointer*                           const_map_pointer;
 
-    typedef deque_iterator<T, T&, T*>                       iterator;
-    typedef deque_iterator<T, const T&, const T*>           const_iterator;
+    typedef deque_iterator<T, T&, T*, BufSize>              iterator;
+    typedef deque_iterator<T, const T&, const T*, BufSize>  const_iterator;
     typedef mystl::reverse_iterator<iterator>               reverse_iterator;
     typedef mystl::reverse_iterator<const_iterator>         const_reverse_iterator;
 
@@ -234,7 +348,7 @@ public:
         return allocator_type();
     }
 
-    static const size_type buffer_size = deque_buf_size<T>::value;
+    static const size_type buffer_size = deque_buf_size<T, BufSize>::value;
 
 private:
     // iterator的成员: first+last+cur+node
@@ -517,8 +631,8 @@ private:
 };
 
 // 复制赋值运算符
-template <class T>
-deque<T>& deque<T>::operator=(const deque& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+deque<T, BufSize, Alloc>& deque<T, BufSize, Alloc>::operator=(const deque& rhs) {
     if (this != &rhs) { // 非自赋值情况
         const auto len = size();    // deque长度
         if (len >= rhs.size()) {    // 小于本身长度时会裁去超出的部分
@@ -534,8 +648,8 @@ deque<T>& deque<T>::operator=(const deque& rhs) {
 }
 
 // 移动赋值运算符
-template <typename T>
-deque<T>& deque<T>::operator=(deque&& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+deque<T, BufSize, Alloc>& deque<T, BufSize, Alloc>::operator=(deque&& rhs) {
     clear();    // 清除原对象, 其它属性照搬
     begin_ = mystl::move(rhs.begin_);
     end_ = mystl::move(rhs.end_);
@@ -547,8 +661,8 @@ deque<T>& deque<T>::operator=(deque&& rhs) {
 }
 
 // 重置容器大小
-template <typename T>
-void deque<T>::resize(size_type new_size, const value_type& value) {    // 和operator=(const deque&)操作几乎一样,少了赋值部分
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::resize(size_type new_size, const value_type& value) {    // 和operator=(const deque&)操作几乎一样,少了赋值部分
     const auto len = size();
     if(new_size < len) {
         erase(begin_ + new_size, end_);
@@ -558,8 +672,8 @@ void deque<T>::resize(size_type new_size, const value_type& value) {    // 和op
 }
 
 // 减小容器容量
-template <typename T>
-void deque<T>::shrink_to_fit() noexcept {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::shrink_to_fit() noexcept {
     // 至少会留下头部缓冲区
     // 消除begin_之前的
     for(auto cur = map_; cur < begin_.node; ++ cur) {
@@ -574,9 +688,9 @@ void deque<T>::shrink_to_fit() noexcept {
 }
 
 // 在头部就地构建元素
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename ...Args>
-void deque<T>::emplace_front(Args&& ...args) {
+void deque<T, BufSize, Alloc>::emplace_front(Args&& ...args) {
     if(begin_.cur != begin_.first) {
         data_allocator::construct(begin_.cur - 1, mystl::forward<Args>(args)...);
         --begin_.cur;
@@ -595,9 +709,9 @@ void deque<T>::emplace_front(Args&& ...args) {
 }
 
 // 在尾部就地构造元素
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename ...Args>
-void deque<T>::emplace_back(Args&& ...args) {
+void deque<T, BufSize, Alloc>::emplace_back(Args&& ...args) {
     if(end_.cur != end_.last - 1) {
         data_allocator::construct(end_.cur, mystl::forward<Args>(args)...);
         ++ end_.cur;
@@ -609,9 +723,9 @@ void deque<T>::emplace_back(Args&& ...args) {
 }
 
 // 在pos位置就地构建元素
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename ...Args>
-typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args) {
+typename deque<T, BufSize, Alloc>::iterator deque<T, BufSize, Alloc>::emplace(iterator pos, Args&& ...args) {
     if(pos.cur == begin_.cur) {
         emplace_front(mystl::forward<Args>(args)...);
         return begin_;
@@ -623,8 +737,8 @@ typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&& ...args) {
 }
 
 // 在头部插入元素
-template <typename T>
-void deque<T>::push_front(const value_type& value) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::push_front(const value_type& value) {
     if(begin_.cur != begin_.first) {
         data_allocator::construct(begin_.cur - 1, value);
         -- begin_.cur;
@@ -642,8 +756,8 @@ void deque<T>::push_front(const value_type& value) {
 
 
 // 在尾部插入元素
-template <typename T>
-void deque<T>::push_back(const value_type& value) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::push_back(const value_type& value) {
     if(end_.cur != end_.last - 1) {
         data_allocator::construct(end_.cur, value);
         ++ end_.cur;
@@ -655,8 +769,8 @@ void deque<T>::push_back(const value_type& value) {
 }
 
 // 弹出头部元素
-template <typename T>
-void deque<T>::pop_front() {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::pop_front() {
     MYSTL_DEBUG(!empty());
     if(begin_.cur != begin_.last - 1) {
         data_allocator::destroy(begin_.cur);
@@ -669,8 +783,8 @@ void deque<T>::pop_front() {
 }
 
 // 弹出尾部元素
-template <typename T>
-void deque<T>::pop_back() {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::pop_back() {
     MYSTL_DEBUG(!empty());
     if(end_.cur != end_.first) {
         -- end_.cur;    // 结点前移
@@ -683,9 +797,9 @@ void deque<T>::pop_back() {
 }
 
 // 在position处插入元素
-template <typename T>
-typename deque<T>::iterator
-deque<T>::insert(iterator position, const value_type& value) {
+template <typename T, size_t BufSize, typename Alloc>
+typename deque<T, BufSize, Alloc>::iterator
+deque<T, BufSize, Alloc>::insert(iterator position, const value_type& value) {
     if(position.cur == begin_.cur) {
         push_front(value);
         return begin_;
@@ -699,9 +813,9 @@ deque<T>::insert(iterator position, const value_type& value) {
     }
 }
 
-template <typename T>
-typename deque<T>::iterator
-deque<T>::insert(iterator position, value_type&& value) {
+template <typename T, size_t BufSize, typename Alloc>
+typename deque<T, BufSize, Alloc>::iterator
+deque<T, BufSize, Alloc>::insert(iterator position, value_type&& value) {
     if(position.cur == begin_.cur) {
         emplace_front(mystl::move(value));
         return begin_;
@@ -716,8 +830,8 @@ deque<T>::insert(iterator position, value_type&& value) {
 }
 
 // 在position位置插入n个元素
-template <typename T>
-void deque<T>::insert(iterator position, size_type n, const value_type& value){
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::insert(iterator position, size_type n, const value_type& value){
     if(position.cur == begin_.cur) {
         require_capacity(n, true);
         auto new_begin = begin_ - n;
@@ -734,9 +848,9 @@ void deque<T>::insert(iterator position, size_type n, const value_type& value){
 }
 
 // 删除position处的元素
-template <typename T>
-typename deque<T>::iterator
-deque<T>::erase(iterator position) {
+template <typename T, size_t BufSize, typename Alloc>
+typename deque<T, BufSize, Alloc>::iterator
+deque<T, BufSize, Alloc>::erase(iterator position) {
     auto next = position;
     ++ next;
     const size_type elems_before = position - begin_;
@@ -751,9 +865,9 @@ deque<T>::erase(iterator position) {
 }
 
 // 删除[first, last]上的元素
-template <typename T>
-typename deque<T>::iterator
-deque<T>::erase(iterator first, iterator last) {
+template <typename T, size_t BufSize, typename Alloc>
+typename deque<T, BufSize, Alloc>::iterator
+deque<T, BufSize, Alloc>::erase(iterator first, iterator last) {
     if(first == begin_ && last == end_) {
         clear();
         return end_;
@@ -776,8 +890,8 @@ deque<T>::erase(iterator first, iterator last) {
 }
 
 // 清空deque
-template <typename T>
-void deque<T>::clear() {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::clear() {
     // clear 会保留头部缓冲区
     for(map_pointer cur = begin_.node + 1; cur < end_.node; ++ cur) {   // 注意这里的begin_.node和end_node并未清空
         data_allocator::destroy(*cur, *cur + buffer_size);  // 清空每一个缓冲区中的结点
@@ -793,8 +907,8 @@ void deque<T>::clear() {
 }
 
 // 交换两个deque
-template <typename T>
-void deque<T>::swap(deque& rhs) noexcept {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::swap(deque& rhs) noexcept {
     if(this != &rhs) {
         mystl::swap(begin_, rhs.begin_);
         mystl::swap(end_, rhs.end_);
@@ -805,9 +919,9 @@ void deque<T>::swap(deque& rhs) noexcept {
 
 // helper function
 
-template <typename T>
-typename deque<T>::map_pointer
-deque<T>::create_map(size_type size) {
+template <typename T, size_t BufSize, typename Alloc>
+typename deque<T, BufSize, Alloc>::map_pointer
+deque<T, BufSize, Alloc>::create_map(size_type size) {
     map_pointer mp = nullptr;
     mp = map_allocator::allocate(size);
     for(size_type i = 0; i < size; ++ i) {
@@ -816,8 +930,8 @@ deque<T>::create_map(size_type size) {
     return mp;
 }
 
-template <typename T>
-void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::create_buffer(map_pointer nstart, map_pointer nfinish) {
     map_pointer cur;
     try{
         for(cur = nstart; cur <= nfinish; ++ cur) {
@@ -833,8 +947,8 @@ void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish) {
     }
 }
 
-template <typename T>
-void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
     for(map_pointer n = nstart; n <= nfinish; ++ n) {
         data_allocator::deallocate(*n, buffer_size);
         *n = nullptr;
@@ -842,8 +956,8 @@ void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish) {
 }
 
 // map_初始化,nElem为初始元素个数
-template <typename T>
-void deque<T>::map_init(size_type nElem) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::map_init(size_type nElem) {
     const size_type nNode = nElem / buffer_size + 1;    // 需要分配的缓冲区个数
     map_size_ = mystl::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nNode + 2);
     try{
@@ -872,8 +986,8 @@ void deque<T>::map_init(size_type nElem) {
 }
 
 // 填充n个value
-template <typename T>
-void deque<T>::fill_init(size_type n, const value_type& value) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::fill_init(size_type n, const value_type& value) {
     map_init(n);
     if(n != 0) {
         for(auto cur = begin_.node; cur <  end_.node; ++ cur) {
@@ -883,9 +997,9 @@ void deque<T>::fill_init(size_type n, const value_type& value) {
     }
 }
 
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename Iter>
-void deque<T>::copy_init(Iter first, Iter last, input_iterator_tag) {
+void deque<T, BufSize, Alloc>::copy_init(Iter first, Iter last, input_iterator_tag) {
     const size_type n = mystl::distance(first, last);
     map_init(n);
     for(; first != last; ++ first) {
@@ -893,9 +1007,9 @@ void deque<T>::copy_init(Iter first, Iter last, input_iterator_tag) {
     }
 }
 
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename Iter>
-void deque<T>::copy_init(Iter first, Iter last, forward_iterator_tag) {
+void deque<T, BufSize, Alloc>::copy_init(Iter first, Iter last, forward_iterator_tag) {
     const size_type n = mystl::distance(first, last);
     map_init(n);
     for(auto cur = begin_.node; cur < end_.node; ++ cur) {
@@ -907,8 +1021,8 @@ void deque<T>::copy_init(Iter first, Iter last, forward_iterator_tag) {
     mystl::uninitialized_copy(first, last, end_.first);
 }
 
-template <typename T>
-void deque<T>::fill_assign(size_type n, const value_type& value) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::fill_assign(size_type n, const value_type& value) {
     if(n > size()) {
         mystl::fill(begin(), end(), value);
         insert(end(), n - size(), value);
@@ -919,9 +1033,9 @@ void deque<T>::fill_assign(size_type n, const value_type& value) {
 }
 
 
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename Iter>
-void deque<T>::copy_assign(Iter first, Iter last, input_iterator_tag) {
+void deque<T, BufSize, Alloc>::copy_assign(Iter first, Iter last, input_iterator_tag) {
     auto first1 = begin();
     auto last1 = end();
     for(; first != last && first1 != last1; ++ first, ++ first1) {
@@ -934,9 +1048,9 @@ void deque<T>::copy_assign(Iter first, Iter last, input_iterator_tag) {
     }
 }
 
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename Iter>
-void deque<T>::copy_assign(Iter first, Iter last, forward_iterator_tag) {  
+void deque<T, BufSize, Alloc>::copy_assign(Iter first, Iter last, forward_iterator_tag) {  
     const size_type len1 = size();
     const size_type len2 = mystl::distance(first, last);
     if (len1 < len2){
@@ -950,10 +1064,10 @@ void deque<T>::copy_assign(Iter first, Iter last, forward_iterator_tag) {
 }
 
 // insert_aux 函数
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename ...Args>
-typename deque<T>::iterator
-deque<T>::insert_aux(iterator position, Args&& ...args){
+typename deque<T, BufSize, Alloc>::iterator
+deque<T, BufSize, Alloc>::insert_aux(iterator position, Args&& ...args){
     const size_type elems_before = position - begin_;
     value_type value_copy = value_type(mystl::forward<Args>(args)...);
     if (elems_before < (size() / 2)) { // 在前半段插入
@@ -980,8 +1094,8 @@ deque<T>::insert_aux(iterator position, Args&& ...args){
 }
 
 // fill_insert 函数
-template <typename T>
-void deque<T>::fill_insert(iterator position, size_type n, const value_type& value) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::fill_insert(iterator position, size_type n, const value_type& value) {
     const size_type elems_before = position - begin_;
     const size_type len = size();
     auto value_copy = value;
@@ -1040,9 +1154,9 @@ void deque<T>::fill_insert(iterator position, size_type n, const value_type& val
 }
 
 // copy_insert
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename FIter>
-void deque<T>::copy_insert(iterator position, FIter first, FIter last, size_type n) {
+void deque<T, BufSize, Alloc>::copy_insert(iterator position, FIter first, FIter last, size_type n) {
     const size_type elems_before = position - begin_;
     auto len = size();
     if (elems_before < (len / 2)) {
@@ -1104,9 +1218,9 @@ void deque<T>::copy_insert(iterator position, FIter first, FIter last, size_type
 }
 
 // insert_dispatch 函数
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename Iter>
-void deque<T>::
+void deque<T, BufSize, Alloc>::
 insert_dispatch(iterator position, Iter first, Iter last, input_iterator_tag) {
     if (last <= first)  return;
     const size_type n = mystl::distance(first, last);
@@ -1123,9 +1237,9 @@ insert_dispatch(iterator position, Iter first, Iter last, input_iterator_tag) {
     }
 }
 
-template <typename T>
+template <typename T, size_t BufSize, typename Alloc>
 template <typename FIter>
-void deque<T>::
+void deque<T, BufSize, Alloc>::
 insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag) {
     if (last <= first)  return;
     const size_type n = mystl::distance(first, last);
@@ -1158,8 +1272,8 @@ insert_dispatch(iterator position, FIter first, FIter last, forward_iterator_tag
 }
 
 // require_capacity 函数
-template <typename T>
-void deque<T>::require_capacity(size_type n, bool front) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::require_capacity(size_type n, bool front) {
     if (front && (static_cast<size_type>(begin_.cur - begin_.first) < n)) {
         const size_type need_buffer = (n - (begin_.cur - begin_.first)) / buffer_size + 1;
         if (need_buffer > static_cast<size_type>(begin_.node - map_)) {
@@ -1178,8 +1292,8 @@ void deque<T>::require_capacity(size_type n, bool front) {
 }
 
 // reallocate_map_at_front 函数 新建一个map并复制原map且在头部加need_buffer个buffer
-template <typename T>
-void deque<T>::reallocate_map_at_front(size_type need_buffer){
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::reallocate_map_at_front(size_type need_buffer){
     const size_type new_map_size = mystl::max(map_size_ << 1,
         map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
     map_pointer new_map = create_map(new_map_size);
@@ -1203,8 +1317,8 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer){
 }
 
 // reallocate_map_at_back 函数 新建一个map并复制原map且在末尾加need_buffer个buffer
-template <typename T>
-void deque<T>::reallocate_map_at_back(size_type need_buffer) {
+template <typename T, size_t BufSize, typename Alloc>
+void deque<T, BufSize, Alloc>::reallocate_map_at_back(size_type need_buffer) {
     const size_type new_map_size = mystl::max(map_size_ << 1,
         map_size_ + need_buffer + DEQUE_MAP_INIT_SIZE);
     map_pointer new_map = create_map(new_map_size);
@@ -1228,44 +1342,48 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer) {
 }
 
 // 重载比较操作符
-template <typename T>
-bool operator==(const deque<T>& lhs, const deque<T>& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+bool operator==(const deque<T, BufSize, Alloc>& lhs, const deque<T, BufSize, Alloc>& rhs) {
     return lhs.size() == rhs.size() && 
         mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <typename T>
-bool operator<(const deque<T>& lhs, const deque<T>& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+bool operator<(const deque<T, BufSize, Alloc>& lhs, const deque<T, BufSize, Alloc>& rhs) {
     return mystl::lexicographical_compare(
         lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <typename T>
-bool operator!=(const deque<T>& lhs, const deque<T>& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+bool operator!=(const deque<T, BufSize, Alloc>& lhs, const deque<T, BufSize, Alloc>& rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T>
-bool operator>(const deque<T>& lhs, const deque<T>& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+bool operator>(const deque<T, BufSize, Alloc>& lhs, const deque<T, BufSize, Alloc>& rhs) {
     return rhs < lhs;
 }
 
-template <typename T>
-bool operator<=(const deque<T>& lhs, const deque<T>& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+bool operator<=(const deque<T, BufSize, Alloc>& lhs, const deque<T, BufSize, Alloc>& rhs) {
     return !(rhs < lhs);
 }
 
-template <typename T>
-bool operator>=(const deque<T>& lhs, const deque<T>& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+bool operator>=(const deque<T, BufSize, Alloc>& lhs, const deque<T, BufSize, Alloc>& rhs) {
     return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <typename T>
-void swap(deque<T>& lhs, deque<T>& rhs) {
+template <typename T, size_t BufSize, typename Alloc>
+void swap(deque<T, BufSize, Alloc>& lhs, deque<T, BufSize, Alloc>& rhs) {
     lhs.swap(rhs);
 }
 
+// deque 的迭代器只指向 map 和缓冲区，对象本身可以按字节搬移
+template <typename T, size_t BufSize, typename Alloc>
+struct is_trivially_relocatable<deque<T, BufSize, Alloc>> : std::true_type {};
+
 
 }   // namespace mystl
 
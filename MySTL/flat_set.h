@@ -0,0 +1,439 @@
+﻿#ifndef MYSTL_FLAT_SET_H_
+#define MYSTL_FLAT_SET_H_
+
+// 这个头文件包含两个模板类 flat_set 和 flat_multiset
+// flat_set      : 以有序 vector 实现的 set，键值不允许重复
+// flat_multiset : 以有序 vector 实现的 multiset，键值允许重复
+
+// notes:
+//
+// 异常保证：
+// mystl::flat_set<Key> / mystl::flat_multiset<Key> 满足基本异常保证，
+// 当元素的移动构造、移动赋值不抛出异常时，对单个元素的 emplace / emplace_hint / insert 做强异常安全保证
+//
+// 接口与 set.h 相同，元素连续存放在 mystl::vector 中，插入、删除可能使所有迭代器失效，详见 flat_tree.h
+
+#include "flat_tree.h"
+
+namespace mystl
+{
+
+// 模板类 flat_set，键值不允许重复
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less 
+template <typename Key, typename Compare = mystl::less<Key>>
+class flat_set
+{
+public:
+    typedef Key        key_type;
+    typedef Key        value_type;
+    typedef Compare    key_compare;
+    typedef Compare    value_compare;
+
+private:
+    // 以 mystl::flat_tree 作为底层机制
+    typedef mystl::flat_tree<value_type, key_compare>  base_type;
+    base_type tree_;
+
+public:
+    // 使用 flat_tree 定义的型别
+    typedef typename base_type::const_pointer          pointer;
+    typedef typename base_type::const_pointer          const_pointer;
+    typedef typename base_type::const_reference        reference;
+    typedef typename base_type::const_reference        const_reference;
+    typedef typename base_type::const_iterator         iterator;
+    typedef typename base_type::const_iterator         const_iterator;
+    typedef typename base_type::const_reverse_iterator reverse_iterator;
+    typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+    typedef typename base_type::size_type              size_type;
+    typedef typename base_type::difference_type        difference_type;
+    typedef typename base_type::allocator_type         allocator_type;
+
+public:
+	// 构造、复制、移动函数
+	flat_set() = default;
+
+	template <class InputIterator>
+	flat_set(InputIterator first, InputIterator last) 
+		:tree_() 
+	{ tree_.insert_unique(first, last); }
+	flat_set(std::initializer_list<value_type> ilist)
+		:tree_()
+	{ tree_.insert_unique(ilist.begin(), ilist.end()); }
+
+	flat_set(const flat_set& rhs) 
+		:tree_(rhs.tree_){}
+	flat_set(flat_set&& rhs) noexcept
+		:tree_(mystl::move(rhs.tree_)){}
+
+	flat_set& operator=(const flat_set& rhs) {
+		tree_ = rhs.tree_;
+		return *this;
+	}
+	flat_set& operator=(flat_set&& rhs){ 
+		tree_ = mystl::move(rhs.tree_); 
+		return *this; 
+	}
+	flat_set& operator=(std::initializer_list<value_type> ilist){
+		tree_.clear();
+		tree_.insert_unique(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	// 相关接口
+
+	key_compare      key_comp()      const { return tree_.key_comp(); }
+	value_compare    value_comp()    const { return tree_.key_comp(); }
+	allocator_type   get_allocator() const { return tree_.get_allocator(); }
+
+	// 迭代器相关
+
+	iterator               begin()         noexcept
+	{ return tree_.begin(); }
+	const_iterator         begin()   const noexcept
+	{ return tree_.begin(); }
+	iterator               end()           noexcept
+	{ return tree_.end(); }
+	const_iterator         end()     const noexcept
+	{ return tree_.end(); }
+
+	reverse_iterator       rbegin()        noexcept
+	{ return reverse_iterator(end()); }
+	const_reverse_iterator rbegin()  const noexcept
+	{ return const_reverse_iterator(end()); }
+	reverse_iterator       rend()          noexcept
+	{ return reverse_iterator(begin()); }
+	const_reverse_iterator rend()    const noexcept
+	{ return const_reverse_iterator(begin()); }
+
+	const_iterator         cbegin()  const noexcept
+	{ return begin(); }
+	const_iterator         cend()    const noexcept
+	{ return end(); }
+	const_reverse_iterator crbegin() const noexcept
+	{ return rbegin(); }
+	const_reverse_iterator crend()   const noexcept
+	{ return rend(); }
+
+	// 容量相关
+	bool                   empty()    const noexcept { return tree_.empty(); }
+	size_type              size()     const noexcept { return tree_.size(); }
+	size_type              max_size() const noexcept { return tree_.max_size(); }
+	size_type              capacity() const noexcept { return tree_.capacity(); }
+	void                   reserve(size_type n)      { tree_.reserve(n); }
+	void                   shrink_to_fit()           { tree_.shrink_to_fit(); }
+
+	// 插入删除操作
+
+	template <typename ...Args>
+	pair<iterator, bool> emplace(Args&& ...args) {
+		return tree_.emplace_unique(mystl::forward<Args>(args)...);
+	}
+
+	template <typename ...Args>
+	iterator emplace_hint(iterator hint, Args&& ...args) {
+		return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...);
+	}
+
+	pair<iterator, bool> insert(const value_type& value) {
+		return tree_.insert_unique(value);
+	}
+	pair<iterator, bool> insert(value_type&& value) {
+		return tree_.insert_unique(mystl::move(value));
+	}
+
+	iterator insert(iterator hint, const value_type& value) {
+		return tree_.insert_unique(hint, value);
+	}
+	iterator insert(iterator hint, value_type&& value) {
+		return tree_.insert_unique(hint, mystl::move(value));
+	}
+
+	template <typename InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		tree_.insert_unique(first, last);
+	}
+
+	void      erase(iterator position)             { tree_.erase(position); }
+	size_type erase(const key_type& key)           { return tree_.erase_unique(key); }
+	void      erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+	void      clear() { tree_.clear(); }
+
+	// flat_set 相关操作
+
+	iterator       find(const key_type& key)              { return tree_.find(key); }
+	const_iterator find(const key_type& key)        const { return tree_.find(key); }
+
+	size_type      count(const key_type& key)       const { return tree_.count_unique(key); }
+
+	iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+	const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+	iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+	const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+	pair<iterator, iterator>
+		equal_range(const key_type& key)
+	{ return tree_.equal_range_unique(key); }
+
+	pair<const_iterator, const_iterator>
+		equal_range(const key_type& key) const
+	{ return tree_.equal_range_unique(key); }
+
+	void swap(flat_set& rhs) noexcept
+	{ tree_.swap(rhs.tree_); }
+
+public:
+	friend bool operator==(const flat_set& lhs, const flat_set& rhs) { return lhs.tree_ == rhs.tree_; }
+	friend bool operator< (const flat_set& lhs, const flat_set& rhs) { return lhs.tree_ <  rhs.tree_; }
+};
+
+// 重载比较操作符
+template <typename Key, typename Compare>
+bool operator==(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs){
+	return lhs == rhs;
+}
+
+template <typename Key, typename Compare>
+bool operator<(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs) {
+	return lhs < rhs;
+}
+
+template <typename Key, typename Compare>
+bool operator!=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename Key, typename Compare>
+bool operator>(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs) {
+	return rhs < lhs;
+}
+
+template <typename Key, typename Compare>
+bool operator<=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs) {
+	return !(rhs < lhs);
+}
+
+template <typename Key, typename Compare>
+bool operator>=(const flat_set<Key, Compare>& lhs, const flat_set<Key, Compare>& rhs) {
+	return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <typename Key, typename Compare>
+void swap(flat_set<Key, Compare>& lhs, flat_set<Key, Compare>& rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+
+// 模板类 flat_multiset，键值允许重复
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less 
+template <typename Key, typename Compare = mystl::less<Key>>
+class flat_multiset
+{
+public:
+	typedef Key        key_type;
+	typedef Key        value_type;
+	typedef Compare    key_compare;
+	typedef Compare    value_compare;
+
+private:
+	// 以 mystl::flat_tree 作为底层机制
+	typedef mystl::flat_tree<value_type, key_compare>  base_type;
+	base_type tree_;  // 以 flat_tree 表现 flat_multiset
+
+public:
+	// 使用 flat_tree 定义的型别
+	typedef typename base_type::const_pointer          pointer;
+	typedef typename base_type::const_pointer          const_pointer;
+	typedef typename base_type::const_reference        reference;
+	typedef typename base_type::const_reference        const_reference;
+	typedef typename base_type::const_iterator         iterator;
+	typedef typename base_type::const_iterator         const_iterator;
+	typedef typename base_type::const_reverse_iterator reverse_iterator;
+	typedef typename base_type::const_reverse_iterator const_reverse_iterator;
+	typedef typename base_type::size_type              size_type;
+	typedef typename base_type::difference_type        difference_type;
+	typedef typename base_type::allocator_type         allocator_type;
+
+public:
+	// 构造、复制、移动函数
+	flat_multiset() = default;
+
+	template <typename InputIterator>
+	flat_multiset(InputIterator first, InputIterator last) 
+		:tree_() 
+	{ tree_.insert_multi(first, last); }
+	flat_multiset(std::initializer_list<value_type> ilist)
+		:tree_() 
+	{ tree_.insert_multi(ilist.begin(), ilist.end()); }
+
+	flat_multiset(const flat_multiset& rhs)
+		:tree_(rhs.tree_){}
+	flat_multiset(flat_multiset&& rhs) noexcept
+		:tree_(mystl::move(rhs.tree_)){}
+
+	flat_multiset& operator=(const flat_multiset& rhs) { 
+		tree_ = rhs.tree_;
+		return *this; 
+	}
+	flat_multiset& operator=(flat_multiset&& rhs) {
+		tree_ = mystl::move(rhs.tree_);
+		return *this; 
+	}
+	flat_multiset& operator=(std::initializer_list<value_type> ilist) {
+		tree_.clear();
+		tree_.insert_multi(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	// 相关接口
+
+	key_compare      key_comp()      const { return tree_.key_comp(); }
+	value_compare    value_comp()    const { return tree_.key_comp(); }
+	allocator_type   get_allocator() const { return tree_.get_allocator(); }
+
+	// 迭代器相关
+
+	iterator               begin()         noexcept
+	{ return tree_.begin(); }
+	const_iterator         begin()   const noexcept
+	{ return tree_.begin(); }
+	iterator               end()           noexcept
+	{ return tree_.end(); }
+	const_iterator         end()     const noexcept
+	{ return tree_.end(); }
+
+	reverse_iterator       rbegin()        noexcept
+	{ return reverse_iterator(end()); }
+	const_reverse_iterator rbegin()  const noexcept
+	{ return const_reverse_iterator(end()); }
+	reverse_iterator       rend()          noexcept
+	{ return reverse_iterator(begin()); }
+	const_reverse_iterator rend()    const noexcept
+	{ return const_reverse_iterator(begin()); }
+
+	const_iterator         cbegin()  const noexcept
+	{ return begin(); }
+	const_iterator         cend()    const noexcept
+	{ return end(); }
+	const_reverse_iterator crbegin() const noexcept
+	{ return rbegin(); }
+	const_reverse_iterator crend()   const noexcept
+	{ return rend(); }
+
+	// 容量相关
+	bool                   empty()    const noexcept { return tree_.empty(); }
+	size_type              size()     const noexcept { return tree_.size(); }
+	size_type              max_size() const noexcept { return tree_.max_size(); }
+	size_type              capacity() const noexcept { return tree_.capacity(); }
+	void                   reserve(size_type n)      { tree_.reserve(n); }
+	void                   shrink_to_fit()           { tree_.shrink_to_fit(); }
+
+	// 插入删除操作
+
+	template <typename ...Args>
+	iterator emplace(Args&& ...args) {
+		return tree_.emplace_multi(mystl::forward<Args>(args)...);
+	}
+
+	template <typename ...Args>
+	iterator emplace_hint(iterator hint, Args&& ...args) {
+		return tree_.emplace_multi_use_hint(hint, mystl::forward<Args>(args)...);
+	}
+
+	iterator insert(const value_type& value) {
+		return tree_.insert_multi(value);
+	}
+	iterator insert(value_type&& value) {
+		return tree_.insert_multi(mystl::move(value));
+	}
+
+	iterator insert(iterator hint, const value_type& value) {
+		return tree_.insert_multi(hint, value);
+	}
+	iterator insert(iterator hint, value_type&& value) {
+		return tree_.insert_multi(hint, mystl::move(value));
+	}
+
+	template <class InputIterator>
+	void insert(InputIterator first, InputIterator last) {
+		tree_.insert_multi(first, last);
+	}
+
+	void           erase(iterator position)             { tree_.erase(position); }
+	size_type      erase(const key_type& key)           { return tree_.erase_multi(key); }
+	void           erase(iterator first, iterator last) { tree_.erase(first, last); }
+
+	void           clear() { tree_.clear(); }
+
+	// flat_multiset 相关操作
+
+	iterator       find(const key_type& key)              { return tree_.find(key); }
+	const_iterator find(const key_type& key)        const { return tree_.find(key); }
+
+	size_type      count(const key_type& key)       const { return tree_.count_multi(key); }
+
+	iterator       lower_bound(const key_type& key)       { return tree_.lower_bound(key); }
+	const_iterator lower_bound(const key_type& key) const { return tree_.lower_bound(key); }
+
+	iterator       upper_bound(const key_type& key)       { return tree_.upper_bound(key); }
+	const_iterator upper_bound(const key_type& key) const { return tree_.upper_bound(key); }
+
+	pair<iterator, iterator>
+		equal_range(const key_type& key)
+	{ return tree_.equal_range_multi(key); }
+
+	pair<const_iterator, const_iterator>
+		equal_range(const key_type& key) const
+	{ return tree_.equal_range_multi(key); }
+
+	void swap(flat_multiset& rhs) noexcept
+	{ tree_.swap(rhs.tree_); }
+
+public:
+	friend bool operator==(const flat_multiset& lhs, const flat_multiset& rhs) { return lhs.tree_ == rhs.tree_; }
+	friend bool operator< (const flat_multiset& lhs, const flat_multiset& rhs) { return lhs.tree_ <  rhs.tree_; }
+};
+
+// 重载比较操作符
+template <typename Key, typename Compare>
+bool operator==(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs) {
+	return lhs == rhs;
+}
+
+template <typename Key, typename Compare>
+bool operator<(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs) {
+	return lhs < rhs;
+}
+
+template <typename Key, typename Compare>
+bool operator!=(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename Key, typename Compare>
+bool operator>(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs) {
+	return rhs < lhs;
+}
+
+template <typename Key, typename Compare>
+bool operator<=(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs) {
+	return !(rhs < lhs);
+}
+
+template <typename Key, typename Compare>
+bool operator>=(const flat_multiset<Key, Compare>& lhs, const flat_multiset<Key, Compare>& rhs) {
+	return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <typename Key, typename Compare>
+void swap(flat_multiset<Key, Compare>& lhs, flat_multiset<Key, Compare>& rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYSTL_FLAT_SET_H_
+
@@ -0,0 +1,480 @@
+﻿#ifndef MYSTL_FLAT_TREE_H_
+#define MYSTL_FLAT_TREE_H_
+
+// 这个头文件包含一个模板类 flat_tree
+// flat_tree : 以有序 vector 保存元素的关联容器底层，flat_map / flat_set 以它为底层机制
+
+// notes:
+//
+// 1. 元素按键值升序连续存放在 mystl::vector 中，没有节点头部的额外开销，查找为二分查找，
+//    遍历与区间扫描都是顺序访存，适合一次构建、多次查询的场景。
+// 2. 单个元素的插入、删除需要移动其后的所有元素，复杂度为 O(n)；
+//    批量插入先追加到末尾，排序、去重后与原有元素归并，复杂度为 O(n + m log m)。
+// 3. 批量插入的区间内有多个相等的键值时，保留哪一个不作保证；与已有元素相等时保留已有元素。
+// 4. 任何插入、删除操作都可能使所有迭代器失效。
+// 5. 为了能够排序和移动，map 的元素类型为 mystl::pair<Key, T> 而不是 mystl::pair<const Key, T>，
+//    修改迭代器所指元素的键值会破坏容器的有序性。
+
+#include <initializer_list>
+
+#include "algo.h"
+#include "functional.h"
+#include "vector.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// flat tree value traits
+
+template <typename T, bool>
+struct flat_tree_value_traits_imp {	// 泛化
+	typedef T key_type;
+	typedef T mapped_type;
+	typedef T value_type;
+
+	template <typename Ty>
+	static const key_type& get_key(const Ty& value) {
+		return value;
+	}
+
+	template <typename Ty>
+	static const value_type& get_value(const Ty& value) {
+		return value;
+	}
+};
+
+template <typename T>
+struct flat_tree_value_traits_imp<T, true> {	// 偏特化
+	typedef typename std::remove_cv<typename T::first_type>::type key_type;
+	typedef typename T::second_type                               mapped_type;
+	typedef T                                                     value_type;
+
+	template <typename Ty>
+	static const key_type& get_key(const Ty& value) {
+		return value.first;
+	}
+
+	template <typename Ty>
+	static const value_type& get_value(const Ty& value) {
+		return value;
+	}
+};
+
+template <typename T>
+struct flat_tree_value_traits {
+	static constexpr bool is_map = mystl::is_pair<T>::value;
+
+	typedef flat_tree_value_traits_imp<T, is_map> value_traits_type;
+
+	typedef typename value_traits_type::key_type    key_type;
+	typedef typename value_traits_type::mapped_type mapped_type;
+	typedef typename value_traits_type::value_type  value_type;
+
+	template <typename Ty>
+	static const key_type& get_key(const Ty& value) {
+		return value_traits_type::get_key(value);
+	}
+
+	template <typename Ty>
+	static const value_type& get_value(const Ty& value) {
+		return value_traits_type::get_value(value);
+	}
+};
+
+// 模板类 flat_tree
+// 参数一代表数据类型，参数二代表键值比较类型
+template <typename T, typename Compare>
+class flat_tree {
+public:
+	// flat_tree 的嵌套型别定义
+
+	typedef flat_tree_value_traits<T>                   value_traits;
+	typedef mystl::vector<T>                            container_type;
+
+	typedef typename value_traits::key_type             key_type;
+	typedef typename value_traits::mapped_type          mapped_type;
+	typedef typename value_traits::value_type           value_type;
+	typedef Compare                                     key_compare;
+
+	typedef typename container_type::allocator_type     allocator_type;
+	typedef typename container_type::pointer            pointer;
+	typedef typename container_type::const_pointer      const_pointer;
+	typedef typename container_type::reference          reference;
+	typedef typename container_type::const_reference    const_reference;
+	typedef typename container_type::size_type          size_type;
+	typedef typename container_type::difference_type    difference_type;
+
+	typedef typename container_type::iterator           iterator;
+	typedef typename container_type::const_iterator     const_iterator;
+	typedef mystl::reverse_iterator<iterator>           reverse_iterator;
+	typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+	allocator_type get_allocator() const { return allocator_type(); }
+	key_compare    key_comp()      const { return key_comp_; }
+
+private:
+	// 按键值比较两个元素，用于排序与归并
+	struct value_compare {
+		key_compare comp;
+		explicit value_compare(const key_compare& c) : comp(c) {}
+		bool operator()(const value_type& lhs, const value_type& rhs) const {
+			return comp(value_traits::get_key(lhs), value_traits::get_key(rhs));
+		}
+	};
+
+	// 判断两个相邻的有序元素键值是否相等，用于去重
+	struct value_equal {
+		key_compare comp;
+		explicit value_equal(const key_compare& c) : comp(c) {}
+		bool operator()(const value_type& lhs, const value_type& rhs) const {
+			return !comp(value_traits::get_key(lhs), value_traits::get_key(rhs));
+		}
+	};
+
+private:
+	container_type data_;      // 按键值有序存放的元素
+	key_compare    key_comp_;  // 键值比较的准则
+
+public:
+	// 构造、复制、析构函数
+	flat_tree() = default;
+
+	flat_tree(const flat_tree& rhs) = default;
+	flat_tree(flat_tree&& rhs) noexcept
+		:data_(mystl::move(rhs.data_)), key_comp_(rhs.key_comp_)
+	{}
+
+	flat_tree& operator=(const flat_tree& rhs) = default;
+	flat_tree& operator=(flat_tree&& rhs) {
+		data_ = mystl::move(rhs.data_);
+		key_comp_ = rhs.key_comp_;
+		return *this;
+	}
+
+public:
+	// 迭代器相关操作
+
+	iterator               begin()         noexcept
+	{ return data_.begin(); }
+	const_iterator         begin()   const noexcept
+	{ return data_.begin(); }
+	iterator               end()           noexcept
+	{ return data_.end(); }
+	const_iterator         end()     const noexcept
+	{ return data_.end(); }
+
+	reverse_iterator       rbegin()        noexcept
+	{ return reverse_iterator(end()); }
+	const_reverse_iterator rbegin()  const noexcept
+	{ return const_reverse_iterator(end()); }
+	reverse_iterator       rend()          noexcept
+	{ return reverse_iterator(begin()); }
+	const_reverse_iterator rend()    const noexcept
+	{ return const_reverse_iterator(begin()); }
+
+	const_iterator         cbegin()  const noexcept
+	{ return begin(); }
+	const_iterator         cend()    const noexcept
+	{ return end(); }
+	const_reverse_iterator crbegin() const noexcept
+	{ return rbegin(); }
+	const_reverse_iterator crend()   const noexcept
+	{ return rend(); }
+
+	// 容量相关操作
+
+	bool      empty()    const noexcept { return data_.empty(); }
+	size_type size()     const noexcept { return data_.size(); }
+	size_type max_size() const noexcept { return data_.max_size(); }
+	size_type capacity() const noexcept { return data_.capacity(); }
+
+	void      reserve(size_type n) { data_.reserve(n); }
+	void      shrink_to_fit()      { data_.shrink_to_fit(); }
+
+	// 插入删除相关操作
+
+	// emplace
+
+	template <typename ...Args>
+	iterator  emplace_multi(Args&& ...args) {
+		value_type value(mystl::forward<Args>(args)...);
+		return data_.insert(upper_pos(value_traits::get_key(value)), mystl::move(value));
+	}
+
+	template <typename ...Args>
+	mystl::pair<iterator, bool> emplace_unique(Args&& ...args) {
+		value_type value(mystl::forward<Args>(args)...);
+		return insert_unique(mystl::move(value));
+	}
+
+	template <typename ...Args>
+	iterator  emplace_multi_use_hint(const_iterator hint, Args&& ...args);
+
+	template <typename ...Args>
+	iterator  emplace_unique_use_hint(const_iterator hint, Args&& ...args);
+
+	// insert
+
+	iterator  insert_multi(const value_type& value) {
+		return data_.insert(upper_pos(value_traits::get_key(value)), value);
+	}
+	iterator  insert_multi(value_type&& value) {
+		return data_.insert(upper_pos(value_traits::get_key(value)), mystl::move(value));
+	}
+
+	iterator  insert_multi(const_iterator hint, const value_type& value) {
+		return emplace_multi_use_hint(hint, value);
+	}
+	iterator  insert_multi(const_iterator hint, value_type&& value) {
+		return emplace_multi_use_hint(hint, mystl::move(value));
+	}
+
+	template <typename InputIterator>
+	void      insert_multi(InputIterator first, InputIterator last) {
+		bulk_insert(first, last, false);
+	}
+
+	mystl::pair<iterator, bool> insert_unique(const value_type& value) {
+		iterator pos = lower_pos(value_traits::get_key(value));
+		if (pos != end() && !key_comp_(value_traits::get_key(value), value_traits::get_key(*pos)))
+			return mystl::make_pair(pos, false);
+		return mystl::make_pair(data_.insert(pos, value), true);
+	}
+	mystl::pair<iterator, bool> insert_unique(value_type&& value) {
+		iterator pos = lower_pos(value_traits::get_key(value));
+		if (pos != end() && !key_comp_(value_traits::get_key(value), value_traits::get_key(*pos)))
+			return mystl::make_pair(pos, false);
+		return mystl::make_pair(data_.insert(pos, mystl::move(value)), true);
+	}
+
+	iterator  insert_unique(const_iterator hint, const value_type& value) {
+		return emplace_unique_use_hint(hint, value);
+	}
+	iterator  insert_unique(const_iterator hint, value_type&& value) {
+		return emplace_unique_use_hint(hint, mystl::move(value));
+	}
+
+	template <typename InputIterator>
+	void      insert_unique(InputIterator first, InputIterator last) {
+		bulk_insert(first, last, true);
+	}
+
+	// erase
+
+	iterator  erase(const_iterator hint) { return data_.erase(hint); }
+
+	size_type erase_multi(const key_type& key) {
+		auto p = equal_range_multi(key);
+		const size_type n = static_cast<size_type>(p.second - p.first);
+		data_.erase(p.first, p.second);
+		return n;
+	}
+	size_type erase_unique(const key_type& key) {
+		iterator it = find(key);
+		if (it == end())
+			return 0;
+		data_.erase(it);
+		return 1;
+	}
+
+	void      erase(const_iterator first, const_iterator last) { data_.erase(first, last); }
+
+	void      clear() { data_.clear(); }
+
+	// flat_tree 相关操作
+
+	iterator       find(const key_type& key) {
+		iterator it = lower_pos(key);
+		return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+	}
+	const_iterator find(const key_type& key) const {
+		const_iterator it = lower_pos(key);
+		return (it == end() || key_comp_(key, value_traits::get_key(*it))) ? end() : it;
+	}
+
+	size_type      count_multi(const key_type& key) const {
+		auto p = equal_range_multi(key);
+		return static_cast<size_type>(p.second - p.first);
+	}
+	size_type      count_unique(const key_type& key) const {
+		return find(key) != end() ? 1 : 0;
+	}
+
+	iterator       lower_bound(const key_type& key)       { return lower_pos(key); }
+	const_iterator lower_bound(const key_type& key) const { return lower_pos(key); }
+
+	iterator       upper_bound(const key_type& key)       { return upper_pos(key); }
+	const_iterator upper_bound(const key_type& key) const { return upper_pos(key); }
+
+	mystl::pair<iterator, iterator>
+	equal_range_multi(const key_type& key) {
+		return mystl::pair<iterator, iterator>(lower_pos(key), upper_pos(key));
+	}
+	mystl::pair<const_iterator, const_iterator>
+	equal_range_multi(const key_type& key) const {
+		return mystl::pair<const_iterator, const_iterator>(lower_pos(key), upper_pos(key));
+	}
+
+	mystl::pair<iterator, iterator>
+	equal_range_unique(const key_type& key) {
+		iterator it = find(key);
+		return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, it + 1);
+	}
+	mystl::pair<const_iterator, const_iterator>
+	equal_range_unique(const key_type& key) const {
+		const_iterator it = find(key);
+		return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, it + 1);
+	}
+
+	void swap(flat_tree& rhs) noexcept {
+		data_.swap(rhs.data_);
+		mystl::swap(key_comp_, rhs.key_comp_);
+	}
+
+private:
+	// 二分查找第一个不小于 / 大于 key 的位置
+	iterator  lower_pos(const key_type& key) const;
+	iterator  upper_pos(const key_type& key) const;
+
+	template <typename InputIterator>
+	void      bulk_insert(InputIterator first, InputIterator last, bool unique);
+};
+
+/*****************************************************************************************/
+
+// 就地插入元素，键值允许重复
+// hint 位于正确的位置时直接插入，否则退化为普通插入
+template <typename T, typename Compare>
+template <typename ...Args>
+typename flat_tree<T, Compare>::iterator
+flat_tree<T, Compare>::
+emplace_multi_use_hint(const_iterator hint, Args&& ...args) {
+	value_type value(mystl::forward<Args>(args)...);
+	const key_type& key = value_traits::get_key(value);
+	if ((hint == begin() || !key_comp_(key, value_traits::get_key(*(hint - 1)))) &&
+	    (hint == end() || !key_comp_(value_traits::get_key(*hint), key)))
+		return data_.insert(hint, mystl::move(value));
+	return insert_multi(mystl::move(value));
+}
+
+// 就地插入元素，键值不允许重复
+template <typename T, typename Compare>
+template <typename ...Args>
+typename flat_tree<T, Compare>::iterator
+flat_tree<T, Compare>::
+emplace_unique_use_hint(const_iterator hint, Args&& ...args) {
+	value_type value(mystl::forward<Args>(args)...);
+	const key_type& key = value_traits::get_key(value);
+	if ((hint == begin() || key_comp_(value_traits::get_key(*(hint - 1)), key)) &&
+	    (hint == end() || key_comp_(key, value_traits::get_key(*hint))))
+		return data_.insert(hint, mystl::move(value));
+	return insert_unique(mystl::move(value)).first;
+}
+
+// lower_pos 函数
+template <typename T, typename Compare>
+typename flat_tree<T, Compare>::iterator
+flat_tree<T, Compare>::
+lower_pos(const key_type& key) const {
+	iterator first = const_cast<iterator>(data_.begin());
+	size_type len = data_.size();
+	while (len > 0) {
+		const size_type half = len >> 1;
+		if (key_comp_(value_traits::get_key(first[half]), key)) {
+			first += half + 1;
+			len -= half + 1;
+		} else {
+			len = half;
+		}
+	}
+	return first;
+}
+
+// upper_pos 函数
+template <typename T, typename Compare>
+typename flat_tree<T, Compare>::iterator
+flat_tree<T, Compare>::
+upper_pos(const key_type& key) const {
+	iterator first = const_cast<iterator>(data_.begin());
+	size_type len = data_.size();
+	while (len > 0) {
+		const size_type half = len >> 1;
+		if (!key_comp_(key, value_traits::get_key(first[half]))) {
+			first += half + 1;
+			len -= half + 1;
+		} else {
+			len = half;
+		}
+	}
+	return first;
+}
+
+// bulk_insert 函数
+// 把[first, last)追加到末尾，对新元素排序(unique 时去重)后与原有元素归并
+// 归并是稳定的，键值相等时原有元素在前，unique 时再去重一次即可保留原有元素
+template <typename T, typename Compare>
+template <typename InputIterator>
+void flat_tree<T, Compare>::
+bulk_insert(InputIterator first, InputIterator last, bool unique) {
+	const size_type old_size = data_.size();
+	data_.insert(data_.end(), first, last);
+	if (data_.size() == old_size)
+		return;
+	const value_compare comp(key_comp_);
+	const value_equal equal(key_comp_);
+	iterator middle = data_.begin() + old_size;
+	mystl::sort(middle, data_.end(), comp);
+	if (unique)
+		data_.erase(mystl::unique(middle, data_.end(), equal), data_.end());
+	// 新元素都不小于原有元素时(有序追加)无需归并
+	if (old_size != 0 && comp(*middle, *(middle - 1))) {
+		mystl::inplace_merge(data_.begin(), middle, data_.end(), comp);
+		if (unique)
+			data_.erase(mystl::unique(data_.begin(), data_.end(), equal), data_.end());
+	} else if (unique && old_size != 0 && !comp(*(middle - 1), *middle)) {
+		// 第一个新元素与最后一个原有元素相等
+		data_.erase(middle);
+	}
+}
+
+// 重载比较操作符
+template <typename T, typename Compare>
+bool operator==(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs) {
+	return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, typename Compare>
+bool operator<(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs) {
+	return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, typename Compare>
+bool operator!=(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename T, typename Compare>
+bool operator>(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs) {
+	return rhs < lhs;
+}
+
+template <typename T, typename Compare>
+bool operator<=(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs) {
+	return !(rhs < lhs);
+}
+
+template <typename T, typename Compare>
+bool operator>=(const flat_tree<T, Compare>& lhs, const flat_tree<T, Compare>& rhs) {
+	return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <typename T, typename Compare>
+void swap(flat_tree<T, Compare>& lhs, flat_tree<T, Compare>& rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYSTL_FLAT_TREE_H_
@@ -76,7 +76,7 @@ template <typename T>
 T identity_element(multiplies<T>) { return T(1); }
 
 // 函数对象：等于
-template <typename T>
+template <typename T = void>
 struct equal_to :public binary_function<T, T, bool>
 {
   bool operator()(const T& x, const T& y) const { return x == y; }
@@ -90,19 +90,46 @@ struct not_equal_to :public binary_function<T, T, bool>
 };
 
 // 函数对象：大于
-template <typename T>
+template <typename T = void>
 struct greater :public binary_function<T, T, bool>
 {
   bool operator()(const T& x, const T& y) const { return x > y; }
 };
 
 // 函数对象：小于
-template <typename T>
+template <typename T = void>
 struct less :public binary_function<T, T, bool>
 {
   bool operator()(const T& x, const T& y) const { return x < y; }
 };
 
+// 透明的函数对象：equal_to<>, greater<>, less<>
+// 两个参数可以是不同的类型，只要它们之间能直接比较。嵌套类型 is_transparent 告诉关联式容器
+// 可以用任意能与键值比较的类型来查找，从而不必为每次查找构造一个临时的键值
+template <>
+struct equal_to<void>
+{
+  typedef int is_transparent;
+  template <typename T, typename U>
+  bool operator()(const T& x, const U& y) const { return x == y; }
+};
+
+template <>
+struct greater<void>
+{
+  typedef int is_transparent;
+  template <typename T, typename U>
+  bool operator()(const T& x, const U& y) const { return x > y; }
+};
+
+template <>
+struct less<void>
+{
+  typedef int is_transparent;
+  template <typename T, typename U>
+  bool operator()(const T& x, const U& y) const { return x < y; }
+};
+
 // 函数对象：大于等于
 template <typename T>
 struct greater_equal :public binary_function<T, T, bool>
@@ -4,11 +4,29 @@
 // 这个头文件包含了一个模板类 hashtable
 // hashtable : 哈希表，使用开链法处理冲突
 
+// notes:
+//
+// 渐进式 rehash：
+// 默认情况下，插入使负载超过 max_load_factor 时会一次性把所有节点搬到新的 bucket 数组，
+// 元素很多时这一次插入的延迟会非常高。打开 incremental_rehash(true) 后，扩容只分配新的 bucket 数组，
+// 旧数组保留在 old_buckets_ 中，之后每次插入顺带搬迁若干个旧 bucket，直到旧数组为空
+//   * erase / extract 不搬迁，边遍历边删除 (erase(it++)) 时其它节点的迭代顺序保持不变
+//   * 迁移期间，某个键位于旧表当且仅当它在旧表中对应的 bucket 非空，查找先查旧表再查新表
+//   * 迭代顺序为先新表、后旧表中尚未迁移的部分
+//   * bucket 接口 (begin(n), bucket_size(n), bucket(key)) 只反映新表
+//   * 区间删除、rehash、reserve 会先完成剩余的迁移
+//
+// 节点句柄：extract 摘下的节点以 node_handle 返回，insert 插回、merge 在两个表之间移动元素时都只重新链接节点
+//
+// 透明查找：hasher 与 key_equal 都定义了 is_transparent 时，find / count / equal_range 接受任意能被
+// 哈希并与键值比较的类型，例如用 const char* 在以 mystl::string 为键的表中查找，不必构造临时的键值
+
 #include <initializer_list>
 
 #include "algo.h"
 #include "functional.h"
 #include "memory.h"
+#include "node_handle.h"
 #include "vector.h"
 #include "util.h"
 #include "exceptdef.h"
@@ -182,13 +200,7 @@ struct ht_iterator :public ht_iterator_base<T, Hash, KeyEqual> {
 
 	iterator& operator++() {
 		MYSTL_DEBUG(node != nullptr);
-		const node_ptr old = node;
-		node = node->next;
-		if (node == nullptr) { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-			auto index = ht->hash(value_traits::get_key(old->value));
-			while (!node && ++index < ht->bucket_size_)
-				node = ht->buckets_[index];
-		}
+		node = ht->M_next(node);
 		return *this;
 	}
 	iterator operator++(int) {
@@ -249,14 +261,7 @@ struct ht_const_iterator :public ht_iterator_base<T, Hash, KeyEqual> {
 
 	const_iterator& operator++() {
 		MYSTL_DEBUG(node != nullptr);
-		const node_ptr old = node;
-		node = node->next;
-		if (node == nullptr) { // 如果下一个位置为空，跳到下一个 bucket 的起始处
-			auto index = ht->hash(value_traits::get_key(old->value));
-			while (!node && ++index < ht->bucket_size_) {
-				node = ht->buckets_[index];
-			}
-		}
+		node = ht->M_next(node);
 		return *this;
 	}
 	const_iterator operator++(int) {
@@ -457,6 +462,9 @@ public:
 	typedef mystl::ht_local_iterator<T>                 local_iterator;
 	typedef mystl::ht_const_local_iterator<T>           const_local_iterator;
 
+	typedef mystl::node_handle<T, node_type>            handle_type;
+	typedef mystl::node_insert_return<iterator, handle_type> insert_return_type;
+
 	allocator_type get_allocator() const { return allocator_type(); }
 
 private:
@@ -468,13 +476,18 @@ private:
 	hasher      hash_;
 	key_equal   equal_;
 
-private:
-	bool is_equal(const key_type& key1, const key_type& key2)
-	{
-		return equal_(key1, key2);
-	}
+	// 渐进式 rehash 的状态，old_bucket_size_ 为 0 表示没有正在进行的迁移
+	bucket_type old_buckets_;
+	size_type   old_bucket_size_;
+	size_type   rehash_pos_;       // 旧表中 [0, rehash_pos_) 的 bucket 已迁移
+	bool        incremental_;
+
+	// 渐进式 rehash 时，每次修改操作最多迁移的非空 bucket 数
+	static constexpr size_type kRehashStep = 8;
 
-	bool is_equal(const key_type& key1, const key_type& key2) const
+private:
+	template <typename K>
+	bool is_equal(const key_type& key1, const K& key2) const
 	{
 		return equal_(key1, key2);
 	}
@@ -486,22 +499,12 @@ private:
 
 	iterator M_begin() noexcept
 	{
-		for (size_type n = 0; n < bucket_size_; ++n)
-		{
-		if (buckets_[n])  // 找到第一个有节点的位置就返回
-			return iterator(buckets_[n], this);
-		}
-		return iterator(nullptr, this);
+		return iterator(M_first(0), this);
 	}
 
 	const_iterator M_begin() const noexcept
 	{
-		for (size_type n = 0; n < bucket_size_; ++n)
-		{
-		if (buckets_[n])  // 找到第一个有节点的位置就返回
-			return M_cit(buckets_[n]);
-		}
-		return M_cit(nullptr);
+		return M_cit(M_first(0));
 	}
 
 public:
@@ -509,7 +512,8 @@ public:
 	explicit hashtable(size_type bucket_count,
 						const Hash& hash = Hash(),
 						const KeyEqual& equal = KeyEqual())
-		:size_(0), mlf_(1.0f), hash_(hash), equal_(equal) {
+		:size_(0), mlf_(1.0f), hash_(hash), equal_(equal),
+		old_bucket_size_(0), rehash_pos_(0), incremental_(false) {
 		init(bucket_count);
 	}
 
@@ -519,12 +523,14 @@ public:
 				size_type bucket_count,
 				const Hash& hash = Hash(),
 				const KeyEqual& equal = KeyEqual())
-		:size_(mystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal) {
+		:size_(mystl::distance(first, last)), mlf_(1.0f), hash_(hash), equal_(equal),
+		old_bucket_size_(0), rehash_pos_(0), incremental_(false) {
 		init(mystl::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))));
 	}
 
 	hashtable(const hashtable& rhs)
-		:hash_(rhs.hash_), equal_(rhs.equal_) {
+		:hash_(rhs.hash_), equal_(rhs.equal_),
+		old_bucket_size_(0), rehash_pos_(0), incremental_(rhs.incremental_) {
 		copy_init(rhs);
 	}
 	hashtable(hashtable&& rhs) noexcept
@@ -532,11 +538,17 @@ public:
 		size_(rhs.size_),
 		mlf_(rhs.mlf_),
 		hash_(rhs.hash_),
-		equal_(rhs.equal_) {
+		equal_(rhs.equal_),
+		old_bucket_size_(rhs.old_bucket_size_),
+		rehash_pos_(rhs.rehash_pos_),
+		incremental_(rhs.incremental_) {
 		buckets_ = mystl::move(rhs.buckets_);
+		old_buckets_ = mystl::move(rhs.old_buckets_);
 		rhs.bucket_size_ = 0;
 		rhs.size_ = 0;
 		rhs.mlf_ = 0.0f;
+		rhs.old_bucket_size_ = 0;
+		rhs.rehash_pos_ = 0;
 	}
 
 	hashtable& operator=(const hashtable& rhs);
@@ -584,6 +596,11 @@ public:
 	iterator emplace_unique_use_hint(const_iterator /*hint*/, Args&& ...args)
 	{ return emplace_unique(mystl::forward<Args>(args)...).first; }
 
+	// 先查找键值，不存在时才以 key 和 args... 就地构造节点的键与值，
+	// 键值已存在时不构造节点，也不会移动 key 与 args
+	template <typename K, typename ...Args>
+	pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args);
+
 	// insert
 
 	iterator             insert_multi_noresize(const value_type& value);
@@ -623,6 +640,21 @@ public:
 	void insert_unique(InputIter first, InputIter last)
 	{ copy_insert_unique(first, last, iterator_category(first)); }
 
+	// 插入节点句柄持有的节点，句柄为空时什么也不做
+	// unique 版本插入失败时节点留在返回值的 node 中
+	insert_return_type insert_unique(handle_type&& nh);
+	iterator           insert_multi(handle_type&& nh);
+
+	// extract / merge
+
+	// 摘下节点并以节点句柄返回，不销毁元素；按键值摘下时键值不存在返回空句柄
+	handle_type extract(const_iterator position);
+	handle_type extract(const key_type& key);
+
+	// merge 把 source 中的节点移入本表，unique 版本中键值已存在的元素留在 source 中
+	void        merge_unique(hashtable& source);
+	void        merge_multi(hashtable& source);
+
 	// erase / clear
 
 	void      erase(const_iterator position);
@@ -636,14 +668,36 @@ public:
 	void      swap(hashtable& rhs) noexcept;
 
 	// 查找相关操作
-
-	size_type                            count(const key_type& key) const;
-
-	iterator                             find(const key_type& key);
-	const_iterator                       find(const key_type& key) const;
+	// 带模板参数 K 的版本是透明查找，只在 hasher 与 key_equal 都定义了 is_transparent 时参与重载
+
+	size_type                            count(const key_type& key) const
+	{ return M_count(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	size_type                            count(const K& key) const
+	{ return M_count(key); }
+
+	iterator                             find(const key_type& key)
+	{ return iterator(M_find(key), this); }
+	const_iterator                       find(const key_type& key) const
+	{ return M_cit(M_find(key)); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	iterator                             find(const K& key)
+	{ return iterator(M_find(key), this); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	const_iterator                       find(const K& key) const
+	{ return M_cit(M_find(key)); }
 
 	pair<iterator, iterator>             equal_range_multi(const key_type& key);
 	pair<const_iterator, const_iterator> equal_range_multi(const key_type& key) const;
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<iterator, iterator>             equal_range_multi(const K& key);
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<const_iterator, const_iterator> equal_range_multi(const K& key) const;
 
 	pair<iterator, iterator>             equal_range_unique(const key_type& key);
 	pair<const_iterator, const_iterator> equal_range_unique(const key_type& key) const;
@@ -702,6 +756,18 @@ public:
 	void reserve(size_type count)
 	{ rehash(static_cast<size_type>((float)count / max_load_factor() + 0.5f)); }
 
+	// 渐进式 rehash，关闭时会先完成正在进行的迁移
+	bool incremental_rehash() const noexcept
+	{ return incremental_; }
+	void incremental_rehash(bool on) {
+		if (!on)
+			finish_rehash();
+		incremental_ = on;
+	}
+	// 是否有正在进行的迁移
+	bool rehashing() const noexcept
+	{ return old_bucket_size_ != 0; }
+
 	hasher    hash_fcn() const { return hash_; }
 	key_equal key_eq()   const { return equal_; }
 
@@ -715,14 +781,38 @@ private:
 	// node
 	template  <class ...Args>
 	node_ptr  create_node(Args&& ...args);
+	template <class K, class ...Args>
+	node_ptr  create_kv_node(K&& key, Args&& ...args);
 	void      destroy_node(node_ptr n);
 
 	// hash
 	size_type next_size(size_type n) const;
-	size_type hash(const key_type& key, size_type n) const;
-	size_type hash(const key_type& key) const;
+	template <typename K>
+	size_type hash(const K& key, size_type n) const;
+	template <typename K>
+	size_type hash(const K& key) const;
 	void      rehash_if_need(size_type n);
 
+	// incremental rehash
+	void      start_rehash(size_type bucket_count);
+	void      rehash_step();
+	void      finish_rehash();
+
+	// 节点定位
+	node_ptr& M_slot(const key_type& key);
+	template <typename K>
+	node_ptr  M_head(const K& key) const;
+	node_ptr  M_first(size_type n) const;
+	node_ptr  M_next(node_ptr node) const;
+
+	// 查找，K 为 key_type 或透明查找时的任意类型
+	template <typename K>
+	node_ptr  M_find(const K& key) const;
+	template <typename K>
+	size_type M_count(const K& key) const;
+	template <typename K>
+	pair<node_ptr, node_ptr> M_equal_range(const K& key) const;
+
 	// insert
 	template <typename InputIter>
 	void copy_insert_multi(InputIter first, InputIter last, mystl::input_iterator_tag);
@@ -733,11 +823,13 @@ private:
 	template <typename ForwardIter>
 	void copy_insert_unique(ForwardIter first, ForwardIter last, mystl::forward_iterator_tag);
 
-	// insert node
+	// insert node / unlink node
 	pair<iterator, bool> insert_node_unique(node_ptr np);
 	iterator             insert_node_multi(node_ptr np);
+	void                 unlink_node(node_ptr np);
 
 	// bucket operator
+	void link_node(bucket_type& bucket, size_type bucket_count, node_ptr np);
 	void replace_bucket(size_type bucket_count);
 	void erase_bucket(size_type n, node_ptr first, node_ptr last);
 	void erase_bucket(size_type n, node_ptr last);
@@ -780,8 +872,7 @@ hashtable<T, Hash, KeyEqual>::
 emplace_multi(Args&& ...args) {
 	auto np = create_node(mystl::forward<Args>(args)...);
 	try {
-		if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-			rehash(size_ + 1);
+		rehash_if_need(1);
 	}catch (...) {
 		destroy_node(np);
 		throw;
@@ -798,13 +889,33 @@ hashtable<T, Hash, KeyEqual>::
 emplace_unique(Args&& ...args) {
 	auto np = create_node(mystl::forward<Args>(args)...);
 	try {
-		if ((float)(size_ + 1) > (float)bucket_size_ * max_load_factor())
-		rehash(size_ + 1);
+		rehash_if_need(1);
 	}catch (...) {
 		destroy_node(np);
 		throw;
 	}
-	return insert_node_unique(np);
+	auto res = insert_node_unique(np);
+	if (!res.second)
+		destroy_node(np);
+	return res;
+}
+
+// 键值不存在时才构造节点，新节点直接挂在所在链表的表头
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K, typename ...Args>
+pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
+hashtable<T, Hash, KeyEqual>::
+try_emplace_unique(K&& key, Args&& ...args) {
+	node_ptr cur = M_find(key);
+	if (cur)
+		return mystl::make_pair(iterator(cur, this), false);
+	rehash_if_need(1);
+	auto np = create_kv_node(mystl::forward<K>(key), mystl::forward<Args>(args)...);
+	auto& head = M_slot(value_traits::get_key(np->value));
+	np->next = head;
+	head = np;
+	++size_;
+	return mystl::make_pair(iterator(np, this), true);
 }
 
 // 在不需要重建表格的情况下插入新节点，键值不允许重复
@@ -812,8 +923,8 @@ template <typename T, typename Hash, typename KeyEqual>
 pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
 hashtable<T, Hash, KeyEqual>::
 insert_unique_noresize(const value_type& value) {
-	const auto n = hash(value_traits::get_key(value));
-	auto first = buckets_[n];
+	auto& head = M_slot(value_traits::get_key(value));
+	auto first = head;
 	for (auto cur = first; cur; cur = cur->next) {
 		if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value)))
 		return mystl::make_pair(iterator(cur, this), false);
@@ -821,7 +932,7 @@ insert_unique_noresize(const value_type& value) {
 	// 让新节点成为链表的第一个节点
 	auto tmp = create_node(value);  
 	tmp->next = first;
-	buckets_[n] = tmp;
+	head = tmp;
 	++size_;
 	return mystl::make_pair(iterator(tmp, this), true);
 }
@@ -831,8 +942,8 @@ template <typename T, typename Hash, typename KeyEqual>
 typename hashtable<T, Hash, KeyEqual>::iterator
 hashtable<T, Hash, KeyEqual>::
 insert_multi_noresize(const value_type& value) {
-	const auto n = hash(value_traits::get_key(value));
-	auto first = buckets_[n];
+	auto& head = M_slot(value_traits::get_key(value));
+	auto first = head;
 	auto tmp = create_node(value);
 	for (auto cur = first; cur; cur = cur->next) {
 		if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(value))) { 
@@ -845,7 +956,7 @@ insert_multi_noresize(const value_type& value) {
 	}
 	// 否则插入在链表头部
 	tmp->next = first;
-	buckets_[n] = tmp;
+	head = tmp;
 	++size_;
 	return iterator(tmp, this);
 }
@@ -856,10 +967,10 @@ void hashtable<T, Hash, KeyEqual>::
 erase(const_iterator position) {
 	auto p = position.node;
 	if (p){
-		const auto n = hash(value_traits::get_key(p->value));
-		auto cur = buckets_[n];
+		auto& head = M_slot(value_traits::get_key(p->value));
+		auto cur = head;
 		if (cur == p) { // p 位于链表头部
-			buckets_[n] = cur->next;
+			head = cur->next;
 			destroy_node(cur);
 			--size_;
 		}else {
@@ -885,6 +996,7 @@ void hashtable<T, Hash, KeyEqual>::
 erase(const_iterator first, const_iterator last) {
 	if (first.node == last.node)
 		return;
+	finish_rehash();  // 迁移只重新链接节点，first 与 last 仍然有效
 	auto first_bucket = first.node 
 		? hash(value_traits::get_key(first.node->value)) 
 		: bucket_size_;
@@ -910,23 +1022,30 @@ template <typename T, typename Hash, typename KeyEqual>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
 erase_multi(const key_type& key) {
-	auto p = equal_range_multi(key);
-	if (p.first.node != nullptr) {
-		erase(p.first, p.second);
-		return mystl::distance(p.first, p.second);
+	// 相等的键值在链表中相邻，找到第一个后连续删除
+	node_ptr* link = &M_slot(key);
+	while (*link && !is_equal(value_traits::get_key((*link)->value), key))
+		link = &(*link)->next;
+	size_type result = 0;
+	while (*link && is_equal(value_traits::get_key((*link)->value), key)) {
+		auto cur = *link;
+		*link = cur->next;
+		destroy_node(cur);
+		++result;
 	}
-	return 0;
+	size_ -= result;
+	return result;
 }
 
 template <typename T, typename Hash, typename KeyEqual>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
 erase_unique(const key_type& key) {
-	const auto n = hash(key);
-	auto first = buckets_[n];
+	auto& head = M_slot(key);
+	auto first = head;
 	if (first) {
 		if (is_equal(value_traits::get_key(first->value), key)) {
-			buckets_[n] = first->next;
+			head = first->next;
 			destroy_node(first);
 			--size_;
 			return 1;
@@ -947,6 +1066,99 @@ erase_unique(const key_type& key) {
 	return 0;
 }
 
+// 插入节点句柄持有的节点，键值不允许重复
+template <typename T, typename Hash, typename KeyEqual>
+typename hashtable<T, Hash, KeyEqual>::insert_return_type
+hashtable<T, Hash, KeyEqual>::
+insert_unique(handle_type&& nh) {
+	if (nh.empty())
+		return insert_return_type{ end(), false, handle_type() };
+	rehash_if_need(1);
+	auto res = insert_node_unique(nh.node_);
+	if (!res.second)
+		return insert_return_type{ res.first, false, mystl::move(nh) };
+	nh.release();
+	return insert_return_type{ res.first, true, handle_type() };
+}
+
+// 插入节点句柄持有的节点，键值允许重复
+template <typename T, typename Hash, typename KeyEqual>
+typename hashtable<T, Hash, KeyEqual>::iterator
+hashtable<T, Hash, KeyEqual>::
+insert_multi(handle_type&& nh) {
+	if (nh.empty())
+		return end();
+	rehash_if_need(1);
+	return insert_node_multi(nh.release());
+}
+
+// 摘下迭代器所指的节点
+template <typename T, typename Hash, typename KeyEqual>
+typename hashtable<T, Hash, KeyEqual>::handle_type
+hashtable<T, Hash, KeyEqual>::
+extract(const_iterator position) {
+	auto np = position.node;
+	MYSTL_DEBUG(np != nullptr);
+	unlink_node(np);
+	return handle_type::from_node(np);
+}
+
+// 摘下键值为 key 的节点
+template <typename T, typename Hash, typename KeyEqual>
+typename hashtable<T, Hash, KeyEqual>::handle_type
+hashtable<T, Hash, KeyEqual>::
+extract(const key_type& key) {
+	auto it = find(key);
+	return it.node != nullptr ? extract(M_cit(it.node)) : handle_type();
+}
+
+// 把 source 中的节点移入本表，键值已存在的节点留在 source 中
+// 先一次性为 source 的元素预留 bucket，之后逐个节点重新链接，不申请节点，也不复制元素
+template <typename T, typename Hash, typename KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+merge_unique(hashtable& source) {
+	if (this == &source || source.size_ == 0)
+		return;
+	source.finish_rehash();
+	rehash_if_need(source.size_);
+	for (size_type i = 0; i < source.bucket_size_; ++i) {
+		node_ptr* link = &source.buckets_[i];
+		while (*link != nullptr) {
+			auto np = *link;
+			auto next = np->next;
+			np->next = nullptr;
+			if (insert_node_unique(np).second) {
+				*link = next;
+				--source.size_;
+			}else {
+				np->next = next;
+				link = &np->next;
+			}
+		}
+	}
+}
+
+// 把 source 中的节点全部移入本表
+template <typename T, typename Hash, typename KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+merge_multi(hashtable& source) {
+	if (this == &source || source.size_ == 0)
+		return;
+	source.finish_rehash();
+	rehash_if_need(source.size_);
+	for (size_type i = 0; i < source.bucket_size_; ++i) {
+		auto np = source.buckets_[i];
+		source.buckets_[i] = nullptr;
+		while (np != nullptr) {
+			auto next = np->next;
+			np->next = nullptr;
+			insert_node_multi(np);
+			np = next;
+		}
+	}
+	source.size_ = 0;
+}
+
 // 清空 hashtable
 template <typename T, typename Hash, typename KeyEqual>
 void hashtable<T, Hash, KeyEqual>::
@@ -961,8 +1173,19 @@ clear() {
 			}
 			buckets_[i] = nullptr;
 		}
+		for (size_type i = rehash_pos_; i < old_bucket_size_; ++i) {
+			node_ptr cur = old_buckets_[i];
+			while (cur != nullptr) {
+				node_ptr next = cur->next;
+				destroy_node(cur);
+				cur = next;
+			}
+		}
 		size_ = 0;
 	}
+	bucket_type().swap(old_buckets_);
+	old_bucket_size_ = 0;
+	rehash_pos_ = 0;
 }
 
 // 在某个 bucket 节点的个数
@@ -992,84 +1215,43 @@ rehash(size_type count) {
 	}
 }
 
-// 查找键值为 key 的节点，返回其迭代器
-template <typename T, typename Hash, typename KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::
-find(const key_type& key) {
-	const auto n = hash(key);
-	node_ptr first = buckets_[n];
-	for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
-	return iterator(first, this);
-}
-
+// 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
 template <typename T, typename Hash, typename KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::const_iterator
+pair<typename hashtable<T, Hash, KeyEqual>::iterator,
+  typename hashtable<T, Hash, KeyEqual>::iterator>
 hashtable<T, Hash, KeyEqual>::
-find(const key_type& key) const {
-	const auto n = hash(key);
-	node_ptr first = buckets_[n];
-	for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
-	return M_cit(first);
+equal_range_multi(const key_type& key) {
+	auto p = M_equal_range(key);
+	return mystl::make_pair(iterator(p.first, this), iterator(p.second, this));
 }
 
-// 查找键值为 key 出现的次数
 template <typename T, typename Hash, typename KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type
+pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
+  	typename hashtable<T, Hash, KeyEqual>::const_iterator>
 hashtable<T, Hash, KeyEqual>::
-count(const key_type& key) const {
-	const auto n = hash(key);
-	size_type result = 0;
-	for (node_ptr cur = buckets_[n]; cur; cur = cur->next) {
-		if (is_equal(value_traits::get_key(cur->value), key))
-			++result;
-	}
-	return result;
+equal_range_multi(const key_type& key) const {
+	auto p = M_equal_range(key);
+	return mystl::make_pair(M_cit(p.first), M_cit(p.second));
 }
 
-// 查找与键值 key 相等的区间，返回一个 pair，指向相等区间的首尾
 template <typename T, typename Hash, typename KeyEqual>
+template <typename K, typename, typename, typename, typename>
 pair<typename hashtable<T, Hash, KeyEqual>::iterator,
   typename hashtable<T, Hash, KeyEqual>::iterator>
 hashtable<T, Hash, KeyEqual>::
-equal_range_multi(const key_type& key) {
-	const auto n = hash(key);
-	for (node_ptr first = buckets_[n]; first; first = first->next) {
-		if (is_equal(value_traits::get_key(first->value), key)) { // 如果出现相等的键值
-			for (node_ptr second = first->next; second; second = second->next) {
-				if (!is_equal(value_traits::get_key(second->value), key))
-					return mystl::make_pair(iterator(first, this), iterator(second, this));
-			}
-			for (auto m = n + 1; m < bucket_size_; ++m) { // 整个链表都相等，查找下一个链表出现的位置
-				if (buckets_[m])
-					return mystl::make_pair(iterator(first, this), iterator(buckets_[m], this));
-			}
-			return mystl::make_pair(iterator(first, this), end());
-		}
-	}
-	return mystl::make_pair(end(), end());
+equal_range_multi(const K& key) {
+	auto p = M_equal_range(key);
+	return mystl::make_pair(iterator(p.first, this), iterator(p.second, this));
 }
 
 template <typename T, typename Hash, typename KeyEqual>
+template <typename K, typename, typename, typename, typename>
 pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
   	typename hashtable<T, Hash, KeyEqual>::const_iterator>
 hashtable<T, Hash, KeyEqual>::
-equal_range_multi(const key_type& key) const {
-	const auto n = hash(key);
-	for (node_ptr first = buckets_[n]; first; first = first->next) {
-		if (is_equal(value_traits::get_key(first->value), key)) {
-			for (node_ptr second = first->next; second; second = second->next){
-				if (!is_equal(value_traits::get_key(second->value), key))
-					return mystl::make_pair(M_cit(first), M_cit(second));
-			}
-			for (auto m = n + 1; m < bucket_size_; ++m) { // 整个链表都相等，查找下一个链表出现的位置
-				if (buckets_[m])
-					return mystl::make_pair(M_cit(first), M_cit(buckets_[m]));
-			}
-			return mystl::make_pair(M_cit(first), cend());
-		}
-	}
-	return mystl::make_pair(cend(), cend());
+equal_range_multi(const K& key) const {
+	auto p = M_equal_range(key);
+	return mystl::make_pair(M_cit(p.first), M_cit(p.second));
 }
 
 template <typename T, typename Hash, typename KeyEqual>
@@ -1077,17 +1259,9 @@ pair<typename hashtable<T, Hash, KeyEqual>::iterator,
   	typename hashtable<T, Hash, KeyEqual>::iterator>
 hashtable<T, Hash, KeyEqual>::
 equal_range_unique(const key_type& key) {
-	const auto n = hash(key);
-	for (node_ptr first = buckets_[n]; first; first = first->next) {
-		if (is_equal(value_traits::get_key(first->value), key)) {
-			if (first->next)
-				return mystl::make_pair(iterator(first, this), iterator(first->next, this));
-			for (auto m = n + 1; m < bucket_size_; ++m) { // 整个链表都相等，查找下一个链表出现的位置
-				if (buckets_[m])
-					return mystl::make_pair(iterator(first, this), iterator(buckets_[m], this));
-			}
-			return mystl::make_pair(iterator(first, this), end());
-		}
+	for (node_ptr first = M_head(key); first; first = first->next) {
+		if (is_equal(value_traits::get_key(first->value), key))
+			return mystl::make_pair(iterator(first, this), iterator(M_next(first), this));
 	}
 	return mystl::make_pair(end(), end());
 }
@@ -1097,17 +1271,9 @@ pair<typename hashtable<T, Hash, KeyEqual>::const_iterator,
 	typename hashtable<T, Hash, KeyEqual>::const_iterator>
 hashtable<T, Hash, KeyEqual>::
 equal_range_unique(const key_type& key) const {
-	const auto n = hash(key);
-	for (node_ptr first = buckets_[n]; first; first = first->next) {
-		if (is_equal(value_traits::get_key(first->value), key)) {
-			if (first->next)
-				return mystl::make_pair(M_cit(first), M_cit(first->next));
-			for (auto m = n + 1; m < bucket_size_; ++m) { // 整个链表都相等，查找下一个链表出现的位置
-				if (buckets_[m])
-					return mystl::make_pair(M_cit(first), M_cit(buckets_[m]));
-			}
-			return mystl::make_pair(M_cit(first), cend());
-		}
+	for (node_ptr first = M_head(key); first; first = first->next) {
+		if (is_equal(value_traits::get_key(first->value), key))
+			return mystl::make_pair(M_cit(first), M_cit(M_next(first)));
 	}
 	return mystl::make_pair(cend(), cend());
 }
@@ -1123,6 +1289,10 @@ void hashtable<T, Hash, KeyEqual>::
 		mystl::swap(mlf_, rhs.mlf_);
 		mystl::swap(hash_, rhs.hash_);
 		mystl::swap(equal_, rhs.equal_);
+		old_buckets_.swap(rhs.old_buckets_);
+		mystl::swap(old_bucket_size_, rhs.old_bucket_size_);
+		mystl::swap(rehash_pos_, rhs.rehash_pos_);
+		mystl::swap(incremental_, rhs.incremental_);
 	}
 }
 
@@ -1165,6 +1335,11 @@ copy_init(const hashtable& ht) {
 				copy->next = nullptr;
 			}
 		}
+		// ht 正在迁移时，旧表中剩余的节点直接复制到新表中
+		for (size_type i = ht.rehash_pos_; i < ht.old_bucket_size_; ++i) {
+			for (node_ptr cur = ht.old_buckets_[i]; cur; cur = cur->next)
+				link_node(buckets_, ht.bucket_size_, create_node(cur->value));
+		}
 		bucket_size_ = ht.bucket_size_;
 		mlf_ = ht.mlf_;
 		size_ = ht.size_;
@@ -1190,6 +1365,31 @@ create_node(Args&& ...args) {
 	return tmp;
 }
 
+// create_kv_node 函数，以 key 构造键、以 args... 就地构造值，不经过 mapped_type 的临时对象
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K, typename ...Args>
+typename hashtable<T, Hash, KeyEqual>::node_ptr
+hashtable<T, Hash, KeyEqual>::
+create_kv_node(K&& key, Args&& ...args) {
+	node_ptr tmp = node_allocator::allocate(1);
+	key_type* kp = const_cast<key_type*>(mystl::address_of(tmp->value.first));
+	try {
+		mystl::construct(kp, mystl::forward<K>(key));
+	}catch (...) {
+		node_allocator::deallocate(tmp);
+		throw;
+	}
+	try {
+		mystl::construct(mystl::address_of(tmp->value.second), mystl::forward<Args>(args)...);
+	}catch (...) {
+		mystl::destroy(kp);
+		node_allocator::deallocate(tmp);
+		throw;
+	}
+	tmp->next = nullptr;
+	return tmp;
+}
+
 // destroy_node 函数
 template <typename T, typename Hash, typename KeyEqual>
 void hashtable<T, Hash, KeyEqual>::
@@ -1208,16 +1408,18 @@ hashtable<T, Hash, KeyEqual>::next_size(size_type n) const {
 
 // hash 函数
 template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
-hash(const key_type& key, size_type n) const {
+hash(const K& key, size_type n) const {
 	return hash_(key) % n;
 }
 
 template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
 typename hashtable<T, Hash, KeyEqual>::size_type
 hashtable<T, Hash, KeyEqual>::
-hash(const key_type& key) const {
+hash(const K& key) const {
 	return hash_(key) % bucket_size_;
 }
 
@@ -1225,8 +1427,169 @@ hash(const key_type& key) const {
 template <typename T, typename Hash, typename KeyEqual>
 void hashtable<T, Hash, KeyEqual>::
 rehash_if_need(size_type n){
-	if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
-    	rehash(size_ + n);
+	rehash_step();
+	if (static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor()) {
+		const auto count = next_size(size_ + n);
+		if (incremental_ && count > bucket_size_)
+			start_rehash(count);
+		else
+			rehash(size_ + n);
+	}
+}
+
+// start_rehash 函数
+// 分配新的 bucket 数组，原数组成为旧表，节点留待之后的修改操作逐步迁移
+template <typename T, typename Hash, typename KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+start_rehash(size_type bucket_count) {
+	finish_rehash();
+	bucket_type bucket(bucket_count);
+	old_buckets_.swap(buckets_);
+	buckets_.swap(bucket);
+	old_bucket_size_ = bucket_size_;
+	bucket_size_ = bucket_count;
+	rehash_pos_ = 0;
+}
+
+// rehash_step 函数
+// 迁移至多 kRehashStep 个非空的旧 bucket，为避免在稀疏的旧表上停留太久，最多检查 4 * kRehashStep 个
+template <typename T, typename Hash, typename KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+rehash_step() {
+	if (old_bucket_size_ == 0)
+		return;
+	size_type moved = 0;
+	for (size_type checked = 0; checked < 4 * kRehashStep && moved < kRehashStep &&
+		rehash_pos_ < old_bucket_size_; ++checked) {
+		node_ptr first = old_buckets_[rehash_pos_];
+		old_buckets_[rehash_pos_++] = nullptr;
+		if (first) {
+			++moved;
+			while (first) {
+				node_ptr next = first->next;
+				link_node(buckets_, bucket_size_, first);
+				first = next;
+			}
+		}
+	}
+	if (rehash_pos_ == old_bucket_size_) { // 迁移完成，释放旧表
+		bucket_type().swap(old_buckets_);
+		old_bucket_size_ = 0;
+		rehash_pos_ = 0;
+	}
+}
+
+// finish_rehash 函数
+template <typename T, typename Hash, typename KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+finish_rehash() {
+	while (old_bucket_size_ != 0)
+		rehash_step();
+}
+
+// M_slot 函数，返回键值为 key 的节点所在链表的表头
+// 迁移期间，旧表中对应的 bucket 非空时键值位于旧表，否则位于新表
+template <typename T, typename Hash, typename KeyEqual>
+typename hashtable<T, Hash, KeyEqual>::node_ptr&
+hashtable<T, Hash, KeyEqual>::
+M_slot(const key_type& key) {
+	if (old_bucket_size_ != 0) {
+		auto& old = old_buckets_[hash(key, old_bucket_size_)];
+		if (old)
+			return old;
+	}
+	return buckets_[hash(key)];
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
+typename hashtable<T, Hash, KeyEqual>::node_ptr
+hashtable<T, Hash, KeyEqual>::
+M_head(const K& key) const {
+	if (old_bucket_size_ != 0) {
+		node_ptr old = old_buckets_[hash(key, old_bucket_size_)];
+		if (old)
+			return old;
+	}
+	return buckets_[hash(key)];
+}
+
+// M_find 函数，返回第一个键值与 key 相等的节点，不存在时返回 nullptr
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
+typename hashtable<T, Hash, KeyEqual>::node_ptr
+hashtable<T, Hash, KeyEqual>::
+M_find(const K& key) const {
+	node_ptr first = M_head(key);
+	for (; first && !is_equal(value_traits::get_key(first->value), key); first = first->next) {}
+	return first;
+}
+
+// M_count 函数，返回键值与 key 相等的节点个数
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
+typename hashtable<T, Hash, KeyEqual>::size_type
+hashtable<T, Hash, KeyEqual>::
+M_count(const K& key) const {
+	size_type result = 0;
+	for (node_ptr cur = M_head(key); cur; cur = cur->next) {
+		if (is_equal(value_traits::get_key(cur->value), key))
+			++result;
+	}
+	return result;
+}
+
+// M_equal_range 函数，相等的键值在链表中相邻，返回这一段的首节点和尾后节点，不存在时两者都是 nullptr
+template <typename T, typename Hash, typename KeyEqual>
+template <typename K>
+pair<typename hashtable<T, Hash, KeyEqual>::node_ptr,
+	typename hashtable<T, Hash, KeyEqual>::node_ptr>
+hashtable<T, Hash, KeyEqual>::
+M_equal_range(const K& key) const {
+	node_ptr first = M_find(key);
+	if (!first)
+		return mystl::make_pair(first, first);
+	node_ptr last = first;
+	while (last->next && is_equal(value_traits::get_key(last->next->value), key))
+		last = last->next;
+	return mystl::make_pair(first, M_next(last));
+}
+
+// M_first 函数，返回新表第 n 个 bucket 起的第一个节点，新表之后是旧表
+template <typename T, typename Hash, typename KeyEqual>
+typename hashtable<T, Hash, KeyEqual>::node_ptr
+hashtable<T, Hash, KeyEqual>::
+M_first(size_type n) const {
+	for (; n < bucket_size_; ++n) {
+		if (buckets_[n])  // 找到第一个有节点的位置就返回
+			return buckets_[n];
+	}
+	for (n = rehash_pos_; n < old_bucket_size_; ++n) {
+		if (old_buckets_[n])
+			return old_buckets_[n];
+	}
+	return nullptr;
+}
+
+// M_next 函数，返回迭代顺序中 node 的下一个节点
+template <typename T, typename Hash, typename KeyEqual>
+typename hashtable<T, Hash, KeyEqual>::node_ptr
+hashtable<T, Hash, KeyEqual>::
+M_next(node_ptr node) const {
+	if (node->next)
+		return node->next;
+	const auto& key = value_traits::get_key(node->value);
+	if (old_bucket_size_ != 0) {
+		auto n = hash(key, old_bucket_size_);
+		if (old_buckets_[n]) { // node 位于旧表，旧表是迭代的最后一段
+			while (++n < old_bucket_size_) {
+				if (old_buckets_[n])
+					return old_buckets_[n];
+			}
+			return nullptr;
+		}
+	}
+	return M_first(hash(key) + 1);
 }
 
 // copy_insert
@@ -1273,10 +1636,10 @@ template <typename T, typename Hash, typename KeyEqual>
 typename hashtable<T, Hash, KeyEqual>::iterator
 hashtable<T, Hash, KeyEqual>::
 insert_node_multi(node_ptr np) {
-	const auto n = hash(value_traits::get_key(np->value));
-	auto cur = buckets_[n];
+	auto& head = M_slot(value_traits::get_key(np->value));
+	auto cur = head;
 	if (cur == nullptr) {
-		buckets_[n] = np;
+		head = np;
 		++size_;
 		return iterator(np, this);
 	}
@@ -1288,8 +1651,8 @@ insert_node_multi(node_ptr np) {
 			return iterator(np, this);
 		}
 	}
-	np->next = buckets_[n];
-	buckets_[n] = np;
+	np->next = head;
+	head = np;
 	++size_;
 	return iterator(np, this);
 }
@@ -1299,10 +1662,10 @@ template <typename T, typename Hash, typename KeyEqual>
 pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>
 hashtable<T, Hash, KeyEqual>::
 insert_node_unique(node_ptr np) {
-	const auto n = hash(value_traits::get_key(np->value));
-	auto cur = buckets_[n];
+	auto& head = M_slot(value_traits::get_key(np->value));
+	auto cur = head;
 	if (cur == nullptr) {
-		buckets_[n] = np;
+		head = np;
 		++size_;
 		return mystl::make_pair(iterator(np, this), true);
 	}
@@ -1311,36 +1674,57 @@ insert_node_unique(node_ptr np) {
 			return mystl::make_pair(iterator(cur, this), false);
 		}
 	}
-	np->next = buckets_[n];
-	buckets_[n] = np;
+	np->next = head;
+	head = np;
 	++size_;
 	return mystl::make_pair(iterator(np, this), true);
 }
 
+// unlink_node 函数
+// 把节点从所在的链表中摘下，不销毁节点
+template <typename T, typename Hash, typename KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+unlink_node(node_ptr np) {
+	node_ptr* link = &M_slot(value_traits::get_key(np->value));
+	while (*link != np) {
+		MYSTL_DEBUG(*link != nullptr);
+		link = &(*link)->next;
+	}
+	*link = np->next;
+	np->next = nullptr;
+	--size_;
+}
+
+// link_node 函数
+// 把节点链接到 bucket 中，键值相等的节点保持相邻
+template <typename T, typename Hash, typename KeyEqual>
+void hashtable<T, Hash, KeyEqual>::
+link_node(bucket_type& bucket, size_type bucket_count, node_ptr np) {
+	const auto n = hash(value_traits::get_key(np->value), bucket_count);
+	for (auto cur = bucket[n]; cur; cur = cur->next) {
+		if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(np->value))) {
+			np->next = cur->next;
+			cur->next = np;
+			return;
+		}
+	}
+	np->next = bucket[n];
+	bucket[n] = np;
+}
+
 // replace_bucket 函数
+// 节点只重新链接而不复制，迭代器与元素的地址保持有效
 template <typename T, typename Hash, typename KeyEqual>
 void hashtable<T, Hash, KeyEqual>::
 replace_bucket(size_type bucket_count) {
+	finish_rehash();
 	bucket_type bucket(bucket_count);
 	if (size_ != 0) {
-		for (size_type i = 0; i < bucket_size_; ++i){
-			for (auto first = buckets_[i]; first; first = first->next) {
-				auto tmp = create_node(first->value);
-				const auto n = hash(value_traits::get_key(first->value), bucket_count);
-				auto f = bucket[n];
-				bool is_inserted = false;
-				for (auto cur = f; cur; cur = cur->next) {
-					if (is_equal(value_traits::get_key(cur->value), value_traits::get_key(first->value))) {
-						tmp->next = cur->next;
-						cur->next = tmp;
-						is_inserted = true;
-						break;
-					}
-				}
-				if (!is_inserted) {
-					tmp->next = f;
-					bucket[n] = tmp;
-				}
+		for (size_type i = 0; i < bucket_size_; ++i) {
+			for (auto first = buckets_[i]; first; ) {
+				auto next = first->next;
+				link_node(bucket, bucket_count, first);
+				first = next;
 			}
 		}
 	}
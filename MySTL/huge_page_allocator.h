@@ -0,0 +1,161 @@
+﻿#ifndef MYSTL_HUGE_PAGE_ALLOCATOR_H_
+#define MYSTL_HUGE_PAGE_ALLOCATOR_H_
+
+// 这个头文件包含一个模板类 huge_page_allocator
+// huge_page_allocator : 大块内存直接用 mmap 申请并映射为 2MB 大页，可选 NUMA 放置策略
+
+// notes:
+//
+// 1. 不小于 MYSTL_HUGE_PAGE_THRESHOLD 字节的申请按 2MB 对齐、按 2MB 取整后 mmap，
+//    并以 madvise(MADV_HUGEPAGE) 建议内核用透明大页映射；更小的申请交给 mystl::allocator
+// 2. MYSTL_HUGE_PAGE_HUGETLB 为 1 时先尝试 MAP_HUGETLB 显式大页，大页池不足时退回透明大页
+// 3. deallocate 按元素个数判断内存来源并计算映射长度，必须传入与 allocate 相同的 n
+// 4. NUMA 放置由模板参数指定：
+//      numa_policy::none        : 由内核默认策略决定，页面落在首次访问它的线程所在的节点
+//      numa_policy::first_touch : allocate 时由当前线程逐页写入，页面全部落在申请线程所在的节点
+//      numa_policy::interleave  : 页面在所有节点间轮流分配
+//      numa_policy::bind        : 页面只在 Node 号节点上分配
+//    interleave / bind 通过 mbind 系统调用设置，失败时忽略，不影响分配结果
+// 5. 非 Linux 平台上等同于 mystl::allocator
+// 6. 作为 vector / deque 的最后一个模板参数使用，例如 vector<double, vector_growth_half, huge_page_allocator<double>>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "allocator.h"
+
+#ifndef MYSTL_HUGE_PAGE_THRESHOLD
+#define MYSTL_HUGE_PAGE_THRESHOLD (2 << 20)
+#endif
+
+#ifndef MYSTL_HUGE_PAGE_HUGETLB
+#define MYSTL_HUGE_PAGE_HUGETLB 0
+#endif
+
+namespace mystl
+{
+
+static constexpr size_t kHugePageSize = 2 << 20;
+
+// 大块内存的 NUMA 放置策略
+enum class numa_policy { none, first_touch, interleave, bind };
+
+// 大页内存的映射与释放，与元素类型无关
+struct huge_page_region
+{
+	// 映射长度，按大页取整
+	static size_t length(size_t bytes) {
+		return (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+	}
+
+#if defined(__linux__)
+	// 映射 len 字节(已按大页取整)，起点按大页对齐
+	static void* map(size_t len, numa_policy policy, unsigned node) {
+#if MYSTL_HUGE_PAGE_HUGETLB && defined(MAP_HUGETLB)
+		void* huge = ::mmap(nullptr, len, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (huge != MAP_FAILED) {
+			place(huge, len, policy, node);
+			return huge;
+		}
+#endif
+		// 多映射一个大页，截掉首尾使起点按大页对齐，透明大页只作用于对齐的 2MB 区间
+		const size_t over = len + kHugePageSize;
+		void* raw = ::mmap(nullptr, over, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (raw == MAP_FAILED)
+			throw std::bad_alloc();
+		char* first = static_cast<char*>(raw);
+		char* p = first + (kHugePageSize - reinterpret_cast<uintptr_t>(first) % kHugePageSize) % kHugePageSize;
+		if (p != first)
+			::munmap(first, static_cast<size_t>(p - first));
+		const size_t tail = static_cast<size_t>(first + over - (p + len));
+		if (tail != 0)
+			::munmap(p + len, tail);
+#ifdef MADV_HUGEPAGE
+		::madvise(p, len, MADV_HUGEPAGE);
+#endif
+		place(p, len, policy, node);
+		return p;
+	}
+
+	static void unmap(void* p, size_t len) {
+		::munmap(p, len);
+	}
+
+	// 按 NUMA 策略放置 [p, p + len)，必须在页面被访问之前调用
+	static void place(void* p, size_t len, numa_policy policy, unsigned node) {
+#if defined(SYS_mbind)
+		if (policy == numa_policy::interleave || policy == numa_policy::bind) {
+			const int mode = policy == numa_policy::bind ? 2 /* MPOL_BIND */ : 3 /* MPOL_INTERLEAVE */;
+			const unsigned long mask = policy == numa_policy::bind ? 1UL << node : ~0UL;
+			::syscall(SYS_mbind, p, len, mode, &mask, sizeof(mask) * 8 + 1, 0);
+		}
+#endif
+		if (policy == numa_policy::first_touch) {
+			const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+			volatile char* c = static_cast<volatile char*>(p);
+			for (size_t off = 0; off < len; off += page)
+				c[off] = 0;
+		}
+	}
+#endif // __linux__
+};
+
+// 模板类：huge_page_allocator
+// 模板参数 T 代表数据类型，Policy 代表 NUMA 放置策略，Node 代表 numa_policy::bind 时的节点编号
+// 对象的构造、析构沿用 mystl::allocator
+template <typename T, numa_policy Policy = numa_policy::none, unsigned Node = 0>
+class huge_page_allocator : public mystl::allocator<T>
+{
+	static_assert(Node < sizeof(unsigned long) * 8, "NUMA node out of range for huge_page_allocator");
+
+public:
+	typedef typename mystl::allocator<T>::size_type size_type;
+
+public:
+	// n 个元素是否由大页内存提供
+	static bool use_huge_page(size_type n) {
+#if defined(__linux__)
+		return n * sizeof(T) >= MYSTL_HUGE_PAGE_THRESHOLD;
+#else
+		return false;
+#endif
+	}
+
+	static T* allocate(size_type n = 1);
+	static void deallocate(T* ptr, size_type n = 0);
+};
+
+template <typename T, numa_policy Policy, unsigned Node>
+T* huge_page_allocator<T, Policy, Node>::allocate(size_type n)
+{
+#if defined(__linux__)
+	if (use_huge_page(n))
+		return static_cast<T*>(huge_page_region::map(huge_page_region::length(n * sizeof(T)), Policy, Node));
+#endif
+	return mystl::allocator<T>::allocate(n);
+}
+
+template <typename T, numa_policy Policy, unsigned Node>
+void huge_page_allocator<T, Policy, Node>::deallocate(T* ptr, size_type n)
+{
+	if (ptr == nullptr)
+		return;
+#if defined(__linux__)
+	if (use_huge_page(n)) {
+		huge_page_region::unmap(ptr, huge_page_region::length(n * sizeof(T)));
+		return;
+	}
+#endif
+	mystl::allocator<T>::deallocate(ptr, n);
+}
+
+} // namespace mystl
+#endif // !MYSTL_HUGE_PAGE_ALLOCATOR_H_
@@ -0,0 +1,916 @@
+﻿#ifndef MYSTL_INTRUSIVE_H_
+#define MYSTL_INTRUSIVE_H_
+
+// 这个头文件包含两个模板类 intrusive_list 和 intrusive_set
+// intrusive_list : 侵入式双向链表，链接部分(挂钩)嵌在元素自身中
+// intrusive_set  : 侵入式红黑树集合，键值不允许重复
+
+// notes:
+//
+// 1. 容器不拥有元素，也不复制元素：插入时只把元素中的挂钩链入容器，删除时只把挂钩摘下，
+//    任何插入、删除操作都不会申请或释放内存。元素的生命周期由使用者管理，元素必须比它所在的容器活得久。
+// 2. 元素类型 T 以成员的形式嵌入挂钩，模板参数为指向该成员的指针，例如 intrusive_list<T, &T::hook>。
+//    一个元素可以有多个挂钩，从而同时位于多个容器中；同一个挂钩同一时刻只能位于一个容器中。
+// 3. intrusive_list_hook 复用 list 的节点链接部分 list_node_base，intrusive_set_hook 复用 rb_tree 的
+//    节点链接部分 rb_tree_node_base，以及 rb_tree_insert_rebalance / rb_tree_erase_rebalance。
+// 4. 已知元素时可以直接从元素找到它在容器中的位置(iterator_to)，按元素删除时
+//    intrusive_list 为 O(1)，intrusive_set 为 O(log n)，都不需要查找。
+// 5. 挂钩被复制时不复制链接关系，复制出的元素不在任何容器中；容器被清空或析构时会摘下所有挂钩。
+// 6. 容器不可复制，只能移动或交换。
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "functional.h"
+#include "iterator.h"
+#include "list.h"
+#include "rb_tree.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 挂钩复用 list、rb_tree 的节点链接部分时所用的占位类型
+struct intrusive_hook_tag {};
+
+// intrusive_list 的挂钩
+struct intrusive_list_hook :public list_node_base<intrusive_hook_tag> {
+	intrusive_list_hook() noexcept { prev = next = nullptr; }
+	intrusive_list_hook(const intrusive_list_hook&) noexcept { prev = next = nullptr; }
+	intrusive_list_hook& operator=(const intrusive_list_hook&) noexcept { return *this; }
+
+	// 是否位于某个容器中
+	bool is_linked() const noexcept { return next != nullptr; }
+};
+
+// intrusive_set 的挂钩
+struct intrusive_set_hook :public rb_tree_node_base<intrusive_hook_tag> {
+	intrusive_set_hook() noexcept { reset(); }
+	intrusive_set_hook(const intrusive_set_hook&) noexcept { reset(); }
+	intrusive_set_hook& operator=(const intrusive_set_hook&) noexcept { return *this; }
+
+	// 是否位于某个容器中，链入树中的节点父节点指针总不为空
+	bool is_linked() const noexcept { return parent_color != 0; }
+
+	void reset() noexcept {
+		parent_color = 0;
+		left = right = nullptr;
+	}
+};
+
+// 由挂钩成员指针在元素与挂钩之间相互转换
+template <typename T, typename Hook, Hook T::*Member>
+struct intrusive_member_traits {
+	static Hook* to_hook(T& value) noexcept {
+		return &(value.*Member);
+	}
+
+	static T* to_value(Hook* hook) noexcept {
+		return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - offset());
+	}
+
+	// 挂钩在 T 中的偏移，在一块未构造的存储上计算成员地址，不会访问其内容
+	static ptrdiff_t offset() noexcept {
+		static const typename std::aligned_storage<sizeof(T), alignof(T)>::type storage = {};
+		const T* p = reinterpret_cast<const T*>(&storage);
+		return reinterpret_cast<const char*>(&(p->*Member)) - reinterpret_cast<const char*>(p);
+	}
+};
+
+/*****************************************************************************************/
+// intrusive_list
+
+template <typename T, intrusive_list_hook T::*Hook> struct intrusive_list_const_iterator;
+
+// 侵入式链表迭代器
+template <typename T, intrusive_list_hook T::*Hook>
+struct intrusive_list_iterator :public mystl::iterator<mystl::bidirectional_iterator_tag, T> {
+	typedef T                                                  value_type;
+	typedef T*                                                 pointer;
+	typedef T&                                                 reference;
+	typedef list_node_base<intrusive_hook_tag>*                base_ptr;
+	typedef intrusive_member_traits<T, intrusive_list_hook, Hook> member_traits;
+	typedef intrusive_list_iterator<T, Hook>                   self;
+
+	base_ptr node_;  // 指向当前元素的挂钩
+
+	// 构造函数
+	intrusive_list_iterator() :node_(nullptr) {}
+	explicit intrusive_list_iterator(base_ptr x) :node_(x) {}
+
+	// 重载操作符
+	reference operator*() const {
+		MYSTL_DEBUG(node_ != nullptr);
+		return *member_traits::to_value(static_cast<intrusive_list_hook*>(node_));
+	}
+	pointer operator->() const {
+		return &(operator*());
+	}
+
+	self& operator++() {
+		node_ = node_->next;
+		return *this;
+	}
+	self operator++(int) {
+		self tmp = *this;
+		++*this;
+		return tmp;
+	}
+	self& operator--() {
+		node_ = node_->prev;
+		return *this;
+	}
+	self operator--(int) {
+		self tmp = *this;
+		--*this;
+		return tmp;
+	}
+
+	bool operator==(const self& rhs) const { return node_ == rhs.node_; }
+	bool operator!=(const self& rhs) const { return node_ != rhs.node_; }
+};
+
+// 侵入式链表常量迭代器
+template <typename T, intrusive_list_hook T::*Hook>
+struct intrusive_list_const_iterator :public mystl::iterator<mystl::bidirectional_iterator_tag, T> {
+	typedef T                                                  value_type;
+	typedef const T*                                           pointer;
+	typedef const T&                                           reference;
+	typedef list_node_base<intrusive_hook_tag>*                base_ptr;
+	typedef intrusive_member_traits<T, intrusive_list_hook, Hook> member_traits;
+	typedef intrusive_list_const_iterator<T, Hook>             self;
+
+	base_ptr node_;  // 指向当前元素的挂钩
+
+	// 构造函数
+	intrusive_list_const_iterator() :node_(nullptr) {}
+	explicit intrusive_list_const_iterator(base_ptr x) :node_(x) {}
+	intrusive_list_const_iterator(const intrusive_list_iterator<T, Hook>& rhs) :node_(rhs.node_) {}
+
+	// 重载操作符
+	reference operator*() const {
+		MYSTL_DEBUG(node_ != nullptr);
+		return *member_traits::to_value(static_cast<intrusive_list_hook*>(node_));
+	}
+	pointer operator->() const {
+		return &(operator*());
+	}
+
+	self& operator++() {
+		node_ = node_->next;
+		return *this;
+	}
+	self operator++(int) {
+		self tmp = *this;
+		++*this;
+		return tmp;
+	}
+	self& operator--() {
+		node_ = node_->prev;
+		return *this;
+	}
+	self operator--(int) {
+		self tmp = *this;
+		--*this;
+		return tmp;
+	}
+
+	bool operator==(const self& rhs) const { return node_ == rhs.node_; }
+	bool operator!=(const self& rhs) const { return node_ != rhs.node_; }
+};
+
+// 模板类 intrusive_list
+// 参数一代表元素类型，参数二代表元素中 intrusive_list_hook 成员的指针
+template <typename T, intrusive_list_hook T::*Hook>
+class intrusive_list {
+public:
+	// intrusive_list 的嵌套型别定义
+	typedef T                                                  value_type;
+	typedef T*                                                 pointer;
+	typedef const T*                                           const_pointer;
+	typedef T&                                                 reference;
+	typedef const T&                                           const_reference;
+	typedef size_t                                             size_type;
+	typedef ptrdiff_t                                          difference_type;
+
+	typedef list_node_base<intrusive_hook_tag>                 base_type;
+	typedef list_node_base<intrusive_hook_tag>*                base_ptr;
+	typedef intrusive_member_traits<T, intrusive_list_hook, Hook> member_traits;
+
+	typedef intrusive_list_iterator<T, Hook>                   iterator;
+	typedef intrusive_list_const_iterator<T, Hook>             const_iterator;
+	typedef mystl::reverse_iterator<iterator>                  reverse_iterator;
+	typedef mystl::reverse_iterator<const_iterator>            const_reverse_iterator;
+
+private:
+	base_type node_;  // 头节点，end() 所在的位置
+	size_type size_;  // 元素个数
+
+public:
+	// 构造、移动、析构函数
+	intrusive_list() noexcept
+	{ reset(); }
+
+	intrusive_list(const intrusive_list&) = delete;
+	intrusive_list& operator=(const intrusive_list&) = delete;
+
+	intrusive_list(intrusive_list&& rhs) noexcept
+	{ reset(); swap(rhs); }
+
+	intrusive_list& operator=(intrusive_list&& rhs) noexcept {
+		if (this != &rhs) {
+			clear();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	~intrusive_list() { clear(); }
+
+public:
+	// 迭代器相关操作
+
+	iterator               begin()         noexcept
+	{ return iterator(node_.next); }
+	const_iterator         begin()   const noexcept
+	{ return const_iterator(node_.next); }
+	iterator               end()           noexcept
+	{ return iterator(header()); }
+	const_iterator         end()     const noexcept
+	{ return const_iterator(header()); }
+
+	reverse_iterator       rbegin()        noexcept
+	{ return reverse_iterator(end()); }
+	const_reverse_iterator rbegin()  const noexcept
+	{ return const_reverse_iterator(end()); }
+	reverse_iterator       rend()          noexcept
+	{ return reverse_iterator(begin()); }
+	const_reverse_iterator rend()    const noexcept
+	{ return const_reverse_iterator(begin()); }
+
+	const_iterator         cbegin()  const noexcept
+	{ return begin(); }
+	const_iterator         cend()    const noexcept
+	{ return end(); }
+
+	// 由元素得到指向它的迭代器，元素必须位于本容器中
+	iterator               iterator_to(reference value)             noexcept
+	{ return iterator(member_traits::to_hook(value)); }
+	const_iterator         iterator_to(const_reference value) const noexcept
+	{ return const_iterator(member_traits::to_hook(const_cast<reference>(value))); }
+
+	// 容量相关操作
+
+	bool      empty()    const noexcept { return size_ == 0; }
+	size_type size()     const noexcept { return size_; }
+	size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+	// 访问元素相关操作
+
+	reference       front()
+	{
+		MYSTL_DEBUG(!empty());
+		return *begin();
+	}
+	const_reference front() const
+	{
+		MYSTL_DEBUG(!empty());
+		return *begin();
+	}
+	reference       back()
+	{
+		MYSTL_DEBUG(!empty());
+		return *iterator(node_.prev);
+	}
+	const_reference back()  const
+	{
+		MYSTL_DEBUG(!empty());
+		return *const_iterator(node_.prev);
+	}
+
+	// 插入删除相关操作，元素插入前不能位于任何容器中
+
+	void     push_front(reference value) noexcept
+	{ insert(begin(), value); }
+	void     push_back(reference value)  noexcept
+	{ insert(end(), value); }
+
+	void     pop_front() noexcept
+	{
+		MYSTL_DEBUG(!empty());
+		erase(begin());
+	}
+	void     pop_back()  noexcept
+	{
+		MYSTL_DEBUG(!empty());
+		erase(iterator(node_.prev));
+	}
+
+	iterator insert(const_iterator pos, reference value) noexcept;
+
+	iterator erase(const_iterator pos) noexcept;
+	iterator erase(const_iterator first, const_iterator last) noexcept;
+
+	// 把 value 从本容器中摘下，O(1)
+	void     erase(reference value) noexcept
+	{ erase(iterator_to(value)); }
+
+	void     clear() noexcept;
+
+	// intrusive_list 相关操作
+
+	void     splice(const_iterator pos, intrusive_list& other) noexcept;
+	void     splice(const_iterator pos, intrusive_list& other, const_iterator it) noexcept;
+
+	void     swap(intrusive_list& rhs) noexcept;
+
+private:
+	// helper functions
+
+	base_ptr header() const noexcept
+	{ return const_cast<base_ptr>(&node_); }
+
+	void reset() noexcept {
+		node_.unlink();
+		size_ = 0;
+	}
+
+	// 在 pos 之前链接 [first, last] 结点
+	static void link_nodes(base_ptr pos, base_ptr first, base_ptr last) noexcept {
+		pos->prev->next = first;
+		first->prev = pos->prev;
+		pos->prev = last;
+		last->next = pos;
+	}
+
+	// 断开 [first, last] 结点
+	static void unlink_nodes(base_ptr first, base_ptr last) noexcept {
+		first->prev->next = last->next;
+		last->next->prev = first->prev;
+	}
+};
+
+/*****************************************************************************************/
+
+// 在 pos 之前插入 value
+template <typename T, intrusive_list_hook T::*Hook>
+typename intrusive_list<T, Hook>::iterator
+intrusive_list<T, Hook>::
+insert(const_iterator pos, reference value) noexcept {
+	intrusive_list_hook* hook = member_traits::to_hook(value);
+	MYSTL_DEBUG(!hook->is_linked());
+	link_nodes(pos.node_, hook, hook);
+	++size_;
+	return iterator(hook);
+}
+
+// 摘下 pos 处的元素
+template <typename T, intrusive_list_hook T::*Hook>
+typename intrusive_list<T, Hook>::iterator
+intrusive_list<T, Hook>::
+erase(const_iterator pos) noexcept {
+	MYSTL_DEBUG(pos != cend());
+	base_ptr n = pos.node_;
+	base_ptr next = n->next;
+	unlink_nodes(n, n);
+	n->prev = n->next = nullptr;
+	--size_;
+	return iterator(next);
+}
+
+// 摘下 [first, last) 内的元素
+template <typename T, intrusive_list_hook T::*Hook>
+typename intrusive_list<T, Hook>::iterator
+intrusive_list<T, Hook>::
+erase(const_iterator first, const_iterator last) noexcept {
+	while (first != last)
+		first = erase(first);
+	return iterator(last.node_);
+}
+
+// 摘下所有元素
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::
+clear() noexcept {
+	base_ptr cur = node_.next;
+	while (cur != header()) {
+		base_ptr next = cur->next;
+		cur->prev = cur->next = nullptr;
+		cur = next;
+	}
+	reset();
+}
+
+// 将 other 的全部元素接合于 pos 之前
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::
+splice(const_iterator pos, intrusive_list& other) noexcept {
+	if (this == &other || other.empty())
+		return;
+	base_ptr first = other.node_.next;
+	base_ptr last = other.node_.prev;
+	other.unlink_nodes(first, last);
+	link_nodes(pos.node_, first, last);
+	size_ += other.size_;
+	other.size_ = 0;
+}
+
+// 将 other 中 it 所指的元素接合于 pos 之前
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::
+splice(const_iterator pos, intrusive_list& other, const_iterator it) noexcept {
+	if (pos.node_ == it.node_ || pos.node_ == it.node_->next)
+		return;
+	base_ptr n = it.node_;
+	other.unlink_nodes(n, n);
+	link_nodes(pos.node_, n, n);
+	++size_;
+	--other.size_;
+}
+
+// 交换两个 intrusive_list，头节点嵌在容器中，交换后需要让首尾元素重新指向各自的头节点
+template <typename T, intrusive_list_hook T::*Hook>
+void intrusive_list<T, Hook>::
+swap(intrusive_list& rhs) noexcept {
+	if (this == &rhs)
+		return;
+	mystl::swap(node_.prev, rhs.node_.prev);
+	mystl::swap(node_.next, rhs.node_.next);
+	mystl::swap(size_, rhs.size_);
+	if (size_ == 0) {
+		node_.unlink();
+	} else {
+		node_.next->prev = header();
+		node_.prev->next = header();
+	}
+	if (rhs.size_ == 0) {
+		rhs.node_.unlink();
+	} else {
+		rhs.node_.next->prev = rhs.header();
+		rhs.node_.prev->next = rhs.header();
+	}
+}
+
+// 重载 mystl 的 swap
+template <typename T, intrusive_list_hook T::*Hook>
+void swap(intrusive_list<T, Hook>& lhs, intrusive_list<T, Hook>& rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+/*****************************************************************************************/
+// intrusive_set
+
+template <typename T, intrusive_set_hook T::*Hook> struct intrusive_set_const_iterator;
+
+// 侵入式集合迭代器，前进、后退复用 rb_tree 迭代器的实现
+template <typename T, intrusive_set_hook T::*Hook>
+struct intrusive_set_iterator :public rb_tree_iterator_base<intrusive_hook_tag> {
+	typedef mystl::bidirectional_iterator_tag                  iterator_category;
+	typedef T                                                  value_type;
+	typedef T*                                                 pointer;
+	typedef T&                                                 reference;
+	typedef ptrdiff_t                                          difference_type;
+	typedef rb_tree_node_base<intrusive_hook_tag>*             base_ptr;
+	typedef intrusive_member_traits<T, intrusive_set_hook, Hook> member_traits;
+	typedef intrusive_set_iterator<T, Hook>                    self;
+
+	// 构造函数
+	intrusive_set_iterator() {}
+	explicit intrusive_set_iterator(base_ptr x) { node = x; }
+
+	// 重载操作符
+	reference operator*() const {
+		return *member_traits::to_value(static_cast<intrusive_set_hook*>(node));
+	}
+	pointer operator->() const {
+		return &(operator*());
+	}
+
+	self& operator++() {
+		this->inc();
+		return *this;
+	}
+	self operator++(int) {
+		self tmp(*this);
+		this->inc();
+		return tmp;
+	}
+	self& operator--() {
+		this->dec();
+		return *this;
+	}
+	self operator--(int) {
+		self tmp(*this);
+		this->dec();
+		return tmp;
+	}
+
+	bool operator==(const self& rhs) const { return node == rhs.node; }
+	bool operator!=(const self& rhs) const { return node != rhs.node; }
+};
+
+// 侵入式集合常量迭代器
+template <typename T, intrusive_set_hook T::*Hook>
+struct intrusive_set_const_iterator :public rb_tree_iterator_base<intrusive_hook_tag> {
+	typedef mystl::bidirectional_iterator_tag                  iterator_category;
+	typedef T                                                  value_type;
+	typedef const T*                                           pointer;
+	typedef const T&                                           reference;
+	typedef ptrdiff_t                                          difference_type;
+	typedef rb_tree_node_base<intrusive_hook_tag>*             base_ptr;
+	typedef intrusive_member_traits<T, intrusive_set_hook, Hook> member_traits;
+	typedef intrusive_set_const_iterator<T, Hook>              self;
+
+	// 构造函数
+	intrusive_set_const_iterator() {}
+	explicit intrusive_set_const_iterator(base_ptr x) { node = x; }
+	intrusive_set_const_iterator(const intrusive_set_iterator<T, Hook>& rhs) { node = rhs.node; }
+
+	// 重载操作符
+	reference operator*() const {
+		return *member_traits::to_value(static_cast<intrusive_set_hook*>(node));
+	}
+	pointer operator->() const {
+		return &(operator*());
+	}
+
+	self& operator++() {
+		this->inc();
+		return *this;
+	}
+	self operator++(int) {
+		self tmp(*this);
+		this->inc();
+		return tmp;
+	}
+	self& operator--() {
+		this->dec();
+		return *this;
+	}
+	self operator--(int) {
+		self tmp(*this);
+		this->dec();
+		return tmp;
+	}
+
+	bool operator==(const self& rhs) const { return node == rhs.node; }
+	bool operator!=(const self& rhs) const { return node != rhs.node; }
+};
+
+// 模板类 intrusive_set
+// 参数一代表元素类型，参数二代表元素中 intrusive_set_hook 成员的指针，参数三代表元素的比较方式
+template <typename T, intrusive_set_hook T::*Hook, typename Compare = mystl::less<T>>
+class intrusive_set {
+public:
+	// intrusive_set 的嵌套型别定义
+	typedef T                                                  key_type;
+	typedef T                                                  value_type;
+	typedef T*                                                 pointer;
+	typedef const T*                                           const_pointer;
+	typedef T&                                                 reference;
+	typedef const T&                                           const_reference;
+	typedef size_t                                             size_type;
+	typedef ptrdiff_t                                          difference_type;
+	typedef Compare                                            key_compare;
+	typedef Compare                                            value_compare;
+
+	typedef rb_tree_node_base<intrusive_hook_tag>              base_type;
+	typedef rb_tree_node_base<intrusive_hook_tag>*             base_ptr;
+	typedef intrusive_member_traits<T, intrusive_set_hook, Hook> member_traits;
+
+	typedef intrusive_set_iterator<T, Hook>                    iterator;
+	typedef intrusive_set_const_iterator<T, Hook>              const_iterator;
+	typedef mystl::reverse_iterator<iterator>                  reverse_iterator;
+	typedef mystl::reverse_iterator<const_iterator>            const_reverse_iterator;
+
+	key_compare   key_comp()   const { return comp_; }
+	value_compare value_comp() const { return comp_; }
+
+private:
+	// 用以下三个数据表现 intrusive_set，header_ 的含义与 rb_tree 中的相同
+	base_type   header_;      // 特殊节点，与根节点互为对方的父节点
+	size_type   node_count_;  // 元素个数
+	key_compare comp_;        // 元素比较的准则
+
+	base_ptr  header()    const { return const_cast<base_ptr>(&header_); }
+	base_ptr  root()      const { return header_.parent(); }
+	void      set_root(base_ptr x) { header_.set_parent(x); }
+	base_ptr& leftmost()  { return header_.left; }
+	base_ptr& rightmost() { return header_.right; }
+
+public:
+	// 构造、移动、析构函数
+	intrusive_set() :comp_()
+	{ reset(); }
+
+	explicit intrusive_set(const key_compare& comp) :comp_(comp)
+	{ reset(); }
+
+	intrusive_set(const intrusive_set&) = delete;
+	intrusive_set& operator=(const intrusive_set&) = delete;
+
+	intrusive_set(intrusive_set&& rhs) noexcept :comp_(rhs.comp_)
+	{ reset(); swap(rhs); }
+
+	intrusive_set& operator=(intrusive_set&& rhs) noexcept {
+		if (this != &rhs) {
+			clear();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	~intrusive_set() { clear(); }
+
+public:
+	// 迭代器相关操作
+
+	iterator               begin()         noexcept
+	{ return iterator(header_.left); }
+	const_iterator         begin()   const noexcept
+	{ return const_iterator(header_.left); }
+	iterator               end()           noexcept
+	{ return iterator(header()); }
+	const_iterator         end()     const noexcept
+	{ return const_iterator(header()); }
+
+	reverse_iterator       rbegin()        noexcept
+	{ return reverse_iterator(end()); }
+	const_reverse_iterator rbegin()  const noexcept
+	{ return const_reverse_iterator(end()); }
+	reverse_iterator       rend()          noexcept
+	{ return reverse_iterator(begin()); }
+	const_reverse_iterator rend()    const noexcept
+	{ return const_reverse_iterator(begin()); }
+
+	const_iterator         cbegin()  const noexcept
+	{ return begin(); }
+	const_iterator         cend()    const noexcept
+	{ return end(); }
+
+	// 由元素得到指向它的迭代器，元素必须位于本容器中
+	iterator               iterator_to(reference value)             noexcept
+	{ return iterator(member_traits::to_hook(value)); }
+	const_iterator         iterator_to(const_reference value) const noexcept
+	{ return const_iterator(member_traits::to_hook(const_cast<reference>(value))); }
+
+	// 容量相关操作
+
+	bool      empty()    const noexcept { return node_count_ == 0; }
+	size_type size()     const noexcept { return node_count_; }
+	size_type max_size() const noexcept { return static_cast<size_type>(-1); }
+
+	// 插入删除相关操作，元素插入前不能位于任何容器中
+
+	// 插入 value，已有等价的元素时不插入，返回指向该元素的迭代器和 false
+	mystl::pair<iterator, bool> insert(reference value);
+
+	iterator  erase(const_iterator pos) noexcept;
+	iterator  erase(const_iterator first, const_iterator last) noexcept;
+
+	// 把 value 从本容器中摘下，O(log n)，不需要查找
+	void      erase(reference value) noexcept
+	{ erase(iterator_to(value)); }
+
+	void      clear() noexcept;
+
+	// intrusive_set 相关操作
+
+	iterator       find(const key_type& key)              { return iterator(find_node(key)); }
+	const_iterator find(const key_type& key)        const { return const_iterator(find_node(key)); }
+	size_type      count(const key_type& key)       const { return find_node(key) != header() ? 1 : 0; }
+	iterator       lower_bound(const key_type& key)       { return iterator(lower_bound_node(key)); }
+	const_iterator lower_bound(const key_type& key) const { return const_iterator(lower_bound_node(key)); }
+	iterator       upper_bound(const key_type& key)       { return iterator(upper_bound_node(key)); }
+	const_iterator upper_bound(const key_type& key) const { return const_iterator(upper_bound_node(key)); }
+
+	// 透明查找，只在 key_compare 定义了 is_transparent 时参与重载，key 可以是任意能与元素比较的类型
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       find(const K& key)                     { return iterator(find_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator find(const K& key)               const { return const_iterator(find_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	size_type      count(const K& key)              const { return find_node(key) != header() ? 1 : 0; }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       lower_bound(const K& key)              { return iterator(lower_bound_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator lower_bound(const K& key)        const { return const_iterator(lower_bound_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       upper_bound(const K& key)              { return iterator(upper_bound_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator upper_bound(const K& key)        const { return const_iterator(upper_bound_node(key)); }
+
+	void swap(intrusive_set& rhs) noexcept;
+
+private:
+	// helper functions
+
+	void reset() noexcept {
+		header_.parent_color = 0;
+		header_.set_color(rb_tree_red);  // header_ 节点颜色为红，与 root 区分
+		leftmost() = header();
+		rightmost() = header();
+		node_count_ = 0;
+	}
+
+	// 令 header_ 的左右指针和根节点的父节点重新指向本容器的 header_
+	void adopt() noexcept {
+		if (node_count_ == 0) {
+			reset();
+		} else {
+			root()->set_parent(header());
+		}
+	}
+
+	static const T& value_of(base_ptr x) {
+		return *member_traits::to_value(static_cast<intrusive_set_hook*>(x));
+	}
+
+	template <typename K>
+	base_ptr  find_node(const K& key) const;
+	template <typename K>
+	base_ptr  lower_bound_node(const K& key) const;
+	template <typename K>
+	base_ptr  upper_bound_node(const K& key) const;
+};
+
+/*****************************************************************************************/
+
+// 插入 value，查找插入位置的方式与 rb_tree::get_insert_unique_pos 相同
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+mystl::pair<typename intrusive_set<T, Hook, Compare>::iterator, bool>
+intrusive_set<T, Hook, Compare>::
+insert(reference value) {
+	intrusive_set_hook* hook = member_traits::to_hook(value);
+	MYSTL_DEBUG(!hook->is_linked());
+	base_ptr x = root();
+	base_ptr y = header();
+	bool add_to_left = true;
+	while (x != nullptr) {
+		y = x;
+		add_to_left = comp_(value, value_of(x));
+		x = add_to_left ? x->left : x->right;
+	}
+	iterator j(y);  // 此时 y 为插入点的父节点
+	bool unique = true;
+	if (add_to_left && y != header() && y != leftmost())
+		--j;  // 如果存在等价的元素，那么 --j 就是它
+	if (!add_to_left || (y != header() && y != leftmost()))
+		unique = comp_(*j, value);
+	if (!unique)
+		return mystl::make_pair(j, false);
+
+	base_ptr z = hook;
+	z->parent_color = 0;
+	z->left = z->right = nullptr;
+	z->set_parent(y);
+	if (y == header()) {
+		set_root(z);
+		leftmost() = z;
+		rightmost() = z;
+	} else if (add_to_left) {
+		y->left = z;
+		if (leftmost() == y)
+			leftmost() = z;
+	} else {
+		y->right = z;
+		if (rightmost() == y)
+			rightmost() = z;
+	}
+	base_ptr r = root();
+	rb_tree_insert_rebalance(z, r);
+	set_root(r);
+	++node_count_;
+	return mystl::make_pair(iterator(z), true);
+}
+
+// 摘下 pos 处的元素
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+typename intrusive_set<T, Hook, Compare>::iterator
+intrusive_set<T, Hook, Compare>::
+erase(const_iterator pos) noexcept {
+	MYSTL_DEBUG(pos != cend());
+	iterator next(pos.node);
+	++next;
+	base_ptr r = root();
+	rb_tree_erase_rebalance(pos.node, r, leftmost(), rightmost());
+	set_root(r);
+	static_cast<intrusive_set_hook*>(pos.node)->reset();
+	--node_count_;
+	if (node_count_ == 0)
+		reset();
+	return next;
+}
+
+// 摘下 [first, last) 内的元素
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+typename intrusive_set<T, Hook, Compare>::iterator
+intrusive_set<T, Hook, Compare>::
+erase(const_iterator first, const_iterator last) noexcept {
+	if (first == begin() && last == end()) {
+		clear();
+		return end();
+	}
+	while (first != last)
+		first = erase(first);
+	return iterator(last.node);
+}
+
+// 摘下所有元素，自底向上逐个复位挂钩，不需要重新平衡
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+void intrusive_set<T, Hook, Compare>::
+clear() noexcept {
+	base_ptr x = root();
+	while (x != nullptr) {
+		if (x->left != nullptr) {
+			x = x->left;
+		} else if (x->right != nullptr) {
+			x = x->right;
+		} else {
+			base_ptr p = x == root() ? nullptr : x->parent();
+			if (p != nullptr) {
+				if (p->left == x)
+					p->left = nullptr;
+				else
+					p->right = nullptr;
+			}
+			static_cast<intrusive_set_hook*>(x)->reset();
+			x = p;
+		}
+	}
+	reset();
+}
+
+// 交换两个 intrusive_set，头节点嵌在容器中，交换后需要让根节点重新指向各自的头节点
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+void intrusive_set<T, Hook, Compare>::
+swap(intrusive_set& rhs) noexcept {
+	if (this == &rhs)
+		return;
+	mystl::swap(header_.parent_color, rhs.header_.parent_color);
+	mystl::swap(header_.left, rhs.header_.left);
+	mystl::swap(header_.right, rhs.header_.right);
+	mystl::swap(node_count_, rhs.node_count_);
+	mystl::swap(comp_, rhs.comp_);
+	adopt();
+	rhs.adopt();
+}
+
+// 查找与 key 等价的元素，不存在时返回 header_
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+template <typename K>
+typename intrusive_set<T, Hook, Compare>::base_ptr
+intrusive_set<T, Hook, Compare>::
+find_node(const K& key) const {
+	base_ptr y = lower_bound_node(key);
+	return (y == header() || comp_(key, value_of(y))) ? header() : y;
+}
+
+// 第一个不小于 key 的元素
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+template <typename K>
+typename intrusive_set<T, Hook, Compare>::base_ptr
+intrusive_set<T, Hook, Compare>::
+lower_bound_node(const K& key) const {
+	base_ptr y = header();
+	base_ptr x = root();
+	while (x != nullptr) {
+		if (!comp_(value_of(x), key)) {
+			y = x;
+			x = x->left;
+		} else {
+			x = x->right;
+		}
+	}
+	return y;
+}
+
+// 第一个大于 key 的元素
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+template <typename K>
+typename intrusive_set<T, Hook, Compare>::base_ptr
+intrusive_set<T, Hook, Compare>::
+upper_bound_node(const K& key) const {
+	base_ptr y = header();
+	base_ptr x = root();
+	while (x != nullptr) {
+		if (comp_(key, value_of(x))) {
+			y = x;
+			x = x->left;
+		} else {
+			x = x->right;
+		}
+	}
+	return y;
+}
+
+// 重载 mystl 的 swap
+template <typename T, intrusive_set_hook T::*Hook, typename Compare>
+void swap(intrusive_set<T, Hook, Compare>& lhs, intrusive_set<T, Hook, Compare>& rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYSTL_INTRUSIVE_H_
@@ -24,6 +24,9 @@
 namespace mystl
 {
 
+// sort_by_buffer 先对每段这么多个节点指针做插入排序，再逐层归并
+constexpr static size_t kListSortRun = 16;
+
 // list_node 共有继承list_node_bace
 // list_node_base负责链表中双向指针部分
 // list_node在base的基础上扩充了数据部分
@@ -546,11 +549,21 @@ public:
     void merge(list& x, Compare comp);
 
     void sort(){
-        list_sort(begin(), end(), size(), mystl::less<T>());
+        list_sort(mystl::less<T>());
     }
     template <typename Compared>
     void sort(Compared comp) {
-        list_sort(begin(), end(), size(), comp);
+        list_sort(comp);
+    }
+
+    // 先把节点指针拷贝到连续的缓冲区中排序，再按顺序重新链接节点
+    // 适合元素较小、节点较多的链表，需要额外 2 * size() 个指针的空间
+    void sort_by_buffer() {
+        list_buffer_sort(mystl::less<T>());
+    }
+    template <typename Compared>
+    void sort_by_buffer(Compared comp) {
+        list_buffer_sort(comp);
     }
 
     void reverse();
@@ -588,7 +601,12 @@ private:
 
     // sort
     template <typename Compared>
-    iterator  list_sort(iterator first, iterator last, size_type n, Compared comp);
+    void      list_sort(Compared comp);
+    template <typename Compared>
+    void      list_buffer_sort(Compared comp);
+    template <typename Compared>
+    void      merge_chain(base_ptr& x, base_ptr& y, Compared& comp);
+    void      link_chain_at_back(base_ptr first);
 }; 
 
 
@@ -613,7 +631,7 @@ typename list<T>::iterator list<T>::erase(const_iterator first, const_iterator l
             auto cur = first.node_;
             ++ first;
             destroy_node(cur->as_node());
-            ++ size_;
+            -- size_;
         }
     }
     return iterator(last.node_);
@@ -1016,73 +1034,165 @@ list<T>::copy_insert(const_iterator pos, size_type n, Iter first) {
     return r;    
 }
 
-// 对list进行归并排序,返回一个指向区间最小元素的位置
+// 对list进行自底向上的归并排序
+// counter[i] 保存一条长度为 2^i 的有序链，新节点像二进制计数器的进位一样逐级向上合并，
+// 每个节点在每一层只被访问常数次；排序期间只维护 next 指针，结束后再统一恢复 prev 指针
 template <typename T>
-template <class Compared>
-typename list<T>::iterator
-list<T>::list_sort(iterator f1, iterator l2, size_type n, Compared comp) {
-    if(n < 2) {
-        return f1;
-    }
-    if(n == 2) {
-        if(comp(*--l2, *f1)) {  // *--l2指向第二个节点
-            auto ln = l2.node_;
-            unlink_nodes(ln, ln);   // 取出第二个节点
-            link_nodes(f1.node_, ln, ln);   // 插到第一个节点前面
-            return l2;
+template <typename Compared>
+void list<T>::list_sort(Compared comp) {
+    if(size_ < 2) {
+        return;
+    }
+    base_ptr counter[64] = {};
+    base_ptr carry = nullptr;
+    size_type fill = 0;
+    base_ptr rest = node_->next;
+    node_->prev->next = nullptr;    // 断开成以 nullptr 结尾的单链
+    try {
+        while(rest != nullptr) {
+            carry = rest;
+            rest = rest->next;
+            carry->next = nullptr;
+            size_type i = 0;
+            for(; i < fill && counter[i] != nullptr; ++ i) {
+                merge_chain(counter[i], carry, comp);   // counter[i] 中的节点在 carry 之前
+                mystl::swap(counter[i], carry);
+            }
+            counter[i] = carry;
+            carry = nullptr;
+            if(i == fill) {
+                ++ fill;
+            }
+        }
+        for(size_type i = 0; i < fill; ++ i) {
+            merge_chain(counter[i], carry, comp);
+            mystl::swap(counter[i], carry);
         }
-        return f1;
+    }catch(...) {
+        // 比较抛出异常时把所有的链重新接回链表，元素不会丢失，但顺序未定
+        node_->unlink();
+        for(size_type i = 0; i < fill; ++ i) {
+            link_chain_at_back(counter[i]);
+        }
+        link_chain_at_back(carry);
+        link_chain_at_back(rest);
+        throw;
     }
+    node_->unlink();
+    link_chain_at_back(carry);
+}
 
-    auto n2 = n / 2;
-    auto l1 = f1;
-    mystl::advance(l1, n2);     // 读到l1后第n2个节点,用于二分
-    auto result = f1 = list_sort(f1, l2, n2, comp); // 前半部分排序
-    auto f2 = l1 = list_sort(l1, l2, n - n2, comp); // 后半部分排序
-    
-
-    // 把较小的一段区间移到前面
-    if(comp(*f2, *f1)) {
-        auto m = f2;
-        ++ m;
-        for(; m != l2 && comp(*m, *f1); ++ m)
-            ;
-        auto f = f2.node_;  // 第一个小于f1的节点
-        auto l = m.node_->prev; // 最后一个小于f1的节点
-        result = f2;    
-        l1 = f2 = m;    // 左区间扩充
-        unlink_nodes(f, l); // [l,f]取消关联
-        m = f1; // 左区间头
-        ++ m;
-        link_nodes(f1.node_, f, l);
-        f1 = m; // f1之前已排好序
-    }else {
-        ++ f1;  // node_不用排
+// 把节点指针拷贝到连续的缓冲区中做稳定的归并排序，再按排好的顺序重新链接节点
+// 排序期间不修改链表，比较抛出异常时链表保持原样
+template <typename T>
+template <typename Compared>
+void list<T>::list_buffer_sort(Compared comp) {
+    if(size_ < 2) {
+        return;
+    }
+    typedef mystl::allocator<base_ptr> ptr_allocator;
+    const size_type n = size_;
+    base_ptr* src = ptr_allocator::allocate(2 * n);
+    base_ptr* dst = src + n;
+    base_ptr* buf = src;
+    try {
+        auto p = node_->next;
+        for(size_type i = 0; i < n; ++ i, p = p->next) {
+            src[i] = p;
+        }
+        // 先对每 kListSortRun 个指针做插入排序
+        for(size_type lo = 0; lo < n; lo += kListSortRun) {
+            const size_type hi = mystl::min(lo + kListSortRun, n);
+            for(size_type i = lo + 1; i < hi; ++ i) {
+                auto v = src[i];
+                auto j = i;
+                for(; j > lo && comp(v->as_node()->value, src[j - 1]->as_node()->value); -- j) {
+                    src[j] = src[j - 1];
+                }
+                src[j] = v;
+            }
+        }
+        // 再在两块缓冲区之间来回两两归并
+        for(size_type width = kListSortRun; width < n; width *= 2) {
+            for(size_type lo = 0; lo < n; lo += 2 * width) {
+                const size_type mid = mystl::min(lo + width, n);
+                const size_type hi = mystl::min(lo + 2 * width, n);
+                size_type i = lo, j = mid, k = lo;
+                while(i < mid && j < hi) {
+                    if(comp(src[j]->as_node()->value, src[i]->as_node()->value)) {
+                        dst[k++] = src[j++];
+                    }else {
+                        dst[k++] = src[i++];
+                    }
+                }
+                while(i < mid) {
+                    dst[k++] = src[i++];
+                }
+                while(j < hi) {
+                    dst[k++] = src[j++];
+                }
+            }
+            mystl::swap(src, dst);
+        }
+    }catch(...) {
+        ptr_allocator::deallocate(buf, 2 * n);
+        throw;
     }
+    base_ptr prev = node_;
+    for(size_type i = 0; i < n; ++ i) {
+        prev->next = src[i];
+        src[i]->prev = prev;
+        prev = src[i];
+    }
+    prev->next = node_;
+    node_->prev = prev;
+    ptr_allocator::deallocate(buf, 2 * n);
+}
 
-    // 合并两段有序区间
-    while(f1 != l1 && f2 != l2) {
-        if(comp(*f2, *f1)) {
-            auto m = f2;
-            ++ m;
-            for(; m != l2 && comp(*m, *f1); ++ m)
-                ;
-            auto f = f2.node_;
-            auto l = m.node_->prev;
-            if(l1 == f2) {  // 第一次排
-                l1 = m;
+// 合并两条以 nullptr 结尾的有序单链，结果存入 x，y 置空
+// 相等的元素 x 中的在前，保证排序稳定；比较抛出异常时 x 仍包含两条链的全部节点
+template <typename T>
+template <typename Compared>
+void list<T>::merge_chain(base_ptr& x, base_ptr& y, Compared& comp) {
+    list_node_base<T> head;
+    auto tail = head.self();
+    auto a = x;
+    auto b = y;
+    y = nullptr;
+    try {
+        while(a != nullptr && b != nullptr) {
+            if(comp(b->as_node()->value, a->as_node()->value)) {
+                tail->next = b;
+                tail = b;
+                b = b->next;
+            }else {
+                tail->next = a;
+                tail = a;
+                a = a->next;
             }
-            f2 = m;
-            unlink_nodes(f, l);
-            m = f1;
-            ++ m;
-            link_nodes(f1.node_, f, l);
-            f1 = m;
-        }else {
-            ++ f1;
         }
+    }catch(...) {
+        for(tail->next = a; tail->next != nullptr; tail = tail->next)
+            ;
+        tail->next = b;
+        x = head.next;
+        throw;
     }
-    return result;
+    tail->next = a != nullptr ? a : b;
+    x = head.next;
+}
+
+// 把以 nullptr 结尾的单链接到链表尾部，并恢复 prev 指针
+template <typename T>
+void list<T>::link_chain_at_back(base_ptr first) {
+    auto prev = node_->prev;
+    for(; first != nullptr; first = first->next) {
+        prev->next = first;
+        first->prev = prev;
+        prev = first;
+    }
+    prev->next = node_;
+    node_->prev = prev;
 }
 
 // 重载比较运算符
@@ -1130,6 +1240,10 @@ void swap(list<T>& lhs, list<T>& rhs) noexcept {
     lhs.swap(rhs);
 }
 
+// list 的头节点在堆上，对象本身可以按字节搬移
+template <typename T>
+struct is_trivially_relocatable<list<T>> : std::true_type {};
+
 }
 
 #endif
\ No newline at end of file
@@ -12,6 +12,13 @@
 //   * emplace
 //   * emplace_hint
 //   * insert
+//
+// 以 sorted_unique 标签构造或插入时，区间须已按键值严格升序排列，容器以线性时间自底向上建树
+//
+// merge / split / extract_range / join 以及 intersect / subtract 基于红黑树的 join 和 split，只重连节点，
+// merge 的时间复杂度为 O(m log(n / m + 1))，m、n 分别为较小、较大一方的元素个数，
+// 指向被转移元素的迭代器和引用保持有效；开启节点池(Pooled)时，拆出到新容器的元素
+// 以及 merge 留在 source 中的重复元素要逐个移动，复杂度多出 O(k) 次分配，指向它们的迭代器失效(见 rb_tree.h)
 
 #include "rb_tree.h"
 
@@ -19,8 +26,10 @@ namespace mystl
 {
 
 // 模板类 map，键值不允许重复
-// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
-template <typename Key, typename T, class Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less，
+// 参数四表示是否开启排名(子树节点数)，开启后可用 nth、rank、index_of 等，缺省不开启，
+// 参数五表示是否从节点池分配节点(见 rb_tree.h)，缺省不开启
+template <typename Key, typename T, class Compare = mystl::less<Key>, bool Ranked = false, bool Pooled = false>
 class map
 {
 public:
@@ -32,7 +41,7 @@ public:
 
     // 定义一个 functor，用来进行元素比较
     class value_compare : public binary_function <value_type, value_type, bool> {
-    	friend class map<Key, T, Compare>;
+    	friend class map<Key, T, Compare, Ranked, Pooled>;
     private:
     	Compare comp;
     	value_compare(Compare c) : comp(c) {}
@@ -44,12 +53,13 @@ public:
 
 private:
 	// 以 mystl::rb_tree 作为底层机制
-	typedef mystl::rb_tree<value_type, key_compare>  base_type;
+	typedef mystl::rb_tree<value_type, key_compare, Ranked, Pooled>  base_type;
 	base_type tree_;
 
 public:
 	// 使用 rb_tree 的型别
 	typedef typename base_type::node_type              node_type;
+	typedef typename base_type::handle_type            handle_type;
 	typedef typename base_type::pointer                pointer;
 	typedef typename base_type::const_pointer          const_pointer;
 	typedef typename base_type::reference              reference;
@@ -61,6 +71,7 @@ public:
 	typedef typename base_type::size_type              size_type;
 	typedef typename base_type::difference_type        difference_type;
 	typedef typename base_type::allocator_type         allocator_type;
+	typedef mystl::node_insert_return<iterator, handle_type> insert_return_type;
 
 public:
 	// 构造、复制、移动、赋值函数
@@ -76,6 +87,15 @@ public:
 		:tree_()
 	{ tree_.insert_unique(ilist.begin(), ilist.end()); }
 
+	template <typename InputIterator>
+	map(sorted_unique_t, InputIterator first, InputIterator last)
+		:tree_()
+	{ tree_.insert_unique_sorted(first, last); }
+
+	map(sorted_unique_t, std::initializer_list<value_type> ilist)
+		:tree_()
+	{ tree_.insert_unique_sorted(ilist.begin(), ilist.end()); }
+
 	map(const map& rhs) 
 		:tree_(rhs.tree_) 
 	{}
@@ -157,18 +177,10 @@ public:
 	}
 
 	mapped_type& operator[](const key_type& key) {
-		iterator it = lower_bound(key);
-		// it->first >= key
-		if (it == end() || key_comp()(key, it->first))
-			it = emplace_hint(it, key, T{});
-		return it->second;
+		return tree_.try_emplace_unique(key).first->second;
 	}
 	mapped_type& operator[](key_type&& key) {
-		iterator it = lower_bound(key);
-		// it->first >= key
-		if (it == end() || key_comp()(key, it->first))
-		it = emplace_hint(it, mystl::move(key), T{});
-		return it->second;
+		return tree_.try_emplace_unique(mystl::move(key)).first->second;
 	}
 
 	// 插入删除相关
@@ -183,6 +195,32 @@ public:
 		return tree_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...);
 	}
 
+	// try_emplace 先查找 key，不存在时才以 key 和 T(args...) 构造节点，已存在时不会移动 key 与 args
+	// insert_or_assign 在 key 已存在时把 obj 赋给它的实值
+	template <typename ...Args>
+	pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args) {
+		return tree_.try_emplace_unique(key, mystl::forward<Args>(args)...);
+	}
+	template <typename ...Args>
+	pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args) {
+		return tree_.try_emplace_unique(mystl::move(key), mystl::forward<Args>(args)...);
+	}
+
+	template <typename M>
+	pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+		auto res = tree_.try_emplace_unique(key, mystl::forward<M>(obj));
+		if (!res.second)
+			res.first->second = mystl::forward<M>(obj);
+		return res;
+	}
+	template <typename M>
+	pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+		auto res = tree_.try_emplace_unique(mystl::move(key), mystl::forward<M>(obj));
+		if (!res.second)
+			res.first->second = mystl::forward<M>(obj);
+		return res;
+	}
+
 	pair<iterator, bool> insert(const value_type& value) {
 		return tree_.insert_unique(value);
 	}
@@ -202,10 +240,25 @@ public:
 		tree_.insert_unique(first, last);
 	}
 
+	template <typename InputIterator>
+	void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+		tree_.insert_unique_sorted(first, last);
+	}
+
 	void      erase(iterator position)             { tree_.erase(position); }
 	size_type erase(const key_type& key)           { return tree_.erase_unique(key); }
 	void      erase(iterator first, iterator last) { tree_.erase(first, last); }
 
+	// 节点句柄，摘下的节点可以插回同类容器(包括键值允许重复的版本)，未开启节点池时不复制元素；句柄可以比源容器活得更久
+	handle_type extract(iterator position)   { return tree_.extract(position); }
+	handle_type extract(const key_type& key) { return tree_.extract(key); }
+
+	insert_return_type insert(handle_type&& nh)
+	{
+		auto res = tree_.insert_unique(mystl::move(nh));
+		return insert_return_type{ res.position, res.inserted, mystl::move(res.node) };
+	}
+
 	void      clear()                              { tree_.clear(); }
 
 	// map 相关操作
@@ -229,6 +282,63 @@ public:
 		equal_range(const key_type& key) const 
 	{ return tree_.equal_range_unique(key); }
 
+	// 透明查找，只在 key_compare 定义了 is_transparent 时参与重载，key 可以是任意能与键值比较的类型
+	// 与 key 等价的元素可能不止一个，count 与 equal_range 按键值可重复处理
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       find(const K& key)                     { return tree_.find(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator find(const K& key)               const { return tree_.find(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	size_type      count(const K& key)              const { return tree_.count_multi(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	pair<iterator, iterator>
+		equal_range(const K& key)
+	{ return tree_.equal_range_multi(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	pair<const_iterator, const_iterator>
+		equal_range(const K& key) const
+	{ return tree_.equal_range_multi(key); }
+
+	// 排名相关，需要开启排名(Ranked)，时间复杂度均为 O(log n)
+
+	iterator        nth(size_type k)                      { return tree_.nth(k); }
+	const_iterator  nth(size_type k)                const { return tree_.nth(k); }
+	size_type       rank(const key_type& key)       const { return tree_.rank(key); }
+	size_type       index_of(const_iterator it)     const { return tree_.index_of(it); }
+	difference_type distance(const_iterator first, const_iterator last) const
+	{ return static_cast<difference_type>(tree_.index_of(last) - tree_.index_of(first)); }
+
+	// 拼接、拆分与集合运算，基于红黑树的 join 和 split，未开启节点池时只重连节点，不复制元素
+	// merge 移入 source 中的元素，键值已存在的留在 source 中；intersect / subtract 只保留 / 删除键值在 other 中的元素
+	// split 摘出键值不小于 key 的元素，extract_range 摘出键值在 [lo, hi) 内的元素，以新的 map 返回
+	// join 把 rhs 中的元素接到末尾，rhs 的键值须都大于本容器的键值
+
+	void merge(map& source)          { tree_.merge_unique(source.tree_); }
+	void intersect(const map& other) { tree_.intersect_unique(other.tree_); }
+	void subtract(const map& other)  { tree_.subtract_unique(other.tree_); }
+	void join(map& rhs)              { tree_.join(rhs.tree_); }
+
+	map split(const key_type& key)
+	{
+		map result;
+		result.tree_ = tree_.split(key);
+		return result;
+	}
+	map extract_range(const key_type& lo, const key_type& hi)
+	{
+		map result;
+		result.tree_ = tree_.extract_range(lo, hi);
+		return result;
+	}
+
 	void           swap(map& rhs) noexcept
 	{ tree_.swap(rhs.tree_); }
 
@@ -238,47 +348,49 @@ public:
 };
 
 // 重载比较操作符
-template <typename Key, typename T, typename Compare>
-bool operator==(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator==(const map<Key, T, Compare, Ranked, Pooled>& lhs, const map<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return lhs == rhs;
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator<(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator<(const map<Key, T, Compare, Ranked, Pooled>& lhs, const map<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return lhs < rhs;
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator!=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator!=(const map<Key, T, Compare, Ranked, Pooled>& lhs, const map<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs == rhs);
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator>(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator>(const map<Key, T, Compare, Ranked, Pooled>& lhs, const map<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return rhs < lhs;
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator<=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator<=(const map<Key, T, Compare, Ranked, Pooled>& lhs, const map<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return !(rhs < lhs);
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator>=(const map<Key, T, Compare>& lhs, const map<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator>=(const map<Key, T, Compare, Ranked, Pooled>& lhs, const map<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <typename Key, typename T, typename Compare>
-void swap(map<Key, T, Compare>& lhs, map<Key, T, Compare>& rhs) noexcept {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+void swap(map<Key, T, Compare, Ranked, Pooled>& lhs, map<Key, T, Compare, Ranked, Pooled>& rhs) noexcept {
 	lhs.swap(rhs);
 }
 
 /*****************************************************************************************/
 
 // 模板类 multimap，键值允许重复
-// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less
-template <typename Key, typename T, class Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表实值类型，参数三代表键值的比较方式，缺省使用 mystl::less，
+// 参数四表示是否开启排名(子树节点数)，开启后可用 nth、rank、index_of 等，缺省不开启，
+// 参数五表示是否从节点池分配节点(见 rb_tree.h)，缺省不开启
+template <typename Key, typename T, class Compare = mystl::less<Key>, bool Ranked = false, bool Pooled = false>
 class multimap
 {
 public:
@@ -290,7 +402,7 @@ public:
 
 	// 定义一个 functor，用来进行元素比较
 	class value_compare : public binary_function <value_type, value_type, bool>{
-		friend class multimap<Key, T, Compare>;
+		friend class multimap<Key, T, Compare, Ranked, Pooled>;
 	private:
 		Compare comp;
 		value_compare(Compare c) : comp(c) {}
@@ -302,12 +414,13 @@ public:
 
 private:
 	// 用 mystl::rb_tree 作为底层机制
-	typedef mystl::rb_tree<value_type, key_compare>  base_type;
+	typedef mystl::rb_tree<value_type, key_compare, Ranked, Pooled>  base_type;
 	base_type tree_;
 
 public:
 	// 使用 rb_tree 的型别
 	typedef typename base_type::node_type              node_type;
+	typedef typename base_type::handle_type            handle_type;
 	typedef typename base_type::pointer                pointer;
 	typedef typename base_type::const_pointer          const_pointer;
 	typedef typename base_type::reference              reference;
@@ -430,6 +543,11 @@ public:
 	size_type      erase(const key_type& key)           { return tree_.erase_multi(key); }
 	void           erase(iterator first, iterator last) { tree_.erase(first, last); }
 
+	// 节点句柄，摘下的节点可以插回同类容器(包括键值不允许重复的版本)，未开启节点池时不复制元素；句柄可以比源容器活得更久
+	handle_type    extract(iterator position)           { return tree_.extract(position); }
+	handle_type    extract(const key_type& key)         { return tree_.extract(key); }
+	iterator       insert(handle_type&& nh)             { return tree_.insert_multi(mystl::move(nh)); }
+
 	void           clear() { tree_.clear(); }
 
 	// multimap 相关操作
@@ -453,6 +571,60 @@ public:
 		equal_range(const key_type& key) const 
 	{ return tree_.equal_range_multi(key); }
 
+	// 透明查找，只在 key_compare 定义了 is_transparent 时参与重载，key 可以是任意能与键值比较的类型
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       find(const K& key)                     { return tree_.find(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator find(const K& key)               const { return tree_.find(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	size_type      count(const K& key)              const { return tree_.count_multi(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	pair<iterator, iterator>
+		equal_range(const K& key)
+	{ return tree_.equal_range_multi(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	pair<const_iterator, const_iterator>
+		equal_range(const K& key) const
+	{ return tree_.equal_range_multi(key); }
+
+	// 排名相关，需要开启排名(Ranked)，时间复杂度均为 O(log n)
+
+	iterator        nth(size_type k)                      { return tree_.nth(k); }
+	const_iterator  nth(size_type k)                const { return tree_.nth(k); }
+	size_type       rank(const key_type& key)       const { return tree_.rank(key); }
+	size_type       index_of(const_iterator it)     const { return tree_.index_of(it); }
+	difference_type distance(const_iterator first, const_iterator last) const
+	{ return static_cast<difference_type>(tree_.index_of(last) - tree_.index_of(first)); }
+
+	// 拼接、拆分与集合运算，基于红黑树的 join 和 split，未开启节点池时只重连节点，不复制元素
+	// merge 移入 source 中的全部元素，排在键值相同的已有元素之后
+	// split 摘出键值不小于 key 的元素，extract_range 摘出键值在 [lo, hi) 内的元素，以新的 multimap 返回
+	// join 把 rhs 中的元素接到末尾，rhs 的键值须都不小于本容器的键值
+
+	void merge(multimap& source) { tree_.merge_multi(source.tree_); }
+	void join(multimap& rhs)     { tree_.join(rhs.tree_); }
+
+	multimap split(const key_type& key)
+	{
+		multimap result;
+		result.tree_ = tree_.split(key);
+		return result;
+	}
+	multimap extract_range(const key_type& lo, const key_type& hi)
+	{
+		multimap result;
+		result.tree_ = tree_.extract_range(lo, hi);
+		return result;
+	}
+
 	void swap(multimap& rhs) noexcept
 	{ tree_.swap(rhs.tree_); }
 
@@ -462,42 +634,51 @@ public:
 };
 
 // 重载比较操作符
-template <typename Key, typename T, typename Compare>
-bool operator==(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator==(const multimap<Key, T, Compare, Ranked, Pooled>& lhs, const multimap<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return lhs == rhs;
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator<(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator<(const multimap<Key, T, Compare, Ranked, Pooled>& lhs, const multimap<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return lhs < rhs;
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator!=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator!=(const multimap<Key, T, Compare, Ranked, Pooled>& lhs, const multimap<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs == rhs);
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator>(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator>(const multimap<Key, T, Compare, Ranked, Pooled>& lhs, const multimap<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return rhs < lhs;
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator<=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator<=(const multimap<Key, T, Compare, Ranked, Pooled>& lhs, const multimap<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return !(rhs < lhs);
 }
 
-template <typename Key, typename T, typename Compare>
-bool operator>=(const multimap<Key, T, Compare>& lhs, const multimap<Key, T, Compare>& rhs) {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator>=(const multimap<Key, T, Compare, Ranked, Pooled>& lhs, const multimap<Key, T, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <typename Key, typename T, typename Compare>
-void swap(multimap<Key, T, Compare>& lhs, multimap<Key, T, Compare>& rhs) noexcept {
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+void swap(multimap<Key, T, Compare, Ranked, Pooled>& lhs, multimap<Key, T, Compare, Ranked, Pooled>& rhs) noexcept {
 	lhs.swap(rhs);
 }
 
+/*****************************************************************************************/
+
+// 开启排名的 map / multimap
+template <typename Key, typename T, class Compare = mystl::less<Key>>
+using ranked_map = map<Key, T, Compare, true>;
+
+template <typename Key, typename T, class Compare = mystl::less<Key>>
+using ranked_multimap = multimap<Key, T, Compare, true>;
+
 } // namespace mystl
 #endif // !MYSTL_MAP_H_
 
@@ -0,0 +1,615 @@
+﻿#ifndef MYSTL_MMAP_VECTOR_H_
+#define MYSTL_MMAP_VECTOR_H_
+
+// 这个头文件包含一个模板类 mmap_vector
+// mmap_vector : 以文件映射为存储的向量，元素直接保存在文件中，再次打开时无需解析即可使用
+
+// notes:
+//
+// 1. 只支持 trivially copyable 的元素类型，元素按内存中的字节原样写入文件，
+//    文件只能由 sizeof(T)、字节序与对齐方式都相同的程序读取
+// 2. 文件布局：64 字节的文件头(mmap_vector_header)，之后是 capacity() 个元素；
+//    文件头记录魔数、格式版本、元素大小与元素个数，打开时逐项校验，不匹配时抛出 runtime_error
+// 3. 打开方式 mmap_mode：
+//      read_only  : 只读映射已有文件，打开时不读取数据，页面在首次访问时才从文件载入
+//      read_write : 读写映射文件，文件不存在时新建
+//      truncate   : 新建文件或清空已有文件后读写映射
+//    只读或未打开时修改容器会抛出 runtime_error，只读方式下也不要通过 data() / operator[] 写入元素
+// 4. 扩容时先用 ftruncate 扩大文件，再用 mremap 扩大映射，映射地址可能改变，迭代器随之失效
+// 5. 修改直接写入共享映射，sync() 用 msync 把脏页写回文件；close() 时把文件截断到 size() 个元素
+// 6. 只在 Linux 上可用
+
+#if defined(__linux__)
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "algo.h"
+#include "iterator.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+static constexpr uint32_t kMmapVectorVersion    = 1;
+static constexpr size_t   kMmapVectorHeaderSize = 64;
+
+// mmap_vector 的文件头
+struct mmap_vector_header
+{
+	char     magic[8];      // "MYSTLVEC"
+	uint32_t version;       // 文件格式版本，即 kMmapVectorVersion
+	uint32_t elem_size;     // 元素大小，即 sizeof(T)
+	uint64_t size;          // 元素个数
+	char     reserved[40];  // 保留，补齐到 kMmapVectorHeaderSize 字节
+};
+
+static_assert(sizeof(mmap_vector_header) == kMmapVectorHeaderSize, "mmap_vector_header must be 64 bytes");
+
+// mmap_vector 的打开方式
+enum class mmap_mode { read_only, read_write, truncate };
+
+// 模板类: mmap_vector
+// 模板参数 T 代表类型
+template <typename T>
+class mmap_vector
+{
+	static_assert(std::is_trivially_copyable<T>::value, "mmap_vector requires a trivially copyable T");
+	static_assert(alignof(T) <= kMmapVectorHeaderSize, "mmap_vector does not support over-aligned T");
+
+public:
+	typedef T                                        value_type;
+	typedef T*                                       pointer;
+	typedef const T*                                 const_pointer;
+	typedef T&                                       reference;
+	typedef const T&                                 const_reference;
+	typedef size_t                                   size_type;
+	typedef ptrdiff_t                                difference_type;
+
+	typedef T*                                       iterator;
+	typedef const T*                                 const_iterator;
+	typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+	typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+private:
+	int       fd_;         // 文件描述符，未打开时为 -1
+	char*     base_;       // 映射的起始地址，指向文件头
+	size_type map_len_;    // 映射的字节数
+	size_type size_;       // 元素个数，与文件头中的 size 保持一致
+	size_type cap_;        // 映射中能容纳的元素个数
+	bool      read_only_;  // 是否只读映射
+
+public:
+	// 构造、移动、析构函数
+	mmap_vector() noexcept
+		:fd_(-1), base_(nullptr), map_len_(0), size_(0), cap_(0), read_only_(true) {}
+
+	explicit mmap_vector(const char* path, mmap_mode mode = mmap_mode::read_only)
+		:mmap_vector() {
+		open(path, mode);
+	}
+
+	mmap_vector(const mmap_vector&) = delete;
+	mmap_vector& operator=(const mmap_vector&) = delete;
+
+	mmap_vector(mmap_vector&& rhs) noexcept
+		:mmap_vector() {
+		swap(rhs);
+	}
+
+	mmap_vector& operator=(mmap_vector&& rhs) noexcept {
+		if (this != &rhs) {
+			close();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	~mmap_vector() {
+		close();
+	}
+
+public:
+	// 文件相关操作
+	void open(const char* path, mmap_mode mode = mmap_mode::read_only);
+	void close() noexcept;
+	void sync(bool wait = true);
+
+	bool is_open() const noexcept {
+		return fd_ != -1;
+	}
+	bool read_only() const noexcept {
+		return read_only_;
+	}
+
+	// 迭代器相关操作
+	iterator begin() noexcept {
+		return data();
+	}
+	const_iterator begin() const noexcept {
+		return data();
+	}
+	iterator end() noexcept {
+		return data() + size_;
+	}
+	const_iterator end() const noexcept {
+		return data() + size_;
+	}
+
+	reverse_iterator rbegin() noexcept {
+		return reverse_iterator(end());
+	}
+	const_reverse_iterator rbegin() const noexcept {
+		return const_reverse_iterator(end());
+	}
+	reverse_iterator rend() noexcept {
+		return reverse_iterator(begin());
+	}
+	const_reverse_iterator rend() const noexcept {
+		return const_reverse_iterator(begin());
+	}
+
+	const_iterator cbegin() const noexcept {
+		return begin();
+	}
+	const_iterator cend() const noexcept {
+		return end();
+	}
+
+	// 容量相关操作
+	bool empty() const noexcept {
+		return size_ == 0;
+	}
+	size_type size() const noexcept {
+		return size_;
+	}
+	size_type max_size() const noexcept {
+		return (static_cast<size_type>(-1) - kMmapVectorHeaderSize) / sizeof(T);
+	}
+	size_type capacity() const noexcept {
+		return cap_;
+	}
+	void reserve(size_type n);
+	void shrink_to_fit();
+
+	// 访问元素相关操作
+	reference operator[](size_type n) {
+		MYSTL_DEBUG(n < size_);
+		return data()[n];
+	}
+	const_reference operator[](size_type n) const {
+		MYSTL_DEBUG(n < size_);
+		return data()[n];
+	}
+	reference at(size_type n) {
+		THROW_OUT_OF_RANGE_IF(!(n < size_), "mmap_vector<T>::at() subscript out of range");
+		return data()[n];
+	}
+	const_reference at(size_type n) const {
+		THROW_OUT_OF_RANGE_IF(!(n < size_), "mmap_vector<T>::at() subscript out of range");
+		return data()[n];
+	}
+
+	reference front() {
+		MYSTL_DEBUG(!empty());
+		return data()[0];
+	}
+	const_reference front() const {
+		MYSTL_DEBUG(!empty());
+		return data()[0];
+	}
+	reference back() {
+		MYSTL_DEBUG(!empty());
+		return data()[size_ - 1];
+	}
+	const_reference back() const {
+		MYSTL_DEBUG(!empty());
+		return data()[size_ - 1];
+	}
+
+	pointer data() noexcept {
+		return base_ == nullptr ? nullptr : reinterpret_cast<pointer>(base_ + kMmapVectorHeaderSize);
+	}
+	const_pointer data() const noexcept {
+		return base_ == nullptr ? nullptr : reinterpret_cast<const_pointer>(base_ + kMmapVectorHeaderSize);
+	}
+
+	// 修改容器相关操作
+
+	// assign
+
+	void assign(size_type n, const value_type& value) {
+		clear();
+		insert(end(), n, value);
+	}
+
+	template <typename Iter, typename std::enable_if<
+		mystl::is_input_iterator<Iter>::value, int>::type = 0>
+	void assign(Iter first, Iter last) {
+		clear();
+		insert(end(), first, last);
+	}
+
+	void assign(std::initializer_list<value_type> ilist) {
+		assign(ilist.begin(), ilist.end());
+	}
+
+	// emplace / emplace_back
+
+	template <typename... Args>
+	iterator emplace(const_iterator pos, Args&& ...args);
+
+	template <typename... Args>
+	void emplace_back(Args&& ...args) {
+		emplace(end(), mystl::forward<Args>(args)...);
+	}
+
+	// push_back / pop_back
+
+	void push_back(const value_type& value) {
+		emplace(end(), value);
+	}
+
+	void pop_back() {
+		require_writable();
+		MYSTL_DEBUG(!empty());
+		set_size(size_ - 1);
+	}
+
+	// insert
+
+	iterator insert(const_iterator pos, const value_type& value) {
+		return emplace(pos, value);
+	}
+
+	iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+	template <typename Iter, typename std::enable_if<
+		mystl::is_input_iterator<Iter>::value, int>::type = 0>
+	iterator insert(const_iterator pos, Iter first, Iter last) {
+		MYSTL_DEBUG(pos >= begin() && pos <= end());
+		return copy_insert(static_cast<size_type>(pos - begin()), first, last, iterator_category(first));
+	}
+
+	iterator insert(const_iterator pos, std::initializer_list<value_type> ilist) {
+		return insert(pos, ilist.begin(), ilist.end());
+	}
+
+	// erase / clear
+
+	iterator erase(const_iterator pos) {
+		return erase(pos, pos + 1);
+	}
+	iterator erase(const_iterator first, const_iterator last);
+
+	void clear() {
+		require_writable();
+		set_size(0);
+	}
+
+	// resize
+
+	void resize(size_type new_size) {
+		resize(new_size, value_type());
+	}
+	void resize(size_type new_size, const value_type& value);
+
+	void swap(mmap_vector& rhs) noexcept;
+
+private:
+	// helper functions
+
+	mmap_vector_header* header() const noexcept {
+		return reinterpret_cast<mmap_vector_header*>(base_);
+	}
+
+	static const char* check_header(const mmap_vector_header* h, size_type cap);
+
+	void require_writable() const {
+		THROW_RUNTIME_ERROR_IF(!is_open() || read_only_, "mmap_vector<T> is not opened for writing");
+	}
+
+	void set_size(size_type n) noexcept {
+		size_ = n;
+		header()->size = n;
+	}
+
+	void remap(size_type new_cap);
+	pointer make_gap(size_type off, size_type n);
+
+	template <typename IIter>
+	iterator copy_insert(size_type off, IIter first, IIter last, input_iterator_tag);
+	template <typename FIter>
+	iterator copy_insert(size_type off, FIter first, FIter last, forward_iterator_tag);
+};
+
+/*****************************************************************************************/
+
+// 打开文件并建立映射，已打开的文件先关闭
+template <typename T>
+void mmap_vector<T>::open(const char* path, mmap_mode mode)
+{
+	close();
+	const bool read_only = mode == mmap_mode::read_only;
+	int flags = read_only ? O_RDONLY : O_RDWR | O_CREAT;
+	if (mode == mmap_mode::truncate)
+		flags |= O_TRUNC;
+	const int fd = ::open(path, flags | O_CLOEXEC, 0644);
+	THROW_RUNTIME_ERROR_IF(fd == -1, "mmap_vector<T> cannot open the file");
+
+	struct stat st;
+	const char* err = nullptr;
+	size_type file_len = 0;
+	bool fresh = false;
+	if (::fstat(fd, &st) != 0) {
+		err = "mmap_vector<T> cannot stat the file";
+	}else {
+		file_len = static_cast<size_type>(st.st_size);
+		if (file_len == 0 && !read_only) {	// 新文件，写入文件头
+			if (::ftruncate(fd, static_cast<off_t>(kMmapVectorHeaderSize)) != 0)
+				err = "mmap_vector<T> cannot resize the file";
+			file_len = kMmapVectorHeaderSize;
+			fresh = true;
+		}else if (file_len < kMmapVectorHeaderSize) {
+			err = "mmap_vector<T> file is too small to hold a header";
+		}
+	}
+	void* p = MAP_FAILED;
+	if (err == nullptr) {
+		p = ::mmap(nullptr, file_len, read_only ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (p == MAP_FAILED)
+			err = "mmap_vector<T> cannot map the file";
+	}
+	const size_type cap = (file_len - kMmapVectorHeaderSize) / sizeof(T);
+	if (err == nullptr) {
+		auto h = static_cast<mmap_vector_header*>(p);
+		if (fresh) {
+			std::memset(h, 0, sizeof(mmap_vector_header));
+			std::memcpy(h->magic, "MYSTLVEC", 8);
+			h->version = kMmapVectorVersion;
+			h->elem_size = static_cast<uint32_t>(sizeof(T));
+		}
+		err = check_header(h, cap);
+	}
+	if (err != nullptr) {
+		if (p != MAP_FAILED)
+			::munmap(p, file_len);
+		::close(fd);
+		throw std::runtime_error(err);
+	}
+	fd_ = fd;
+	base_ = static_cast<char*>(p);
+	map_len_ = file_len;
+	size_ = static_cast<size_type>(header()->size);
+	cap_ = cap;
+	read_only_ = read_only;
+}
+
+// 解除映射并关闭文件，读写方式下先把文件截断到 size() 个元素
+template <typename T>
+void mmap_vector<T>::close() noexcept
+{
+	if (!is_open())
+		return;
+	::munmap(base_, map_len_);
+	if (!read_only_)
+		(void)::ftruncate(fd_, static_cast<off_t>(kMmapVectorHeaderSize + size_ * sizeof(T)));
+	::close(fd_);
+	fd_ = -1;
+	base_ = nullptr;
+	map_len_ = 0;
+	size_ = 0;
+	cap_ = 0;
+	read_only_ = true;
+}
+
+// 把修改写回文件，wait 为 false 时只发起写回，不等待完成
+template <typename T>
+void mmap_vector<T>::sync(bool wait)
+{
+	if (!is_open() || read_only_)
+		return;
+	THROW_RUNTIME_ERROR_IF(::msync(base_, map_len_, wait ? MS_SYNC : MS_ASYNC) != 0,
+		"mmap_vector<T>::sync() failed");
+}
+
+// 预留空间大小，当原容量小于要求大小时，才会扩大文件与映射
+template <typename T>
+void mmap_vector<T>::reserve(size_type n)
+{
+	require_writable();
+	THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size() in mmap_vector<T>::reserve(n)");
+	if (cap_ < n)
+		remap(n);
+}
+
+// 放弃多余的容量，文件随之缩小
+template <typename T>
+void mmap_vector<T>::shrink_to_fit()
+{
+	require_writable();
+	if (size_ < cap_)
+		remap(size_);
+}
+
+// 在 pos 位置构造元素
+template <typename T>
+template <typename ...Args>
+typename mmap_vector<T>::iterator
+mmap_vector<T>::emplace(const_iterator pos, Args&& ...args)
+{
+	require_writable();
+	MYSTL_DEBUG(pos >= begin() && pos <= end());
+	const value_type value(mystl::forward<Args>(args)...);	// 参数可能引用容器中的元素，先于扩容构造
+	auto p = make_gap(static_cast<size_type>(pos - begin()), 1);
+	std::memcpy(static_cast<void*>(p), &value, sizeof(T));
+	return p;
+}
+
+// 在 pos 位置插入 n 个元素
+template <typename T>
+typename mmap_vector<T>::iterator
+mmap_vector<T>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+	require_writable();
+	MYSTL_DEBUG(pos >= begin() && pos <= end());
+	const value_type value_copy = value;
+	auto p = make_gap(static_cast<size_type>(pos - begin()), n);
+	mystl::fill_n(p, n, value_copy);
+	return p;
+}
+
+// 删除 [first, last) 上的元素
+template <typename T>
+typename mmap_vector<T>::iterator
+mmap_vector<T>::erase(const_iterator first, const_iterator last)
+{
+	require_writable();
+	MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+	auto r = begin() + (first - begin());
+	const auto n = static_cast<size_type>(last - first);
+	if (n != 0) {
+		std::memmove(static_cast<void*>(r), r + n, (end() - (r + n)) * sizeof(T));
+		set_size(size_ - n);
+	}
+	return r;
+}
+
+// 重置容器大小
+template <typename T>
+void mmap_vector<T>::resize(size_type new_size, const value_type& value)
+{
+	require_writable();
+	if (new_size < size_)
+		set_size(new_size);
+	else
+		insert(end(), new_size - size_, value);
+}
+
+// 与另一个 mmap_vector 交换
+template <typename T>
+void mmap_vector<T>::swap(mmap_vector& rhs) noexcept
+{
+	mystl::swap(fd_, rhs.fd_);
+	mystl::swap(base_, rhs.base_);
+	mystl::swap(map_len_, rhs.map_len_);
+	mystl::swap(size_, rhs.size_);
+	mystl::swap(cap_, rhs.cap_);
+	mystl::swap(read_only_, rhs.read_only_);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// check_header 函数 校验文件头，返回错误信息，通过时返回 nullptr
+template <typename T>
+const char* mmap_vector<T>::check_header(const mmap_vector_header* h, size_type cap)
+{
+	if (std::memcmp(h->magic, "MYSTLVEC", 8) != 0)
+		return "mmap_vector<T> file has a bad magic number";
+	if (h->version != kMmapVectorVersion)
+		return "mmap_vector<T> file has an unsupported version";
+	if (h->elem_size != sizeof(T))
+		return "mmap_vector<T> file was written with a different element size";
+	if (h->size > cap)
+		return "mmap_vector<T> file is shorter than its recorded size";
+	return nullptr;
+}
+
+// remap 函数 把文件与映射调整为 new_cap 个元素，扩大时先扩文件，缩小时先缩映射
+template <typename T>
+void mmap_vector<T>::remap(size_type new_cap)
+{
+	const size_type new_len = kMmapVectorHeaderSize + new_cap * sizeof(T);
+	if (new_len > map_len_) {
+		THROW_RUNTIME_ERROR_IF(::ftruncate(fd_, static_cast<off_t>(new_len)) != 0,
+			"mmap_vector<T> cannot resize the file");
+	}
+	void* p = ::mremap(base_, map_len_, new_len, MREMAP_MAYMOVE);
+	if (p == MAP_FAILED) {
+		if (new_len > map_len_)
+			(void)::ftruncate(fd_, static_cast<off_t>(map_len_));	// 恢复文件大小
+		throw std::runtime_error("mmap_vector<T> cannot remap the file");
+	}
+	if (new_len < map_len_)
+		(void)::ftruncate(fd_, static_cast<off_t>(new_len));
+	base_ = static_cast<char*>(p);
+	map_len_ = new_len;
+	cap_ = new_cap;
+}
+
+// make_gap 函数 在 off 处空出 n 个位置，容量不足时按 vector 的策略扩容，返回空位的起始位置
+template <typename T>
+typename mmap_vector<T>::pointer
+mmap_vector<T>::make_gap(size_type off, size_type n)
+{
+	if (cap_ - size_ < n)
+		remap(vector_grow_cap(cap_, n, max_size()));
+	auto p = data() + off;
+	if (off != size_)
+		std::memmove(static_cast<void*>(p + n), p, (size_ - off) * sizeof(T));
+	set_size(size_ + n);
+	return p;
+}
+
+// copy_insert 函数 无法预先得到长度时逐个追加到尾部，再旋转到 off 处
+template <typename T>
+template <typename IIter>
+typename mmap_vector<T>::iterator
+mmap_vector<T>::copy_insert(size_type off, IIter first, IIter last, input_iterator_tag)
+{
+	require_writable();
+	const size_type old_size = size_;
+	for (; first != last; ++first)
+		emplace_back(*first);
+	mystl::rotate(begin() + off, begin() + old_size, end());
+	return begin() + off;
+}
+
+// copy_insert 函数 [first, last) 不能指向本容器
+template <typename T>
+template <typename FIter>
+typename mmap_vector<T>::iterator
+mmap_vector<T>::copy_insert(size_type off, FIter first, FIter last, forward_iterator_tag)
+{
+	require_writable();
+	const auto n = static_cast<size_type>(mystl::distance(first, last));
+	auto p = make_gap(off, n);
+	mystl::copy(first, last, p);
+	return p;
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <typename T>
+bool operator==(const mmap_vector<T>& lhs, const mmap_vector<T>& rhs)
+{
+	return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T>
+bool operator!=(const mmap_vector<T>& lhs, const mmap_vector<T>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+// 重载 mystl 的 swap
+template <typename T>
+void swap(mmap_vector<T>& lhs, mmap_vector<T>& rhs) noexcept
+{
+	lhs.swap(rhs);
+}
+
+} // namespace mystl
+
+#endif // __linux__
+#endif // !MYSTL_MMAP_VECTOR_H_
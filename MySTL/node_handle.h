@@ -0,0 +1,148 @@
+﻿#ifndef MYSTL_NODE_HANDLE_H_
+#define MYSTL_NODE_HANDLE_H_
+
+// 这个头文件包含一个模板类 node_handle 和一个模板结构体 node_insert_return
+// node_handle        : 节点句柄，持有从节点式容器中摘下的一个节点
+// node_insert_return : 以节点句柄插入不允许重复键值的容器时的返回值
+
+// notes:
+//
+// 1. 句柄独占节点，只能移动；插回容器时只重新链接节点，不复制元素，也不重新申请内存
+// 2. 句柄中的节点总是单独向 allocator 申请，不依赖源容器，句柄可以比源容器活得更久；
+//    rb_tree 开启节点池时，extract 把元素移到单独申请的节点中，插入时再移回目标树的节点池
+// 3. key() 与 mapped() 只对 map 类容器的句柄可用，key() 返回可修改的引用，可以改键后再插入
+
+#include <type_traits>
+
+#include "memory.h"
+#include "type_traits.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// forward declaration
+
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+class rb_tree;
+
+template <typename T, typename Hash, typename KeyEqual>
+class hashtable;
+
+// 模板类 node_handle
+// 参数一代表元素类型，参数二代表容器的节点类型，节点中的元素保存在成员 value 中
+template <typename T, typename Node>
+class node_handle {
+	template <typename, typename, bool, bool> friend class rb_tree;
+	template <typename, typename, typename> friend class hashtable;
+
+public:
+	typedef T                      value_type;
+	typedef mystl::allocator<T>    allocator_type;
+
+private:
+	typedef Node                   node_type;
+	typedef Node*                  node_ptr;
+	typedef mystl::allocator<T>    data_allocator;
+	typedef mystl::allocator<Node> node_allocator;
+
+	node_ptr node_;  // 持有的节点，为空表示空句柄
+
+public:
+	// 构造、移动、析构函数
+	constexpr node_handle() noexcept
+	  :node_(nullptr) {
+	}
+
+	node_handle(const node_handle&) = delete;
+	node_handle& operator=(const node_handle&) = delete;
+
+	node_handle(node_handle&& rhs) noexcept
+	  :node_(rhs.node_) {
+		rhs.node_ = nullptr;
+	}
+
+	node_handle& operator=(node_handle&& rhs) noexcept {
+		if (this != &rhs) {
+			destroy();
+			node_ = rhs.node_;
+			rhs.node_ = nullptr;
+		}
+		return *this;
+	}
+
+	~node_handle() { destroy(); }
+
+public:
+	bool           empty()         const noexcept { return node_ == nullptr; }
+	explicit       operator bool() const noexcept { return node_ != nullptr; }
+	allocator_type get_allocator() const          { return allocator_type(); }
+
+	// 访问元素，句柄不能为空
+	value_type& value() const {
+		MYSTL_DEBUG(node_ != nullptr);
+		return node_->value;
+	}
+
+	template <typename U = T, typename std::enable_if<
+		mystl::is_pair<U>::value, int>::type = 0>
+	typename std::remove_const<typename U::first_type>::type& key() const {
+		MYSTL_DEBUG(node_ != nullptr);
+		return const_cast<typename std::remove_const<typename U::first_type>::type&>(node_->value.first);
+	}
+
+	template <typename U = T, typename std::enable_if<
+		mystl::is_pair<U>::value, int>::type = 0>
+	typename U::second_type& mapped() const {
+		MYSTL_DEBUG(node_ != nullptr);
+		return node_->value.second;
+	}
+
+	void swap(node_handle& rhs) noexcept {
+		mystl::swap(node_, rhs.node_);
+	}
+
+private:
+	// 以下函数供容器使用，不提供对应的构造函数，以免 insert({ ... }) 之类的调用产生歧义
+
+	// 以容器摘下的节点构造句柄，节点须单独向 allocator 申请
+	static node_handle from_node(node_ptr node) noexcept {
+		node_handle nh;
+		nh.node_ = node;
+		return nh;
+	}
+
+	// 交出节点的所有权
+	node_ptr release() noexcept {
+		auto p = node_;
+		node_ = nullptr;
+		return p;
+	}
+
+	// 销毁元素并归还节点
+	void destroy() noexcept {
+		if (node_ == nullptr)
+			return;
+		data_allocator::destroy(mystl::address_of(node_->value));
+		node_allocator::deallocate(release());
+	}
+};
+
+// 重载 mystl 的 swap
+template <typename T, typename Node>
+void swap(node_handle<T, Node>& lhs, node_handle<T, Node>& rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+// 模板结构体 node_insert_return
+// position 指向插入的元素或阻止插入的元素；插入失败时 node 仍持有原来的节点
+template <typename Iterator, typename NodeHandle>
+struct node_insert_return {
+	Iterator   position;
+	bool       inserted;
+	NodeHandle node;
+};
+
+} // namespace mystl
+#endif // !MYSTL_NODE_HANDLE_H_
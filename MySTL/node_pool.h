@@ -0,0 +1,170 @@
+﻿#ifndef MYSTL_NODE_POOL_H_
+#define MYSTL_NODE_POOL_H_
+
+// 这个头文件包含一个模板类 node_pool
+// node_pool : 节点池，为节点式容器按块(slab)批量申请节点内存
+
+// notes:
+//
+// 1. 节点从当前块中顺序切出，被单独释放的节点挂入空闲链表，下次分配时优先复用
+// 2. 块的大小从 kNodePoolFirstSlab 个节点开始倍增，到 kNodePoolMaxSlab 个节点为止
+// 3. release() 一次性归还所有块，调用前需要自行析构仍存活节点上的元素
+// 4. 节点池不可复制，只能交换或移动，容器交换时节点池随节点一起交换
+// 5. splice() 接管另一个节点池的全部块，用于把一个容器的节点整体并入另一个容器
+
+#include <cstddef>
+#include <new>
+
+#include "util.h"
+
+namespace mystl
+{
+
+static constexpr size_t kNodePoolFirstSlab = 16;
+static constexpr size_t kNodePoolMaxSlab   = 4096;
+
+// 模板类 node_pool
+// 模板参数 Node 代表节点类型
+template <typename Node>
+class node_pool {
+public:
+	typedef Node   node_type;
+	typedef size_t size_type;
+
+private:
+	// 块头，按 max_align_t 对齐，保证紧随其后的节点满足对齐要求
+	union slab_header {
+		slab_header*     next;
+		std::max_align_t align;
+	};
+
+	// 被释放的节点复用自身的存储空间作为空闲链表的链接
+	struct free_node {
+		free_node* next;
+	};
+
+	static_assert(sizeof(Node) >= sizeof(free_node), "node is too small for node_pool");
+	static_assert(alignof(Node) <= alignof(std::max_align_t), "node is over-aligned for node_pool");
+
+private:
+	slab_header* slabs_;      // 已申请的块组成的链表
+	free_node*   free_;       // 空闲节点链表
+	Node*        cur_;        // 当前块中下一个未使用的节点
+	Node*        end_;        // 当前块的尾部
+	size_type    next_slab_;  // 下一个块包含的节点数
+	size_type    capacity_;   // 所有块包含的节点总数
+
+public:
+	node_pool() noexcept
+	  :slabs_(nullptr), free_(nullptr), cur_(nullptr), end_(nullptr),
+	  next_slab_(kNodePoolFirstSlab), capacity_(0) {
+	}
+
+	node_pool(const node_pool&) = delete;
+	node_pool& operator=(const node_pool&) = delete;
+
+	node_pool(node_pool&& rhs) noexcept
+	  :slabs_(rhs.slabs_), free_(rhs.free_), cur_(rhs.cur_), end_(rhs.end_),
+	  next_slab_(rhs.next_slab_), capacity_(rhs.capacity_) {
+		rhs.reset();
+	}
+
+	node_pool& operator=(node_pool&& rhs) noexcept {
+		if (this != &rhs) {
+			release();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	~node_pool() { release(); }
+
+public:
+	// 分配一个节点的内存，不构造节点
+	Node* allocate() {
+		if (free_ != nullptr) {
+			auto p = free_;
+			free_ = free_->next;
+			return reinterpret_cast<Node*>(p);
+		}
+		if (cur_ == end_)
+			new_slab();
+		return cur_++;
+	}
+
+	// 归还一个节点的内存，节点上的元素需已析构
+	void deallocate(Node* p) noexcept {
+		auto f = reinterpret_cast<free_node*>(p);
+		f->next = free_;
+		free_ = f;
+	}
+
+	// 一次性归还所有块
+	void release() noexcept {
+		while (slabs_ != nullptr) {
+			auto next = slabs_->next;
+			::operator delete(slabs_);
+			slabs_ = next;
+		}
+		reset();
+	}
+
+	// 所有块包含的节点总数，以及占用的字节数
+	size_type capacity() const noexcept { return capacity_; }
+	size_type bytes()    const noexcept { return capacity_ * sizeof(Node); }
+
+	// 接管 rhs 的所有块，rhs 的空闲节点和当前块中未用的节点并入本节点池的空闲链表，rhs 被重置为空
+	void splice(node_pool& rhs) noexcept {
+		if (this == &rhs || rhs.slabs_ == nullptr)
+			return;
+		for (; rhs.cur_ != rhs.end_; ++rhs.cur_)
+			deallocate(rhs.cur_);
+		while (rhs.free_ != nullptr) {
+			auto p = rhs.free_;
+			rhs.free_ = p->next;
+			p->next = free_;
+			free_ = p;
+		}
+		auto tail = rhs.slabs_;
+		while (tail->next != nullptr)
+			tail = tail->next;
+		tail->next = slabs_;
+		slabs_ = rhs.slabs_;
+		capacity_ += rhs.capacity_;
+		rhs.reset();
+	}
+
+	void swap(node_pool& rhs) noexcept {
+		mystl::swap(slabs_, rhs.slabs_);
+		mystl::swap(free_, rhs.free_);
+		mystl::swap(cur_, rhs.cur_);
+		mystl::swap(end_, rhs.end_);
+		mystl::swap(next_slab_, rhs.next_slab_);
+		mystl::swap(capacity_, rhs.capacity_);
+	}
+
+private:
+	void new_slab() {
+		auto raw = ::operator new(sizeof(slab_header) + next_slab_ * sizeof(Node));
+		auto header = static_cast<slab_header*>(raw);
+		header->next = slabs_;
+		slabs_ = header;
+		cur_ = reinterpret_cast<Node*>(header + 1);
+		end_ = cur_ + next_slab_;
+		capacity_ += next_slab_;
+		if (next_slab_ < kNodePoolMaxSlab)
+			next_slab_ *= 2;
+	}
+
+	void reset() noexcept {
+		slabs_ = nullptr;
+		free_ = nullptr;
+		cur_ = nullptr;
+		end_ = nullptr;
+		next_slab_ = kNodePoolFirstSlab;
+		capacity_ = 0;
+	}
+};
+
+} // namespace mystl
+#endif // !MYSTL_NODE_POOL_H_
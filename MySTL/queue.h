@@ -3,8 +3,9 @@
 
 // 这个头文件包含了两个模板类 queue 和 priority_queue
 // queue          : 队列
-// priority_queue : 优先队列
+// priority_queue : 优先队列，支持批量插入 push_range 与批量弹出 pop_n
 
+#include "algo.h"
 #include "deque.h"
 #include "vector.h"
 #include "functional.h"
@@ -272,6 +273,18 @@ public:
 		c_.pop_back();
 	}
 
+	// 批量插入 [first, last)，根据批量大小选择整体重建堆或逐个上溯
+	template <typename IIter>
+	void push_range(IIter first, IIter last) {
+		const size_type old_size = c_.size();
+		c_.insert(c_.end(), first, last);
+		rebuild_tail(old_size);
+	}
+
+	// 批量弹出至多 k 个元素，按出堆顺序依次写入 out，返回写入结束的位置
+	template <typename OIter>
+	OIter pop_n(size_type k, OIter out);
+
 	void clear() {
 		while (!empty())
 			pop();
@@ -283,6 +296,10 @@ public:
 		mystl::swap(comp_, rhs.comp_);
 	}
 
+private:
+	// helper functions
+	void rebuild_tail(size_type start);
+
 public:
 	friend bool operator==(const priority_queue& lhs, const priority_queue& rhs) {
 		return lhs.c_ == rhs.c_;
@@ -292,6 +309,65 @@ public:
 	}
 };
 
+/*****************************************************************************************/
+
+// 批量弹出至多 k 个元素
+// k 较小时在收缩的区间上连续执行 pop_heap，弹出的元素聚集在尾部，最后一次性删除
+// k 不小于一半时直接对整个容器逆序排序，前 k 个即为结果，剩余部分逆序有序，本身就是一个 heap
+template <typename T, typename Container, typename Compare>
+template <typename OIter>
+OIter priority_queue<T, Container, Compare>::pop_n(size_type k, OIter out) {
+	const size_type n = c_.size();
+	if (k > n)
+		k = n;
+	if (k == 0)
+		return out;
+	auto first = c_.begin();
+	auto last = c_.end();
+	if (k < n / 2) {
+		for (size_type i = 0; i < k; ++i)
+			mystl::pop_heap(first, last - i, comp_);
+		for (auto cur = last; cur != last - k; ++out)
+			*out = mystl::move(*--cur);
+		c_.erase(last - k, last);
+	}else {
+		auto comp = comp_;
+		mystl::sort(first, last, [comp](const value_type& lhs, const value_type& rhs) {
+			return comp(rhs, lhs);
+		});
+		out = mystl::move(first, first + k, out);
+		c_.erase(first, first + k);
+	}
+	return out;
+}
+
+// rebuild_tail 函数
+// [0, start) 已经是 heap，新元素位于 [start, size())
+// 逐个上溯的代价约为 tail_len * log(start)，整体重建的代价约为 2 * size()，取较小者
+template <typename T, typename Container, typename Compare>
+void priority_queue<T, Container, Compare>::rebuild_tail(size_type start) {
+	const size_type len = c_.size();
+	const size_type tail_len = len - start;
+	if (tail_len == 0)
+		return;
+	bool better_to_rebuild;
+	if (start < tail_len) {
+		better_to_rebuild = true;
+	}else {
+		size_type lg = 0;
+		for (size_type i = start; i > 1; i >>= 1)
+			++lg;
+		better_to_rebuild = 2 * len < tail_len * lg;
+	}
+	auto first = c_.begin();
+	if (better_to_rebuild) {
+		mystl::make_heap(first, c_.end(), comp_);
+	}else {
+		for (size_type i = start + 1; i <= len; ++i)
+			mystl::push_heap(first, first + i, comp_);
+	}
+}
+
 // 重载比较操作符
 template <typename T, typename Container, typename Compare>
 bool operator==(priority_queue<T, Container, Compare>& lhs,
@@ -4,13 +4,36 @@
 // 这个头文件包含一个模板类 rb_tree
 // rb_tree : 红黑树
 
+// notes:
+//
+// 1. 节点颜色保存在父节点指针的最低位，节点只有三个指针加元素本身
+// 2. 模板参数 Pooled 为 true 时，节点从每棵树独有的节点池中分配，
+//    clear() 和析构时只析构元素，节点内存由节点池整块归还；为 false(缺省)时每个节点单独向 allocator 申请，
+//    节点池成员为空类。节点池中的节点随树一起销毁，节点在树之间转移(split、extract_range、merge 留下的重复元素、
+//    extract 与插入节点句柄)时只能移动元素而不是重连节点，因此节点池需要显式开启；
+//    开启与否是树类型的一部分，不同编译单元中的同一类型总是使用相同的节点来源
+// 3. 模板参数 Ranked 为 true 时节点额外保存子树的节点数，在旋转和插入、删除的再平衡中维护，
+//    提供 O(log n) 的 nth、rank、index_of；为 false 时该字段是空基类，不占空间
+// 4. join(以一个节点为枢轴拼接两颗树) 与 split(按键值拆成两颗树) 只重连节点，不复制元素，
+//    merge、split、extract_range 以及求交、求差都建立在它们之上；不开启节点池时，
+//    指向被转移元素的迭代器和引用仍然有效，只是改为属于另一个容器。开启节点池时，
+//    整颗并入的树由节点池整体接管，但被拆出到另一颗树的元素要在那颗树的节点池中逐个移动构造：
+//    split、extract_range 需要 O(k) 次分配与移动(k 为拆出的元素个数)，merge 留在 source 中的重复元素
+//    也会被移动重建，指向这些元素的迭代器和引用失效
+// 5. extract 摘下的节点以节点句柄(node_handle)返回，插回时只重连节点，句柄可以比源树活得更久；
+//    开启节点池时，extract 把元素移到单独申请的节点中交给句柄，插入句柄时再移回本树的节点池，
+//    各需要一次分配与移动
+
 #include <initializer_list>
 
 #include <cassert>
+#include <cstdint>
 
 #include "functional.h"
 #include "iterator.h"
 #include "memory.h"
+#include "node_handle.h"
+#include "node_pool.h"
 #include "type_traits.h"
 #include "exceptdef.h"
 
@@ -24,13 +47,16 @@ typedef bool rb_tree_color_type;
 static constexpr rb_tree_color_type rb_tree_red   = false;
 static constexpr rb_tree_color_type rb_tree_black = true;
 
+// 并集运算中较小一方的子树黑高不超过该值时，不再拆分另一方，而是把它的节点逐个插入
+static constexpr size_t kRbTreeUnionInsertBh = 3;
+
 // forward declaration
 
-template <typename T> struct rb_tree_node_base;
-template <typename T> struct rb_tree_node;
+template <typename T, bool Ranked = false> struct rb_tree_node_base;
+template <typename T, bool Ranked = false> struct rb_tree_node;
 
-template <typename T> struct rb_tree_iterator;
-template <typename T> struct rb_tree_const_iterator;
+template <typename T, bool Ranked = false> struct rb_tree_iterator;
+template <typename T, bool Ranked = false> struct rb_tree_const_iterator;
 
 // rb tree value traits
 
@@ -91,7 +117,7 @@ struct rb_tree_value_traits {
 
 // rb tree node traits
 
-template <typename T>
+template <typename T, bool Ranked = false>
 struct rb_tree_node_traits {
 	typedef rb_tree_color_type                 color_type;
 
@@ -100,22 +126,48 @@ struct rb_tree_node_traits {
 	typedef typename value_traits::mapped_type mapped_type;
 	typedef typename value_traits::value_type  value_type;
 
-	typedef rb_tree_node_base<T>*              base_ptr;
-	typedef rb_tree_node<T>*                   node_ptr;
+	typedef rb_tree_node_base<T, Ranked>*      base_ptr;
+	typedef rb_tree_node<T, Ranked>*           node_ptr;
 };
 
 // rb tree 的节点设计
 
-template <typename T>
-struct rb_tree_node_base {
-	typedef rb_tree_color_type    color_type;
-	typedef rb_tree_node_base<T>* base_ptr;
-	typedef rb_tree_node<T>*      node_ptr;
+// 开启排名(Ranked)时节点额外保存子树的节点数，用于按序号查找和计算排名；否则为空基类，不占空间
+template <bool Ranked>
+struct rb_tree_node_size {
+};
+
+template <>
+struct rb_tree_node_size<true> {
+	size_t size;  // 以该节点为根的子树中的节点数
+};
+
+template <typename T, bool Ranked>
+struct rb_tree_node_base :public rb_tree_node_size<Ranked> {
+	typedef rb_tree_color_type            color_type;
+	typedef rb_tree_node_base<T, Ranked>* base_ptr;
+	typedef rb_tree_node<T, Ranked>*      node_ptr;
 
-	base_ptr   parent;  // 父节点
-	base_ptr   left;    // 左子节点
-	base_ptr   right;   // 右子节点
-	color_type color;   // 节点颜色
+	// 节点至少按指针大小对齐，父节点指针的最低位总为 0，用来保存节点颜色
+	uintptr_t  parent_color;  // 父节点 | 节点颜色
+	base_ptr   left;          // 左子节点
+	base_ptr   right;         // 右子节点
+
+	base_ptr parent() const {
+		return reinterpret_cast<base_ptr>(parent_color & ~static_cast<uintptr_t>(1));
+	}
+
+	color_type color() const {
+		return static_cast<color_type>(parent_color & 1);
+	}
+
+	void set_parent(base_ptr p) {
+		parent_color = reinterpret_cast<uintptr_t>(p) | (parent_color & 1);
+	}
+
+	void set_color(color_type c) {
+		parent_color = (parent_color & ~static_cast<uintptr_t>(1)) | static_cast<uintptr_t>(c);
+	}
 
 	base_ptr get_base_ptr() {
 		return &*this;
@@ -130,10 +182,10 @@ struct rb_tree_node_base {
 	}
 };
 
-template <typename T>
-struct rb_tree_node :public rb_tree_node_base<T> {
-	typedef rb_tree_node_base<T>* base_ptr;
-	typedef rb_tree_node<T>*      node_ptr;
+template <typename T, bool Ranked>
+struct rb_tree_node :public rb_tree_node_base<T, Ranked> {
+	typedef rb_tree_node_base<T, Ranked>* base_ptr;
+	typedef rb_tree_node<T, Ranked>*      node_ptr;
 
 	T value;  // 节点值
 
@@ -146,9 +198,24 @@ struct rb_tree_node :public rb_tree_node_base<T> {
 	}
 };
 
+// 节点内存的来源
+// 开启节点池(Pooled)时为每棵树独有的 node_pool；否则每个节点单独向 allocator 申请，为空类，接口与 node_pool 相同
+template <typename Node, bool Pooled>
+struct rb_tree_node_store {
+	Node* allocate()                   { return mystl::allocator<Node>::allocate(1); }
+	void  deallocate(Node* p) noexcept { mystl::allocator<Node>::deallocate(p); }
+	void  release() noexcept {}
+	void  splice(rb_tree_node_store&) noexcept {}
+	void  swap(rb_tree_node_store&) noexcept {}
+};
+
+template <typename Node>
+struct rb_tree_node_store<Node, true> :public node_pool<Node> {
+};
+
 // rb tree traits
 
-template <typename T>
+template <typename T, bool Ranked = false>
 struct rb_tree_traits {
 	typedef rb_tree_value_traits<T>            value_traits;
 
@@ -161,8 +228,8 @@ struct rb_tree_traits {
 	typedef const value_type*                  const_pointer;
 	typedef const value_type&                  const_reference;
 
-	typedef rb_tree_node_base<T>               base_type;
-	typedef rb_tree_node<T>                    node_type;
+	typedef rb_tree_node_base<T, Ranked>       base_type;
+	typedef rb_tree_node<T, Ranked>            node_type;
 
 	typedef base_type*                         base_ptr;
 	typedef node_type*                         node_ptr;
@@ -170,9 +237,9 @@ struct rb_tree_traits {
 
 // rb tree 的迭代器设计
 
-template <typename T>
+template <typename T, bool Ranked = false>
 struct rb_tree_iterator_base :public mystl::iterator<mystl::bidirectional_iterator_tag, T> {
-	typedef typename rb_tree_traits<T>::base_ptr  base_ptr;
+	typedef typename rb_tree_traits<T, Ranked>::base_ptr  base_ptr;
 
 	base_ptr node;  // 指向节点本身
 
@@ -185,11 +252,11 @@ struct rb_tree_iterator_base :public mystl::iterator<mystl::bidirectional_iterat
 			// 找最左子树
 			node = rb_tree_min(node->right);
 		} else {  // 如果没有右子节点
-			auto y = node->parent;
+			auto y = node->parent();
 			while (y->right == node) {	// 找祖先结点,且该结点是其父结点的左子树
 				// 结点往上走
 				node = y;
-				y = y->parent;
+				y = y->parent();
 			}
 			if (node->right != y)  // 应对“寻找根节点的下一节点，而根节点没有右子节点”的特殊情况
 				node = y;
@@ -198,15 +265,15 @@ struct rb_tree_iterator_base :public mystl::iterator<mystl::bidirectional_iterat
 
 	// 使迭代器后退
 	void dec() {
-		if (node->parent->parent == node && rb_tree_is_red(node)) { // 如果 node 为 header
+		if (node->parent()->parent() == node && rb_tree_is_red(node)) { // 如果 node 为 header
 			node = node->right;  // 指向整棵树的 max 节点
 		} else if (node->left != nullptr) {
 			node = rb_tree_max(node->left);
 		} else {  // 非 header 节点，也无左子节点
-			auto y = node->parent;
+			auto y = node->parent();
 			while (node == y->left) {
 				node = y;
-				y = y->parent;
+				y = y->parent();
 			}
 			node = y;
 		}
@@ -217,9 +284,9 @@ struct rb_tree_iterator_base :public mystl::iterator<mystl::bidirectional_iterat
 };
 
 // 红黑树迭代器
-template <typename T>
-struct rb_tree_iterator :public rb_tree_iterator_base<T> {
-	typedef rb_tree_traits<T>                tree_traits;
+template <typename T, bool Ranked>
+struct rb_tree_iterator :public rb_tree_iterator_base<T, Ranked> {
+	typedef rb_tree_traits<T, Ranked>        tree_traits;
 
 	typedef typename tree_traits::value_type value_type;
 	typedef typename tree_traits::pointer    pointer;
@@ -227,11 +294,11 @@ struct rb_tree_iterator :public rb_tree_iterator_base<T> {
 	typedef typename tree_traits::base_ptr   base_ptr;
 	typedef typename tree_traits::node_ptr   node_ptr;
 
-	typedef rb_tree_iterator<T>              iterator;
-	typedef rb_tree_const_iterator<T>        const_iterator;
+	typedef rb_tree_iterator<T, Ranked>       iterator;
+	typedef rb_tree_const_iterator<T, Ranked> const_iterator;
 	typedef iterator                         self;
 
-	using rb_tree_iterator_base<T>::node;
+	using rb_tree_iterator_base<T, Ranked>::node;
 
 	// 构造函数
 	rb_tree_iterator() {}
@@ -266,9 +333,9 @@ struct rb_tree_iterator :public rb_tree_iterator_base<T> {
 
 
 // 红黑树常量迭代器
-template <typename T>
-struct rb_tree_const_iterator :public rb_tree_iterator_base<T> {
-	typedef rb_tree_traits<T>                     tree_traits;
+template <typename T, bool Ranked>
+struct rb_tree_const_iterator :public rb_tree_iterator_base<T, Ranked> {
+	typedef rb_tree_traits<T, Ranked>             tree_traits;
 
 	typedef typename tree_traits::value_type      value_type;
 	typedef typename tree_traits::const_pointer   pointer;
@@ -276,11 +343,11 @@ struct rb_tree_const_iterator :public rb_tree_iterator_base<T> {
 	typedef typename tree_traits::base_ptr        base_ptr;
 	typedef typename tree_traits::node_ptr        node_ptr;
 
-	typedef rb_tree_iterator<T>                   iterator;
-	typedef rb_tree_const_iterator<T>             const_iterator;
+	typedef rb_tree_iterator<T, Ranked>           iterator;
+	typedef rb_tree_const_iterator<T, Ranked>     const_iterator;
 	typedef const_iterator                        self;
 
-	using rb_tree_iterator_base<T>::node;
+	using rb_tree_iterator_base<T, Ranked>::node;
 
 	// 构造函数
 	rb_tree_const_iterator() {}
@@ -335,25 +402,73 @@ NodePtr rb_tree_max(NodePtr x) noexcept {
 // 判断该结点是不是父节点的左子
 template <typename NodePtr>
 bool rb_tree_is_lchild(NodePtr node) noexcept {
-	return node == node->parent->left;
+	return node == node->parent()->left;
 }
 
 // 判断该节点颜色是不是红色
 template <typename NodePtr>
 bool rb_tree_is_red(NodePtr node) noexcept {
-	return node->color == rb_tree_red;
+	return node->color() == rb_tree_red;
 }
 
 // 设置该结点的颜色为黑色
 template <typename NodePtr>
-void rb_tree_set_black(NodePtr& node) noexcept {
-	node->color = rb_tree_black;
+void rb_tree_set_black(NodePtr node) noexcept {
+	node->set_color(rb_tree_black);
 }
 
 // 设置该结点的颜色为红色
 template <typename NodePtr>
-void rb_tree_set_red(NodePtr& node) noexcept {
-	node->color = rb_tree_red;
+void rb_tree_set_red(NodePtr node) noexcept {
+	node->set_color(rb_tree_red);
+}
+
+// 以下函数维护子树的节点数，只对开启排名的节点生效，普通节点上什么也不做
+
+// 以 x 为根的子树中的节点数，x 为空时为 0
+template <typename T>
+size_t rb_tree_size(rb_tree_node_base<T, true>* x) noexcept {
+	return x == nullptr ? 0 : x->size;
+}
+
+// 设置 x 的子树节点数为 n
+template <typename T>
+void rb_tree_size_set(rb_tree_node_base<T, false>*, size_t) noexcept {}
+
+template <typename T>
+void rb_tree_size_set(rb_tree_node_base<T, true>* x, size_t n) noexcept {
+	x->size = n;
+}
+
+// 令 x 的子树节点数与 y 相同
+template <typename T>
+void rb_tree_size_copy(rb_tree_node_base<T, false>*, rb_tree_node_base<T, false>*) noexcept {}
+
+template <typename T>
+void rb_tree_size_copy(rb_tree_node_base<T, true>* x, rb_tree_node_base<T, true>* y) noexcept {
+	x->size = y->size;
+}
+
+// 由左右子树重新计算 x 的子树节点数
+template <typename T>
+void rb_tree_size_update(rb_tree_node_base<T, false>*) noexcept {}
+
+template <typename T>
+void rb_tree_size_update(rb_tree_node_base<T, true>* x) noexcept {
+	x->size = rb_tree_size(x->left) + rb_tree_size(x->right) + 1;
+}
+
+// 从 x 开始沿父节点一直到 root，子树节点数都加上 n(以无符号数回绕表示减法)
+template <typename T>
+void rb_tree_size_add_path(rb_tree_node_base<T, false>*, rb_tree_node_base<T, false>*, size_t) noexcept {}
+
+template <typename T>
+void rb_tree_size_add_path(rb_tree_node_base<T, true>* x, rb_tree_node_base<T, true>* root, size_t n) noexcept {
+	for (;; x = x->parent()) {
+		x->size += n;
+		if (x == root)
+			break;
+	}
 }
 
 // 和base的inc一样
@@ -362,8 +477,8 @@ NodePtr rb_tree_next(NodePtr node) noexcept {
 	if (node->right != nullptr)	// 右子树不为空找右子树的最小(最左结点)
 		return rb_tree_min(node->right);
 	while (!rb_tree_is_lchild(node))	// 找非左子祖先节点
-    	node = node->parent;
-	return node->parent;
+    	node = node->parent();
+	return node->parent();
 }
 
 /*---------------------------------------*\
@@ -381,20 +496,23 @@ void rb_tree_rotate_left(NodePtr x, NodePtr& root) noexcept {
 	auto y = x->right;  // y 为 x 的右子节点
 	x->right = y->left;
 	if (y->left != nullptr) {
-		y->left->parent = x;
+		y->left->set_parent(x);
 	}
-	y->parent = x->parent;
+	y->set_parent(x->parent());
 
 	if (x == root) { // 如果 x 为根节点，让 y 顶替 x 成为根节点
 		root = y;
 	}else if (rb_tree_is_lchild(x)) { // 如果 x 是左子节点
-		x->parent->left = y;
+		x->parent()->left = y;
 	}else { // 如果 x 是右子节点
-		x->parent->right = y;
+		x->parent()->right = y;
 	}
 	// 调整 x 与 y 的关系
 	y->left = x;  
-	x->parent = y;
+	x->set_parent(y);
+	// y 接管原来以 x 为根的整棵子树
+	rb_tree_size_copy(y, x);
+	rb_tree_size_update(x);
 }
 
 /*----------------------------------------*\
@@ -412,20 +530,23 @@ void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept {
 	auto y = x->left;
 	x->left = y->right;
 	if (y->right) {
-		y->right->parent = x;
+		y->right->set_parent(x);
 	}
-	y->parent = x->parent;
+	y->set_parent(x->parent());
 
 	if (x == root) { // 如果 x 为根节点，让 y 顶替 x 成为根节点
 		root = y;
 	}else if (rb_tree_is_lchild(x)) { // 如果 x 是右子节点
-		x->parent->left = y;
+		x->parent()->left = y;
 	}else { // 如果 x 是左子节点
-		x->parent->right = y;
+		x->parent()->right = y;
 	}
 	// 调整 x 与 y 的关系
 	y->right = x;                      
-	x->parent = y;
+	x->set_parent(y);
+	// y 接管原来以 x 为根的整棵子树
+	rb_tree_size_copy(y, x);
+	rb_tree_size_update(x);
 }
 
 // 插入节点后使 rb tree 重新平衡，参数一为新增节点，参数二为根节点
@@ -441,49 +562,61 @@ void rb_tree_rotate_right(NodePtr x, NodePtr& root) noexcept {
 //
 // 参考博客: http://blog.csdn.net/v_JULY_v/article/details/6105630
 //          http://blog.csdn.net/v_JULY_v/article/details/6109153
+//
+// rb_tree_insert_fixup 只做 case 2 ~ case 5 的调整，不把根节点染黑，也不维护子树节点数，
+// join 时用它修复挂入的红色节点，并根据根节点是否变红得知黑高是否增加
 template <typename NodePtr>
-void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept {
+void rb_tree_insert_fixup(NodePtr x, NodePtr& root) noexcept {
 	rb_tree_set_red(x);  // 新增节点为红色
-	while (x != root && rb_tree_is_red(x->parent)) {
-		if (rb_tree_is_lchild(x->parent)) { // 如果父节点是左子节点(方便左右旋)
-			auto uncle = x->parent->parent->right;	// 伯父节点
+	while (x != root && rb_tree_is_red(x->parent())) {
+		if (rb_tree_is_lchild(x->parent())) { // 如果父节点是左子节点(方便左右旋)
+			auto uncle = x->parent()->parent()->right;	// 伯父节点
 			if (uncle != nullptr && rb_tree_is_red(uncle)) { // case 3: 父节点和叔叔节点都为红
-				rb_tree_set_black(x->parent);
+				rb_tree_set_black(x->parent());
 				rb_tree_set_black(uncle);
-				x = x->parent->parent;
+				x = x->parent()->parent();
 				rb_tree_set_red(x);
 			}else { // 无叔叔节点或叔叔节点为黑 case4/5
 				if (!rb_tree_is_lchild(x)) { // case 4: 当前节点 x 为右子节点
-					x = x->parent;
+					x = x->parent();
 					rb_tree_rotate_left(x, root);
 				}	
 				// 都转换成 case 5： 当前节点为左子节点
-				rb_tree_set_black(x->parent);
-				rb_tree_set_red(x->parent->parent);
-				rb_tree_rotate_right(x->parent->parent, root);
+				rb_tree_set_black(x->parent());
+				rb_tree_set_red(x->parent()->parent());
+				rb_tree_rotate_right(x->parent()->parent(), root);
 				break;
 			}
 		}else { // 如果父节点是右子节点，对称处理 
-			auto uncle = x->parent->parent->left;
+			auto uncle = x->parent()->parent()->left;
 			if (uncle != nullptr && rb_tree_is_red(uncle)) { // case 3: 父节点和叔叔节点都为红
-				rb_tree_set_black(x->parent);
+				rb_tree_set_black(x->parent());
 				rb_tree_set_black(uncle);
-				x = x->parent->parent;
+				x = x->parent()->parent();
 				rb_tree_set_red(x);
 				// 此时祖父节点为红，可能会破坏红黑树的性质，令当前节点为祖父节点，继续处理
 			}else { // 无叔叔节点或叔叔节点为黑
 				if (rb_tree_is_lchild(x)) { // case 4: 当前节点 x 为左子节点
-					x = x->parent;
+					x = x->parent();
 					rb_tree_rotate_right(x, root);
 				}
 				// 都转换成 case 5： 当前节点为左子节点
-				rb_tree_set_black(x->parent);
-				rb_tree_set_red(x->parent->parent);
-				rb_tree_rotate_left(x->parent->parent, root);
+				rb_tree_set_black(x->parent());
+				rb_tree_set_red(x->parent()->parent());
+				rb_tree_rotate_left(x->parent()->parent(), root);
 				break;
 			}
 		}
 	}
+}
+
+template <typename NodePtr>
+void rb_tree_insert_rebalance(NodePtr x, NodePtr& root) noexcept {
+	// 新增节点到根节点路径上的子树节点数都加一
+	rb_tree_size_set(x, 1);
+	if (x != root)
+		rb_tree_size_add_path(x->parent(), root, 1);
+	rb_tree_insert_fixup(x, root);
 	rb_tree_set_black(root);  // 根节点永远为黑
 }
 
@@ -499,22 +632,25 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 	auto x = y->left != nullptr ? y->left : y->right;
 	// xp 为 x 的父节点
 	NodePtr xp = nullptr;
+	// 实际被摘下的是 y，y 的父节点到根节点路径上的子树节点数都减一
+	if (y != root)
+		rb_tree_size_add_path(y->parent(), root, static_cast<size_t>(-1));
 
 	// y != z 说明 z 有两个非空子节点，此时 y 指向 z 右子树的最左节点，x 指向 y 的右子节点。
 	// 用 y 顶替 z 的位置，用 x 顶替 y 的位置，最后用 y 指向 z
 	if (y != z) {
-		z->left->parent = y;
+		z->left->set_parent(y);
 		y->left = z->left;
 
 		// 如果 y 不是 z 的右子节点，那么 z 的右子节点一定有左孩子
 		if (y != z->right){ // x 替换 y 的位置
-			xp = y->parent;
+			xp = y->parent();
 			if (x != nullptr)
-				x->parent = y->parent;
+				x->set_parent(y->parent());
 
-			y->parent->left = x;
+			y->parent()->left = x;
 			y->right = z->right;
-			z->right->parent = y;
+			z->right->set_parent(y);
 		}else {
 			xp = y;
 		}
@@ -523,24 +659,27 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 		if (root == z)
 			root = y;
 		else if (rb_tree_is_lchild(z))
-			z->parent->left = y;
+			z->parent()->left = y;
 		else
-			z->parent->right = y;
-		y->parent = z->parent;
-		mystl::swap(y->color, z->color);
+			z->parent()->right = y;
+		y->set_parent(z->parent());
+		auto c = y->color();
+		y->set_color(z->color());
+		z->set_color(c);
+		rb_tree_size_copy(y, z);  // z 位于上面的路径上，子树节点数已经减一
 		y = z;
 	}else {	// // y == z 说明 z 至多只有一个孩子 
-		xp = y->parent;
+		xp = y->parent();
 		if (x)  
-			x->parent = y->parent;
+			x->set_parent(y->parent());
 
 		// 连接 x 与 z 的父节点
 		if (root == z)
 			root = x;
 		else if (rb_tree_is_lchild(z))
-			z->parent->left = x;
+			z->parent()->left = x;
 		else
-			z->parent->right = x;
+			z->parent()->right = x;
 
 		// 此时 z 有可能是最左节点或最右节点，更新数据
 		if (leftmost == z)
@@ -572,7 +711,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 					(brother->right == nullptr || !rb_tree_is_red(brother->right))) { // case 2
 					rb_tree_set_red(brother);
 					x = xp;
-					xp = xp->parent;
+					xp = xp->parent();
 				}else { 
 					if (brother->right == nullptr || !rb_tree_is_red(brother->right)) { // case 3
 						if (brother->left != nullptr)
@@ -582,7 +721,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 						brother = xp->right;
 					}
 					// 转为 case 4
-					brother->color = xp->color;
+					brother->set_color(xp->color());
 					rb_tree_set_black(xp);
 					if (brother->right != nullptr)  
 					rb_tree_set_black(brother->right);
@@ -601,7 +740,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 					(brother->right == nullptr || !rb_tree_is_red(brother->right))) { // case 2
 					rb_tree_set_red(brother);
 					x = xp;
-					xp = xp->parent;
+					xp = xp->parent();
 				}else {
 					if (brother->left == nullptr || !rb_tree_is_red(brother->left)) { // case 3
 						if (brother->right != nullptr)
@@ -611,7 +750,7 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 						brother = xp->left;
 					}
 					// 转为 case 4
-					brother->color = xp->color;
+					brother->set_color(xp->color());
 					rb_tree_set_black(xp);
 					if (brother->left != nullptr)  
 					rb_tree_set_black(brother->left);
@@ -627,13 +766,13 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root, NodePtr& leftmost, Nod
 }
 
 // 模板类 rb_tree
-// 参数一代表数据类型，参数二代表键值比较类型
-template <typename T, typename Compare>
+// 参数一代表数据类型，参数二代表键值比较类型，参数三表示是否开启排名，参数四表示是否从节点池分配节点
+template <typename T, typename Compare, bool Ranked = false, bool Pooled = false>
 class rb_tree {
 public:
 	// rb_tree 的嵌套型别定义 
 
-	typedef rb_tree_traits<T>                        tree_traits;
+	typedef rb_tree_traits<T, Ranked>                tree_traits;
 	typedef rb_tree_value_traits<T>                  value_traits;
 
 	typedef typename tree_traits::base_type          base_type;
@@ -657,11 +796,14 @@ public:
 	typedef typename allocator_type::size_type       size_type;
 	typedef typename allocator_type::difference_type difference_type;
 
-	typedef rb_tree_iterator<T>                      iterator;
-	typedef rb_tree_const_iterator<T>                const_iterator;
+	typedef rb_tree_iterator<T, Ranked>              iterator;
+	typedef rb_tree_const_iterator<T, Ranked>        const_iterator;
 	typedef mystl::reverse_iterator<iterator>        reverse_iterator;
 	typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
 
+	typedef mystl::node_handle<T, node_type>         handle_type;
+	typedef mystl::node_insert_return<iterator, handle_type> insert_return_type;
+
 	allocator_type get_allocator() const { return node_allocator(); }
 	key_compare    key_comp()      const { return key_comp_; }
 
@@ -670,10 +812,13 @@ private:
 	base_ptr    header_;      // 特殊节点，与根节点互为对方的父节点
 	size_type   node_count_;  // 节点数
 	key_compare key_comp_;    // 节点键值比较的准则
+	rb_tree_node_store<node_type, Pooled> pool_;  // 节点池，未开启时为空类
 
 private:
-	// 以下三个函数用于取得根节点，最小节点和最大节点
-	base_ptr& root()      const { return header_->parent; }
+	// 以下函数用于取得、设置根节点，以及取得最小节点和最大节点
+	// 根节点保存在 header_ 的父节点指针中，与颜色位共用，只能通过 set_root 修改
+	base_ptr  root()      const { return header_->parent(); }
+	void      set_root(base_ptr x) const { header_->set_parent(x); }
 	base_ptr& leftmost()  const { return header_->left; }
 	base_ptr& rightmost() const { return header_->right; }
 
@@ -687,7 +832,7 @@ public:
 	rb_tree& operator=(const rb_tree& rhs);
 	rb_tree& operator=(rb_tree&& rhs);
 
-	~rb_tree() { clear(); }
+	~rb_tree() { clear(); base_allocator::deallocate(header_); }
 
 public:
 	// 迭代器相关操作
@@ -741,6 +886,11 @@ public:
 	template <typename ...Args>
 	iterator  emplace_unique_use_hint(iterator hint, Args&& ...args);
 
+	// 先按键值查找插入位置，键值不存在时才以 key 和 args... 就地构造节点的键与值，
+	// 键值已存在时不构造节点，也不会移动 key 与 args
+	template <typename K, typename ...Args>
+	mystl::pair<iterator, bool> try_emplace_unique(K&& key, Args&& ...args);
+
 	// insert
 
 	iterator  insert_multi(const value_type& value);
@@ -783,6 +933,21 @@ public:
 			insert_unique(end(), *first);
 	}
 
+	// 区间已按键值严格升序排列时，归并后自底向上线性构建平衡的树
+	template <typename InputIterator>
+	void      insert_unique_sorted(InputIterator first, InputIterator last);
+
+	// 插入节点句柄持有的节点，句柄为空时什么也不做
+	// unique 版本插入失败时节点留在返回值的 node 中
+	insert_return_type insert_unique(handle_type&& nh);
+	iterator           insert_multi(handle_type&& nh);
+
+	// extract
+
+	// 摘下节点并以节点句柄返回，不销毁元素；按键值摘下时取第一个匹配的节点，不存在时返回空句柄
+	handle_type extract(iterator position);
+	handle_type extract(const key_type& key);
+
 	// erase
 
 	iterator  erase(iterator hint);
@@ -795,23 +960,42 @@ public:
 	void      clear();
 
 	// rb_tree 相关操作
+	// 带模板参数 K 的版本只在 key_compare 定义了 is_transparent 时参与重载，
+	// 可以用任意能与键值比较的类型查找，不必构造临时的键值
 
-	iterator       find(const key_type& key);
-	const_iterator find(const key_type& key) const;
+	iterator       find(const key_type& key)       { return iterator(find_node(key)); }
+	const_iterator find(const key_type& key) const { return const_iterator(find_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       find(const K& key)              { return iterator(find_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator find(const K& key)        const { return const_iterator(find_node(key)); }
 
 	size_type      count_multi(const key_type& key) const {
 		auto p = equal_range_multi(key);
 		return static_cast<size_type>(mystl::distance(p.first, p.second));
 	}
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	size_type      count_multi(const K& key) const {
+		auto p = equal_range_multi(key);
+		return static_cast<size_type>(mystl::distance(p.first, p.second));
+	}
 	size_type      count_unique(const key_type& key) const {
 		return find(key) != end() ? 1 : 0;
 	}
 
-	iterator       lower_bound(const key_type& key);
-	const_iterator lower_bound(const key_type& key) const;
+	iterator       lower_bound(const key_type& key)       { return iterator(lower_bound_node(key)); }
+	const_iterator lower_bound(const key_type& key) const { return const_iterator(lower_bound_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       lower_bound(const K& key)              { return iterator(lower_bound_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator lower_bound(const K& key)        const { return const_iterator(lower_bound_node(key)); }
 
-	iterator       upper_bound(const key_type& key);
-	const_iterator upper_bound(const key_type& key) const;
+	iterator       upper_bound(const key_type& key)       { return iterator(upper_bound_node(key)); }
+	const_iterator upper_bound(const key_type& key) const { return const_iterator(upper_bound_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       upper_bound(const K& key)              { return iterator(upper_bound_node(key)); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator upper_bound(const K& key)        const { return const_iterator(upper_bound_node(key)); }
 
 	mystl::pair<iterator, iterator>             
 	equal_range_multi(const key_type& key) {
@@ -821,6 +1005,16 @@ public:
 	equal_range_multi(const key_type& key) const {
 		return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
 	}
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	mystl::pair<iterator, iterator>
+	equal_range_multi(const K& key) {
+		return mystl::pair<iterator, iterator>(lower_bound(key), upper_bound(key));
+	}
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	mystl::pair<const_iterator, const_iterator>
+	equal_range_multi(const K& key) const {
+		return mystl::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
+	}
 
 	mystl::pair<iterator, iterator>             
 	equal_range_unique(const key_type& key) {
@@ -835,6 +1029,28 @@ public:
 		return it == end() ? mystl::make_pair(it, it) : mystl::make_pair(it, ++next);
 	}
 
+	// 排名相关，只有开启排名(Ranked)的树可用，时间复杂度均为 O(log n)
+	// nth 返回第 k 个(从 0 开始)元素，k >= size() 时返回 end()
+	// rank 返回键值小于 key 的元素个数，index_of 返回 it 之前的元素个数
+	iterator       nth(size_type k);
+	const_iterator nth(size_type k) const;
+	size_type      rank(const key_type& key) const;
+	size_type      index_of(const_iterator it) const;
+
+	// 拼接、拆分与集合运算，都建立在红黑树的 join(以一个节点为枢轴拼接两颗树) 和 split(按键值拆成两颗树) 上
+	// merge 把 source 的节点并入本树，unique 版本中键值已存在的元素留在 source 中，
+	// 时间复杂度为 O(m log(n / m + 1))，m、n 分别为较小、较大一方的元素个数
+	// intersect_unique / subtract_unique 只保留 / 删除键值在 other 中出现的元素，复杂度同上
+	// split 摘出键值不小于 key 的元素，extract_range 摘出键值在 [lo, hi) 内的元素，以新树返回
+	// join 把 rhs 接在本树之后，要求 rhs 的键值都不小于本树的键值
+	void           merge_unique(rb_tree& source);
+	void           merge_multi(rb_tree& source);
+	void           intersect_unique(const rb_tree& other);
+	void           subtract_unique(const rb_tree& other);
+	rb_tree        split(const key_type& key);
+	rb_tree        extract_range(const key_type& lo, const key_type& hi);
+	void           join(rb_tree& rhs);
+
 	void swap(rb_tree& rhs) noexcept;
 
 private:
@@ -842,8 +1058,21 @@ private:
 	// node related
 	template <typename ...Args>
 	node_ptr create_node(Args&&... args);
+	template <typename K, typename ...Args>
+	node_ptr create_kv_node(K&& key, Args&&... args);
 	node_ptr clone_node(base_ptr x);
 	void     destroy_node(node_ptr p);
+	node_ptr get_node();
+	void     put_node(node_ptr p);
+	node_ptr take_handle(handle_type& nh);
+
+	// lookup
+	template <typename K>
+	base_ptr find_node(const K& key) const;
+	template <typename K>
+	base_ptr lower_bound_node(const K& key) const;
+	template <typename K>
+	base_ptr upper_bound_node(const K& key) const;
 
 	// init / reset
 	void     rb_tree_init();
@@ -866,17 +1095,53 @@ private:
 	// copy tree / erase tree
 	base_ptr copy_from(base_ptr x, base_ptr p);
 	void     erase_since(base_ptr x);
+
+	// build tree from sorted nodes
+	template <typename InputIterator>
+	base_ptr build_from_range(InputIterator& first, size_type n, size_type depth,
+	                          size_type red_depth, base_ptr& prev, bool& sorted);
+	base_ptr build_from_vine(base_ptr& vine, size_type n, size_type depth, size_type red_depth);
+	base_ptr tree_to_vine(base_ptr x);
+	void     insert_unique_vine(base_ptr vine);
+	void     attach_root(base_ptr x, size_type n);
+	static size_type balanced_red_depth(size_type n);
+
+	// join / split
+	// tree_part 表示一颗独立的子树，first 为根节点(根节点的父节点指针没有意义)，second 为黑高
+	typedef mystl::pair<base_ptr, size_type> tree_part;
+
+	tree_part take_tree();
+	void      attach_part(tree_part t, size_type n);
+	void      adopt_pool(rb_tree& from);
+	size_type take_part(tree_part t, rb_tree& from);
+	base_ptr  import_vine(base_ptr vine, rb_tree& from, size_type& n);
+	size_type destroy_tree(base_ptr x);
+	tree_part join_part(tree_part l, base_ptr k, tree_part r);
+	tree_part join2_part(tree_part l, tree_part r);
+	void      split_part(tree_part t, const key_type& key, bool unique, bool upper,
+	                     tree_part& l, base_ptr& m, tree_part& r);
+	void      split_first(tree_part t, base_ptr& m, tree_part& r);
+	tree_part union_part(tree_part a, tree_part b, bool unique, bool a_wins,
+	                     base_ptr*& dups, size_type& ndups);
+	tree_part insert_part(tree_part a, base_ptr x, bool unique, bool a_wins,
+	                      base_ptr*& dups, size_type& ndups);
+	tree_part intersect_part(tree_part a, base_ptr b, size_type& removed);
+	tree_part subtract_part(tree_part a, base_ptr b, size_type& removed);
+	static size_type black_height(base_ptr x);
+	static size_type count_nodes(base_ptr x);
+	static size_type count_nodes(base_ptr x, m_true_type);
+	static size_type count_nodes(base_ptr x, m_false_type);
 };
 
 /*****************************************************************************************/
 
 // 复制构造函数
-template <typename T, typename Compare>
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+rb_tree<T, Compare, Ranked, Pooled>::
 rb_tree(const rb_tree& rhs) {
 	rb_tree_init();
 	if (rhs.node_count_ != 0) {
-		root() = copy_from(rhs.root(), header_);
+		set_root(copy_from(rhs.root(), header_));
 		leftmost() = rb_tree_min(root());
 		rightmost() = rb_tree_max(root());
 	}
@@ -885,25 +1150,26 @@ rb_tree(const rb_tree& rhs) {
 }
 
 // 移动构造函数
-template <typename T, typename Compare>
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+rb_tree<T, Compare, Ranked, Pooled>::
 rb_tree(rb_tree&& rhs) noexcept
   :header_(mystl::move(rhs.header_)),
   node_count_(rhs.node_count_),
-  key_comp_(rhs.key_comp_){
+  key_comp_(rhs.key_comp_),
+  pool_(mystl::move(rhs.pool_)) {
 	rhs.reset();
 }
 
 // 复制赋值操作符
-template <typename T, typename Compare>
-rb_tree<T, Compare>& 
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+rb_tree<T, Compare, Ranked, Pooled>& 
+rb_tree<T, Compare, Ranked, Pooled>::
 operator=(const rb_tree& rhs) {
 	if (this != &rhs) {
 	    clear();
 
     	if (rhs.node_count_ != 0) {
-			root() = copy_from(rhs.root(), header_);
+			set_root(copy_from(rhs.root(), header_));
       		leftmost() = rb_tree_min(root());
 			rightmost() = rb_tree_max(root());
     	}
@@ -915,23 +1181,25 @@ operator=(const rb_tree& rhs) {
 }
 
 // 移动赋值操作符
-template <typename T, typename Compare>
-rb_tree<T, Compare>&
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+rb_tree<T, Compare, Ranked, Pooled>&
+rb_tree<T, Compare, Ranked, Pooled>::
 operator=(rb_tree&& rhs) {
 	clear();
+	base_allocator::deallocate(header_);
 	header_ = mystl::move(rhs.header_);
 	node_count_ = rhs.node_count_;
 	key_comp_ = rhs.key_comp_;
+	pool_ = mystl::move(rhs.pool_);
 	rhs.reset();
 	return *this;
 }
 
 // 就地插入元素，键值允许重复
-template <typename T,typename Compare>
+template <typename T, typename Compare, bool Ranked, bool Pooled>
 template <typename ...Args>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator 
+rb_tree<T, Compare, Ranked, Pooled>::
 emplace_multi(Args&& ...args) {
 	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
 	node_ptr np = create_node(mystl::forward<Args>(args)...);
@@ -940,10 +1208,10 @@ emplace_multi(Args&& ...args) {
 }
 
 // 就地插入元素，键值不允许重复
-template <typename T, typename Compare>
+template <typename T, typename Compare, bool Ranked, bool Pooled>
 template <typename ...Args>
-mystl::pair<typename rb_tree<T, Compare>::iterator, bool> 
-rb_tree<T, Compare>::
+mystl::pair<typename rb_tree<T, Compare, Ranked, Pooled>::iterator, bool> 
+rb_tree<T, Compare, Ranked, Pooled>::
 emplace_unique(Args&& ...args) {
 	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
 	node_ptr np = create_node(mystl::forward<Args>(args)...);
@@ -955,11 +1223,25 @@ emplace_unique(Args&& ...args) {
 	return mystl::make_pair(iterator(res.first.first), false);
 }
 
+// 键值不存在时才构造节点并插入
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+template <typename K, typename ...Args>
+mystl::pair<typename rb_tree<T, Compare, Ranked, Pooled>::iterator, bool>
+rb_tree<T, Compare, Ranked, Pooled>::
+try_emplace_unique(K&& key, Args&& ...args) {
+	auto res = get_insert_unique_pos(key);
+	if (!res.second)
+		return mystl::make_pair(iterator(res.first.first), false);
+	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
+	node_ptr np = create_kv_node(mystl::forward<K>(key), mystl::forward<Args>(args)...);
+	return mystl::make_pair(insert_node_at(res.first.first, np, res.first.second), true);
+}
+
 // 就地插入元素，键值允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-template <typename T, typename Compare>
+template <typename T, typename Compare, bool Ranked, bool Pooled>
 template <typename ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator
+rb_tree<T, Compare, Ranked, Pooled>::
 emplace_multi_use_hint(iterator hint, Args&& ...args) {
 	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
 	node_ptr np = create_node(mystl::forward<Args>(args)...);
@@ -989,10 +1271,10 @@ emplace_multi_use_hint(iterator hint, Args&& ...args) {
 }
 
 // 就地插入元素，键值不允许重复，当 hint 位置与插入位置接近时，插入操作的时间复杂度可以降低
-template<typename T, typename Compare>
+template <typename T, typename Compare, bool Ranked, bool Pooled>
 template<typename ...Args>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator
+rb_tree<T, Compare, Ranked, Pooled>::
 emplace_unique_use_hint(iterator hint, Args&& ...args) {
 	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
 	node_ptr np = create_node(mystl::forward<Args>(args)...);
@@ -1027,9 +1309,9 @@ emplace_unique_use_hint(iterator hint, Args&& ...args) {
 }
 
 // 插入元素，节点键值允许重复
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator
+rb_tree<T, Compare, Ranked, Pooled>::
 insert_multi(const value_type& value) {
 	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
 	auto res = get_insert_multi_pos(value_traits::get_key(value));
@@ -1037,9 +1319,9 @@ insert_multi(const value_type& value) {
 }
 
 // 插入新值，节点键值不允许重复，返回一个 pair，若插入成功，pair 的第二参数为 true，否则为 false
-template <typename T, typename Compare>
-mystl::pair<typename rb_tree<T, Compare>::iterator, bool>
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+mystl::pair<typename rb_tree<T, Compare, Ranked, Pooled>::iterator, bool>
+rb_tree<T, Compare, Ranked, Pooled>::
 insert_unique(const value_type& value) {
 	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - 1, "rb_tree<T, Comp>'s size too big");
 	auto res = get_insert_unique_pos(value_traits::get_key(value));
@@ -1050,24 +1332,89 @@ insert_unique(const value_type& value) {
 }
 
 // 删除 hint 位置的节点
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator
+rb_tree<T, Compare, Ranked, Pooled>::
 erase(iterator hint) {
 	auto node = hint.node->get_node_ptr();
 	iterator next(node);
 	++next;
 
-	rb_tree_erase_rebalance(hint.node, root(), leftmost(), rightmost());
+	auto r = root();
+	rb_tree_erase_rebalance(hint.node, r, leftmost(), rightmost());
+	set_root(r);
 	destroy_node(node);
 	--node_count_;
 	return next;
 }
 
+// 插入节点句柄持有的节点，键值不允许重复
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::insert_return_type
+rb_tree<T, Compare, Ranked, Pooled>::
+insert_unique(handle_type&& nh) {
+	if (nh.empty())
+		return insert_return_type{ end(), false, handle_type() };
+	auto res = get_insert_unique_pos(value_traits::get_key(nh.node_->value));
+	if (!res.second)
+		return insert_return_type{ iterator(res.first.first), false, mystl::move(nh) };
+	auto np = take_handle(nh);
+	return insert_return_type{ insert_node_at(res.first.first, np, res.first.second), true, handle_type() };
+}
+
+// 插入节点句柄持有的节点，键值允许重复
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator
+rb_tree<T, Compare, Ranked, Pooled>::
+insert_multi(handle_type&& nh) {
+	if (nh.empty())
+		return end();
+	auto res = get_insert_multi_pos(value_traits::get_key(nh.node_->value));
+	auto np = take_handle(nh);
+	return insert_node_at(res.first, np, res.second);
+}
+
+// 摘下 position 处的节点
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::handle_type
+rb_tree<T, Compare, Ranked, Pooled>::
+extract(iterator position) {
+	auto node = position.node->get_node_ptr();
+	auto np = node;
+	if (Pooled) {
+		// 句柄中的节点不能属于本树的节点池，先把元素移到单独申请的节点中，失败时树保持不变
+		np = node_allocator::allocate(1);
+		try {
+			data_allocator::construct(mystl::address_of(np->value), mystl::move(node->value));
+		}catch (...) {
+			node_allocator::deallocate(np);
+			throw;
+		}
+	}
+	auto r = root();
+	rb_tree_erase_rebalance(position.node, r, leftmost(), rightmost());
+	set_root(r);
+	--node_count_;
+	if (Pooled)
+		destroy_node(node);
+	return handle_type::from_node(np);
+}
+
+// 摘下第一个键值等于 key 的节点
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::handle_type
+rb_tree<T, Compare, Ranked, Pooled>::
+extract(const key_type& key) {
+	auto it = lower_bound(key);
+	if (it == end() || key_comp_(key, value_traits::get_key(*it)))
+		return handle_type();
+	return extract(it);
+}
+
 // 删除键值等于 key 的元素，返回删除的个数
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
 erase_multi(const key_type& key) {
 	auto p = equal_range_multi(key);
 	size_type n = mystl::distance(p.first, p.second);
@@ -1076,9 +1423,9 @@ erase_multi(const key_type& key) {
 }
 
 // 删除键值等于 key 的元素，返回删除的个数
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::size_type
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
 erase_unique(const key_type& key) {
 	auto it = find(key);
 	if (it != end()) {
@@ -1089,8 +1436,8 @@ erase_unique(const key_type& key) {
 }
 
 // 删除[first, last)区间内的元素
-template <typename T, typename Compare>
-void rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
 erase(iterator first, iterator last) {
 	if (first == begin() && last == end()) {
 		clear();
@@ -1101,58 +1448,124 @@ erase(iterator first, iterator last) {
 }
 
 // 清空 rb tree
-template <typename T, typename Compare>
-void rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
 clear() {
 	if (node_count_ != 0) {
-		erase_since(root());
+		if (Pooled) {
+			// 只析构元素，节点内存由节点池整块归还，不必逐个释放
+			if (!std::is_trivially_destructible<T>::value) {
+				for (auto it = begin(); it != end(); ++it)
+					data_allocator::destroy(mystl::address_of(*it));
+			}
+			pool_.release();
+		}else {
+			erase_since(root());
+		}
 		leftmost() = header_;
-		root() = nullptr;
+		set_root(nullptr);
 		rightmost() = header_;
 		node_count_ = 0;
 	}
 }
 
-// 查找键值为 k 的节点，返回指向它的迭代器
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
-find(const key_type& key) {
-	auto y = header_;  // 最后一个不小于 key 的节点
-	auto x = root();
-	while (x != nullptr) {
-		if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) { // key 小于等于 x 键值，向左走
-			y = x, x = x->left;
-		}else { // key 大于 x 键值，向右走
-			x = x->right;
+// 按键值严格升序、无重复的区间插入元素
+// 树为空时直接从区间自底向上构建一颗平衡的树；否则先把新元素构造成有序链表，
+// 若新元素相对已有元素足够多，把已有的树也压成有序链表，两者归并(键值已存在的新元素被丢弃)后重建；
+// 新元素很少，或者区间实际上并不有序时，退化为逐个插入
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+template <typename InputIterator>
+void rb_tree<T, Compare, Ranked, Pooled>::
+insert_unique_sorted(InputIterator first, InputIterator last) {
+	size_type n = mystl::distance(first, last);
+	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - n, "rb_tree<T, Comp>'s size too big");
+	if (n == 0)
+		return;
+	bool sorted = true;
+	if (node_count_ == 0) {
+		base_ptr prev = nullptr;
+		auto x = build_from_range(first, n, 0, balanced_red_depth(n), prev, sorted);
+		if (sorted)
+			attach_root(x, n);
+		else
+			insert_unique_vine(tree_to_vine(x));
+		return;
+	}
+	// 新节点以 right 相连，构造失败时销毁已构造的节点
+	base_ptr head = nullptr;
+	base_ptr tail = nullptr;
+	try {
+		for (size_type i = 0; i < n; ++i, ++first) {
+			base_ptr node = create_node(*first);
+			if (tail == nullptr) {
+				head = node;
+			}else {
+				if (!key_comp_(value_traits::get_key(tail->get_node_ptr()->value),
+					value_traits::get_key(node->get_node_ptr()->value)))
+					sorted = false;
+				tail->right = node;
+			}
+			tail = node;
 		}
+	}catch (...) {
+		while (head != nullptr) {
+			auto next = head->right;
+			destroy_node(head->get_node_ptr());
+			head = next;
+		}
+		throw;
 	}
-	iterator j = iterator(y);
-	return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
-}
-
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
-find(const key_type& key) const {
-	auto y = header_;  // 最后一个不小于 key 的节点
-	auto x = root();
-	while (x != nullptr) {
-		if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) { // key 小于等于 x 键值，向左走
-			y = x, x = x->left;
-		}else { // key 大于 x 键值，向右走
-			x = x->right;
+	// 新元素个数 n 满足 n * log2(size) < size 时，逐个插入更快
+	size_type lg = 0;
+	for (size_type k = node_count_; k > 1; k >>= 1)
+		++lg;
+	if (!sorted || n * lg < node_count_) {
+		insert_unique_vine(head);
+		return;
+	}
+	// 归并两条有序链表
+	auto old = tree_to_vine(root());
+	base_ptr merged = nullptr;
+	base_ptr* link = &merged;
+	n = node_count_;
+	while (head != nullptr) {
+		if (old != nullptr && key_comp_(value_traits::get_key(old->get_node_ptr()->value),
+			value_traits::get_key(head->get_node_ptr()->value))) {
+			*link = old;
+			link = &old->right;
+			old = old->right;
+		}else if (old == nullptr || key_comp_(value_traits::get_key(head->get_node_ptr()->value),
+			value_traits::get_key(old->get_node_ptr()->value))) {
+			*link = head;
+			link = &head->right;
+			head = head->right;
+			++n;
+		}else {  // 键值已存在
+			auto next = head->right;
+			destroy_node(head->get_node_ptr());
+			head = next;
 		}
 	}
-	const_iterator j = const_iterator(y);
-	return (j == end() || key_comp_(key, value_traits::get_key(*j))) ? end() : j;
+	*link = old;
+	attach_root(build_from_vine(merged, n, 0, balanced_red_depth(n)), n);
+}
+
+// 查找键值等价于 key 的节点，不存在时返回 header_
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+template <typename K>
+typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+find_node(const K& key) const {
+	auto y = lower_bound_node(key);
+	return (y == header_ || key_comp_(key, value_traits::get_key(y->get_node_ptr()->value))) ? header_ : y;
 }
 
-// 键值不小于 key 的第一个位置
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
-lower_bound(const key_type& key) {
+// 键值不小于 key 的第一个节点
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+template <typename K>
+typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+lower_bound_node(const K& key) const {
 	auto y = header_;
 	auto x = root();
 	while (x != nullptr) {
@@ -1162,66 +1575,248 @@ lower_bound(const key_type& key) {
 			x = x->right;
 		}
 	}
-	return iterator(y);
+	return y;
 }
 
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
-lower_bound(const key_type& key) const {
+// 键值大于 key 的第一个节点
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+template <typename K>
+typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+upper_bound_node(const K& key) const {
 	auto y = header_;
 	auto x = root();
 	while (x != nullptr) {
-		if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) { // key <= x
+		if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
 			y = x, x = x->left;
 		}else {
 			x = x->right;
 		}
 	}
-	return const_iterator(y);
+	return y;
 }
 
-// 键值不小于 key 的最后一个位置
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
-upper_bound(const key_type& key) {
-	auto y = header_;
+// 按序号查找元素，从根节点出发，根据左子树的节点数决定向左还是向右
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator
+rb_tree<T, Compare, Ranked, Pooled>::
+nth(size_type k) {
+	static_assert(Ranked, "nth requires a ranked rb_tree");
 	auto x = root();
 	while (x != nullptr) {
-		if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
-			y = x, x = x->left;
+		const size_type ls = rb_tree_size(x->left);
+		if (k < ls) {
+			x = x->left;
+		}else if (k == ls) {
+			return iterator(x);
 		}else {
+			k -= ls + 1;
 			x = x->right;
 		}
 	}
-  return iterator(y);
+	return end();
 }
 
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::const_iterator
-rb_tree<T, Compare>::
-upper_bound(const key_type& key) const {
-	auto y = header_;
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::const_iterator
+rb_tree<T, Compare, Ranked, Pooled>::
+nth(size_type k) const {
+	return const_cast<rb_tree*>(this)->nth(k);
+}
+
+// 键值小于 key 的元素个数，与 lower_bound 走同一条路径，向右走时累加左子树和当前节点
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+rank(const key_type& key) const {
+	static_assert(Ranked, "rank requires a ranked rb_tree");
+	size_type n = 0;
 	auto x = root();
-	while (x != nullptr){
-		if (key_comp_(key, value_traits::get_key(x->get_node_ptr()->value))) { // key < x
-			y = x, x = x->left;
+	while (x != nullptr) {
+		if (!key_comp_(value_traits::get_key(x->get_node_ptr()->value), key)) { // x >= key
+			x = x->left;
 		}else {
+			n += rb_tree_size(x->left) + 1;
 			x = x->right;
 		}
 	}
-	return const_iterator(y);
+	return n;
+}
+
+// it 之前的元素个数，从 it 向上走到根节点，每当从右子树上来时累加左兄弟子树和父节点
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+index_of(const_iterator it) const {
+	static_assert(Ranked, "index_of requires a ranked rb_tree");
+	base_ptr x = it.node;
+	if (x == header_)
+		return node_count_;
+	size_type n = rb_tree_size(x->left);
+	const auto r = root();
+	while (x != r) {
+		auto p = x->parent();
+		if (p->right == x)
+			n += rb_tree_size(p->left) + 1;
+		x = p;
+	}
+	return n;
+}
+
+// 把 source 中的元素并入本树，键值已存在的元素留在 source 中
+// 以较小一方的根为枢轴拆开较大的一方，两边递归合并后再以枢轴 join 起来，只有被拆开的路径会被访问
+// 开启节点池时先让 source 的节点归本树的节点池所有，留在 source 中的元素再移回它自己的节点池，指向它们的迭代器失效
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+merge_unique(rb_tree& source) {
+	if (this == &source || source.node_count_ == 0)
+		return;
+	const bool mine_larger = node_count_ >= source.node_count_;
+	const size_type n = node_count_ + source.node_count_;
+	adopt_pool(source);
+	auto a = take_tree();
+	auto b = source.take_tree();
+	base_ptr dups = nullptr;
+	base_ptr* link = &dups;
+	size_type ndups = 0;
+	auto t = mine_larger ? union_part(a, b, true, true, link, ndups)
+	                     : union_part(b, a, true, false, link, ndups);
+	*link = nullptr;
+	attach_part(t, n - ndups);
+	// 重复的元素已按升序排好，直接在 source 中重建
+	if (ndups != 0) {
+		dups = source.import_vine(dups, *this, ndups);
+		source.attach_root(source.build_from_vine(dups, ndups, 0, balanced_red_depth(ndups)), ndups);
+	}
+}
+
+// 把 source 中的元素全部并入本树，source 中的元素排在键值相同的已有元素之后
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+merge_multi(rb_tree& source) {
+	if (this == &source || source.node_count_ == 0)
+		return;
+	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - source.node_count_,
+	                      "rb_tree<T, Comp>'s size too big");
+	const bool mine_larger = node_count_ >= source.node_count_;
+	const size_type n = node_count_ + source.node_count_;
+	adopt_pool(source);
+	auto a = take_tree();
+	auto b = source.take_tree();
+	base_ptr dups = nullptr;
+	base_ptr* link = &dups;
+	size_type ndups = 0;
+	attach_part(mine_larger ? union_part(a, b, false, true, link, ndups)
+	                        : union_part(b, a, false, false, link, ndups), n);
+}
+
+// 只保留键值在 other 中出现的元素
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+intersect_unique(const rb_tree& other) {
+	if (this == &other || node_count_ == 0)
+		return;
+	const size_type n = node_count_;
+	size_type removed = 0;
+	auto t = intersect_part(take_tree(), other.root(), removed);
+	attach_part(t, n - removed);
+}
+
+// 删除键值在 other 中出现的元素
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+subtract_unique(const rb_tree& other) {
+	if (this == &other) {
+		clear();
+		return;
+	}
+	if (node_count_ == 0 || other.node_count_ == 0)
+		return;
+	const size_type n = node_count_;
+	size_type removed = 0;
+	auto t = subtract_part(take_tree(), other.root(), removed);
+	attach_part(t, n - removed);
+}
+
+// 摘出键值不小于 key 的元素，以一颗新树返回
+// 拆分本身为 O(log n)；新树需要知道元素个数，未开启排名时要数一遍被摘出的节点，
+// 开启节点池时被摘出的元素还要移到新树的节点池中，这两种情况下为 O(log n + k)
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+rb_tree<T, Compare, Ranked, Pooled>
+rb_tree<T, Compare, Ranked, Pooled>::
+split(const key_type& key) {
+	rb_tree result;
+	result.key_comp_ = key_comp_;
+	if (node_count_ == 0)
+		return result;
+	const size_type n = node_count_;
+	tree_part l, r;
+	base_ptr m = nullptr;
+	split_part(take_tree(), key, false, false, l, m, r);
+	size_type k = 0;
+	try {
+		k = result.take_part(r, *this);
+	}catch (...) {
+		attach_part(l, count_nodes(l.first));
+		throw;
+	}
+	attach_part(l, n - k);
+	return result;
+}
+
+// 摘出键值在 [lo, hi) 内的元素，以一颗新树返回，剩余的两段重新 join 起来
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+rb_tree<T, Compare, Ranked, Pooled>
+rb_tree<T, Compare, Ranked, Pooled>::
+extract_range(const key_type& lo, const key_type& hi) {
+	rb_tree result;
+	result.key_comp_ = key_comp_;
+	if (node_count_ == 0 || !key_comp_(lo, hi))
+		return result;
+	const size_type n = node_count_;
+	tree_part a, b, c, rest;
+	base_ptr m = nullptr;
+	split_part(take_tree(), lo, false, false, a, m, rest);
+	split_part(rest, hi, false, false, b, m, c);
+	auto t = join2_part(a, c);
+	size_type k = 0;
+	try {
+		k = result.take_part(b, *this);
+	}catch (...) {
+		attach_part(t, count_nodes(t.first));
+		throw;
+	}
+	attach_part(t, n - k);
+	return result;
+}
+
+// 把 rhs 中的元素接在本树之后，rhs 变为空树
+// 摘下 rhs 的最小节点作为枢轴，沿较高一方的脊柱找到黑高相同的位置挂入，时间复杂度为 O(log n)
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+join(rb_tree& rhs) {
+	if (this == &rhs || rhs.node_count_ == 0)
+		return;
+	MYSTL_DEBUG(node_count_ == 0 ||
+	            !key_comp_(value_traits::get_key(rhs.leftmost()->get_node_ptr()->value),
+	                       value_traits::get_key(rightmost()->get_node_ptr()->value)));
+	THROW_LENGTH_ERROR_IF(node_count_ > max_size() - rhs.node_count_,
+	                      "rb_tree<T, Comp>'s size too big");
+	const size_type n = node_count_ + rhs.node_count_;
+	adopt_pool(rhs);
+	auto l = take_tree();
+	attach_part(join2_part(l, rhs.take_tree()), n);
 }
 
 // 交换 rb tree
-template <typename T, typename Compare>
-void rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
 swap(rb_tree& rhs) noexcept {
 	if (this != &rhs) {
 		mystl::swap(header_, rhs.header_);
 		mystl::swap(node_count_, rhs.node_count_);
 		mystl::swap(key_comp_, rhs.key_comp_);
+		pool_.swap(rhs.pool_);
   	}
 }
 
@@ -1229,67 +1824,128 @@ swap(rb_tree& rhs) noexcept {
 // helper function
 
 // 创建一个结点
-template <typename T, typename Compare>
+template <typename T, typename Compare, bool Ranked, bool Pooled>
 template <typename ...Args>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::
+typename rb_tree<T, Compare, Ranked, Pooled>::node_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
 create_node(Args&&... args) {
-	auto tmp = node_allocator::allocate(1);
+	auto tmp = get_node();
 	try {
 		data_allocator::construct(mystl::address_of(tmp->value), mystl::forward<Args>(args)...);
 		tmp->left = nullptr;
 		tmp->right = nullptr;
-		tmp->parent = nullptr;
+		tmp->parent_color = 0;
 	}catch (...) {
-		node_allocator::deallocate(tmp);
+		put_node(tmp);
 		throw;
 	}
 	return tmp;
 }
 
+// 以 key 构造键、以 args... 就地构造值，不经过 mapped_type 的临时对象
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+template <typename K, typename ...Args>
+typename rb_tree<T, Compare, Ranked, Pooled>::node_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+create_kv_node(K&& key, Args&&... args) {
+	auto tmp = get_node();
+	key_type* kp = const_cast<key_type*>(mystl::address_of(tmp->value.first));
+	try {
+		mystl::construct(kp, mystl::forward<K>(key));
+	}catch (...) {
+		put_node(tmp);
+		throw;
+	}
+	try {
+		mystl::construct(mystl::address_of(tmp->value.second), mystl::forward<Args>(args)...);
+	}catch (...) {
+		mystl::destroy(kp);
+		put_node(tmp);
+		throw;
+	}
+	tmp->left = nullptr;
+	tmp->right = nullptr;
+	tmp->parent_color = 0;
+	return tmp;
+}
+
 // 复制一个结点
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::node_ptr
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::node_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
 clone_node(base_ptr x) {
 	node_ptr tmp = create_node(x->get_node_ptr()->value);
-	tmp->color = x->color;
+	tmp->set_color(x->color());
+	rb_tree_size_copy(tmp->get_base_ptr(), x);
 	tmp->left = nullptr;
 	tmp->right = nullptr;
 	return tmp;
 }
 
 // 销毁一个结点
-template <typename T, typename Compare>
-void rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
 destroy_node(node_ptr p) {
 	data_allocator::destroy(&p->value);
-	node_allocator::deallocate(p);
+	put_node(p);
+}
+
+// 申请 / 归还一个结点的内存
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::node_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+get_node() {
+	return pool_.allocate();
+}
+
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+put_node(node_ptr p) {
+	pool_.deallocate(p);
+}
+
+// take_handle 函数
+// 取出句柄中的节点作为本树待插入的节点
+// 开启节点池时，在本树的节点池中以移动的方式重新构造元素，原节点由句柄释放，构造失败时句柄仍持有原节点
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::node_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+take_handle(handle_type& nh) {
+	if (Pooled) {
+		auto np = create_node(mystl::move(nh.node_->value));
+		nh.destroy();
+		return np;
+	}
+	auto np = nh.release();
+	np->left = nullptr;
+	np->right = nullptr;
+	np->parent_color = 0;
+	return np;
 }
 
 // 初始化容器
-template <typename T, typename Compare>
-void rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
 rb_tree_init() {
 	header_ = base_allocator::allocate(1);
-	header_->color = rb_tree_red;  // header_ 节点颜色为红，与 root 区分
-	root() = nullptr;
+	header_->parent_color = 0;
+	header_->set_color(rb_tree_red);  // header_ 节点颜色为红，与 root 区分
 	leftmost() = header_;
 	rightmost() = header_;
 	node_count_ = 0;
 }
 
 // reset 函数
-template <typename T, typename Compare>
-void rb_tree<T, Compare>::reset() {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::reset() {
 	header_ = nullptr;
 	node_count_ = 0;
 }
 
 // get_insert_multi_pos 函数
-template <typename T, typename Compare>
-mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>
-rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key) {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+mystl::pair<typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr, bool>
+rb_tree<T, Compare, Ranked, Pooled>::get_insert_multi_pos(const key_type& key) {
 	auto x = root();
 	auto y = header_;
 	bool add_to_left = true;
@@ -1302,11 +1958,11 @@ rb_tree<T, Compare>::get_insert_multi_pos(const key_type& key) {
 }
 
 // get_insert_unique_pos 函数
-template <typename T, typename Compare>
-mystl::pair<mystl::pair<typename rb_tree<T, Compare>::base_ptr, bool>, bool>
-rb_tree<T, Compare>::get_insert_unique_pos(const key_type& key) { 
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+mystl::pair<mystl::pair<typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr, bool>, bool>
+rb_tree<T, Compare, Ranked, Pooled>::get_insert_unique_pos(const key_type& key) { 
 	// 返回一个 pair，第一个值为一个 pair，包含插入点的父节点和一个 bool 表示是否在左边插入，
-	// 第二个值为一个 bool，表示是否插入成功
+	// 第二个值为一个 bool，表示是否插入成功；插入失败时第一个节点为键值重复的节点
 	auto x = root();
 	auto y = header_;
 	bool add_to_left = true;  // 树为空时也在 header_ 左边插入
@@ -1327,20 +1983,20 @@ rb_tree<T, Compare>::get_insert_unique_pos(const key_type& key) {
 		return mystl::make_pair(mystl::make_pair(y, add_to_left), true);
 	}
 	// 进行至此，表示新节点与现有节点键值重复
-	return mystl::make_pair(mystl::make_pair(y, add_to_left), false);
+	return mystl::make_pair(mystl::make_pair(j.node, add_to_left), false);
 }
 
 // insert_value_at 函数
 // x 为插入点的父节点， value 为要插入的值，add_to_left 表示是否在左边插入
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator
+rb_tree<T, Compare, Ranked, Pooled>::
 insert_value_at(base_ptr x, const value_type& value, bool add_to_left) {
 	node_ptr node = create_node(value);
-	node->parent = x;
+	node->set_parent(x);
 	auto base_node = node->get_base_ptr();
 	if (x == header_) {
-		root() = base_node;
+		set_root(base_node);
 		leftmost() = base_node;
 		rightmost() = base_node;
 	}else if (add_to_left) {
@@ -1352,21 +2008,23 @@ insert_value_at(base_ptr x, const value_type& value, bool add_to_left) {
 		if (rightmost() == x)
 		rightmost() = base_node;
 	}
-	rb_tree_insert_rebalance(base_node, root());
+	auto r = root();
+	rb_tree_insert_rebalance(base_node, r);
+	set_root(r);
 	++node_count_;
 	return iterator(node);
 }
 
 // 在 x 节点处插入新的节点
 // x 为插入点的父节点， node 为要插入的节点，add_to_left 表示是否在左边插入
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator
+rb_tree<T, Compare, Ranked, Pooled>::
 insert_node_at(base_ptr x, node_ptr node, bool add_to_left) {
-	node->parent = x;
+	node->set_parent(x);
 	auto base_node = node->get_base_ptr();
 	if (x == header_) {
-		root() = base_node;
+		set_root(base_node);
 		leftmost() = base_node;
 		rightmost() = base_node;
 	}else if (add_to_left) {
@@ -1378,15 +2036,17 @@ insert_node_at(base_ptr x, node_ptr node, bool add_to_left) {
 		if (rightmost() == x)
 		rightmost() = base_node;
 	}
-	rb_tree_insert_rebalance(base_node, root());
+	auto r = root();
+	rb_tree_insert_rebalance(base_node, r);
+	set_root(r);
 	++node_count_;
 	return iterator(node);
 }
 
 // 插入元素，键值允许重复，使用 hint
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator 
+rb_tree<T, Compare, Ranked, Pooled>::
 insert_multi_use_hint(iterator hint, key_type key, node_ptr node) {
 	// 在 hint 附近寻找可插入的位置
 	auto np = hint.node;
@@ -1406,9 +2066,9 @@ insert_multi_use_hint(iterator hint, key_type key, node_ptr node) {
 }
 
 // 插入元素，键值不允许重复，使用 hint
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::iterator 
-rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::iterator 
+rb_tree<T, Compare, Ranked, Pooled>::
 insert_unique_use_hint(iterator hint, key_type key, node_ptr node) {
 	// 在 hint 附近寻找可插入的位置
 	auto np = hint.node;
@@ -1433,11 +2093,11 @@ insert_unique_use_hint(iterator hint, key_type key, node_ptr node) {
 
 // copy_from 函数
 // 递归复制一颗树，节点从 x 开始，p 为 x 的父节点
-template <typename T, typename Compare>
-typename rb_tree<T, Compare>::base_ptr
-rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p) {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr
+rb_tree<T, Compare, Ranked, Pooled>::copy_from(base_ptr x, base_ptr p) {
 	auto top = clone_node(x);
-	top->parent = p;
+	top->set_parent(p);
 	try {
 		if (x->right)
 			top->right = copy_from(x->right, top);
@@ -1446,7 +2106,7 @@ rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p) {
 		while (x != nullptr) {
 			auto y = clone_node(x);
 			p->left = y;
-			y->parent = p;
+			y->set_parent(p);
 			if (x->right)
 			y->right = copy_from(x->right, y);
 			p = y;
@@ -1461,8 +2121,8 @@ rb_tree<T, Compare>::copy_from(base_ptr x, base_ptr p) {
 
 // erase_since 函数
 // 从 x 节点开始删除该节点及其子树
-template <typename T, typename Compare>
-void rb_tree<T, Compare>::
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
 erase_since(base_ptr x) {
 	while (x != nullptr) {
 		erase_since(x->right);
@@ -1472,40 +2132,630 @@ erase_since(base_ptr x) {
 	}
 }
 
+// build_from_range 函数
+// 从 first 开始按序取出 n 个元素构造节点，构建一颗以中间元素为根的子树，depth 为子树根的深度
+// 这样构建的树中空链接的深度只相差一，深度为 red_depth 的节点(最底下不满的一层)染红，其余染黑
+// prev 为上一个构造的节点，发现相邻元素不是严格升序时把 sorted 置为 false；构造失败时销毁整颗子树
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+template <typename InputIterator>
+typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+build_from_range(InputIterator& first, size_type n, size_type depth,
+                 size_type red_depth, base_ptr& prev, bool& sorted) {
+	if (n == 0)
+		return nullptr;
+	const size_type ln = (n - 1) / 2;
+	auto left = build_from_range(first, ln, depth + 1, red_depth, prev, sorted);
+	base_ptr top = nullptr;
+	try {
+		top = create_node(*first);
+	}catch (...) {
+		erase_since(left);
+		throw;
+	}
+	++first;
+	if (prev != nullptr && !key_comp_(value_traits::get_key(prev->get_node_ptr()->value),
+		value_traits::get_key(top->get_node_ptr()->value)))
+		sorted = false;
+	prev = top;
+	top->set_color(depth == red_depth ? rb_tree_red : rb_tree_black);
+	rb_tree_size_set(top, n);
+	top->left = left;
+	if (left != nullptr)
+		left->set_parent(top);
+	try {
+		top->right = build_from_range(first, n - 1 - ln, depth + 1, red_depth, prev, sorted);
+	}catch (...) {
+		erase_since(top);
+		throw;
+	}
+	if (top->right != nullptr)
+		top->right->set_parent(top);
+	return top;
+}
+
+// build_from_vine 函数
+// 与 build_from_range 相同，但节点从以 right 相连的有序链表 vine 中取出
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+build_from_vine(base_ptr& vine, size_type n, size_type depth, size_type red_depth) {
+	if (n == 0)
+		return nullptr;
+	const size_type ln = (n - 1) / 2;
+	auto left = build_from_vine(vine, ln, depth + 1, red_depth);
+	auto top = vine;
+	vine = vine->right;
+	top->set_color(depth == red_depth ? rb_tree_red : rb_tree_black);
+	rb_tree_size_set(top, n);
+	top->left = left;
+	if (left != nullptr)
+		left->set_parent(top);
+	top->right = build_from_vine(vine, n - 1 - ln, depth + 1, red_depth);
+	if (top->right != nullptr)
+		top->right->set_parent(top);
+	return top;
+}
+
+// tree_to_vine 函数
+// 通过不断右旋把以 x 为根的树压成以 right 相连的有序链表，返回表头，不维护父节点和颜色
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+tree_to_vine(base_ptr x) {
+	base_type pseudo;
+	pseudo.right = x;
+	base_ptr tail = &pseudo;
+	base_ptr rest = tail->right;
+	while (rest != nullptr) {
+		if (rest->left == nullptr) {
+			tail = rest;
+			rest = rest->right;
+		}else {
+			auto y = rest->left;
+			rest->left = y->right;
+			y->right = rest;
+			rest = y;
+			tail->right = y;
+		}
+	}
+	return pseudo.right;
+}
+
+// insert_unique_vine 函数
+// 把以 right 相连的链表 vine 中的节点逐个插入，键值已存在的节点被销毁
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+insert_unique_vine(base_ptr vine) {
+	while (vine != nullptr) {
+		auto next = vine->right;
+		auto node = vine->get_node_ptr();
+		node->left = nullptr;
+		node->right = nullptr;
+		auto pos = get_insert_unique_pos(value_traits::get_key(node->value));
+		if (pos.second)
+			insert_node_at(pos.first.first, node, pos.first.second);
+		else
+			destroy_node(node);
+		vine = next;
+	}
+}
+
+// attach_root 函数
+// 以 x 为根、含 n 个节点的树替换整棵树
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+attach_root(base_ptr x, size_type n) {
+	x->set_parent(header_);
+	set_root(x);
+	leftmost() = rb_tree_min(x);
+	rightmost() = rb_tree_max(x);
+	node_count_ = n;
+}
+
+// balanced_red_depth 函数
+// 返回 floor(log2(n + 1))，n 个节点的平衡树中深度小于它的各层都是满的
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+balanced_red_depth(size_type n) {
+	size_type depth = 0;
+	for (size_type k = n + 1; k > 1; k >>= 1)
+		++depth;
+	return depth;
+}
+
+// take_tree 函数
+// 把整棵树作为一颗独立的子树摘下，本树变为空树
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::tree_part
+rb_tree<T, Compare, Ranked, Pooled>::
+take_tree() {
+	auto x = root();
+	set_root(nullptr);
+	leftmost() = header_;
+	rightmost() = header_;
+	node_count_ = 0;
+	return tree_part(x, black_height(x));
+}
+
+// attach_part 函数
+// 以子树 t 替换整棵树，n 为 t 中的节点数
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+attach_part(tree_part t, size_type n) {
+	if (t.first == nullptr) {
+		set_root(nullptr);
+		leftmost() = header_;
+		rightmost() = header_;
+		node_count_ = 0;
+	}else {
+		rb_tree_set_black(t.first);
+		attach_root(t.first, n);
+	}
+}
+
+// adopt_pool 函数
+// 开启节点池时，接管 from 的节点池，让 from 的节点都归本树的节点池所有
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+adopt_pool(rb_tree& from) {
+	pool_.splice(from.pool_);
+}
+
+// take_part 函数
+// 以从 from 中拆出的子树 t 作为本树(空树)的全部节点，返回节点数
+// 开启节点池且 from 不是本树时，节点要移到本树的节点池中，压成链表逐个移动后重新构建
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+take_part(tree_part t, rb_tree& from) {
+	if (t.first == nullptr)
+		return 0;
+	if (Pooled && &from != this) {
+		size_type n = 0;
+		auto vine = import_vine(from.tree_to_vine(t.first), from, n);
+		attach_root(build_from_vine(vine, n, 0, balanced_red_depth(n)), n);
+		return n;
+	}
+	attach_part(t, count_nodes(t.first));
+	return node_count_;
+}
+
+// import_vine 函数
+// 把属于 from、以 right 相连的链表 vine 变为本树的节点，返回新的链表，n 为节点数
+// 开启节点池且 from 不是本树时，在本树的节点池中以移动的方式重新构造元素并销毁原节点，
+// 构造失败时销毁两边剩余的节点
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::base_ptr
+rb_tree<T, Compare, Ranked, Pooled>::
+import_vine(base_ptr vine, rb_tree& from, size_type& n) {
+	n = 0;
+	if (Pooled && &from != this) {
+		base_ptr head = nullptr;
+		base_ptr* link = &head;
+		try {
+			while (vine != nullptr) {
+				base_ptr node = create_node(mystl::move(vine->get_node_ptr()->value));
+				auto next = vine->right;
+				from.destroy_node(vine->get_node_ptr());
+				vine = next;
+				*link = node;
+				link = &node->right;
+				++n;
+			}
+		}catch (...) {
+			*link = nullptr;
+			while (head != nullptr) {
+				auto next = head->right;
+				destroy_node(head->get_node_ptr());
+				head = next;
+			}
+			while (vine != nullptr) {
+				auto next = vine->right;
+				from.destroy_node(vine->get_node_ptr());
+				vine = next;
+			}
+			throw;
+		}
+		return head;
+	}
+	for (auto x = vine; x != nullptr; x = x->right)
+		++n;
+	return vine;
+}
+
+// destroy_tree 函数
+// 销毁以 x 为根的子树，返回销毁的节点数
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+destroy_tree(base_ptr x) {
+	size_type n = 0;
+	for (auto vine = tree_to_vine(x); vine != nullptr; ++n) {
+		auto next = vine->right;
+		destroy_node(vine->get_node_ptr());
+		vine = next;
+	}
+	return n;
+}
+
+// join_part 函数
+// 以节点 k 为枢轴拼接子树 l 和 r，要求 l 的键值不大于 k，r 的键值不小于 k
+// 两边黑高相同时 k 直接作为新的黑色根节点；否则沿较高一方朝向另一方的脊柱往下走，
+// 找到黑高与较矮一方相同的黑色节点 c，以红色的 k 取代 c，c 和较矮的一方成为 k 的两个孩子，
+// 再像插入一个红色节点那样向上修复，时间复杂度为 O(两边黑高之差 + 1)
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::tree_part
+rb_tree<T, Compare, Ranked, Pooled>::
+join_part(tree_part l, base_ptr k, tree_part r) {
+	// 根节点为红时先染黑，黑高加一
+	if (l.first != nullptr && rb_tree_is_red(l.first)) {
+		rb_tree_set_black(l.first);
+		++l.second;
+	}
+	if (r.first != nullptr && rb_tree_is_red(r.first)) {
+		rb_tree_set_black(r.first);
+		++r.second;
+	}
+	if (l.second == r.second) {
+		k->left = l.first;
+		k->right = r.first;
+		if (l.first != nullptr)
+			l.first->set_parent(k);
+		if (r.first != nullptr)
+			r.first->set_parent(k);
+		rb_tree_set_black(k);
+		rb_tree_size_update(k);
+		return tree_part(k, l.second + 1);
+	}
+	const bool to_right = l.second > r.second;  // 较矮的一方挂在较高一方的右(左)脊柱上
+	tree_part& tall = to_right ? l : r;
+	tree_part& low = to_right ? r : l;
+	base_ptr p = nullptr;
+	base_ptr c = tall.first;
+	size_type h = tall.second;
+	while (h > low.second || (c != nullptr && rb_tree_is_red(c))) {
+		if (!rb_tree_is_red(c))
+			--h;
+		p = c;
+		c = to_right ? c->right : c->left;
+	}
+	if (to_right) {
+		k->left = c;
+		k->right = low.first;
+		p->right = k;
+	}else {
+		k->left = low.first;
+		k->right = c;
+		p->left = k;
+	}
+	k->set_parent(p);
+	if (c != nullptr)
+		c->set_parent(k);
+	if (low.first != nullptr)
+		low.first->set_parent(k);
+	if (Ranked) {
+		// 自下而上更新 k 到根节点路径上的子树节点数
+		for (auto x = k; x != tall.first; x = x->parent())
+			rb_tree_size_update(x);
+		rb_tree_size_update(tall.first);
+	}
+	auto root = tall.first;
+	rb_tree_insert_fixup(k, root);
+	size_type bh = tall.second;
+	if (rb_tree_is_red(root)) {
+		rb_tree_set_black(root);
+		++bh;
+	}
+	return tree_part(root, bh);
+}
+
+// join2_part 函数
+// 拼接子树 l 和 r，摘下 r 的最小节点作为枢轴
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::tree_part
+rb_tree<T, Compare, Ranked, Pooled>::
+join2_part(tree_part l, tree_part r) {
+	if (r.first == nullptr)
+		return l;
+	if (l.first == nullptr)
+		return r;
+	base_ptr m = nullptr;
+	tree_part rest;
+	split_first(r, m, rest);
+	return join_part(l, m, rest);
+}
+
+// split_part 函数
+// 按 key 把子树 t 拆成 l 和 r：键值小于 key 的节点在 l 中，大于 key 的节点在 r 中；
+// 键值等于 key 的节点，unique 时单独放在 m 中(没有则 m 为空)，否则 upper 为 true 时放在 l 中，为 false 时放在 r 中
+// 沿查找 key 的路径往下走，路径两侧挂着的子树在返回时依次 join 到 l 或 r 上，时间复杂度为 O(log n)
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+split_part(tree_part t, const key_type& key, bool unique, bool upper,
+           tree_part& l, base_ptr& m, tree_part& r) {
+	auto x = t.first;
+	if (x == nullptr) {
+		l = r = tree_part(nullptr, 0);
+		m = nullptr;
+		return;
+	}
+	const size_type cbh = t.second - (rb_tree_is_red(x) ? 0 : 1);  // 子树的黑高
+	tree_part xl(x->left, cbh);
+	tree_part xr(x->right, cbh);
+	const auto& xk = value_traits::get_key(x->get_node_ptr()->value);
+	bool to_left;  // x 是否属于 l
+	if (key_comp_(xk, key)) {
+		to_left = true;
+	}else if (key_comp_(key, xk)) {
+		to_left = false;
+	}else if (unique) {
+		l = xl;
+		m = x;
+		r = xr;
+		return;
+	}else {
+		to_left = upper;
+	}
+	if (to_left) {
+		tree_part rl;
+		split_part(xr, key, unique, upper, rl, m, r);
+		l = join_part(xl, x, rl);
+	}else {
+		tree_part lr;
+		split_part(xl, key, unique, upper, l, m, lr);
+		r = join_part(lr, x, xr);
+	}
+}
+
+// split_first 函数
+// 摘下子树 t 中的最小节点 m，其余节点组成 r
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void rb_tree<T, Compare, Ranked, Pooled>::
+split_first(tree_part t, base_ptr& m, tree_part& r) {
+	auto x = t.first;
+	const size_type cbh = t.second - (rb_tree_is_red(x) ? 0 : 1);
+	if (x->left == nullptr) {
+		m = x;
+		r = tree_part(x->right, cbh);
+		return;
+	}
+	tree_part lr;
+	split_first(tree_part(x->left, cbh), m, lr);
+	r = join_part(lr, x, tree_part(x->right, cbh));
+}
+
+// union_part 函数
+// 以 b 的根为枢轴把 a 拆成两半，分别与 b 的左右子树递归合并后再以枢轴 join 起来
+// unique 时键值相同的两个节点只保留一个，a_wins 为 true 时保留 a 中的节点，
+// 被淘汰的节点按键值升序以 right 相连，接在 dups 所指的链接上；
+// 否则 a_wins 为 true 表示 a 中与枢轴键值相同的节点排在枢轴之前
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::tree_part
+rb_tree<T, Compare, Ranked, Pooled>::
+union_part(tree_part a, tree_part b, bool unique, bool a_wins,
+           base_ptr*& dups, size_type& ndups) {
+	if (a.first == nullptr)
+		return b;
+	if (b.first == nullptr)
+		return a;
+	auto x = b.first;
+	const size_type cbh = b.second - (rb_tree_is_red(x) ? 0 : 1);
+	tree_part bl(x->left, cbh);
+	tree_part br(x->right, cbh);
+	if (b.second <= kRbTreeUnionInsertBh) {
+		// b 只剩几个节点时，拆开 a 再 join 回去要访问的节点比直接插入更多，按中序逐个插入 a；
+		// 键值相同的节点要插在前面时改为逆序插入，使 b 中键值相同的节点保持原来的先后
+		const bool reverse = !unique && !a_wins;
+		a = union_part(a, reverse ? br : bl, unique, a_wins, dups, ndups);
+		a = insert_part(a, x, unique, a_wins, dups, ndups);
+		return union_part(a, reverse ? bl : br, unique, a_wins, dups, ndups);
+	}
+	tree_part al, ar;
+	base_ptr m = nullptr;
+	split_part(a, value_traits::get_key(x->get_node_ptr()->value), unique, a_wins, al, m, ar);
+	base_ptr loser = nullptr;
+	if (m != nullptr) {
+		loser = a_wins ? x : m;
+		if (a_wins)
+			x = m;
+	}
+	auto lt = union_part(al, bl, unique, a_wins, dups, ndups);
+	if (loser != nullptr) {
+		*dups = loser;
+		dups = &loser->right;
+		++ndups;
+	}
+	auto rt = union_part(ar, br, unique, a_wins, dups, ndups);
+	return join_part(lt, x, rt);
+}
+
+// insert_part 函数
+// 把单个节点 x 插入子树 a，键值相同时的处理与 union_part 相同：
+// unique 时被淘汰的节点接到 dups 上(a_wins 为 false 时 x 取代 a 中的节点)，否则 a_wins 决定 x 排在相同键值之后还是之前
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::tree_part
+rb_tree<T, Compare, Ranked, Pooled>::
+insert_part(tree_part a, base_ptr x, bool unique, bool a_wins,
+            base_ptr*& dups, size_type& ndups) {
+	x->left = nullptr;
+	x->right = nullptr;
+	rb_tree_size_set(x, 1);
+	if (a.first == nullptr) {
+		rb_tree_set_black(x);
+		return tree_part(x, 1);
+	}
+	if (rb_tree_is_red(a.first)) {  // 与 join_part 一样，先把根节点染黑
+		rb_tree_set_black(a.first);
+		++a.second;
+	}
+	const auto& key = value_traits::get_key(x->get_node_ptr()->value);
+	base_ptr p = nullptr;
+	bool add_to_left = false;
+	for (auto y = a.first; y != nullptr; y = add_to_left ? y->left : y->right) {
+		p = y;
+		const auto& yk = value_traits::get_key(y->get_node_ptr()->value);
+		if (key_comp_(key, yk)) {
+			add_to_left = true;
+		}else if (key_comp_(yk, key)) {
+			add_to_left = false;
+		}else if (unique) {
+			base_ptr loser = x;
+			if (!a_wins) {  // x 取代 y 的位置
+				x->parent_color = y->parent_color;
+				x->left = y->left;
+				x->right = y->right;
+				if (x->left != nullptr)
+					x->left->set_parent(x);
+				if (x->right != nullptr)
+					x->right->set_parent(x);
+				rb_tree_size_copy(x, y);
+				if (y == a.first)
+					a.first = x;
+				else if (y->parent()->left == y)
+					y->parent()->left = x;
+				else
+					y->parent()->right = x;
+				loser = y;
+			}
+			*dups = loser;
+			dups = &loser->right;
+			++ndups;
+			return a;
+		}else {
+			add_to_left = !a_wins;
+		}
+	}
+	x->set_parent(p);
+	if (add_to_left)
+		p->left = x;
+	else
+		p->right = x;
+	rb_tree_size_add_path(p, a.first, 1);
+	rb_tree_insert_fixup(x, a.first);
+	if (rb_tree_is_red(a.first)) {
+		rb_tree_set_black(a.first);
+		++a.second;
+	}
+	return a;
+}
+
+// intersect_part 函数
+// 以只读的子树 b 的根拆开 a，a 中与之键值相同的节点作为枢轴保留，两边分别与 b 的左右子树递归求交
+// b 为空时 a 中剩下的节点全部销毁，removed 累计销毁的节点数
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::tree_part
+rb_tree<T, Compare, Ranked, Pooled>::
+intersect_part(tree_part a, base_ptr b, size_type& removed) {
+	if (a.first == nullptr)
+		return a;
+	if (b == nullptr) {
+		removed += destroy_tree(a.first);
+		return tree_part(nullptr, 0);
+	}
+	tree_part al, ar;
+	base_ptr m = nullptr;
+	split_part(a, value_traits::get_key(b->get_node_ptr()->value), true, false, al, m, ar);
+	auto lt = intersect_part(al, b->left, removed);
+	auto rt = intersect_part(ar, b->right, removed);
+	return m != nullptr ? join_part(lt, m, rt) : join2_part(lt, rt);
+}
+
+// subtract_part 函数
+// 以只读的子树 b 的根拆开 a，销毁 a 中与之键值相同的节点，两边分别与 b 的左右子树递归求差
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::tree_part
+rb_tree<T, Compare, Ranked, Pooled>::
+subtract_part(tree_part a, base_ptr b, size_type& removed) {
+	if (a.first == nullptr || b == nullptr)
+		return a;
+	tree_part al, ar;
+	base_ptr m = nullptr;
+	split_part(a, value_traits::get_key(b->get_node_ptr()->value), true, false, al, m, ar);
+	if (m != nullptr) {
+		destroy_node(m->get_node_ptr());
+		++removed;
+	}
+	auto lt = subtract_part(al, b->left, removed);
+	auto rt = subtract_part(ar, b->right, removed);
+	return join2_part(lt, rt);
+}
+
+// black_height 函数
+// 以 x 为根的子树的黑高，即从 x(含)到空链接的路径上黑色节点的个数
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+black_height(base_ptr x) {
+	size_type h = 0;
+	for (; x != nullptr; x = x->left) {
+		if (!rb_tree_is_red(x))
+			++h;
+	}
+	return h;
+}
+
+// count_nodes 函数
+// 以 x 为根的子树中的节点数，开启排名时直接读取，否则递归计数
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+count_nodes(base_ptr x) {
+	return count_nodes(x, m_bool_constant<Ranked>());
+}
+
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+count_nodes(base_ptr x, m_true_type) {
+	return rb_tree_size(x);
+}
+
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+typename rb_tree<T, Compare, Ranked, Pooled>::size_type
+rb_tree<T, Compare, Ranked, Pooled>::
+count_nodes(base_ptr x, m_false_type) {
+	size_type n = 0;
+	for (; x != nullptr; x = x->left)
+		n += 1 + count_nodes(x->right, m_false_type());
+	return n;
+}
+
 // 重载比较操作符
-template <typename T, typename Compare>
-bool operator==(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs) {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator==(const rb_tree<T, Compare, Ranked, Pooled>& lhs, const rb_tree<T, Compare, Ranked, Pooled>& rhs) {
   	return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <typename T, typename Compare>
-bool operator<(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs) {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator<(const rb_tree<T, Compare, Ranked, Pooled>& lhs, const rb_tree<T, Compare, Ranked, Pooled>& rhs) {
  	return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
 
-template <typename T, typename Compare>
-bool operator!=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs) {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator!=(const rb_tree<T, Compare, Ranked, Pooled>& lhs, const rb_tree<T, Compare, Ranked, Pooled>& rhs) {
   	return !(lhs == rhs);
 }
 
-template <typename T, typename Compare>
-bool operator>(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs) {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator>(const rb_tree<T, Compare, Ranked, Pooled>& lhs, const rb_tree<T, Compare, Ranked, Pooled>& rhs) {
 	return rhs < lhs;
 }
 
-template <typename T, typename Compare>
-bool operator<=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs) {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator<=(const rb_tree<T, Compare, Ranked, Pooled>& lhs, const rb_tree<T, Compare, Ranked, Pooled>& rhs) {
   	return !(rhs < lhs);
 }
 
-template <typename T, typename Compare>
-bool operator>=(const rb_tree<T, Compare>& lhs, const rb_tree<T, Compare>& rhs) {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+bool operator>=(const rb_tree<T, Compare, Ranked, Pooled>& lhs, const rb_tree<T, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <typename T, typename Compare>
-void swap(rb_tree<T, Compare>& lhs, rb_tree<T, Compare>& rhs) noexcept {
+template <typename T, typename Compare, bool Ranked, bool Pooled>
+void swap(rb_tree<T, Compare, Ranked, Pooled>& lhs, rb_tree<T, Compare, Ranked, Pooled>& rhs) noexcept {
   	lhs.swap(rhs);
 }
 
@@ -0,0 +1,563 @@
+﻿#ifndef MYSTL_SERIALIZE_H_
+#define MYSTL_SERIALIZE_H_
+
+// 这个头文件包含二进制序列化的读写流 binary_writer / binary_reader，
+// 以及把 mystl 容器写入流、从流中恢复容器的函数 serialize / deserialize
+
+// notes:
+//
+// 1. 元素个数一律写成 8 字节的 uint64_t，trivially copyable 的值按内存中的字节原样写入，
+//    数据只能由 sizeof、字节序与对齐方式都相同的程序读取
+// 2. vector / basic_string 的元素可按字节序列化时，写入个数后整块 memcpy，
+//    读取时用 resize_default_init 开出空间后整块读入，不逐个构造元素
+// 3. list / deque 以及元素不能按字节序列化的 vector，写入个数后逐个写入元素
+// 4. map / set 按键值升序写入，读取时以 sorted_unique 插入空容器，走线性时间的自底向上建树；
+//    multimap / multiset 以 end() 为提示逐个插入，有序的输入下每次插入为均摊常数时间
+// 5. unordered_* 读取前先 reserve(元素个数)，之后的插入不会 rehash
+// 6. deserialize 会先清空容器；数据不完整或元素个数超出剩余数据时抛出 runtime_error，
+//    此时容器处于有效但未指定的状态；从文件读取时剩余数据按文件大小计算，
+//    不能定位的文件(如管道)无法得知剩余数据，不检查元素个数
+// 7. 其它类型可以特化 serializer<T>，提供静态成员 save(binary_writer&, const T&) 与
+//    load(binary_reader&, T&)；trivially copyable 但含有指针等不能按字节保存的类型，
+//    还需要把 is_bitwise_serializable<T> 特化为 false_type
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include "basic_string.h"
+#include "deque.h"
+#include "iterator.h"
+#include "list.h"
+#include "map.h"
+#include "set.h"
+#include "unordered_map.h"
+#include "unordered_set.h"
+#include "util.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 文件读写的缓冲区大小，不小于它的数据块不经过缓冲区
+static constexpr size_t kSerializeBufferSize = 64 << 10;
+
+// is_bitwise_serializable : 类型的值是否可以按内存中的字节原样写入和读回
+template <typename T>
+struct is_bitwise_serializable : std::is_trivially_copyable<T> {};
+
+// binary_writer
+// 写入 FILE*(由调用者打开和关闭)，或者追加到 vector<char> 的末尾
+class binary_writer
+{
+public:
+	explicit binary_writer(std::FILE* file)
+		:file_(file), out_(nullptr), buf_(new char[kSerializeBufferSize]), pos_(0), count_(0) {}
+
+	explicit binary_writer(mystl::vector<char>& out)
+		:file_(nullptr), out_(&out), buf_(nullptr), pos_(0), count_(0) {}
+
+	binary_writer(const binary_writer&) = delete;
+	binary_writer& operator=(const binary_writer&) = delete;
+
+	~binary_writer() {
+		if (pos_ != 0)
+			std::fwrite(buf_, 1, pos_, file_);
+		delete[] buf_;
+	}
+
+	// 已写入的字节数
+	uint64_t count() const noexcept { return count_; }
+
+	void write(const void* p, size_t n) {
+		if (n == 0)
+			return;
+		count_ += n;
+		if (out_ != nullptr) {
+			const auto old = out_->size();
+			out_->resize_default_init(old + n);
+			std::memcpy(out_->data() + old, p, n);
+			return;
+		}
+		if (pos_ + n > kSerializeBufferSize) {
+			flush_buffer();
+			if (n >= kSerializeBufferSize) {
+				write_file(p, n);
+				return;
+			}
+		}
+		std::memcpy(buf_ + pos_, p, n);
+		pos_ += n;
+	}
+
+	void write_size(uint64_t n) { write(&n, sizeof(n)); }
+
+	// 把缓冲区中的数据交给文件
+	void flush() {
+		if (file_ != nullptr) {
+			flush_buffer();
+			THROW_RUNTIME_ERROR_IF(std::fflush(file_) != 0, "binary_writer: flush failed");
+		}
+	}
+
+private:
+	void flush_buffer() {
+		if (pos_ != 0) {
+			const auto n = pos_;
+			pos_ = 0;
+			write_file(buf_, n);
+		}
+	}
+
+	void write_file(const void* p, size_t n) {
+		THROW_RUNTIME_ERROR_IF(std::fwrite(p, 1, n, file_) != n, "binary_writer: write failed");
+	}
+
+private:
+	std::FILE*           file_;
+	mystl::vector<char>* out_;
+	char*                buf_;    // 文件写入的缓冲区
+	size_t               pos_;    // 缓冲区中的字节数
+	uint64_t             count_;
+};
+
+// binary_reader
+// 从 FILE*(由调用者打开和关闭)或者一段内存中读取，内存在读取期间必须有效
+class binary_reader
+{
+public:
+	explicit binary_reader(std::FILE* file)
+		:file_(file), buf_(new char[kSerializeBufferSize]), cur_(buf_), last_(buf_),
+		file_left_(file_remaining(file)) {}
+
+	binary_reader(const void* data, size_t len)
+		:file_(nullptr), buf_(nullptr), cur_(static_cast<const char*>(data)),
+		last_(static_cast<const char*>(data) + len), file_left_(0) {}
+
+	binary_reader(const binary_reader&) = delete;
+	binary_reader& operator=(const binary_reader&) = delete;
+
+	~binary_reader() { delete[] buf_; }
+
+	void read(void* p, size_t n) {
+		if (static_cast<size_t>(last_ - cur_) >= n) {
+			if (n != 0)
+				std::memcpy(p, cur_, n);
+			cur_ += n;
+			return;
+		}
+		read_file(static_cast<char*>(p), n);
+	}
+
+	uint64_t read_size() {
+		uint64_t n;
+		read(&n, sizeof(n));
+		return n;
+	}
+
+	// 读取 n 个至少占 bytes 字节的元素之前调用，拒绝超出剩余数据(缓冲区中的与文件中未读的)的个数，
+	// 避免损坏的数据造成巨大的内存申请
+	void check_size(uint64_t n, size_t bytes) const {
+		if (file_left_ == UINT64_MAX)
+			return;
+		const auto left = static_cast<uint64_t>(last_ - cur_) + file_left_;
+		THROW_RUNTIME_ERROR_IF(n > left / bytes, "binary_reader: element count exceeds remaining data");
+	}
+
+private:
+	// 文件从当前位置到末尾的字节数；不能定位的文件(如管道)无法得知，不限制个数
+	// 在构造函数中调用，不抛出异常：定位回原处失败时返回 0，之后的读取会报告数据不完整
+	static uint64_t file_remaining(std::FILE* file) noexcept {
+		const long pos = std::ftell(file);
+		if (pos < 0 || std::fseek(file, 0, SEEK_END) != 0)
+			return UINT64_MAX;
+		const long end = std::ftell(file);
+		if (std::fseek(file, pos, SEEK_SET) != 0)
+			return 0;
+		return end < pos ? UINT64_MAX : static_cast<uint64_t>(end - pos);
+	}
+
+	// 读入的字节多于预计(文件在读取期间变长)时截断为 0，实际能否读到仍以 fread 的结果为准
+	void consume_file(size_t n) {
+		if (file_left_ != UINT64_MAX)
+			file_left_ = file_left_ > n ? file_left_ - n : 0;
+	}
+
+	// 缓冲区中的数据不够时，先取走剩余部分，再从文件读取
+	void read_file(char* p, size_t n) {
+		THROW_RUNTIME_ERROR_IF(file_ == nullptr, "binary_reader: unexpected end of data");
+		const auto have = static_cast<size_t>(last_ - cur_);
+		if (have != 0)
+			std::memcpy(p, cur_, have);
+		p += have;
+		n -= have;
+		cur_ = last_ = buf_;
+		if (n >= kSerializeBufferSize) {
+			THROW_RUNTIME_ERROR_IF(std::fread(p, 1, n, file_) != n, "binary_reader: unexpected end of data");
+			consume_file(n);
+			return;
+		}
+		last_ = buf_ + std::fread(buf_, 1, kSerializeBufferSize, file_);
+		consume_file(static_cast<size_t>(last_ - buf_));
+		THROW_RUNTIME_ERROR_IF(static_cast<size_t>(last_ - buf_) < n, "binary_reader: unexpected end of data");
+		std::memcpy(p, buf_, n);
+		cur_ = buf_ + n;
+	}
+
+private:
+	std::FILE*  file_;
+	char*       buf_;    // 文件读取的缓冲区
+	const char* cur_;    // 下一个未读的字节
+	const char* last_;   // 可读数据的末尾
+	uint64_t    file_left_;  // 文件中尚未读入的字节数，未知时为 UINT64_MAX
+};
+
+/*****************************************************************************************/
+// serializer
+// 模板类 serializer<T> 定义类型 T 的写入与读取方式，缺省按字节原样读写
+
+template <typename T>
+struct serializer
+{
+	static_assert(is_bitwise_serializable<T>::value,
+		"serializer<T> requires a trivially copyable T, or a specialization of serializer<T>");
+
+	static void save(binary_writer& w, const T& value) { w.write(&value, sizeof(T)); }
+	static void load(binary_reader& r, T& value)       { r.read(&value, sizeof(T)); }
+};
+
+template <typename T>
+void serialize(binary_writer& w, const T& value)
+{
+	serializer<T>::save(w, value);
+}
+
+template <typename T>
+void deserialize(binary_reader& r, T& value)
+{
+	serializer<T>::load(r, value);
+}
+
+// 写入个数与 [first, first + n) 上的元素
+template <typename InputIterator>
+void serialize_range(binary_writer& w, InputIterator first, size_t n)
+{
+	typedef typename std::remove_const<
+		typename iterator_traits<InputIterator>::value_type>::type value_type;
+	w.write_size(n);
+	for (; n > 0; --n, ++first)
+		serializer<value_type>::save(w, *first);
+}
+
+// 逐个在容器末尾构造元素并读入
+template <typename Container>
+void deserialize_back(binary_reader& r, Container& c)
+{
+	typedef typename Container::value_type value_type;
+	const auto n = r.read_size();
+	r.check_size(n, 1);
+	c.clear();
+	for (uint64_t i = 0; i < n; ++i)
+	{
+		c.emplace_back();
+		serializer<value_type>::load(r, c.back());
+	}
+}
+
+// 从流中依次读出元素的迭代器，用于把有序的数据直接交给容器建树
+// 只能单趟使用：每个位置恰好解引用一次，之后前进；
+// 标记为随机访问迭代器，只是为了让 mystl::distance 以 last - first 直接得到元素个数
+template <typename T>
+class serial_load_iterator : public mystl::iterator<mystl::random_access_iterator_tag, T>
+{
+public:
+	serial_load_iterator(binary_reader& r, size_t left) :r_(&r), left_(left) {}
+
+	T operator*() const {
+		T value;
+		serializer<T>::load(*r_, value);
+		return value;
+	}
+
+	serial_load_iterator& operator++() {
+		--left_;
+		return *this;
+	}
+
+	ptrdiff_t operator-(const serial_load_iterator& rhs) const {
+		return static_cast<ptrdiff_t>(rhs.left_) - static_cast<ptrdiff_t>(left_);
+	}
+
+	bool operator==(const serial_load_iterator& rhs) const { return left_ == rhs.left_; }
+	bool operator!=(const serial_load_iterator& rhs) const { return left_ != rhs.left_; }
+
+private:
+	binary_reader* r_;
+	size_t         left_;  // 剩余的元素个数
+};
+
+// 读出 n 个有序的元素，以 sorted_unique 插入空容器
+template <typename T, typename Container>
+void deserialize_sorted(binary_reader& r, Container& c)
+{
+	const auto n = r.read_size();
+	r.check_size(n, 1);
+	c.clear();
+	c.insert(mystl::sorted_unique, serial_load_iterator<T>(r, static_cast<size_t>(n)),
+		serial_load_iterator<T>(r, 0));
+}
+
+/*****************************************************************************************/
+// pair
+
+template <typename T1, typename T2>
+struct serializer<mystl::pair<T1, T2>>
+{
+	typedef typename std::remove_const<T1>::type first_type;
+
+	static void save(binary_writer& w, const mystl::pair<T1, T2>& value) {
+		serializer<first_type>::save(w, value.first);
+		serializer<T2>::save(w, value.second);
+	}
+	static void load(binary_reader& r, mystl::pair<T1, T2>& value) {
+		serializer<T1>::load(r, value.first);
+		serializer<T2>::load(r, value.second);
+	}
+};
+
+/*****************************************************************************************/
+// vector / basic_string
+
+template <typename T, typename GrowthPolicy, typename Alloc>
+struct serializer<mystl::vector<T, GrowthPolicy, Alloc>>
+{
+	typedef mystl::vector<T, GrowthPolicy, Alloc> container_type;
+
+	static void save(binary_writer& w, const container_type& v) {
+		save_dispatch(w, v, is_bitwise_serializable<T>());
+	}
+	static void load(binary_reader& r, container_type& v) {
+		load_dispatch(r, v, is_bitwise_serializable<T>());
+	}
+
+private:
+	static void save_dispatch(binary_writer& w, const container_type& v, std::true_type) {
+		w.write_size(v.size());
+		w.write(v.data(), v.size() * sizeof(T));
+	}
+	static void save_dispatch(binary_writer& w, const container_type& v, std::false_type) {
+		serialize_range(w, v.begin(), v.size());
+	}
+
+	static void load_dispatch(binary_reader& r, container_type& v, std::true_type) {
+		const auto n = r.read_size();
+		r.check_size(n, sizeof(T));
+		v.clear();
+		v.resize_default_init(static_cast<size_t>(n));
+		r.read(v.data(), v.size() * sizeof(T));
+	}
+	static void load_dispatch(binary_reader& r, container_type& v, std::false_type) {
+		const auto n = r.read_size();
+		r.check_size(n, 1);
+		v.clear();
+		v.reserve(static_cast<size_t>(n));
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v.emplace_back();
+			serializer<T>::load(r, v.back());
+		}
+	}
+};
+
+template <typename CharType, typename CharTraits>
+struct serializer<mystl::basic_string<CharType, CharTraits>>
+{
+	typedef mystl::basic_string<CharType, CharTraits> string_type;
+
+	static void save(binary_writer& w, const string_type& s) {
+		w.write_size(s.size());
+		w.write(s.data(), s.size() * sizeof(CharType));
+	}
+	static void load(binary_reader& r, string_type& s) {
+		const auto n = r.read_size();
+		r.check_size(n, sizeof(CharType));
+		s.clear();
+		s.resize_default_init(static_cast<size_t>(n));
+		r.read(s.begin(), s.size() * sizeof(CharType));
+	}
+};
+
+/*****************************************************************************************/
+// list / deque
+
+template <typename T>
+struct serializer<mystl::list<T>>
+{
+	static void save(binary_writer& w, const mystl::list<T>& l) {
+		serialize_range(w, l.begin(), l.size());
+	}
+	static void load(binary_reader& r, mystl::list<T>& l) {
+		deserialize_back(r, l);
+	}
+};
+
+template <typename T, size_t BufSize, typename Alloc>
+struct serializer<mystl::deque<T, BufSize, Alloc>>
+{
+	static void save(binary_writer& w, const mystl::deque<T, BufSize, Alloc>& d) {
+		serialize_range(w, d.begin(), d.size());
+	}
+	static void load(binary_reader& r, mystl::deque<T, BufSize, Alloc>& d) {
+		deserialize_back(r, d);
+	}
+};
+
+/*****************************************************************************************/
+// map / multimap / set / multiset
+
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+struct serializer<mystl::map<Key, T, Compare, Ranked, Pooled>>
+{
+	static void save(binary_writer& w, const mystl::map<Key, T, Compare, Ranked, Pooled>& m) {
+		serialize_range(w, m.begin(), m.size());
+	}
+	static void load(binary_reader& r, mystl::map<Key, T, Compare, Ranked, Pooled>& m) {
+		deserialize_sorted<mystl::pair<Key, T>>(r, m);
+	}
+};
+
+template <typename Key, typename T, typename Compare, bool Ranked, bool Pooled>
+struct serializer<mystl::multimap<Key, T, Compare, Ranked, Pooled>>
+{
+	static void save(binary_writer& w, const mystl::multimap<Key, T, Compare, Ranked, Pooled>& m) {
+		serialize_range(w, m.begin(), m.size());
+	}
+	static void load(binary_reader& r, mystl::multimap<Key, T, Compare, Ranked, Pooled>& m) {
+		const auto n = r.read_size();
+		r.check_size(n, 1);
+		m.clear();
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			Key key;
+			T value;
+			serializer<Key>::load(r, key);
+			serializer<T>::load(r, value);
+			m.emplace_hint(m.end(), mystl::move(key), mystl::move(value));
+		}
+	}
+};
+
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+struct serializer<mystl::set<Key, Compare, Ranked, Pooled>>
+{
+	static void save(binary_writer& w, const mystl::set<Key, Compare, Ranked, Pooled>& s) {
+		serialize_range(w, s.begin(), s.size());
+	}
+	static void load(binary_reader& r, mystl::set<Key, Compare, Ranked, Pooled>& s) {
+		deserialize_sorted<Key>(r, s);
+	}
+};
+
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+struct serializer<mystl::multiset<Key, Compare, Ranked, Pooled>>
+{
+	static void save(binary_writer& w, const mystl::multiset<Key, Compare, Ranked, Pooled>& s) {
+		serialize_range(w, s.begin(), s.size());
+	}
+	static void load(binary_reader& r, mystl::multiset<Key, Compare, Ranked, Pooled>& s) {
+		const auto n = r.read_size();
+		r.check_size(n, 1);
+		s.clear();
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			Key key;
+			serializer<Key>::load(r, key);
+			s.emplace_hint(s.end(), mystl::move(key));
+		}
+	}
+};
+
+/*****************************************************************************************/
+// unordered_map / unordered_multimap / unordered_set / unordered_multiset
+
+// 先按元素个数 reserve，再逐个读入并插入
+template <typename Key, typename T, typename Container>
+void deserialize_hash_map(binary_reader& r, Container& c)
+{
+	const auto n = r.read_size();
+	r.check_size(n, 1);
+	c.clear();
+	c.reserve(static_cast<size_t>(n));
+	for (uint64_t i = 0; i < n; ++i)
+	{
+		Key key;
+		T value;
+		serializer<Key>::load(r, key);
+		serializer<T>::load(r, value);
+		c.emplace(mystl::move(key), mystl::move(value));
+	}
+}
+
+template <typename Key, typename Container>
+void deserialize_hash_set(binary_reader& r, Container& c)
+{
+	const auto n = r.read_size();
+	r.check_size(n, 1);
+	c.clear();
+	c.reserve(static_cast<size_t>(n));
+	for (uint64_t i = 0; i < n; ++i)
+	{
+		Key key;
+		serializer<Key>::load(r, key);
+		c.emplace(mystl::move(key));
+	}
+}
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+struct serializer<mystl::unordered_map<Key, T, Hash, KeyEqual>>
+{
+	static void save(binary_writer& w, const mystl::unordered_map<Key, T, Hash, KeyEqual>& m) {
+		serialize_range(w, m.begin(), m.size());
+	}
+	static void load(binary_reader& r, mystl::unordered_map<Key, T, Hash, KeyEqual>& m) {
+		deserialize_hash_map<Key, T>(r, m);
+	}
+};
+
+template <typename Key, typename T, typename Hash, typename KeyEqual>
+struct serializer<mystl::unordered_multimap<Key, T, Hash, KeyEqual>>
+{
+	static void save(binary_writer& w, const mystl::unordered_multimap<Key, T, Hash, KeyEqual>& m) {
+		serialize_range(w, m.begin(), m.size());
+	}
+	static void load(binary_reader& r, mystl::unordered_multimap<Key, T, Hash, KeyEqual>& m) {
+		deserialize_hash_map<Key, T>(r, m);
+	}
+};
+
+template <typename Key, typename Hash, typename KeyEqual>
+struct serializer<mystl::unordered_set<Key, Hash, KeyEqual>>
+{
+	static void save(binary_writer& w, const mystl::unordered_set<Key, Hash, KeyEqual>& s) {
+		serialize_range(w, s.begin(), s.size());
+	}
+	static void load(binary_reader& r, mystl::unordered_set<Key, Hash, KeyEqual>& s) {
+		deserialize_hash_set<Key>(r, s);
+	}
+};
+
+template <typename Key, typename Hash, typename KeyEqual>
+struct serializer<mystl::unordered_multiset<Key, Hash, KeyEqual>>
+{
+	static void save(binary_writer& w, const mystl::unordered_multiset<Key, Hash, KeyEqual>& s) {
+		serialize_range(w, s.begin(), s.size());
+	}
+	static void load(binary_reader& r, mystl::unordered_multiset<Key, Hash, KeyEqual>& s) {
+		deserialize_hash_set<Key>(r, s);
+	}
+};
+
+} // namespace mystl
+#endif // !MYSTL_SERIALIZE_H_
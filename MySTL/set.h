@@ -12,6 +12,13 @@
 //   * emplace
 //   * emplace_hint
 //   * insert
+//
+// 以 sorted_unique 标签构造或插入时，区间须已严格升序排列，容器以线性时间自底向上建树
+//
+// merge / split / extract_range / join 以及 intersect / subtract 基于红黑树的 join 和 split，只重连节点，
+// merge 的时间复杂度为 O(m log(n / m + 1))，m、n 分别为较小、较大一方的元素个数，
+// 指向被转移元素的迭代器和引用保持有效；开启节点池(Pooled)时，拆出到新容器的元素
+// 以及 merge 留在 source 中的重复元素要逐个移动，复杂度多出 O(k) 次分配，指向它们的迭代器失效(见 rb_tree.h)
 
 #include "rb_tree.h"
 
@@ -19,8 +26,10 @@ namespace mystl
 {
 
 // 模板类 set，键值不允许重复
-// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less 
-template <typename Key, typename Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，
+// 参数三表示是否开启排名(子树节点数)，开启后可用 nth、rank、index_of 等，缺省不开启，
+// 参数四表示是否从节点池分配节点(见 rb_tree.h)，缺省不开启
+template <typename Key, typename Compare = mystl::less<Key>, bool Ranked = false, bool Pooled = false>
 class set
 {
 public:
@@ -31,12 +40,13 @@ public:
 
 private:
     // 以 mystl::rb_tree 作为底层机制
-    typedef mystl::rb_tree<value_type, key_compare>  base_type;
+    typedef mystl::rb_tree<value_type, key_compare, Ranked, Pooled>  base_type;
     base_type tree_;
 
 public:
     // 使用 rb_tree 定义的型别
     typedef typename base_type::node_type              node_type;
+    typedef typename base_type::handle_type            handle_type;
     typedef typename base_type::const_pointer          pointer;
     typedef typename base_type::const_pointer          const_pointer;
     typedef typename base_type::const_reference        reference;
@@ -48,6 +58,7 @@ public:
     typedef typename base_type::size_type              size_type;
     typedef typename base_type::difference_type        difference_type;
     typedef typename base_type::allocator_type         allocator_type;
+    typedef mystl::node_insert_return<iterator, handle_type> insert_return_type;
 
 public:
 	// 构造、复制、移动函数
@@ -61,6 +72,14 @@ public:
 		:tree_()
 	{ tree_.insert_unique(ilist.begin(), ilist.end()); }
 
+	template <class InputIterator>
+	set(sorted_unique_t, InputIterator first, InputIterator last)
+		:tree_()
+	{ tree_.insert_unique_sorted(first, last); }
+	set(sorted_unique_t, std::initializer_list<value_type> ilist)
+		:tree_()
+	{ tree_.insert_unique_sorted(ilist.begin(), ilist.end()); }
+
 	set(const set& rhs) 
 		:tree_(rhs.tree_){}
 	set(set&& rhs) noexcept
@@ -151,10 +170,25 @@ public:
 		tree_.insert_unique(first, last);
 	}
 
+	template <typename InputIterator>
+	void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+		tree_.insert_unique_sorted(first, last);
+	}
+
 	void      erase(iterator position)             { tree_.erase(position); }
 	size_type erase(const key_type& key)           { return tree_.erase_unique(key); }
 	void      erase(iterator first, iterator last) { tree_.erase(first, last); }
 
+	// 节点句柄，摘下的节点可以插回同类容器(包括键值允许重复的版本)，未开启节点池时不复制元素；句柄可以比源容器活得更久
+	handle_type extract(iterator position)   { return tree_.extract(position); }
+	handle_type extract(const key_type& key) { return tree_.extract(key); }
+
+	insert_return_type insert(handle_type&& nh)
+	{
+		auto res = tree_.insert_unique(mystl::move(nh));
+		return insert_return_type{ res.position, res.inserted, mystl::move(res.node) };
+	}
+
 	void      clear() { tree_.clear(); }
 
 	// set 相关操作
@@ -178,6 +212,63 @@ public:
 		equal_range(const key_type& key) const
 	{ return tree_.equal_range_unique(key); }
 
+	// 透明查找，只在 key_compare 定义了 is_transparent 时参与重载，key 可以是任意能与键值比较的类型
+	// 与 key 等价的元素可能不止一个，count 与 equal_range 按键值可重复处理
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       find(const K& key)                     { return tree_.find(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator find(const K& key)               const { return tree_.find(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	size_type      count(const K& key)              const { return tree_.count_multi(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	pair<iterator, iterator>
+		equal_range(const K& key)
+	{ return tree_.equal_range_multi(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	pair<const_iterator, const_iterator>
+		equal_range(const K& key) const
+	{ return tree_.equal_range_multi(key); }
+
+	// 排名相关，需要开启排名(Ranked)，时间复杂度均为 O(log n)
+
+	iterator        nth(size_type k)                      { return tree_.nth(k); }
+	const_iterator  nth(size_type k)                const { return tree_.nth(k); }
+	size_type       rank(const key_type& key)       const { return tree_.rank(key); }
+	size_type       index_of(const_iterator it)     const { return tree_.index_of(it); }
+	difference_type distance(const_iterator first, const_iterator last) const
+	{ return static_cast<difference_type>(tree_.index_of(last) - tree_.index_of(first)); }
+
+	// 拼接、拆分与集合运算，基于红黑树的 join 和 split，未开启节点池时只重连节点，不复制元素
+	// merge 移入 source 中的元素，键值已存在的留在 source 中；intersect / subtract 只保留 / 删除键值在 other 中的元素
+	// split 摘出键值不小于 key 的元素，extract_range 摘出键值在 [lo, hi) 内的元素，以新的 set 返回
+	// join 把 rhs 中的元素接到末尾，rhs 的键值须都大于本容器的键值
+
+	void merge(set& source)          { tree_.merge_unique(source.tree_); }
+	void intersect(const set& other) { tree_.intersect_unique(other.tree_); }
+	void subtract(const set& other)  { tree_.subtract_unique(other.tree_); }
+	void join(set& rhs)              { tree_.join(rhs.tree_); }
+
+	set split(const key_type& key)
+	{
+		set result;
+		result.tree_ = tree_.split(key);
+		return result;
+	}
+	set extract_range(const key_type& lo, const key_type& hi)
+	{
+		set result;
+		result.tree_ = tree_.extract_range(lo, hi);
+		return result;
+	}
+
 	void swap(set& rhs) noexcept
 	{ tree_.swap(rhs.tree_); }
 
@@ -187,47 +278,49 @@ public:
 };
 
 // 重载比较操作符
-template <typename Key, typename Compare>
-bool operator==(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs){
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator==(const set<Key, Compare, Ranked, Pooled>& lhs, const set<Key, Compare, Ranked, Pooled>& rhs){
 	return lhs == rhs;
 }
 
-template <typename Key, typename Compare>
-bool operator<(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator<(const set<Key, Compare, Ranked, Pooled>& lhs, const set<Key, Compare, Ranked, Pooled>& rhs) {
 	return lhs < rhs;
 }
 
-template <typename Key, typename Compare>
-bool operator!=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator!=(const set<Key, Compare, Ranked, Pooled>& lhs, const set<Key, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs == rhs);
 }
 
-template <typename Key, typename Compare>
-bool operator>(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator>(const set<Key, Compare, Ranked, Pooled>& lhs, const set<Key, Compare, Ranked, Pooled>& rhs) {
 	return rhs < lhs;
 }
 
-template <typename Key, typename Compare>
-bool operator<=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator<=(const set<Key, Compare, Ranked, Pooled>& lhs, const set<Key, Compare, Ranked, Pooled>& rhs) {
 	return !(rhs < lhs);
 }
 
-template <typename Key, typename Compare>
-bool operator>=(const set<Key, Compare>& lhs, const set<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator>=(const set<Key, Compare, Ranked, Pooled>& lhs, const set<Key, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <typename Key, typename Compare>
-void swap(set<Key, Compare>& lhs, set<Key, Compare>& rhs) noexcept {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+void swap(set<Key, Compare, Ranked, Pooled>& lhs, set<Key, Compare, Ranked, Pooled>& rhs) noexcept {
 	lhs.swap(rhs);
 }
 
 /*****************************************************************************************/
 
 // 模板类 multiset，键值允许重复
-// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less 
-template <typename Key, typename Compare = mystl::less<Key>>
+// 参数一代表键值类型，参数二代表键值比较方式，缺省使用 mystl::less，
+// 参数三表示是否开启排名(子树节点数)，开启后可用 nth、rank、index_of 等，缺省不开启，
+// 参数四表示是否从节点池分配节点(见 rb_tree.h)，缺省不开启
+template <typename Key, typename Compare = mystl::less<Key>, bool Ranked = false, bool Pooled = false>
 class multiset
 {
 public:
@@ -238,12 +331,13 @@ public:
 
 private:
 	// 以 mystl::rb_tree 作为底层机制
-	typedef mystl::rb_tree<value_type, key_compare>  base_type;
+	typedef mystl::rb_tree<value_type, key_compare, Ranked, Pooled>  base_type;
 	base_type tree_;  // 以 rb_tree 表现 multiset
 
 public:
 	// 使用 rb_tree 定义的型别
 	typedef typename base_type::node_type              node_type;
+	typedef typename base_type::handle_type            handle_type;
 	typedef typename base_type::const_pointer          pointer;
 	typedef typename base_type::const_pointer          const_pointer;
 	typedef typename base_type::const_reference        reference;
@@ -362,6 +456,11 @@ public:
 	size_type      erase(const key_type& key)           { return tree_.erase_multi(key); }
 	void           erase(iterator first, iterator last) { tree_.erase(first, last); }
 
+	// 节点句柄，摘下的节点可以插回同类容器(包括键值不允许重复的版本)，未开启节点池时不复制元素；句柄可以比源容器活得更久
+	handle_type    extract(iterator position)           { return tree_.extract(position); }
+	handle_type    extract(const key_type& key)         { return tree_.extract(key); }
+	iterator       insert(handle_type&& nh)             { return tree_.insert_multi(mystl::move(nh)); }
+
 	void           clear() { tree_.clear(); }
 
 	// multiset 相关操作
@@ -385,6 +484,60 @@ public:
 		equal_range(const key_type& key) const
 	{ return tree_.equal_range_multi(key); }
 
+	// 透明查找，只在 key_compare 定义了 is_transparent 时参与重载，key 可以是任意能与键值比较的类型
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       find(const K& key)                     { return tree_.find(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator find(const K& key)               const { return tree_.find(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	size_type      count(const K& key)              const { return tree_.count_multi(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       lower_bound(const K& key)              { return tree_.lower_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator lower_bound(const K& key)        const { return tree_.lower_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	iterator       upper_bound(const K& key)              { return tree_.upper_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	const_iterator upper_bound(const K& key)        const { return tree_.upper_bound(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	pair<iterator, iterator>
+		equal_range(const K& key)
+	{ return tree_.equal_range_multi(key); }
+	template <typename K, typename C = key_compare, typename = typename C::is_transparent>
+	pair<const_iterator, const_iterator>
+		equal_range(const K& key) const
+	{ return tree_.equal_range_multi(key); }
+
+	// 排名相关，需要开启排名(Ranked)，时间复杂度均为 O(log n)
+
+	iterator        nth(size_type k)                      { return tree_.nth(k); }
+	const_iterator  nth(size_type k)                const { return tree_.nth(k); }
+	size_type       rank(const key_type& key)       const { return tree_.rank(key); }
+	size_type       index_of(const_iterator it)     const { return tree_.index_of(it); }
+	difference_type distance(const_iterator first, const_iterator last) const
+	{ return static_cast<difference_type>(tree_.index_of(last) - tree_.index_of(first)); }
+
+	// 拼接、拆分与集合运算，基于红黑树的 join 和 split，未开启节点池时只重连节点，不复制元素
+	// merge 移入 source 中的全部元素，排在键值相同的已有元素之后
+	// split 摘出键值不小于 key 的元素，extract_range 摘出键值在 [lo, hi) 内的元素，以新的 multiset 返回
+	// join 把 rhs 中的元素接到末尾，rhs 的键值须都不小于本容器的键值
+
+	void merge(multiset& source) { tree_.merge_multi(source.tree_); }
+	void join(multiset& rhs)     { tree_.join(rhs.tree_); }
+
+	multiset split(const key_type& key)
+	{
+		multiset result;
+		result.tree_ = tree_.split(key);
+		return result;
+	}
+	multiset extract_range(const key_type& lo, const key_type& hi)
+	{
+		multiset result;
+		result.tree_ = tree_.extract_range(lo, hi);
+		return result;
+	}
+
 	void swap(multiset& rhs) noexcept
 	{ tree_.swap(rhs.tree_); }
 
@@ -394,42 +547,51 @@ public:
 };
 
 // 重载比较操作符
-template <typename Key, typename Compare>
-bool operator==(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator==(const multiset<Key, Compare, Ranked, Pooled>& lhs, const multiset<Key, Compare, Ranked, Pooled>& rhs) {
 	return lhs == rhs;
 }
 
-template <typename Key, typename Compare>
-bool operator<(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator<(const multiset<Key, Compare, Ranked, Pooled>& lhs, const multiset<Key, Compare, Ranked, Pooled>& rhs) {
 	return lhs < rhs;
 }
 
-template <typename Key, typename Compare>
-bool operator!=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator!=(const multiset<Key, Compare, Ranked, Pooled>& lhs, const multiset<Key, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs == rhs);
 }
 
-template <typename Key, typename Compare>
-bool operator>(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator>(const multiset<Key, Compare, Ranked, Pooled>& lhs, const multiset<Key, Compare, Ranked, Pooled>& rhs) {
 	return rhs < lhs;
 }
 
-template <typename Key, typename Compare>
-bool operator<=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator<=(const multiset<Key, Compare, Ranked, Pooled>& lhs, const multiset<Key, Compare, Ranked, Pooled>& rhs) {
 	return !(rhs < lhs);
 }
 
-template <typename Key, typename Compare>
-bool operator>=(const multiset<Key, Compare>& lhs, const multiset<Key, Compare>& rhs) {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+bool operator>=(const multiset<Key, Compare, Ranked, Pooled>& lhs, const multiset<Key, Compare, Ranked, Pooled>& rhs) {
 	return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <typename Key, typename Compare>
-void swap(multiset<Key, Compare>& lhs, multiset<Key, Compare>& rhs) noexcept {
+template <typename Key, typename Compare, bool Ranked, bool Pooled>
+void swap(multiset<Key, Compare, Ranked, Pooled>& lhs, multiset<Key, Compare, Ranked, Pooled>& rhs) noexcept {
 	lhs.swap(rhs);
 }
 
+/*****************************************************************************************/
+
+// 开启排名的 set / multiset
+template <typename Key, typename Compare = mystl::less<Key>>
+using ranked_set = set<Key, Compare, true>;
+
+template <typename Key, typename Compare = mystl::less<Key>>
+using ranked_multiset = multiset<Key, Compare, true>;
+
 } // namespace mystl
 #endif // !MYSTL_SET_H_
 
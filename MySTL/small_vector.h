@@ -0,0 +1,789 @@
+﻿#ifndef MYSTL_SMALL_VECTOR_H_
+#define MYSTL_SMALL_VECTOR_H_
+
+// 这个头文件包含一个模板类 small_vector
+// small_vector : 带有内联存储的向量，元素不超过 N 个时不申请堆内存
+
+// notes:
+//
+// 1. 对象内部预留 N 个元素的存储空间，元素个数不超过 N 时全部放在其中，超过时才整体搬到堆上，
+//    之后按 vector 的扩容策略(vector_grow_cap)增长，第一次溢出时与 vector 一样至少申请 16 个元素；
+//    shrink_to_fit 在元素个数不超过 N 时搬回内联存储
+// 2. 接口与 vector 相同，另有 is_inline() 查询当前是否使用内联存储
+// 3. 移动、交换：使用堆内存的一方直接转移指针，使用内联存储的一方逐个移动元素，
+//    因此移动、交换后指向内联元素的迭代器会失效
+// 4. data() 与 size() 描述一段连续的元素，可以通过 span 传给同时接受 vector 的代码
+// 5. 异常保证与 vector 相同：emplace_back、push_back 满足强异常安全保证，其余函数满足基本异常保证
+
+#include <initializer_list>
+#include <type_traits>
+
+#include "algo.h"
+#include "iterator.h"
+#include "memory.h"
+#include "span.h"
+#include "vector.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 模板类: small_vector
+// 模板参数 T 代表类型，N 代表内联存储的元素个数
+template <typename T, size_t N>
+class small_vector {
+	static_assert(N > 0, "small_vector needs at least one inline element");
+	static_assert(!std::is_same<bool, T>::value, "small_vector<bool> is abandoned in mystl");
+public:
+	// small_vector 的嵌套型别定义
+	typedef mystl::allocator<T>                      allocator_type;
+	typedef mystl::allocator<T>                      data_allocator;
+
+	typedef typename allocator_type::value_type      value_type;
+	typedef typename allocator_type::pointer         pointer;
+	typedef typename allocator_type::const_pointer   const_pointer;
+	typedef typename allocator_type::reference       reference;
+	typedef typename allocator_type::const_reference const_reference;
+	typedef typename allocator_type::size_type       size_type;
+	typedef typename allocator_type::difference_type difference_type;
+
+	typedef value_type*                              iterator;
+	typedef const value_type*                        const_iterator;
+	typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+	typedef mystl::reverse_iterator<const_iterator>  const_reverse_iterator;
+
+	static constexpr size_type inline_capacity = N;
+
+	// 获取分配器类型
+	allocator_type get_allocator() { return data_allocator(); }
+
+private:
+	iterator begin_;  // 表示目前使用空间的头部
+	iterator end_;    // 表示目前使用空间的尾部
+	iterator cap_;    // 表示目前储存空间的尾部
+	typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buf_;  // 内联存储
+
+public:
+	// 构造、复制、移动、析构函数
+	small_vector() noexcept
+	{ reset_inline(); }
+
+	explicit small_vector(size_type n)
+	{
+		reset_inline();
+		fill_init(n, value_type());
+	}
+
+	small_vector(size_type n, const value_type& value)
+	{
+		reset_inline();
+		fill_init(n, value);
+	}
+
+	template <class Iter, typename std::enable_if<
+		mystl::is_input_iterator<Iter>::value, int>::type = 0>
+	small_vector(Iter first, Iter last)
+	{
+		reset_inline();
+		copy_init(first, last, iterator_category(first));
+	}
+
+	small_vector(const small_vector& rhs)
+	{
+		reset_inline();
+		copy_init(rhs.begin_, rhs.end_, mystl::forward_iterator_tag{});
+	}
+
+	small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+	{
+		reset_inline();
+		steal(rhs);
+	}
+
+	small_vector(std::initializer_list<value_type> ilist)
+	{
+		reset_inline();
+		copy_init(ilist.begin(), ilist.end(), mystl::forward_iterator_tag{});
+	}
+
+	small_vector& operator=(const small_vector& rhs)
+	{
+		if (this != &rhs)
+			assign(rhs.begin_, rhs.end_);
+		return *this;
+	}
+
+	small_vector& operator=(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+	{
+		if (this != &rhs)
+		{
+			destroy_and_recover();
+			reset_inline();
+			steal(rhs);
+		}
+		return *this;
+	}
+
+	small_vector& operator=(std::initializer_list<value_type> ilist)
+	{
+		assign(ilist.begin(), ilist.end());
+		return *this;
+	}
+
+	~small_vector()
+	{ destroy_and_recover(); }
+
+public:
+
+	// 迭代器相关操作
+	iterator               begin()         noexcept { return begin_; }
+	const_iterator         begin()   const noexcept { return begin_; }
+	iterator               end()           noexcept { return end_; }
+	const_iterator         end()     const noexcept { return end_; }
+
+	reverse_iterator       rbegin()        noexcept { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin()  const noexcept { return const_reverse_iterator(end()); }
+	reverse_iterator       rend()          noexcept { return reverse_iterator(begin()); }
+	const_reverse_iterator rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+	const_iterator         cbegin()  const noexcept { return begin(); }
+	const_iterator         cend()    const noexcept { return end(); }
+	const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+	const_reverse_iterator crend()   const noexcept { return rend(); }
+
+	// 容量相关操作
+	bool      empty()     const noexcept { return begin_ == end_; }
+	size_type size()      const noexcept { return static_cast<size_type>(end_ - begin_); }
+	size_type max_size()  const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+	size_type capacity()  const noexcept { return static_cast<size_type>(cap_ - begin_); }
+	// 元素是否存放在内联存储中
+	bool      is_inline() const noexcept { return begin_ == inline_data(); }
+	void      reserve(size_type n);
+	void      shrink_to_fit();
+
+	// 访问元素相关操作
+	reference operator[](size_type n)
+	{
+		MYSTL_DEBUG(n < size());
+		return *(begin_ + n);
+	}
+	const_reference operator[](size_type n) const
+	{
+		MYSTL_DEBUG(n < size());
+		return *(begin_ + n);
+	}
+	reference at(size_type n)
+	{
+		THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+		return (*this)[n];
+	}
+	const_reference at(size_type n) const
+	{
+		THROW_OUT_OF_RANGE_IF(!(n < size()), "small_vector<T, N>::at() subscript out of range");
+		return (*this)[n];
+	}
+
+	reference front()
+	{
+		MYSTL_DEBUG(!empty());
+		return *begin_;
+	}
+	const_reference front() const
+	{
+		MYSTL_DEBUG(!empty());
+		return *begin_;
+	}
+	reference back()
+	{
+		MYSTL_DEBUG(!empty());
+		return *(end_ - 1);
+	}
+	const_reference back() const
+	{
+		MYSTL_DEBUG(!empty());
+		return *(end_ - 1);
+	}
+
+	pointer       data()       noexcept { return begin_; }
+	const_pointer data() const noexcept { return begin_; }
+
+	// 转换为视图
+	span<T>       as_span()       noexcept { return span<T>(begin_, size()); }
+	span<const T> as_span() const noexcept { return span<const T>(begin_, size()); }
+
+	// 修改容器相关操作
+
+	// assign
+
+	void assign(size_type n, const value_type& value)
+	{
+		clear();
+		insert(end(), n, value);
+	}
+
+	template <typename Iter, typename std::enable_if<
+		mystl::is_input_iterator<Iter>::value, int>::type = 0>
+	void assign(Iter first, Iter last)
+	{
+		clear();
+		insert(end(), first, last);
+	}
+
+	void assign(std::initializer_list<value_type> il)
+	{ assign(il.begin(), il.end()); }
+
+	// emplace / emplace_back
+
+	template <typename... Args>
+	iterator emplace(const_iterator pos, Args&& ...args);
+
+	template <typename... Args>
+	void emplace_back(Args&& ...args)
+	{
+		if (end_ != cap_)
+		{
+			data_allocator::construct(mystl::address_of(*end_), mystl::forward<Args>(args)...);
+			++end_;
+		}
+		else
+		{
+			reallocate_emplace(end_, mystl::forward<Args>(args)...);
+		}
+	}
+
+	// push_back / pop_back
+
+	void push_back(const value_type& value)
+	{ emplace_back(value); }
+	void push_back(value_type&& value)
+	{ emplace_back(mystl::move(value)); }
+
+	void pop_back()
+	{
+		MYSTL_DEBUG(!empty());
+		data_allocator::destroy(end_ - 1);
+		--end_;
+	}
+
+	// insert
+
+	iterator insert(const_iterator pos, const value_type& value)
+	{ return emplace(pos, value); }
+	iterator insert(const_iterator pos, value_type&& value)
+	{ return emplace(pos, mystl::move(value)); }
+
+	iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+	template <typename Iter, typename std::enable_if<
+		mystl::is_input_iterator<Iter>::value, int>::type = 0>
+	iterator insert(const_iterator pos, Iter first, Iter last)
+	{
+		MYSTL_DEBUG(pos >= begin() && pos <= end());
+		return copy_insert(const_cast<iterator>(pos), first, last, iterator_category(first));
+	}
+
+	iterator insert(const_iterator pos, std::initializer_list<value_type> il)
+	{ return insert(pos, il.begin(), il.end()); }
+
+	// erase / clear
+	iterator erase(const_iterator pos);
+	iterator erase(const_iterator first, const_iterator last);
+	void     clear() noexcept
+	{
+		destroy_range(begin_, end_);
+		end_ = begin_;
+	}
+
+	// resize / reverse
+	void resize(size_type new_size)
+	{ resize(new_size, value_type()); }
+	void resize(size_type new_size, const value_type& value)
+	{
+		if (new_size < size())
+			erase(begin() + new_size, end());
+		else
+			insert(end(), new_size - size(), value);
+	}
+
+	void reverse()
+	{ mystl::reverse(begin(), end()); }
+
+	// swap
+	void swap(small_vector& rhs) noexcept(std::is_nothrow_move_constructible<T>::value);
+
+private:
+	// helper functions
+
+	pointer       inline_data()       noexcept { return reinterpret_cast<pointer>(&buf_); }
+	const_pointer inline_data() const noexcept { return reinterpret_cast<const_pointer>(&buf_); }
+
+	void reset_inline() noexcept
+	{
+		begin_ = end_ = inline_data();
+		cap_ = begin_ + N;
+	}
+
+	// 逐个析构 [first, last) 上的元素
+	static void destroy_range(pointer first, pointer last) noexcept
+	{
+		for (; first != last; ++first)
+			data_allocator::destroy(first);
+	}
+
+	// 销毁所有元素并归还堆内存，不重置指针
+	void destroy_and_recover() noexcept
+	{
+		destroy_range(begin_, end_);
+		if (!is_inline())
+			data_allocator::deallocate(begin_, capacity());
+	}
+
+	// 接管 rhs 的元素，要求本容器为空且使用内联存储
+	void steal(small_vector& rhs);
+
+	void fill_init(size_type n, const value_type& value);
+	template <typename IIter>
+	void copy_init(IIter first, IIter last, input_iterator_tag);
+	template <typename FIter>
+	void copy_init(FIter first, FIter last, forward_iterator_tag);
+
+	// 至少再容纳 add_size 个元素时的新容量，第一次溢出到堆上时与 vector 一样至少为 16
+	size_type next_cap(size_type add_size) const
+	{
+		const size_type new_cap = vector_grow_cap(capacity(), add_size, max_size());
+		return is_inline() ? mystl::max(new_cap, static_cast<size_type>(16)) : new_cap;
+	}
+
+	// 把元素搬到容量为 new_cap 的新空间，new_cap 不超过 N 时搬回内联存储
+	void relocate(size_type new_cap);
+	// 把[begin_, pos)和[pos, end_)上的元素搬到 new_begin 开始的新空间，两段之间空出 gap 个位置
+	void relocate_to(pointer new_begin, iterator pos, size_type gap);
+	// 元素搬走之后释放旧的堆空间，并指向新空间
+	void adopt(pointer new_begin, size_type new_size, size_type new_cap) noexcept
+	{
+		if (!is_inline())
+			data_allocator::deallocate(begin_, capacity());
+		begin_ = new_begin;
+		end_ = new_begin + new_size;
+		cap_ = new_begin + new_cap;
+	}
+
+	template <typename... Args>
+	void reallocate_emplace(iterator pos, Args&& ...args);
+
+	template <typename IIter>
+	iterator copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag);
+	template <typename FIter>
+	iterator copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag);
+};
+
+template <typename T, size_t N>
+constexpr typename small_vector<T, N>::size_type small_vector<T, N>::inline_capacity;
+
+/*****************************************************************************************/
+
+// 预留空间大小，当原容量小于要求大小时，才会重新分配
+template <typename T, size_t N>
+void small_vector<T, N>::reserve(size_type n)
+{
+	if (capacity() < n)
+	{
+		THROW_LENGTH_ERROR_IF(n > max_size(),
+			"n can not larger than max_size() in small_vector<T, N>::reserve(n)");
+		relocate(n);
+	}
+}
+
+// 放弃多余的容量，元素个数不超过 N 时搬回内联存储
+template <typename T, size_t N>
+void small_vector<T, N>::shrink_to_fit()
+{
+	if (!is_inline() && end_ < cap_)
+		relocate(size());
+}
+
+// 在 pos 位置就地构造元素
+template <typename T, size_t N>
+template <typename ...Args>
+typename small_vector<T, N>::iterator
+small_vector<T, N>::emplace(const_iterator pos, Args&& ...args)
+{
+	MYSTL_DEBUG(pos >= begin() && pos <= end());
+	iterator xpos = const_cast<iterator>(pos);
+	const size_type n = xpos - begin_;
+	if (end_ == cap_)
+	{
+		reallocate_emplace(xpos, mystl::forward<Args>(args)...);
+	}
+	else if (xpos == end_)
+	{
+		data_allocator::construct(mystl::address_of(*end_), mystl::forward<Args>(args)...);
+		++end_;
+	}
+	else
+	{
+		value_type value_copy(mystl::forward<Args>(args)...);  // 参数可能引用容器中的元素
+		data_allocator::construct(mystl::address_of(*end_), mystl::move(*(end_ - 1)));
+		++end_;
+		mystl::move_backward(xpos, end_ - 2, end_ - 1);
+		*xpos = mystl::move(value_copy);
+	}
+	return begin_ + n;
+}
+
+// 在 pos 处插入 n 个 value
+template <typename T, size_t N>
+typename small_vector<T, N>::iterator
+small_vector<T, N>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+	MYSTL_DEBUG(pos >= begin() && pos <= end());
+	const size_type xpos = pos - begin_;
+	if (n == 0)
+		return begin_ + xpos;
+	const value_type value_copy = value;  // 避免被覆盖
+	if (static_cast<size_type>(cap_ - end_) < n)
+		relocate(next_cap(n));
+	iterator p = begin_ + xpos;
+	const size_type after_elems = end_ - p;
+	auto old_end = end_;
+	if (after_elems > n)
+	{
+		end_ = mystl::uninitialized_move(end_ - n, end_, end_);
+		mystl::move_backward(p, old_end - n, old_end);
+		mystl::fill_n(p, n, value_copy);
+	}
+	else
+	{
+		end_ = mystl::uninitialized_fill_n(end_, n - after_elems, value_copy);
+		end_ = mystl::uninitialized_move(p, old_end, end_);
+		mystl::fill_n(p, after_elems, value_copy);
+	}
+	return begin_ + xpos;
+}
+
+// 删除 pos 位置上的元素
+template <typename T, size_t N>
+typename small_vector<T, N>::iterator
+small_vector<T, N>::erase(const_iterator pos)
+{
+	MYSTL_DEBUG(pos >= begin() && pos < end());
+	iterator xpos = begin_ + (pos - begin());
+	mystl::move(xpos + 1, end_, xpos);
+	data_allocator::destroy(end_ - 1);
+	--end_;
+	return xpos;
+}
+
+// 删除[first, last)上的元素
+template <typename T, size_t N>
+typename small_vector<T, N>::iterator
+small_vector<T, N>::erase(const_iterator first, const_iterator last)
+{
+	MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+	iterator r = begin_ + (first - begin());
+	if (first == last)
+		return r;  // 避免元素自移动赋值
+	destroy_range(mystl::move(r + (last - first), end_, r), end_);
+	end_ = end_ - (last - first);
+	return r;
+}
+
+// 与另一个 small_vector 交换
+// 双方都使用堆内存时交换指针，否则借助一个临时对象逐个移动元素
+template <typename T, size_t N>
+void small_vector<T, N>::swap(small_vector& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+{
+	if (this == &rhs)
+		return;
+	if (!is_inline() && !rhs.is_inline())
+	{
+		mystl::swap(begin_, rhs.begin_);
+		mystl::swap(end_, rhs.end_);
+		mystl::swap(cap_, rhs.cap_);
+		return;
+	}
+	small_vector tmp(mystl::move(rhs));
+	rhs = mystl::move(*this);
+	*this = mystl::move(tmp);
+}
+
+/*****************************************************************************************/
+// helper function
+
+// steal 函数，rhs 使用堆内存时直接接管，否则逐个移动元素，rhs 被置为空
+template <typename T, size_t N>
+void small_vector<T, N>::steal(small_vector& rhs)
+{
+	if (!rhs.is_inline())
+	{
+		begin_ = rhs.begin_;
+		end_ = rhs.end_;
+		cap_ = rhs.cap_;
+		rhs.reset_inline();
+	}
+	else
+	{
+		end_ = mystl::uninitialized_relocate(rhs.begin_, rhs.end_, begin_);
+		rhs.end_ = rhs.begin_;
+	}
+}
+
+// fill_init 函数
+template <typename T, size_t N>
+void small_vector<T, N>::fill_init(size_type n, const value_type& value)
+{
+	if (n > N)
+	{
+		begin_ = end_ = data_allocator::allocate(n);
+		cap_ = begin_ + n;
+	}
+	try
+	{
+		end_ = mystl::uninitialized_fill_n(begin_, n, value);
+	}
+	catch (...)
+	{
+		if (!is_inline())
+			data_allocator::deallocate(begin_, n);
+		throw;
+	}
+}
+
+// copy_init 函数
+template <typename T, size_t N>
+template <typename IIter>
+void small_vector<T, N>::copy_init(IIter first, IIter last, input_iterator_tag)
+{
+	try
+	{
+		for (; first != last; ++first)
+			emplace_back(*first);
+	}
+	catch (...)
+	{
+		destroy_and_recover();
+		throw;
+	}
+}
+
+template <typename T, size_t N>
+template <typename FIter>
+void small_vector<T, N>::copy_init(FIter first, FIter last, forward_iterator_tag)
+{
+	const size_type n = mystl::distance(first, last);
+	if (n > N)
+	{
+		begin_ = end_ = data_allocator::allocate(n);
+		cap_ = begin_ + n;
+	}
+	try
+	{
+		end_ = mystl::uninitialized_copy(first, last, begin_);
+	}
+	catch (...)
+	{
+		if (!is_inline())
+			data_allocator::deallocate(begin_, n);
+		throw;
+	}
+}
+
+// relocate 函数
+template <typename T, size_t N>
+void small_vector<T, N>::relocate(size_type new_cap)
+{
+	MYSTL_DEBUG(new_cap >= size());
+	const bool to_inline = new_cap <= N;
+	if (to_inline && is_inline())
+		return;
+	pointer new_begin = to_inline ? inline_data() : data_allocator::allocate(new_cap);
+	try
+	{
+		relocate_to(new_begin, end_, 0);
+	}
+	catch (...)
+	{
+		if (!to_inline)
+			data_allocator::deallocate(new_begin, new_cap);
+		throw;
+	}
+	adopt(new_begin, size(), to_inline ? N : new_cap);
+}
+
+// relocate_to 函数，与 vector::relocate_to 相同
+// 元素可按字节搬移(is_trivially_relocatable)时直接复制内存，否则逐个移动构造，全部成功后才析构旧元素
+template <typename T, size_t N>
+void small_vector<T, N>::relocate_to(pointer new_begin, iterator pos, size_type gap)
+{
+	if (is_trivially_relocatable<T>::value)
+	{
+		auto mid = mystl::uninitialized_relocate(begin_, pos, new_begin);
+		mystl::uninitialized_relocate(pos, end_, mid + gap);
+	}
+	else
+	{
+		auto mid = mystl::uninitialized_move(begin_, pos, new_begin);
+		try
+		{
+			mystl::uninitialized_move(pos, end_, mid + gap);
+		}
+		catch (...)
+		{
+			destroy_range(new_begin, mid);
+			throw;
+		}
+		destroy_range(begin_, end_);
+	}
+}
+
+// 重新分配空间并在 pos 处就地构造元素
+template <typename T, size_t N>
+template <typename ...Args>
+void small_vector<T, N>::reallocate_emplace(iterator pos, Args&& ...args)
+{
+	const auto new_cap = next_cap(1);
+	auto new_begin = data_allocator::allocate(new_cap);
+	const size_type xpos = pos - begin_;
+	try
+	{
+		// 先构造新元素，参数可能引用容器中的元素
+		data_allocator::construct(mystl::address_of(*(new_begin + xpos)), mystl::forward<Args>(args)...);
+	}
+	catch (...)
+	{
+		data_allocator::deallocate(new_begin, new_cap);
+		throw;
+	}
+	try
+	{
+		relocate_to(new_begin, pos, 1);
+	}
+	catch (...)
+	{
+		data_allocator::destroy(new_begin + xpos);
+		data_allocator::deallocate(new_begin, new_cap);
+		throw;
+	}
+	adopt(new_begin, size() + 1, new_cap);
+}
+
+// copy_insert 函数
+template <typename T, size_t N>
+template <typename IIter>
+typename small_vector<T, N>::iterator
+small_vector<T, N>::copy_insert(iterator pos, IIter first, IIter last, input_iterator_tag)
+{
+	const size_type xpos = pos - begin_;
+	const size_type old_size = size();
+	for (; first != last; ++first)
+		emplace_back(*first);
+	mystl::rotate(begin_ + xpos, begin_ + old_size, end_);
+	return begin_ + xpos;
+}
+
+template <typename T, size_t N>
+template <typename FIter>
+typename small_vector<T, N>::iterator
+small_vector<T, N>::copy_insert(iterator pos, FIter first, FIter last, forward_iterator_tag)
+{
+	const size_type xpos = pos - begin_;
+	const size_type n = mystl::distance(first, last);
+	if (n == 0)
+		return pos;
+	if (static_cast<size_type>(cap_ - end_) < n)
+	{
+		// 备用空间不足，[first, last) 可能引用容器中的元素，在旧空间释放前复制到新空间
+		const auto new_cap = next_cap(n);
+		auto new_begin = data_allocator::allocate(new_cap);
+		try
+		{
+			mystl::uninitialized_copy(first, last, new_begin + xpos);
+		}
+		catch (...)
+		{
+			data_allocator::deallocate(new_begin, new_cap);
+			throw;
+		}
+		try
+		{
+			relocate_to(new_begin, pos, n);
+		}
+		catch (...)
+		{
+			destroy_range(new_begin + xpos, new_begin + xpos + n);
+			data_allocator::deallocate(new_begin, new_cap);
+			throw;
+		}
+		adopt(new_begin, size() + n, new_cap);
+		return begin_ + xpos;
+	}
+	iterator p = begin_ + xpos;
+	const size_type after_elems = end_ - p;
+	auto old_end = end_;
+	if (after_elems > n)
+	{
+		end_ = mystl::uninitialized_move(end_ - n, end_, end_);
+		mystl::move_backward(p, old_end - n, old_end);
+		mystl::copy(first, last, p);
+	}
+	else
+	{
+		auto mid = first;
+		mystl::advance(mid, after_elems);
+		end_ = mystl::uninitialized_copy(mid, last, end_);
+		end_ = mystl::uninitialized_move(p, old_end, end_);
+		mystl::copy(first, mid, p);
+	}
+	return begin_ + xpos;
+}
+
+/*****************************************************************************************/
+// 重载比较操作符
+
+template <typename T, size_t N>
+bool operator==(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+{
+	return lhs.size() == rhs.size() &&
+		mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, size_t N>
+bool operator<(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+{
+	return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t N>
+bool operator!=(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+{
+	return !(lhs == rhs);
+}
+
+template <typename T, size_t N>
+bool operator>(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+{
+	return rhs < lhs;
+}
+
+template <typename T, size_t N>
+bool operator<=(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+{
+	return !(rhs < lhs);
+}
+
+template <typename T, size_t N>
+bool operator>=(const small_vector<T, N>& lhs, const small_vector<T, N>& rhs)
+{
+	return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <typename T, size_t N>
+void swap(small_vector<T, N>& lhs, small_vector<T, N>& rhs)
+{
+	lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYSTL_SMALL_VECTOR_H_
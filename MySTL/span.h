@@ -0,0 +1,141 @@
+﻿#ifndef MYSTL_SPAN_H_
+#define MYSTL_SPAN_H_
+
+// 这个头文件包含一个模板类 span
+// span : 连续存储的一段元素的视图，不拥有元素
+
+// notes:
+//
+// 1. span 只保存首元素指针和元素个数，复制、传值的开销与一对指针相同
+// 2. 可以由数组、指针与长度、以及任何提供 data() 和 size() 的连续容器(vector、small_vector、basic_string 等)隐式构造，
+//    接受 span<const T> 的函数因此可以同时用于这些容器，而不必关心它们的具体类型
+// 3. span 不延长元素的生命周期，被引用的容器重新分配内存后，原来的 span 失效
+
+#include <cstddef>
+#include <type_traits>
+
+#include "iterator.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 模板类 span
+// 模板参数 T 代表元素类型，只读视图使用 span<const T>
+template <typename T>
+class span {
+public:
+	// span 的嵌套型别定义
+	typedef T                                        element_type;
+	typedef typename std::remove_cv<T>::type         value_type;
+	typedef T*                                       pointer;
+	typedef const T*                                 const_pointer;
+	typedef T&                                       reference;
+	typedef const T&                                 const_reference;
+	typedef size_t                                   size_type;
+	typedef ptrdiff_t                                difference_type;
+
+	typedef T*                                       iterator;
+	typedef mystl::reverse_iterator<iterator>        reverse_iterator;
+
+private:
+	pointer   data_;  // 首元素
+	size_type size_;  // 元素个数
+
+public:
+	// 构造函数
+	span() noexcept
+	  :data_(nullptr), size_(0) {
+	}
+
+	span(pointer p, size_type n) noexcept
+	  :data_(p), size_(n) {
+	}
+
+	span(pointer first, pointer last) noexcept
+	  :data_(first), size_(static_cast<size_type>(last - first)) {
+		MYSTL_DEBUG(!(last < first));
+	}
+
+	template <size_t N>
+	span(element_type (&arr)[N]) noexcept
+	  :data_(arr), size_(N) {
+	}
+
+	// 由提供 data() 和 size() 的连续容器构造，data() 的返回值需要能转换为 pointer
+	template <typename Container, typename = typename std::enable_if<
+		!std::is_array<Container>::value &&
+		std::is_convertible<decltype(std::declval<Container&>().data()), pointer>::value>::type>
+	span(Container& c) noexcept
+	  :data_(c.data()), size_(static_cast<size_type>(c.size())) {
+	}
+
+	// span<T> 可以转换为 span<const T>
+	template <typename U, typename = typename std::enable_if<
+		std::is_convertible<U(*)[], T(*)[]>::value>::type>
+	span(const span<U>& rhs) noexcept
+	  :data_(rhs.data()), size_(rhs.size()) {
+	}
+
+public:
+	// 迭代器相关操作
+	iterator         begin()  const noexcept { return data_; }
+	iterator         end()    const noexcept { return data_ + size_; }
+	reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+	reverse_iterator rend()   const noexcept { return reverse_iterator(begin()); }
+
+	// 容量相关操作
+	bool      empty()      const noexcept { return size_ == 0; }
+	size_type size()       const noexcept { return size_; }
+	size_type size_bytes() const noexcept { return size_ * sizeof(T); }
+
+	// 访问元素相关操作
+	pointer   data() const noexcept { return data_; }
+
+	reference operator[](size_type n) const {
+		MYSTL_DEBUG(n < size_);
+		return data_[n];
+	}
+	reference at(size_type n) const {
+		THROW_OUT_OF_RANGE_IF(!(n < size_), "span<T>::at() subscript out of range");
+		return data_[n];
+	}
+	reference front() const {
+		MYSTL_DEBUG(!empty());
+		return data_[0];
+	}
+	reference back() const {
+		MYSTL_DEBUG(!empty());
+		return data_[size_ - 1];
+	}
+
+	// 子视图
+	span first(size_type n) const {
+		MYSTL_DEBUG(n <= size_);
+		return span(data_, n);
+	}
+	span last(size_type n) const {
+		MYSTL_DEBUG(n <= size_);
+		return span(data_ + size_ - n, n);
+	}
+	span subspan(size_type offset, size_type n = static_cast<size_type>(-1)) const {
+		MYSTL_DEBUG(offset <= size_);
+		return span(data_ + offset, n == static_cast<size_type>(-1) ? size_ - offset : n);
+	}
+};
+
+// 为容器或数组构造只读视图
+template <typename Container>
+span<const typename std::remove_pointer<decltype(std::declval<const Container&>().data())>::type>
+make_span(const Container& c) noexcept {
+	return { c.data(), static_cast<size_t>(c.size()) };
+}
+
+template <typename T, size_t N>
+span<const T> make_span(const T (&arr)[N]) noexcept {
+	return span<const T>(arr, N);
+}
+
+} // namespace mystl
+#endif // !MYSTL_SPAN_H_
@@ -39,6 +39,22 @@ struct is_pair : mystl::m_false_type {};
 template <typename T1, typename T2>
 struct is_pair<mystl::pair<T1, T2>> : mystl::m_true_type {};
 
+// is_trivially_relocatable
+// 对象可以按字节复制到新地址，并且复制之后不需要在原地址析构，即“移动构造 + 析构原对象”等价于 memcpy
+// 可平凡复制的类型都满足；不指向自身的容器(只保存指向堆内存的指针)可以通过特化加入，
+// 指向自身内部的类型(如带内联存储的 small_vector、把头节点嵌在对象中的 unrolled_list)不能加入
+
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+struct is_trivially_relocatable<const T> : is_trivially_relocatable<T> {};
+
+template <typename T1, typename T2>
+struct is_trivially_relocatable<mystl::pair<T1, T2>>
+  : std::integral_constant<bool, is_trivially_relocatable<T1>::value &&
+                                 is_trivially_relocatable<T2>::value> {};
+
 } // namespace mystl
 
 #endif // !MYSTL_TYPE_TRAITS_H_
@@ -3,6 +3,8 @@
 
 // 这个头文件用于对未初始化空间构造元素
 
+#include <cstring>
+
 #include "algobase.h"
 #include "construct.h"
 #include "iterator.h"
@@ -171,6 +173,50 @@ ForwardIter uninitialized_fill_n(ForwardIter first, Size n, const T& value)
                                         value_type>{});
 }
 
+/*****************************************************************************************/
+// uninitialized_default_construct_n
+// 从 first 位置开始，默认初始化 n 个元素，返回结束的位置
+// 平凡默认构造的类型(如 int、char)不做任何写入，元素的值是不确定的
+/*****************************************************************************************/
+template <typename ForwardIter, typename Size>
+ForwardIter 
+unchecked_uninit_default_n(ForwardIter first, Size n, std::true_type)
+{
+  mystl::advance(first, n);
+  return first;
+}
+
+template <typename ForwardIter, typename Size>
+ForwardIter 
+unchecked_uninit_default_n(ForwardIter first, Size n, std::false_type)
+{
+  typedef typename iterator_traits<ForwardIter>::value_type value_type;
+  auto cur = first;
+  try
+  {
+    for (; n > 0; --n, ++cur)
+    {
+      ::new ((void*)&*cur) value_type;
+    }
+  }
+  catch (...)
+  {
+    for (; first != cur; ++first)
+      mystl::destroy(&*first);
+    throw;
+  }
+  return cur;
+}
+
+template <typename ForwardIter, typename Size>
+ForwardIter uninitialized_default_construct_n(ForwardIter first, Size n)
+{
+  return mystl::unchecked_uninit_default_n(first, n,
+                                           std::is_trivially_default_constructible<
+                                           typename iterator_traits<ForwardIter>::
+                                           value_type>{});
+}
+
 /*****************************************************************************************/
 // uninitialized_move
 // 把[first, last)上的内容移动到以 result 为起始处的空间，返回移动结束的位置
@@ -251,6 +297,37 @@ ForwardIter uninitialized_move_n(InputIter first, Size n, ForwardIter result)
                                         value_type>{});
 }
 
+/*****************************************************************************************/
+// uninitialized_relocate
+// 把[first, last)上的对象搬到以 result 为起始处的未初始化空间，返回搬移结束的位置
+// 搬移之后[first, last)上只剩未初始化的空间，不需要再析构
+// is_trivially_relocatable 的类型直接按字节复制，其余类型逐个移动构造后析构原对象
+/*****************************************************************************************/
+template <typename T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, std::true_type)
+{
+  const auto n = static_cast<size_t>(last - first);
+  if (n != 0)
+    std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T));
+  return result + n;
+}
+
+template <typename T>
+T* unchecked_uninit_relocate(T* first, T* last, T* result, std::false_type)
+{
+  auto cur = mystl::uninitialized_move(first, last, result);
+  for (; first != last; ++first)
+    mystl::destroy(first);
+  return cur;
+}
+
+template <typename T>
+T* uninitialized_relocate(T* first, T* last, T* result)
+{
+  return mystl::unchecked_uninit_relocate(first, last, result,
+                                          is_trivially_relocatable<T>{});
+}
+
 } // namespace mystl
 #endif // !MYSTL_UNINITIALIZED_H_
 
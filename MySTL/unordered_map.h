@@ -48,6 +48,9 @@ public:
 	typedef typename base_type::local_iterator       local_iterator;
 	typedef typename base_type::const_local_iterator const_local_iterator;
 
+	typedef typename base_type::handle_type          handle_type;
+	typedef mystl::node_insert_return<iterator, handle_type> insert_return_type;
+
 	allocator_type get_allocator() const { return ht_.get_allocator(); }
 
 public:
@@ -142,6 +145,31 @@ public:
 	iterator emplace_hint(const_iterator hint, Args&& ...args)
 	{ return ht_.emplace_unique_use_hint(hint, mystl::forward<Args>(args)...); }
 
+	// try_emplace 先查找 key，不存在时才以 key 和 T(args...) 构造节点，已存在时不会移动 key 与 args
+	// insert_or_assign 在 key 已存在时把 obj 赋给它的实值
+
+	template <typename ...Args>
+	pair<iterator, bool> try_emplace(const key_type& key, Args&& ...args)
+	{ return ht_.try_emplace_unique(key, mystl::forward<Args>(args)...); }
+	template <typename ...Args>
+	pair<iterator, bool> try_emplace(key_type&& key, Args&& ...args)
+	{ return ht_.try_emplace_unique(mystl::move(key), mystl::forward<Args>(args)...); }
+
+	template <typename M>
+	pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+		auto res = ht_.try_emplace_unique(key, mystl::forward<M>(obj));
+		if (!res.second)
+			res.first->second = mystl::forward<M>(obj);
+		return res;
+	}
+	template <typename M>
+	pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+		auto res = ht_.try_emplace_unique(mystl::move(key), mystl::forward<M>(obj));
+		if (!res.second)
+			res.first->second = mystl::forward<M>(obj);
+		return res;
+	}
+
 	// insert
 
 	pair<iterator, bool> insert(const value_type& value)
@@ -174,6 +202,22 @@ public:
 	void      swap(unordered_map& other) noexcept
 	{ ht_.swap(other.ht_); }
 
+	// 节点句柄与 merge，只重新链接节点，不复制元素，也不申请节点
+
+	handle_type extract(const_iterator it)
+	{ return ht_.extract(it); }
+	handle_type extract(const key_type& key)
+	{ return ht_.extract(key); }
+
+	insert_return_type insert(handle_type&& nh) {
+		auto res = ht_.insert_unique(mystl::move(nh));
+		return insert_return_type{ res.position, res.inserted, mystl::move(res.node) };
+	}
+
+	// 键值已存在的元素留在 source 中
+	void        merge(unordered_map& source)
+	{ ht_.merge_unique(source.ht_); }
+
 	// 查找相关
 
 	mapped_type& at(const key_type& key) {
@@ -187,18 +231,10 @@ public:
 		return it->second;
 	}
 
-	mapped_type& operator[](const key_type& key) {
-		iterator it = ht_.find(key);
-		if (it.node == nullptr)
-			it = ht_.emplace_unique(key, T{}).first;
-		return it->second;
-	}
-	mapped_type& operator[](key_type&& key) {
-		iterator it = ht_.find(key);
-		if (it.node == nullptr)
-			it = ht_.emplace_unique(mystl::move(key), T{}).first;
-		return it->second;
-	}
+	mapped_type& operator[](const key_type& key)
+	{ return ht_.try_emplace_unique(key).first->second; }
+	mapped_type& operator[](key_type&& key)
+	{ return ht_.try_emplace_unique(mystl::move(key)).first->second; }
 
 	size_type      count(const key_type& key) const 
 	{ return ht_.count(key); }
@@ -213,6 +249,29 @@ public:
 	pair<const_iterator, const_iterator> equal_range(const key_type& key) const
 	{ return ht_.equal_range_unique(key); }
 
+	// 透明查找，只在 hasher 与 key_equal 都定义了 is_transparent 时参与重载
+	// 与 key 相等的元素可能不止一个，equal_range 按键值可重复处理
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	size_type      count(const K& key) const
+	{ return ht_.count(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	iterator       find(const K& key)
+	{ return ht_.find(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	const_iterator find(const K& key) const
+	{ return ht_.find(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<iterator, iterator> equal_range(const K& key)
+	{ return ht_.equal_range_multi(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<const_iterator, const_iterator> equal_range(const K& key) const
+	{ return ht_.equal_range_multi(key); }
+
 	// bucket interface
 
 	local_iterator       begin(size_type n)        noexcept
@@ -249,6 +308,9 @@ public:
 	void      rehash(size_type count)                 { ht_.rehash(count); }
 	void      reserve(size_type count)                { ht_.reserve(count); }
 
+	bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+	void      incremental_rehash(bool on)             { ht_.incremental_rehash(on); }
+
 	hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
 	key_equal key_eq()                 const          { return ht_.key_eq(); }
 
@@ -314,6 +376,8 @@ public:
 	typedef typename base_type::local_iterator       local_iterator;
 	typedef typename base_type::const_local_iterator const_local_iterator;
 
+	typedef typename base_type::handle_type          handle_type;
+
 	allocator_type get_allocator() const { return ht_.get_allocator(); }
 
 public:
@@ -440,6 +504,19 @@ public:
 	void      swap(unordered_multimap& other) noexcept 
 	{ ht_.swap(other.ht_); }
 
+	// 节点句柄与 merge，只重新链接节点，不复制元素，也不申请节点
+
+	handle_type extract(const_iterator it)
+	{ return ht_.extract(it); }
+	handle_type extract(const key_type& key)
+	{ return ht_.extract(key); }
+
+	iterator    insert(handle_type&& nh)
+	{ return ht_.insert_multi(mystl::move(nh)); }
+
+	void        merge(unordered_multimap& source)
+	{ ht_.merge_multi(source.ht_); }
+
 	// 查找相关
 
 	size_type      count(const key_type& key) const 
@@ -455,6 +532,28 @@ public:
 	pair<const_iterator, const_iterator> equal_range(const key_type& key) const 
 	{ return ht_.equal_range_multi(key); }
 
+	// 透明查找，只在 hasher 与 key_equal 都定义了 is_transparent 时参与重载
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	size_type      count(const K& key) const
+	{ return ht_.count(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	iterator       find(const K& key)
+	{ return ht_.find(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	const_iterator find(const K& key) const
+	{ return ht_.find(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<iterator, iterator> equal_range(const K& key)
+	{ return ht_.equal_range_multi(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<const_iterator, const_iterator> equal_range(const K& key) const
+	{ return ht_.equal_range_multi(key); }
+
 	// bucket interface
 
 	local_iterator       begin(size_type n)        noexcept
@@ -491,6 +590,9 @@ public:
 	void      rehash(size_type count)                 { ht_.rehash(count); }
 	void      reserve(size_type count)                { ht_.reserve(count); }
 
+	bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+	void      incremental_rehash(bool on)             { ht_.incremental_rehash(on); }
+
 	hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
 	key_equal key_eq()                 const          { return ht_.key_eq(); }
 
@@ -47,6 +47,9 @@ public:
 	typedef typename base_type::const_local_iterator local_iterator;
 	typedef typename base_type::const_local_iterator const_local_iterator;
 
+	typedef typename base_type::handle_type          handle_type;
+	typedef mystl::node_insert_return<iterator, handle_type> insert_return_type;
+
 	allocator_type get_allocator() const { return ht_.get_allocator(); }
 
 public:
@@ -173,6 +176,22 @@ public:
 	void      swap(unordered_set& other) noexcept
 	{ ht_.swap(other.ht_); }
 
+	// 节点句柄与 merge，只重新链接节点，不复制元素，也不申请节点
+
+	handle_type extract(const_iterator it)
+	{ return ht_.extract(it); }
+	handle_type extract(const key_type& key)
+	{ return ht_.extract(key); }
+
+	insert_return_type insert(handle_type&& nh) {
+		auto res = ht_.insert_unique(mystl::move(nh));
+		return insert_return_type{ res.position, res.inserted, mystl::move(res.node) };
+	}
+
+	// 键值已存在的元素留在 source 中
+	void        merge(unordered_set& source)
+	{ ht_.merge_unique(source.ht_); }
+
 	// 查找相关
 
 	size_type      count(const key_type& key) const 
@@ -188,6 +207,29 @@ public:
 	pair<const_iterator, const_iterator> equal_range(const key_type& key) const
 	{ return ht_.equal_range_unique(key); }
 
+	// 透明查找，只在 hasher 与 key_equal 都定义了 is_transparent 时参与重载
+	// 与 key 相等的元素可能不止一个，equal_range 按键值可重复处理
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	size_type      count(const K& key) const
+	{ return ht_.count(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	iterator       find(const K& key)
+	{ return ht_.find(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	const_iterator find(const K& key) const
+	{ return ht_.find(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<iterator, iterator> equal_range(const K& key)
+	{ return ht_.equal_range_multi(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<const_iterator, const_iterator> equal_range(const K& key) const
+	{ return ht_.equal_range_multi(key); }
+
 	// bucket interface
 
 	local_iterator       begin(size_type n)        noexcept
@@ -224,6 +266,9 @@ public:
 	void      rehash(size_type count)                 { ht_.rehash(count); }
 	void      reserve(size_type count)                { ht_.reserve(count); }
 
+	bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+	void      incremental_rehash(bool on)             { ht_.incremental_rehash(on); }
+
 	hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
 	key_equal key_eq()                 const          { return ht_.key_eq(); }
 
@@ -289,6 +334,8 @@ public:
 	typedef typename base_type::const_local_iterator local_iterator;
 	typedef typename base_type::const_local_iterator const_local_iterator;
 
+	typedef typename base_type::handle_type          handle_type;
+
 	allocator_type get_allocator() const { return ht_.get_allocator(); }
 
 public:
@@ -416,6 +463,19 @@ public:
 	void      swap(unordered_multiset& other) noexcept 
 	{ ht_.swap(other.ht_); }
 
+	// 节点句柄与 merge，只重新链接节点，不复制元素，也不申请节点
+
+	handle_type extract(const_iterator it)
+	{ return ht_.extract(it); }
+	handle_type extract(const key_type& key)
+	{ return ht_.extract(key); }
+
+	iterator    insert(handle_type&& nh)
+	{ return ht_.insert_multi(mystl::move(nh)); }
+
+	void        merge(unordered_multiset& source)
+	{ ht_.merge_multi(source.ht_); }
+
 	// 查找相关
 
 	size_type      count(const key_type& key) const 
@@ -431,6 +491,28 @@ public:
 	pair<const_iterator, const_iterator> equal_range(const key_type& key) const
 	{ return ht_.equal_range_multi(key); }
 
+	// 透明查找，只在 hasher 与 key_equal 都定义了 is_transparent 时参与重载
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	size_type      count(const K& key) const
+	{ return ht_.count(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	iterator       find(const K& key)
+	{ return ht_.find(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	const_iterator find(const K& key) const
+	{ return ht_.find(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<iterator, iterator> equal_range(const K& key)
+	{ return ht_.equal_range_multi(key); }
+	template <typename K, typename H = hasher, typename E = key_equal,
+	          typename = typename H::is_transparent, typename = typename E::is_transparent>
+	pair<const_iterator, const_iterator> equal_range(const K& key) const
+	{ return ht_.equal_range_multi(key); }
+
 	// bucket interface
 
 	local_iterator       begin(size_type n)        noexcept
@@ -467,6 +549,9 @@ public:
 	void      rehash(size_type count)                 { ht_.rehash(count); }
 	void      reserve(size_type count)                { ht_.reserve(count); }
 
+	bool      incremental_rehash()     const noexcept { return ht_.incremental_rehash(); }
+	void      incremental_rehash(bool on)             { ht_.incremental_rehash(on); }
+
 	hasher    hash_fcn()               const          { return ht_.hash_fcn(); }
 	key_equal key_eq()                 const          { return ht_.key_eq(); }
 
@@ -0,0 +1,819 @@
+﻿#ifndef MYSTL_UNROLLED_LIST_H_
+#define MYSTL_UNROLLED_LIST_H_
+
+// 这个头文件包含一个模板类 unrolled_list
+// unrolled_list : 展开链表，双向链表的每个节点(块)连续存放若干个元素
+
+// notes:
+//
+// 1. list 的每个元素单独占一个节点，顺序遍历时几乎每个元素都落在一条新的 cache line 上；
+//    unrolled_list 的每个块约占 kUnrolledChunkBytes 字节，块内元素连续存放，遍历时访存几乎是连续的。
+// 2. 模板参数 N 为每个块的容量，为 0 时由 kUnrolledChunkBytes 和元素大小决定，每块至少 kUnrolledMinChunk 个元素。
+// 3. 在块内插入、删除需要移动该块中的其余元素：块满时对半分裂，块中元素不足容量的 1/4 时
+//    尝试与相邻的块合并，因此插入、删除的代价与块的容量成正比，与链表的长度无关。
+// 4. 插入、删除只会使被修改的块(以及分裂出的新块、被合并的相邻块)上的迭代器失效，
+//    其他块上的迭代器保持有效；end() 始终有效。
+// 5. splice 以块为单位接合，只在 pos 位于块中间时把 pos 所在的块分裂一次，不移动 other 中的任何元素。
+// 6. 块内移动元素要求元素的移动构造不抛出异常，平凡可复制的元素直接按字节搬移。
+
+#include <initializer_list>
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 块的目标大小(字节)
+static constexpr size_t kUnrolledChunkBytes = 512;
+// 每个块至少容纳的元素个数
+static constexpr size_t kUnrolledMinChunk   = 8;
+
+// 根据 N、kUnrolledChunkBytes 与元素大小计算每个块的容量
+template <typename T, size_t N>
+struct unrolled_chunk_size {
+	// 块头：前后块指针、元素个数
+	static constexpr size_t header_bytes = sizeof(void*) * 3;
+	static constexpr size_t fit          = (kUnrolledChunkBytes - header_bytes) / sizeof(T);
+	static constexpr size_t value        = N != 0 ? N : (fit > kUnrolledMinChunk ? fit : kUnrolledMinChunk);
+};
+
+// unrolled_list 的块设计
+// 头节点只有块头部分，与所有块组成一个环状双向链表
+
+template <typename T>
+struct unrolled_chunk_base {
+	typedef unrolled_chunk_base<T>* base_ptr;
+
+	base_ptr prev;   // 前一个块
+	base_ptr next;   // 后一个块
+	size_t   count;  // 块中的元素个数，头节点为 0
+};
+
+template <typename T, size_t Cap>
+struct unrolled_chunk :public unrolled_chunk_base<T> {
+	typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[Cap];
+
+	T* value_ptr(size_t i) { return reinterpret_cast<T*>(&slots[i]); }
+	T& value(size_t i)     { return *value_ptr(i); }
+};
+
+// unrolled_list 的迭代器设计
+// 迭代器由块和块内下标组成，end() 为头节点的第 0 个位置
+
+template <typename T, size_t Cap>
+struct unrolled_iterator_base :public mystl::iterator<mystl::bidirectional_iterator_tag, T> {
+	typedef unrolled_chunk_base<T>* base_ptr;
+	typedef unrolled_chunk<T, Cap>* chunk_ptr;
+
+	base_ptr node;  // 所在的块
+	size_t   pos;   // 块内的下标
+
+	unrolled_iterator_base() :node(nullptr), pos(0) {}
+
+	// 使迭代器前进，到达块末尾时转到下一个块的开头
+	void inc() {
+		if (++pos == node->count) {
+			node = node->next;
+			pos = 0;
+		}
+	}
+
+	// 使迭代器后退，位于块开头时转到上一个块的末尾
+	void dec() {
+		if (pos == 0) {
+			node = node->prev;
+			pos = node->count - 1;
+		} else {
+			--pos;
+		}
+	}
+
+	T& value() const { return static_cast<chunk_ptr>(node)->value(pos); }
+
+	bool operator==(const unrolled_iterator_base& rhs) const { return node == rhs.node && pos == rhs.pos; }
+	bool operator!=(const unrolled_iterator_base& rhs) const { return !(*this == rhs); }
+};
+
+template <typename T, size_t Cap> struct unrolled_const_iterator;
+
+// 展开链表迭代器
+template <typename T, size_t Cap>
+struct unrolled_iterator :public unrolled_iterator_base<T, Cap> {
+	typedef T                                 value_type;
+	typedef T*                                pointer;
+	typedef T&                                reference;
+	typedef unrolled_chunk_base<T>*           base_ptr;
+
+	typedef unrolled_iterator<T, Cap>         iterator;
+	typedef unrolled_const_iterator<T, Cap>   const_iterator;
+	typedef iterator                          self;
+
+	using unrolled_iterator_base<T, Cap>::node;
+	using unrolled_iterator_base<T, Cap>::pos;
+
+	// 构造函数
+	unrolled_iterator() {}
+	unrolled_iterator(base_ptr x, size_t n) { node = x; pos = n; }
+
+	// 重载操作符
+	reference operator*()  const { return this->value(); }
+	pointer   operator->() const { return &(operator*()); }
+
+	self& operator++() {
+		this->inc();
+		return *this;
+	}
+	self operator++(int) {
+		self tmp(*this);
+		this->inc();
+		return tmp;
+	}
+	self& operator--() {
+		this->dec();
+		return *this;
+	}
+	self operator--(int) {
+		self tmp(*this);
+		this->dec();
+		return tmp;
+	}
+};
+
+// 展开链表常量迭代器
+template <typename T, size_t Cap>
+struct unrolled_const_iterator :public unrolled_iterator_base<T, Cap> {
+	typedef T                                 value_type;
+	typedef const T*                          pointer;
+	typedef const T&                          reference;
+	typedef unrolled_chunk_base<T>*           base_ptr;
+
+	typedef unrolled_iterator<T, Cap>         iterator;
+	typedef unrolled_const_iterator<T, Cap>   const_iterator;
+	typedef const_iterator                    self;
+
+	using unrolled_iterator_base<T, Cap>::node;
+	using unrolled_iterator_base<T, Cap>::pos;
+
+	// 构造函数
+	unrolled_const_iterator() {}
+	unrolled_const_iterator(base_ptr x, size_t n) { node = x; pos = n; }
+	unrolled_const_iterator(const iterator& rhs) { node = rhs.node; pos = rhs.pos; }
+
+	// 重载操作符
+	reference operator*()  const { return this->value(); }
+	pointer   operator->() const { return &(operator*()); }
+
+	self& operator++() {
+		this->inc();
+		return *this;
+	}
+	self operator++(int) {
+		self tmp(*this);
+		this->inc();
+		return tmp;
+	}
+	self& operator--() {
+		this->dec();
+		return *this;
+	}
+	self operator--(int) {
+		self tmp(*this);
+		this->dec();
+		return tmp;
+	}
+};
+
+// 模板类 unrolled_list
+// 参数一代表数据类型，参数二代表每个块的容量，为 0 时自动选择
+template <typename T, size_t N = 0>
+class unrolled_list {
+public:
+	// unrolled_list 的嵌套型别定义
+
+	// 每个块的容量
+	static constexpr size_t chunk_capacity = unrolled_chunk_size<T, N>::value;
+
+	typedef unrolled_chunk_base<T>                    base_type;
+	typedef unrolled_chunk_base<T>*                   base_ptr;
+	typedef unrolled_chunk<T, chunk_capacity>         chunk_type;
+	typedef unrolled_chunk<T, chunk_capacity>*        chunk_ptr;
+
+	typedef mystl::allocator<T>                       allocator_type;
+	typedef mystl::allocator<T>                       data_allocator;
+	typedef mystl::allocator<chunk_type>              chunk_allocator;
+
+	typedef typename allocator_type::value_type       value_type;
+	typedef typename allocator_type::pointer          pointer;
+	typedef typename allocator_type::const_pointer    const_pointer;
+	typedef typename allocator_type::reference        reference;
+	typedef typename allocator_type::const_reference  const_reference;
+	typedef typename allocator_type::size_type        size_type;
+	typedef typename allocator_type::difference_type  difference_type;
+
+	typedef unrolled_iterator<T, chunk_capacity>       iterator;
+	typedef unrolled_const_iterator<T, chunk_capacity> const_iterator;
+	typedef mystl::reverse_iterator<iterator>          reverse_iterator;
+	typedef mystl::reverse_iterator<const_iterator>    const_reverse_iterator;
+
+	allocator_type get_allocator() const { return allocator_type(); }
+
+private:
+	// 用以下三个数据表现 unrolled_list
+	base_type head_;    // 头节点，end() 所在的位置
+	size_type size_;    // 元素个数
+	size_type chunks_;  // 块的个数
+
+public:
+	// 构造、复制、移动、析构函数
+	unrolled_list() noexcept
+	{ reset(); }
+
+	explicit unrolled_list(size_type n)
+	{ reset(); fill_init(n, value_type()); }
+
+	unrolled_list(size_type n, const value_type& value)
+	{ reset(); fill_init(n, value); }
+
+	template <typename Iter, typename std::enable_if<
+		mystl::is_input_iterator<Iter>::value, int>::type = 0>
+	unrolled_list(Iter first, Iter last)
+	{ reset(); copy_init(first, last); }
+
+	unrolled_list(std::initializer_list<value_type> ilist)
+	{ reset(); copy_init(ilist.begin(), ilist.end()); }
+
+	unrolled_list(const unrolled_list& rhs)
+	{ reset(); copy_init(rhs.begin(), rhs.end()); }
+
+	unrolled_list(unrolled_list&& rhs) noexcept
+	{ reset(); steal(rhs); }
+
+	unrolled_list& operator=(const unrolled_list& rhs) {
+		if (this != &rhs) {
+			unrolled_list tmp(rhs);
+			swap(tmp);
+		}
+		return *this;
+	}
+
+	unrolled_list& operator=(unrolled_list&& rhs) noexcept {
+		if (this != &rhs) {
+			clear();
+			steal(rhs);
+		}
+		return *this;
+	}
+
+	unrolled_list& operator=(std::initializer_list<value_type> ilist) {
+		unrolled_list tmp(ilist);
+		swap(tmp);
+		return *this;
+	}
+
+	~unrolled_list() { clear(); }
+
+public:
+	// 迭代器相关操作
+
+	iterator               begin()         noexcept
+	{ return iterator(head_.next, 0); }
+	const_iterator         begin()   const noexcept
+	{ return const_iterator(head_.next, 0); }
+	iterator               end()           noexcept
+	{ return iterator(header(), 0); }
+	const_iterator         end()     const noexcept
+	{ return const_iterator(header(), 0); }
+
+	reverse_iterator       rbegin()        noexcept
+	{ return reverse_iterator(end()); }
+	const_reverse_iterator rbegin()  const noexcept
+	{ return const_reverse_iterator(end()); }
+	reverse_iterator       rend()          noexcept
+	{ return reverse_iterator(begin()); }
+	const_reverse_iterator rend()    const noexcept
+	{ return const_reverse_iterator(begin()); }
+
+	const_iterator         cbegin()  const noexcept
+	{ return begin(); }
+	const_iterator         cend()    const noexcept
+	{ return end(); }
+	const_reverse_iterator crbegin() const noexcept
+	{ return rbegin(); }
+	const_reverse_iterator crend()   const noexcept
+	{ return rend(); }
+
+	// 容量相关操作
+
+	bool      empty()       const noexcept { return size_ == 0; }
+	size_type size()        const noexcept { return size_; }
+	size_type max_size()    const noexcept { return static_cast<size_type>(-1); }
+	size_type chunk_count() const noexcept { return chunks_; }
+
+	// 访问元素相关操作
+
+	reference       front()
+	{
+		MYSTL_DEBUG(!empty());
+		return *begin();
+	}
+	const_reference front() const
+	{
+		MYSTL_DEBUG(!empty());
+		return *begin();
+	}
+	reference       back()
+	{
+		MYSTL_DEBUG(!empty());
+		return *slot(head_.prev, head_.prev->count - 1);
+	}
+	const_reference back()  const
+	{
+		MYSTL_DEBUG(!empty());
+		return *slot(head_.prev, head_.prev->count - 1);
+	}
+
+	// 插入删除相关操作
+
+	// emplace_front / emplace_back / emplace
+
+	template <typename ...Args>
+	void     emplace_front(Args&& ...args);
+
+	template <typename ...Args>
+	void     emplace_back(Args&& ...args);
+
+	template <typename ...Args>
+	iterator emplace(const_iterator pos, Args&& ...args);
+
+	// push_front / push_back
+
+	void push_front(const value_type& value) { emplace_front(value); }
+	void push_front(value_type&& value)      { emplace_front(mystl::move(value)); }
+
+	void push_back(const value_type& value)  { emplace_back(value); }
+	void push_back(value_type&& value)       { emplace_back(mystl::move(value)); }
+
+	// pop_front / pop_back
+
+	void pop_front()
+	{
+		MYSTL_DEBUG(!empty());
+		erase(begin());
+	}
+	void pop_back();
+
+	// insert
+
+	iterator insert(const_iterator pos, const value_type& value)
+	{ return emplace(pos, value); }
+	iterator insert(const_iterator pos, value_type&& value)
+	{ return emplace(pos, mystl::move(value)); }
+
+	// erase / clear
+
+	iterator erase(const_iterator pos);
+	iterator erase(const_iterator first, const_iterator last);
+
+	void     clear() noexcept;
+
+	// unrolled_list 相关操作
+
+	void splice(const_iterator pos, unrolled_list& other);
+	void splice(const_iterator pos, unrolled_list&& other)
+	{ splice(pos, other); }
+
+	void swap(unrolled_list& rhs) noexcept;
+
+private:
+	// helper functions
+
+	base_ptr header() const noexcept
+	{ return const_cast<base_ptr>(&head_); }
+
+	static pointer slot(base_ptr c, size_type i)
+	{ return static_cast<chunk_ptr>(c)->value_ptr(i); }
+
+	void reset() noexcept {
+		head_.prev = head_.next = header();
+		head_.count = 0;
+		size_ = 0;
+		chunks_ = 0;
+	}
+
+	void steal(unrolled_list& rhs) noexcept;
+
+	// initialize
+	void fill_init(size_type n, const value_type& value);
+	template <typename Iter>
+	void copy_init(Iter first, Iter last);
+
+	// chunk related
+	base_ptr create_chunk();
+	void     destroy_chunk(base_ptr c) noexcept;
+	void     link_chunk(base_ptr pos, base_ptr c) noexcept;
+	void     unlink_chunk(base_ptr c) noexcept;
+	base_ptr split_chunk(base_ptr c, size_type i);
+	iterator rebalance(base_ptr c, size_type i) noexcept;
+
+	static void destroy_slots(pointer first, pointer last) noexcept {
+		for (; first != last; ++first)
+			data_allocator::destroy(first);
+	}
+
+	// 把 [src, src + n) 的元素搬到 dst 处，两个区间可以重叠，原位置上的元素随即被析构
+	static void relocate(pointer dst, pointer src, size_type n) noexcept {
+		relocate_aux(dst, src, n, std::is_trivially_copyable<T>());
+	}
+	static void relocate_aux(pointer dst, pointer src, size_type n, std::true_type) noexcept {
+		if (n != 0)
+			std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(T));
+	}
+	static void relocate_aux(pointer dst, pointer src, size_type n, std::false_type) noexcept {
+		if (dst < src) {
+			for (size_type i = 0; i < n; ++i) {
+				data_allocator::construct(dst + i, mystl::move(src[i]));
+				data_allocator::destroy(src + i);
+			}
+		} else {
+			for (size_type i = n; i > 0; --i) {
+				data_allocator::construct(dst + i - 1, mystl::move(src[i - 1]));
+				data_allocator::destroy(src + i - 1);
+			}
+		}
+	}
+};
+
+/*****************************************************************************************/
+
+// 在头部就地构建元素，首块已满时在前面新建一个块
+template <typename T, size_t N>
+template <typename ...Args>
+void unrolled_list<T, N>::
+emplace_front(Args&& ...args) {
+	THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+	base_ptr c = head_.next;
+	if (c == header() || c->count == chunk_capacity) {
+		c = create_chunk();
+		try {
+			data_allocator::construct(slot(c, 0), mystl::forward<Args>(args)...);
+		} catch (...) {
+			chunk_allocator::deallocate(static_cast<chunk_ptr>(c));
+			throw;
+		}
+		link_chunk(head_.next, c);
+	} else {
+		relocate(slot(c, 1), slot(c, 0), c->count);
+		try {
+			data_allocator::construct(slot(c, 0), mystl::forward<Args>(args)...);
+		} catch (...) {
+			relocate(slot(c, 0), slot(c, 1), c->count);
+			throw;
+		}
+	}
+	++c->count;
+	++size_;
+}
+
+// 在尾部就地构建元素，尾块已满时在后面新建一个块
+template <typename T, size_t N>
+template <typename ...Args>
+void unrolled_list<T, N>::
+emplace_back(Args&& ...args) {
+	THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+	base_ptr c = head_.prev;
+	if (c == header() || c->count == chunk_capacity) {
+		c = create_chunk();
+		try {
+			data_allocator::construct(slot(c, 0), mystl::forward<Args>(args)...);
+		} catch (...) {
+			chunk_allocator::deallocate(static_cast<chunk_ptr>(c));
+			throw;
+		}
+		link_chunk(header(), c);
+	} else {
+		data_allocator::construct(slot(c, c->count), mystl::forward<Args>(args)...);
+	}
+	++c->count;
+	++size_;
+}
+
+// 在 pos 处就地构建元素
+// pos 所在的块已满时，若 pos 位于块首且前一块有空位就追加到前一块的末尾，否则把该块对半分裂
+template <typename T, size_t N>
+template <typename ...Args>
+typename unrolled_list<T, N>::iterator
+unrolled_list<T, N>::
+emplace(const_iterator pos, Args&& ...args) {
+	if (pos.node == header()) {
+		emplace_back(mystl::forward<Args>(args)...);
+		return iterator(head_.prev, head_.prev->count - 1);
+	}
+	THROW_LENGTH_ERROR_IF(size_ > max_size() - 1, "unrolled_list<T>'s size too big");
+	base_ptr c = pos.node;
+	size_type i = pos.pos;
+	if (c->count == chunk_capacity) {
+		if (i == 0 && c->prev != header() && c->prev->count < chunk_capacity) {
+			c = c->prev;
+			i = c->count;
+		} else {
+			base_ptr n = split_chunk(c, chunk_capacity / 2);
+			if (i > c->count) {
+				i -= c->count;
+				c = n;
+			}
+		}
+	}
+	relocate(slot(c, i + 1), slot(c, i), c->count - i);
+	try {
+		data_allocator::construct(slot(c, i), mystl::forward<Args>(args)...);
+	} catch (...) {
+		relocate(slot(c, i), slot(c, i + 1), c->count - i);
+		throw;
+	}
+	++c->count;
+	++size_;
+	return iterator(c, i);
+}
+
+// 删除尾部元素
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+pop_back() {
+	MYSTL_DEBUG(!empty());
+	base_ptr c = head_.prev;
+	data_allocator::destroy(slot(c, --c->count));
+	--size_;
+	if (c->count == 0) {
+		unlink_chunk(c);
+		chunk_allocator::deallocate(static_cast<chunk_ptr>(c));
+	}
+}
+
+// 删除 pos 处的元素
+template <typename T, size_t N>
+typename unrolled_list<T, N>::iterator
+unrolled_list<T, N>::
+erase(const_iterator pos) {
+	MYSTL_DEBUG(pos != cend());
+	base_ptr c = pos.node;
+	const size_type i = pos.pos;
+	data_allocator::destroy(slot(c, i));
+	relocate(slot(c, i), slot(c, i + 1), c->count - i - 1);
+	--c->count;
+	--size_;
+	return rebalance(c, i);
+}
+
+// 删除 [first, last) 内的元素，逐块整段析构并搬移，最后合并边界上过小的块
+template <typename T, size_t N>
+typename unrolled_list<T, N>::iterator
+unrolled_list<T, N>::
+erase(const_iterator first, const_iterator last) {
+	if (first == last)
+		return iterator(last.node, last.pos);
+	size_type n = static_cast<size_type>(mystl::distance(first, last));
+	base_ptr c = first.node;
+	size_type i = first.pos;
+	while (n > 0) {
+		const size_type k = mystl::min(n, c->count - i);
+		destroy_slots(slot(c, i), slot(c, i + k));
+		relocate(slot(c, i), slot(c, i + k), c->count - i - k);
+		c->count -= k;
+		size_ -= k;
+		n -= k;
+		if (c->count == 0) {
+			base_ptr next = c->next;
+			unlink_chunk(c);
+			chunk_allocator::deallocate(static_cast<chunk_ptr>(c));
+			c = next;
+			i = 0;
+		} else if (i == c->count) {
+			c = c->next;
+			i = 0;
+		}
+	}
+	if (i == 0 && c->prev != header())
+		return rebalance(c->prev, c->prev->count);
+	return c == header() ? end() : rebalance(c, i);
+}
+
+// 清空 unrolled_list
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+clear() noexcept {
+	base_ptr c = head_.next;
+	while (c != header()) {
+		base_ptr next = c->next;
+		destroy_chunk(c);
+		c = next;
+	}
+	reset();
+}
+
+// 将 other 的全部块接合于 pos 之前，pos 位于块中间时先在 pos 处分裂该块
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+splice(const_iterator pos, unrolled_list& other) {
+	if (this == &other || other.empty())
+		return;
+	THROW_LENGTH_ERROR_IF(size_ > max_size() - other.size_, "unrolled_list<T>'s size too big");
+	base_ptr at = pos.node;
+	if (pos.pos != 0)
+		at = split_chunk(pos.node, pos.pos);
+	base_ptr first = other.head_.next;
+	base_ptr last = other.head_.prev;
+	first->prev = at->prev;
+	at->prev->next = first;
+	last->next = at;
+	at->prev = last;
+	size_ += other.size_;
+	chunks_ += other.chunks_;
+	other.reset();
+}
+
+// 交换两个 unrolled_list
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+swap(unrolled_list& rhs) noexcept {
+	if (this != &rhs) {
+		unrolled_list tmp(mystl::move(rhs));
+		rhs.steal(*this);
+		steal(tmp);
+	}
+}
+
+// helper function
+
+// 接管 rhs 的全部块，本对象需为空
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+steal(unrolled_list& rhs) noexcept {
+	if (rhs.empty())
+		return;
+	head_.next = rhs.head_.next;
+	head_.prev = rhs.head_.prev;
+	head_.next->prev = header();
+	head_.prev->next = header();
+	size_ = rhs.size_;
+	chunks_ = rhs.chunks_;
+	rhs.reset();
+}
+
+// 用 n 个元素初始化容器
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+fill_init(size_type n, const value_type& value) {
+	try {
+		for (; n > 0; --n)
+			emplace_back(value);
+	} catch (...) {
+		clear();
+		throw;
+	}
+}
+
+// 以 [first, last) 初始化容器，得到的块除最后一块外都是满的
+template <typename T, size_t N>
+template <typename Iter>
+void unrolled_list<T, N>::
+copy_init(Iter first, Iter last) {
+	try {
+		for (; first != last; ++first)
+			emplace_back(*first);
+	} catch (...) {
+		clear();
+		throw;
+	}
+}
+
+// 分配一个空块，不链入链表
+template <typename T, size_t N>
+typename unrolled_list<T, N>::base_ptr
+unrolled_list<T, N>::
+create_chunk() {
+	base_ptr c = chunk_allocator::allocate(1);
+	c->prev = c->next = nullptr;
+	c->count = 0;
+	return c;
+}
+
+// 析构块中的元素并释放块
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+destroy_chunk(base_ptr c) noexcept {
+	destroy_slots(slot(c, 0), slot(c, c->count));
+	chunk_allocator::deallocate(static_cast<chunk_ptr>(c));
+}
+
+// 把块 c 链接在 pos 之前
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+link_chunk(base_ptr pos, base_ptr c) noexcept {
+	c->prev = pos->prev;
+	c->next = pos;
+	pos->prev->next = c;
+	pos->prev = c;
+	++chunks_;
+}
+
+// 把块 c 从链表中断开，不释放
+template <typename T, size_t N>
+void unrolled_list<T, N>::
+unlink_chunk(base_ptr c) noexcept {
+	c->prev->next = c->next;
+	c->next->prev = c->prev;
+	--chunks_;
+}
+
+// 把块 c 中 [i, count) 的元素搬到紧随其后的新块中，返回新块
+template <typename T, size_t N>
+typename unrolled_list<T, N>::base_ptr
+unrolled_list<T, N>::
+split_chunk(base_ptr c, size_type i) {
+	base_ptr n = create_chunk();
+	relocate(slot(n, 0), slot(c, i), c->count - i);
+	n->count = c->count - i;
+	c->count = i;
+	link_chunk(c->next, n);
+	return n;
+}
+
+// 删除元素后整理块 c，返回原先位于 (c, i) 的元素的迭代器
+// 空块直接释放；元素不足容量的 1/4 时，若与后一块或前一块合起来不超过容量的 3/4 就合并为一块
+template <typename T, size_t N>
+typename unrolled_list<T, N>::iterator
+unrolled_list<T, N>::
+rebalance(base_ptr c, size_type i) noexcept {
+	if (c->count == 0) {
+		base_ptr next = c->next;
+		unlink_chunk(c);
+		chunk_allocator::deallocate(static_cast<chunk_ptr>(c));
+		return iterator(next, 0);
+	}
+	if (c->count < chunk_capacity / 4) {
+		const size_type limit = chunk_capacity * 3 / 4;
+		base_ptr n = c->next;
+		base_ptr p = c->prev;
+		if (n != header() && c->count + n->count <= limit) {
+			relocate(slot(c, c->count), slot(n, 0), n->count);
+			c->count += n->count;
+			unlink_chunk(n);
+			chunk_allocator::deallocate(static_cast<chunk_ptr>(n));
+		} else if (p != header() && p->count + c->count <= limit) {
+			relocate(slot(p, p->count), slot(c, 0), c->count);
+			i += p->count;
+			p->count += c->count;
+			unlink_chunk(c);
+			chunk_allocator::deallocate(static_cast<chunk_ptr>(c));
+			c = p;
+		}
+	}
+	return i < c->count ? iterator(c, i) : iterator(c->next, 0);
+}
+
+// 重载比较操作符
+template <typename T, size_t N>
+bool operator==(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs) {
+	return lhs.size() == rhs.size() && mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, size_t N>
+bool operator<(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs) {
+	return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t N>
+bool operator!=(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs) {
+	return !(lhs == rhs);
+}
+
+template <typename T, size_t N>
+bool operator>(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs) {
+	return rhs < lhs;
+}
+
+template <typename T, size_t N>
+bool operator<=(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs) {
+	return !(rhs < lhs);
+}
+
+template <typename T, size_t N>
+bool operator>=(const unrolled_list<T, N>& lhs, const unrolled_list<T, N>& rhs) {
+	return !(lhs < rhs);
+}
+
+// 重载 mystl 的 swap
+template <typename T, size_t N>
+void swap(unrolled_list<T, N>& lhs, unrolled_list<T, N>& rhs) noexcept {
+	lhs.swap(rhs);
+}
+
+} // namespace mystl
+#endif // !MYSTL_UNROLLED_LIST_H_
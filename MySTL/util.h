@@ -1,7 +1,7 @@
 ﻿#ifndef MYSTL_UTIL_H_
 #define MYSTL_UTIL_H_
 
-// 这个文件包含一些通用工具，包括 move, forward, swap 等函数，以及 pair 等 
+// 这个文件包含一些通用工具，包括 move, forward, swap 等函数，以及 pair、sorted_unique 等 
 
 #include <cstddef>
 
@@ -291,6 +291,13 @@ pair<Ty1, Ty2> make_pair(Ty1&& first, Ty2&& second)
   return pair<Ty1, Ty2>(mystl::forward<Ty1>(first), mystl::forward<Ty2>(second));
 }
 
+// --------------------------------------------------------------------------------------
+// sorted_unique
+// 标签类型，表示传入的区间已按键值严格升序排列、没有重复的键值，有序容器可以据此线性构建
+
+struct sorted_unique_t { explicit sorted_unique_t() = default; };
+static constexpr sorted_unique_t sorted_unique{};
+
 }
 
 #endif // !MYSTL_UTIL_H_
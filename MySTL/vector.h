@@ -16,8 +16,17 @@
 //   * reserve
 //   * resize
 //   * insert
+//
+// 重新分配空间时，满足 is_trivially_relocatable 的元素按字节整体搬到新空间，其余元素逐个移动构造
+//
+// 扩容策略由模板参数 GrowthPolicy 指定，默认 1.5 倍，另有 2 倍、按页取整、按 jemalloc size class 取整。
+// 使用默认空间配置器时，满足 is_trivially_relocatable 的元素用 malloc 分配空间，旧空间不小于 GrowthPolicy::realloc_bytes() 字节时，
+// reserve、尾部插入、shrink_to_fit 改用 realloc 原地调整，大块内存上 glibc 用 mremap 重新映射页而不复制数据。
+// 阈值属于 vector 的类型，空间由 malloc 还是空间配置器提供不会因编译单元而不同
 
+#include <cstdlib>
 #include <initializer_list>
+#include <new>
 
 #include "iterator.h"
 #include "memory.h"
@@ -37,16 +46,104 @@ namespace mystl
 #undef min
 #endif // min
 
+// vector 的扩容策略，由当前容量 old_cap 和至少要增加的元素个数 add_size 计算新的容量
+// small_vector 溢出到堆上之后使用相同的策略
+inline size_t vector_grow_cap(size_t old_cap, size_t add_size, size_t max_size) {
+	THROW_LENGTH_ERROR_IF(old_cap > max_size - add_size,		// old_cap + add_size > max_size报错
+		"vector<T>'s size too big");
+	if (old_cap > max_size - old_cap / 2) {	// old_cap超过max_size一半时
+		return old_cap + add_size > max_size - 16
+			? old_cap + add_size : old_cap + add_size + 16;
+	}
+	const size_t new_cap = old_cap == 0
+		? mystl::max(add_size, static_cast<size_t>(16))		// old_cap为0,则加add_size和16的大值
+		: mystl::max(old_cap + old_cap / 2, old_cap + add_size);		// old_cap不为0,则加3/2old_cap和old_cap+add_size的大值
+	return new_cap;
+}
+
+// vector 的扩容策略
+// 策略类提供静态函数 new_cap(old_cap, add_size, max_size, elem_size)，返回不小于 old_cap + add_size 的新容量，
+// 以元素个数计，elem_size 为单个元素的字节数；
+// 以及静态函数 realloc_bytes()，元素可按字节搬移且旧空间不小于该字节数时用 realloc 调整空间，为 0 时不用 realloc
+
+// 内置扩容策略的 realloc 阈值
+static constexpr size_t kVectorReallocBytes = 128 * 1024;
+
+// 把 cap 个元素占用的字节数按 round 向上取整后换回元素个数，round(bytes) 不小于 bytes
+template <typename Round>
+size_t vector_round_cap(size_t cap, size_t max_size, size_t elem_size, Round round) {
+	const size_t bytes = cap * elem_size;
+	if (bytes > static_cast<size_t>(-1) / 2)	// 取整可能溢出，不再取整
+		return cap;
+	return mystl::min(round(bytes) / elem_size, max_size);
+}
+
+// 1.5 倍增长，首次分配至少 16 个元素，vector 的默认策略
+struct vector_growth_half {
+	static constexpr size_t realloc_bytes() { return kVectorReallocBytes; }
+	static size_t new_cap(size_t old_cap, size_t add_size, size_t max_size, size_t) {
+		return vector_grow_cap(old_cap, add_size, max_size);
+	}
+};
+
+// 2 倍增长，首次分配至少 16 个元素，扩容次数更少，但平均多占用一些空间
+struct vector_growth_double {
+	static constexpr size_t realloc_bytes() { return kVectorReallocBytes; }
+	static size_t new_cap(size_t old_cap, size_t add_size, size_t max_size, size_t) {
+		THROW_LENGTH_ERROR_IF(old_cap > max_size - add_size, "vector<T>'s size too big");
+		if (old_cap == 0)
+			return mystl::max(add_size, static_cast<size_t>(16));
+		if (old_cap > max_size - old_cap)
+			return old_cap + add_size;
+		return mystl::max(old_cap * 2, old_cap + add_size);
+	}
+};
+
+// 1.5 倍增长后把字节数向上取整到整页(4KB)，大块内存按页映射，取整出来的尾部本来就已分配
+struct vector_growth_page {
+	static constexpr size_t realloc_bytes() { return kVectorReallocBytes; }
+	static size_t new_cap(size_t old_cap, size_t add_size, size_t max_size, size_t elem_size) {
+		return vector_round_cap(vector_grow_cap(old_cap, add_size, max_size), max_size, elem_size,
+			[](size_t bytes) { return (bytes + 4095) & ~static_cast<size_t>(4095); });
+	}
+};
+
+// 1.5 倍增长后把字节数向上取整到 jemalloc 的 size class，避免申请的大小落在两档之间被分配器悄悄补齐：
+// 128 字节以内按 16 字节取整，之后每个 (2^k, 2^(k+1)] 区间等分为 4 档
+struct vector_growth_size_class {
+	static constexpr size_t realloc_bytes() { return kVectorReallocBytes; }
+	static size_t size_class(size_t bytes) {
+		if (bytes <= 128)
+			return (bytes + 15) & ~static_cast<size_t>(15);
+		size_t group = 128;	// 2^k < bytes <= 2^(k+1)
+		while (group * 2 < bytes)
+			group *= 2;
+		const size_t delta = group / 4;
+		return (bytes + delta - 1) & ~(delta - 1);
+	}
+	static size_t new_cap(size_t old_cap, size_t add_size, size_t max_size, size_t elem_size) {
+		return vector_round_cap(vector_grow_cap(old_cap, add_size, max_size), max_size, elem_size,
+			size_class);
+	}
+};
+
+// 沿用 Policy 的扩容方式，把 realloc 阈值改为 Bytes 字节，为 0 时不用 realloc，
+// 例如 vector<int, vector_realloc_at<vector_growth_half, 0>>
+template <typename Policy, size_t Bytes>
+struct vector_realloc_at : Policy {
+	static constexpr size_t realloc_bytes() { return Bytes; }
+};
+
 // 模板类: vector 
-// 模板参数 T 代表类型
-template <typename T>
+// 模板参数 T 代表类型，GrowthPolicy 代表扩容策略，Alloc 代表空间配置器(静态接口，同 mystl::allocator)
+template <typename T, typename GrowthPolicy = vector_growth_half, typename Alloc = mystl::allocator<T>>
 class vector{
 	// 不支持vector<bool>
 	static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in mystl");
 public:
 	// vector 的嵌套型别定义
-	typedef mystl::allocator<T>                      allocator_type;
-	typedef mystl::allocator<T>                      data_allocator;
+	typedef Alloc                                    allocator_type;
+	typedef Alloc                                    data_allocator;
 
 	typedef typename allocator_type::value_type      value_type;
 	typedef typename allocator_type::pointer         pointer;
@@ -65,6 +162,11 @@ public:
 	allocator_type get_allocator() { return data_allocator(); }
 
 private:
+	// 是否用 malloc / realloc 管理空间，指定了其他空间配置器时不用
+	static constexpr bool use_realloc = GrowthPolicy::realloc_bytes() != 0 &&
+		std::is_same<Alloc, mystl::allocator<T>>::value &&
+		is_trivially_relocatable<T>::value && alignof(T) <= alignof(std::max_align_t);
+
 	// 三个指针
 	iterator begin_;  // 表示目前使用空间的头部
 	iterator end_;    // 表示目前使用空间的尾部
@@ -289,6 +391,14 @@ public:
 	}
 	void resize(size_type new_size, const value_type& value);
 
+	// 新增的元素只做默认初始化，int 等平凡类型不写入任何值，适合随后整体覆盖的缓冲区
+	void resize_default_init(size_type new_size);
+
+	// 容量扩到至少 n 后调用 op(data(), n)，op 写入前 r 个元素并返回 r(r <= n)，之后 size() == r
+	// 只用于平凡类型，[size(), n) 上的元素在 op 写入之前是不确定的
+	template <typename Operation>
+	void resize_and_overwrite(size_type n, Operation op);
+
 	void reverse() { 
 		mystl::reverse(begin(), end());
 	}
@@ -310,6 +420,23 @@ private:
 
 	void destroy_and_recover(iterator first, iterator last, size_type n);
 
+	// buffer
+
+	static pointer allocate_buffer(size_type n);
+	static void deallocate_buffer(pointer p, size_type n);
+	// realloc 路径按 use_realloc 在编译期选择，不满足条件的类型不会实例化 realloc_buffer
+	typedef std::integral_constant<bool, use_realloc> realloc_tag;
+	bool can_realloc() const noexcept {
+		return capacity() * sizeof(T) >= GrowthPolicy::realloc_bytes();
+	}
+	void realloc_buffer(size_type new_cap);
+	bool try_realloc(size_type new_cap, std::true_type);
+	bool try_realloc(size_type, std::false_type) noexcept { return false; }
+	template <typename ...Args>
+	bool try_realloc_emplace_back(size_type new_cap, std::true_type, Args&& ...args);
+	template <typename ...Args>
+	bool try_realloc_emplace_back(size_type, std::false_type, Args&& ...) { return false; }
+
 	// calculate the growth size
 	size_type get_new_cap(size_type add_size);
 
@@ -325,6 +452,7 @@ private:
 
 	// reallocate
 
+	void relocate_to(iterator new_begin, iterator pos, size_type gap);
 	template <typename... Args>
 	void reallocate_emplace(iterator pos, Args&& ...args);
 	void reallocate_insert(iterator pos, const value_type& value);
@@ -343,8 +471,8 @@ private:
 /*****************************************************************************************/
 
 // 复制赋值操作符
-template <typename T>
-vector<T>& vector<T>::operator=(const vector& rhs) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+vector<T, GrowthPolicy, Alloc>& vector<T, GrowthPolicy, Alloc>::operator=(const vector& rhs) {
 	if (this != &rhs) {	// 自赋值检查
 		const auto len = rhs.size();
 		if (len > capacity()) { // 大于capacity直接新建一个vector然后交换
@@ -357,15 +485,15 @@ vector<T>& vector<T>::operator=(const vector& rhs) {
 		}else { // rhs长度大于size=>拷贝前面部分,插入后面部分	
 			mystl::copy(rhs.begin(), rhs.begin() + size(), begin_);	//拷贝前面部分
 			mystl::uninitialized_copy(rhs.begin() + size(), rhs.end(), end_);	// 插入后面部分
-			cap_ = end_ = begin_ + len;	// 更新end_,cap_
+			end_ = begin_ + len;	// 只更新end_，容量不变，释放时仍按申请时的大小归还
 		}
 	}
 	return *this;
 }
 
 // 移动赋值操作符
-template <typename T>
-vector<T>& vector<T>::operator=(vector&& rhs) noexcept {
+template <typename T, typename GrowthPolicy, typename Alloc>
+vector<T, GrowthPolicy, Alloc>& vector<T, GrowthPolicy, Alloc>::operator=(vector&& rhs) noexcept {
 	destroy_and_recover(begin_, end_, cap_ - begin_);	// 销毁原vector
 	// 后面直接拷贝rhs的
 	begin_ = rhs.begin_;
@@ -378,15 +506,22 @@ vector<T>& vector<T>::operator=(vector&& rhs) noexcept {
 }
 
 // 预留空间大小，当原容量小于要求大小时，才会重新分配
-template <typename T>
-void vector<T>::reserve(size_type n) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::reserve(size_type n) {
 	if (capacity() < n) {// 容量小于n时
 		// THROW_LENGTH_ERROR_IF(n > max_size(),	// max_size的最大值,n是uint类型=>是uint这种情况应该是不会出现的
 		// 	"n can not larger than max_size() in vector<T>::reserve(n)");
+		if (try_realloc(n, realloc_tag()))	// 大块空间原地增长
+			return;
 		const auto old_size = size();
-		auto tmp = data_allocator::allocate(n);	// 申请新空间
-		mystl::uninitialized_move(begin_, end_, tmp);	// 拷贝到新空间
-		data_allocator::deallocate(begin_, cap_ - begin_);	// 销毁旧空间
+		auto tmp = allocate_buffer(n);	// 申请新空间
+		try {
+			relocate_to(tmp, end_, 0);	// 搬到新空间
+		}catch (...) {
+			deallocate_buffer(tmp, n);
+			throw;
+		}
+		deallocate_buffer(begin_, cap_ - begin_);	// 释放旧空间
 		begin_ = tmp;
 		end_ = tmp + old_size;
 		cap_ = begin_ + n;
@@ -394,18 +529,18 @@ void vector<T>::reserve(size_type n) {
 }
 
 // 放弃多余的容量
-template <typename T>
-void vector<T>::shrink_to_fit() {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::shrink_to_fit() {
 	if (end_ < cap_) {
 	    reinsert(size());
 	}
 }
 
 // 在 pos 位置就地构造元素，避免额外的复制或移动开销
-template <typename T>
+template <typename T, typename GrowthPolicy, typename Alloc>
 template <typename ...Args>
-typename vector<T>::iterator
-vector<T>::emplace(const_iterator pos, Args&& ...args) {
+typename vector<T, GrowthPolicy, Alloc>::iterator
+vector<T, GrowthPolicy, Alloc>::emplace(const_iterator pos, Args&& ...args) {
 	MYSTL_DEBUG(pos >= begin() && pos <= end());
 	iterator xpos = const_cast<iterator>(pos);	// 去const
 	const size_type n = xpos - begin_;	// pos与begin_的距离
@@ -418,6 +553,7 @@ vector<T>::emplace(const_iterator pos, Args&& ...args) {
 		++ new_end;
 		mystl::copy_backward(xpos, end_ - 1, end_);
 		*xpos = value_type(mystl::forward<Args>(args)...);
+		end_ = new_end;
 	}else {	// 没有容量  == > 重新构造vector且在xpos处构造元素
 		reallocate_emplace(xpos, mystl::forward<Args>(args)...);
 	}
@@ -426,9 +562,9 @@ vector<T>::emplace(const_iterator pos, Args&& ...args) {
 }
 
 // 在尾部就地构造元素，避免额外的复制或移动开销
-template <typename T>
+template <typename T, typename GrowthPolicy, typename Alloc>
 template <typename ...Args>
-void vector<T>::emplace_back(Args&& ...args) {
+void vector<T, GrowthPolicy, Alloc>::emplace_back(Args&& ...args) {
 	if (end_ < cap_) {	// 容量未满
 		data_allocator::construct(mystl::address_of(*end_), mystl::forward<Args>(args)...);
 		++ end_;
@@ -438,8 +574,8 @@ void vector<T>::emplace_back(Args&& ...args) {
 }
 
 // 在尾部插入元素
-template <typename T>
-void vector<T>::push_back(const value_type& value) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::push_back(const value_type& value) {
 	if (end_ != cap_) {
 		data_allocator::construct(mystl::address_of(*end_), value);
 		++ end_;
@@ -449,17 +585,17 @@ void vector<T>::push_back(const value_type& value) {
 }
 
 // 弹出尾部元素
-template <typename T>
-void vector<T>::pop_back() {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::pop_back() {
 	MYSTL_DEBUG(!empty());	// 非空断言
 	data_allocator::destroy(end_ - 1);	// 销毁最后一个元素
 	-- end_;
 }
 
 // 在 pos 处插入元素
-template <typename T>
-typename vector<T>::iterator
-vector<T>::insert(const_iterator pos, const value_type& value) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+typename vector<T, GrowthPolicy, Alloc>::iterator
+vector<T, GrowthPolicy, Alloc>::insert(const_iterator pos, const value_type& value) {
 	MYSTL_DEBUG(pos >= begin() && pos <= end());
 	iterator xpos = const_cast<iterator>(pos);
 	const size_type n = pos - begin_;
@@ -481,9 +617,9 @@ vector<T>::insert(const_iterator pos, const value_type& value) {
 }
 
 // 删除 pos 位置上的元素
-template <typename T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator pos) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+typename vector<T, GrowthPolicy, Alloc>::iterator
+vector<T, GrowthPolicy, Alloc>::erase(const_iterator pos) {
 	MYSTL_DEBUG(pos >= begin() && pos < end());
 	iterator xpos = begin_ + (pos - begin());
 	mystl::move(xpos + 1, end_, xpos);
@@ -493,20 +629,22 @@ vector<T>::erase(const_iterator pos) {
 }
 
 // 删除[first, last)上的元素
-template <typename T>
-typename vector<T>::iterator
-vector<T>::erase(const_iterator first, const_iterator last) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+typename vector<T, GrowthPolicy, Alloc>::iterator
+vector<T, GrowthPolicy, Alloc>::erase(const_iterator first, const_iterator last) {
 	MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
 	const auto n = first - begin();
 	iterator r = begin_ + (first - begin());
+	if (first == last)
+		return r;  // 避免元素自移动赋值
 	data_allocator::destroy(mystl::move(r + (last - first), end_, r), end_);
 	end_ = end_ - (last - first);
 	return begin_ + n;
 }
 
 // 重置容器大小
-template <typename T>
-void vector<T>::resize(size_type new_size, const value_type& value) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::resize(size_type new_size, const value_type& value) {
 	if (new_size < size()) {
 		erase(begin() + new_size, end());
 	}else {
@@ -514,9 +652,33 @@ void vector<T>::resize(size_type new_size, const value_type& value) {
 	}
 }
 
+// 重置容器大小，新增元素默认初始化
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::resize_default_init(size_type new_size) {
+	if (new_size < size()) {
+		erase(begin() + new_size, end());
+	}else {
+		if (new_size > capacity())
+			reserve(get_new_cap(new_size - size()));
+		end_ = mystl::uninitialized_default_construct_n(end_, new_size - size());
+	}
+}
+
+// 由 op 直接写入元素并决定新的大小
+template <typename T, typename GrowthPolicy, typename Alloc>
+template <typename Operation>
+void vector<T, GrowthPolicy, Alloc>::resize_and_overwrite(size_type n, Operation op) {
+	static_assert(std::is_trivial<T>::value, "vector<T>::resize_and_overwrite requires a trivial T");
+	if (n > capacity())
+		reserve(get_new_cap(n - size()));
+	const auto r = static_cast<size_type>(op(begin_, n));
+	MYSTL_DEBUG(r <= n);
+	end_ = begin_ + r;
+}
+
 // 与另一个 vector 交换
-template <typename T>
-void vector<T>::swap(vector<T>& rhs) noexcept {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::swap(vector<T, GrowthPolicy, Alloc>& rhs) noexcept {
 	if (this != &rhs) {
 		mystl::swap(begin_, rhs.begin_);
 		mystl::swap(end_, rhs.end_);
@@ -528,10 +690,10 @@ void vector<T>::swap(vector<T>& rhs) noexcept {
 // helper function
 
 // try_init 函数，若分配失败则忽略，不抛出异常
-template <typename T>
-void vector<T>::try_init() noexcept {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::try_init() noexcept {
 	try {
-		begin_ = data_allocator::allocate(16);
+		begin_ = allocate_buffer(16);
 		end_ = begin_;
 		cap_ = begin_ + 16;
 	}catch (...) {
@@ -542,10 +704,10 @@ void vector<T>::try_init() noexcept {
 }
 
 // init_space 函数 申请cap单位空间并初始化size单位
-template <typename T>
-void vector<T>::init_space(size_type size, size_type cap) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::init_space(size_type size, size_type cap) {
 	try{
-		begin_ = data_allocator::allocate(cap);
+		begin_ = allocate_buffer(cap);
 		end_ = begin_ + size;
 		cap_ = begin_ + cap;
 	}catch(...) {
@@ -557,50 +719,98 @@ void vector<T>::init_space(size_type size, size_type cap) {
 }
 
 // fill_init 函数
-template <typename T>
-void vector<T>::fill_init(size_type n, const value_type& value) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::fill_init(size_type n, const value_type& value) {
 	const size_type init_size = mystl::max(static_cast<size_type>(16), n);	// 最小初始化16个单位
 	init_space(n, init_size);	// 申请一块init_size的空间并初始化n个单位
 	mystl::uninitialized_fill_n(begin_, n, value);	// 从begin_起初始化n个数为value
 }
 
 // range_init 函数
-template <typename T>
+template <typename T, typename GrowthPolicy, typename Alloc>
 template <typename Iter>
-void vector<T>::range_init(Iter first, Iter last) {
+void vector<T, GrowthPolicy, Alloc>::range_init(Iter first, Iter last) {
 	const size_type init_size = mystl::max(static_cast<size_type>(last - first),
 		static_cast<size_type>(16));	// 最小初始化16个单位
 	init_space(static_cast<size_type>(last - first), init_size);
 	mystl::uninitialized_copy(first, last, begin_);
 }
 
+// allocate_buffer 函数 元素可按字节搬移时用 malloc 申请，以便之后用 realloc 调整
+template <typename T, typename GrowthPolicy, typename Alloc>
+typename vector<T, GrowthPolicy, Alloc>::pointer
+vector<T, GrowthPolicy, Alloc>::allocate_buffer(size_type n) {
+	if (!use_realloc)
+		return data_allocator::allocate(n);
+	if (n == 0)
+		return nullptr;
+	auto p = std::malloc(n * sizeof(T));
+	if (p == nullptr)
+		throw std::bad_alloc();
+	return static_cast<pointer>(p);
+}
+
+// deallocate_buffer 函数 与 allocate_buffer 配对
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::deallocate_buffer(pointer p, size_type n) {
+	if (use_realloc)
+		std::free(p);
+	else
+		data_allocator::deallocate(p, n);
+}
+
+// realloc_buffer 函数 把空间调整为 new_cap 个元素，元素随空间按字节搬移，调用者保证 can_realloc() 且 new_cap >= size()
+// 只在 use_realloc 为真时实例化，元素可按字节搬移，转为 void* 传给 realloc
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::realloc_buffer(size_type new_cap) {
+	const size_type old_size = size();
+	auto p = std::realloc(static_cast<void*>(begin_), new_cap * sizeof(T));
+	if (p == nullptr)	// 失败时原空间保持不变
+		throw std::bad_alloc();
+	begin_ = static_cast<pointer>(p);
+	end_ = begin_ + old_size;
+	cap_ = begin_ + new_cap;
+}
+
+// try_realloc 函数 空间够大时用 realloc 调整为 new_cap 个元素，返回是否已调整
+template <typename T, typename GrowthPolicy, typename Alloc>
+bool vector<T, GrowthPolicy, Alloc>::try_realloc(size_type new_cap, std::true_type) {
+	if (!can_realloc())
+		return false;
+	realloc_buffer(new_cap);
+	return true;
+}
+
+// try_realloc_emplace_back 函数 空间够大时用 realloc 增长为 new_cap 个元素并在尾部构造元素，返回是否已完成
+template <typename T, typename GrowthPolicy, typename Alloc>
+template <typename ...Args>
+bool vector<T, GrowthPolicy, Alloc>::try_realloc_emplace_back(size_type new_cap, std::true_type, Args&& ...args) {
+	if (!can_realloc())
+		return false;
+	value_type tmp(mystl::forward<Args>(args)...);	// 参数可能引用容器中的元素，先于 realloc 构造
+	realloc_buffer(new_cap);
+	data_allocator::construct(mystl::address_of(*end_), mystl::move(tmp));
+	++ end_;
+	return true;
+}
+
 // destroy_and_recover 函数 一般n会大于(last - first),deallocate的大小大于destroy的大小
-template <typename T>
-void vector<T>::destroy_and_recover(iterator first, iterator last, size_type n) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::destroy_and_recover(iterator first, iterator last, size_type n) {
 	data_allocator::destroy(first, last);
-	data_allocator::deallocate(first, n);
+	deallocate_buffer(first, n);
 }
 
 // get_new_cap 函数
-template <typename T>
-typename vector<T>::size_type 
-vector<T>::get_new_cap(size_type add_size) {
-	const auto old_size = capacity();
-	THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size,		// old_size + new_size > max_size报错
-		"vector<T>'s size too big");
-	if (old_size > max_size() - old_size / 2) {	// old_size超过max_size一半时
-		return old_size + add_size > max_size() - 16
-			? old_size + add_size : old_size + add_size + 16;
-	}
-	const size_type new_size = old_size == 0
-		? mystl::max(add_size, static_cast<size_type>(16))		// old_size为0,则加add_size和16的大值
-		: mystl::max(old_size + old_size / 2, old_size + add_size);		// old_size不为0,则加3/2old_size和old_size+add_size的大值
-	return new_size;
+template <typename T, typename GrowthPolicy, typename Alloc>
+typename vector<T, GrowthPolicy, Alloc>::size_type 
+vector<T, GrowthPolicy, Alloc>::get_new_cap(size_type add_size) {
+	return GrowthPolicy::new_cap(capacity(), add_size, max_size(), sizeof(T));
 }
 
 // fill_assign 函数
-template <typename T>
-void vector<T>::fill_assign(size_type n, const value_type& value) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::fill_assign(size_type n, const value_type& value) {
 	if (n > capacity()) {
 		vector tmp(n, value);
 		swap(tmp);
@@ -613,9 +823,9 @@ void vector<T>::fill_assign(size_type n, const value_type& value) {
 }
 
 // copy_assign 函数
-template <typename T>
+template <typename T, typename GrowthPolicy, typename Alloc>
 template <typename IIter>
-void vector<T>::copy_assign(IIter first, IIter last, input_iterator_tag) {
+void vector<T, GrowthPolicy, Alloc>::copy_assign(IIter first, IIter last, input_iterator_tag) {
 	auto cur = begin_;
 	for (; first != last && cur != end_; ++first, ++cur) {
 		*cur = *first;
@@ -628,9 +838,9 @@ void vector<T>::copy_assign(IIter first, IIter last, input_iterator_tag) {
 }
 
 // 用 [first, last) 为容器赋值 无法随机读取版本
-template <typename T>
+template <typename T, typename GrowthPolicy, typename Alloc>
 template <typename FIter>
-void vector<T>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
+void vector<T, GrowthPolicy, Alloc>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
 	const size_type len = mystl::distance(first, last);
 	if (len > capacity()) {
 		vector tmp(first, last);
@@ -648,55 +858,67 @@ void vector<T>::copy_assign(FIter first, FIter last, forward_iterator_tag) {
 	}
 }
 
+// relocate_to 函数 把[begin_, pos)和[pos, end_)上的元素搬到 new_begin 开始的新空间，两段之间空出 gap 个位置
+// 元素可按字节搬移(is_trivially_relocatable)时直接复制内存，否则逐个移动构造，全部成功后才析构旧元素
+// 旧空间由调用者释放
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::relocate_to(iterator new_begin, iterator pos, size_type gap) {
+	if (is_trivially_relocatable<T>::value) {
+		auto mid = mystl::uninitialized_relocate(begin_, pos, new_begin);
+		mystl::uninitialized_relocate(pos, end_, mid + gap);
+	}else {
+		auto mid = mystl::uninitialized_move(begin_, pos, new_begin);
+		try {
+			mystl::uninitialized_move(pos, end_, mid + gap);
+		}catch (...) {
+			data_allocator::destroy(new_begin, mid);
+			throw;
+		}
+		data_allocator::destroy(begin_, end_);
+	}
+}
+
 // 重新分配空间并在 pos 处就地构造元素
-template <typename T>
+template <typename T, typename GrowthPolicy, typename Alloc>
 template <typename ...Args>
-void vector<T>::reallocate_emplace(iterator pos, Args&& ...args) {
+void vector<T, GrowthPolicy, Alloc>::reallocate_emplace(iterator pos, Args&& ...args) {
 	const auto new_size = get_new_cap(1);	// 申请一块加长(+1)的空间(实际上加的可能不止1)
-	auto new_begin = data_allocator::allocate(new_size);	// 申请一块新的new_size的空间
-	auto new_end = new_begin;	
+	// 尾部插入且空间够大，原地增长
+	if (pos == end_ && try_realloc_emplace_back(new_size, realloc_tag(), mystl::forward<Args>(args)...))
+		return;
+	auto new_begin = allocate_buffer(new_size);	// 申请一块新的new_size的空间
+	const size_type xpos = pos - begin_;
+	const size_type old_size = size();
 	try {
-		new_end = mystl::uninitialized_move(begin_, pos, new_begin);	// pos 前面部分元素的复制
-		data_allocator::construct(mystl::address_of(*new_end), mystl::forward<Args>(args)...);	// pos位置元素的构造
-		++ new_end;	// new_end后移 
-		new_end = mystl::uninitialized_move(pos, end_, new_end);	// pos后面部分元素的复制
+		// 先构造新元素，参数可能引用容器中的元素
+		data_allocator::construct(mystl::address_of(*(new_begin + xpos)), mystl::forward<Args>(args)...);
 	}catch (...) {
-		data_allocator::deallocate(new_begin, new_size);	// 
+		deallocate_buffer(new_begin, new_size);
 		throw;
 	}
-	destroy_and_recover(begin_, end_, cap_ - begin_);	// 销毁原对象
-	// 拷贝到原对象
-	begin_ = new_begin;
-	end_ = new_end;
-	cap_ = new_begin + new_size;
-}
-
-// 重新分配空间并在 pos 处插入元素 和reallocate_emplace几乎一样(除了构造pos元素部分)
-template <typename T>
-void vector<T>::reallocate_insert(iterator pos, const value_type& value) {
-	const auto new_size = get_new_cap(1);
-	auto new_begin = data_allocator::allocate(new_size);
-	auto new_end = new_begin;
-	const value_type& value_copy = value;
 	try {
-		new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-		data_allocator::construct(mystl::address_of(*new_end), value_copy);
-		++new_end;
-		new_end = mystl::uninitialized_move(pos, end_, new_end);
+		relocate_to(new_begin, pos, 1);	// pos 前后两部分元素搬到新空间
 	}catch (...) {
-		data_allocator::deallocate(new_begin, new_size);
+		data_allocator::destroy(new_begin + xpos);
+		deallocate_buffer(new_begin, new_size);
 		throw;
 	}
-	destroy_and_recover(begin_, end_, cap_ - begin_);
+	deallocate_buffer(begin_, cap_ - begin_);	// 释放旧空间
 	begin_ = new_begin;
-	end_ = new_end;
+	end_ = new_begin + old_size + 1;
 	cap_ = new_begin + new_size;
 }
 
+// 重新分配空间并在 pos 处插入元素
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::reallocate_insert(iterator pos, const value_type& value) {
+	reallocate_emplace(pos, value);
+}
+
 // fill_insert 函数
-template <typename T>
-typename vector<T>::iterator 
-vector<T>::fill_insert(iterator pos, size_type n, const value_type& value) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+typename vector<T, GrowthPolicy, Alloc>::iterator 
+vector<T, GrowthPolicy, Alloc>::fill_insert(iterator pos, size_type n, const value_type& value) {
 	if (n == 0)
 		return pos;
 	const size_type xpos = pos - begin_;
@@ -716,28 +938,33 @@ vector<T>::fill_insert(iterator pos, size_type n, const value_type& value) {
 		}
 	}else { // 如果备用空间不足
 		const auto new_size = get_new_cap(n);
-		auto new_begin = data_allocator::allocate(new_size);
-		auto new_end = new_begin;
+		auto new_begin = allocate_buffer(new_size);
+		const size_type old_size = size();
 		try {
-			new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-			new_end = mystl::uninitialized_fill_n(new_end, n, value);
-			new_end = mystl::uninitialized_move(pos, end_, new_end);
+			mystl::uninitialized_fill_n(new_begin + xpos, n, value_copy);
 		}catch (...) {
-			destroy_and_recover(new_begin, new_end, new_size);
+			deallocate_buffer(new_begin, new_size);
 			throw;
 		}
-		data_allocator::deallocate(begin_, cap_ - begin_);
+		try {
+			relocate_to(new_begin, pos, n);
+		}catch (...) {
+			data_allocator::destroy(new_begin + xpos, new_begin + xpos + n);
+			deallocate_buffer(new_begin, new_size);
+			throw;
+		}
+		deallocate_buffer(begin_, cap_ - begin_);
 		begin_ = new_begin;
-		end_ = new_end;
+		end_ = new_begin + old_size + n;
 		cap_ = begin_ + new_size;
 	}
 	return begin_ + xpos;
 }
 
 // copy_insert 函数
-template <typename T>
+template <typename T, typename GrowthPolicy, typename Alloc>
 template <typename IIter>
-void vector<T>::copy_insert(iterator pos, IIter first, IIter last) {
+void vector<T, GrowthPolicy, Alloc>::copy_insert(iterator pos, IIter first, IIter last) {
 	if (first == last)
 		return;
 	const auto n = mystl::distance(first, last);
@@ -757,34 +984,42 @@ void vector<T>::copy_insert(iterator pos, IIter first, IIter last) {
 		}
 	}else { // 备用空间不足
 		const auto new_size = get_new_cap(n);
-		auto new_begin = data_allocator::allocate(new_size);
-		auto new_end = new_begin;
+		auto new_begin = allocate_buffer(new_size);
+		const auto xpos = pos - begin_;
+		const size_type old_size = size();
+		try{
+			mystl::uninitialized_copy(first, last, new_begin + xpos);
+		}catch (...) {
+			deallocate_buffer(new_begin, new_size);
+			throw;
+		}
 		try{
-			new_end = mystl::uninitialized_move(begin_, pos, new_begin);
-			new_end = mystl::uninitialized_copy(first, last, new_end);
-			new_end = mystl::uninitialized_move(pos, end_, new_end);
+			relocate_to(new_begin, pos, n);
 		}catch (...) {
-			destroy_and_recover(new_begin, new_end, new_size);
+			data_allocator::destroy(new_begin + xpos, new_begin + xpos + n);
+			deallocate_buffer(new_begin, new_size);
 			throw;
 		}
-		data_allocator::deallocate(begin_, cap_ - begin_);
+		deallocate_buffer(begin_, cap_ - begin_);
 		begin_ = new_begin;
-		end_ = new_end;
+		end_ = new_begin + old_size + n;
 		cap_ = begin_ + new_size;
 	}
 }
 
 // reinsert 函数
-template <typename T>
-void vector<T>::reinsert(size_type size) {
-	auto new_begin = data_allocator::allocate(size);	// 申请一块新的空间
+template <typename T, typename GrowthPolicy, typename Alloc>
+void vector<T, GrowthPolicy, Alloc>::reinsert(size_type size) {
+	if (size != 0 && try_realloc(size, realloc_tag()))
+		return;
+	auto new_begin = allocate_buffer(size);	// 申请一块新的空间
 	try {
-		mystl::uninitialized_move(begin_, end_, new_begin);	// 拷贝到新空间
+		relocate_to(new_begin, end_, 0);	// 搬到新空间
 	}catch (...) {
-		data_allocator::deallocate(new_begin, size);	// 
+		deallocate_buffer(new_begin, size);	// 
 		throw;
 	}
-	data_allocator::deallocate(begin_, cap_ - begin_);	// 销毁旧空间
+	deallocate_buffer(begin_, cap_ - begin_);	// 释放旧空间
 	// 三个指针指向新空间
 	begin_ = new_begin;
 	end_ = begin_ + size;
@@ -794,43 +1029,47 @@ void vector<T>::reinsert(size_type size) {
 /*****************************************************************************************/
 // 重载比较操作符
 
-template <typename T>
-bool operator==(const vector<T>& lhs, const vector<T>& rhs) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+bool operator==(const vector<T, GrowthPolicy, Alloc>& lhs, const vector<T, GrowthPolicy, Alloc>& rhs) {
 	return lhs.size() == rhs.size() &&
     	mystl::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template <typename T>
-bool operator<(const vector<T>& lhs, const vector<T>& rhs) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+bool operator<(const vector<T, GrowthPolicy, Alloc>& lhs, const vector<T, GrowthPolicy, Alloc>& rhs) {
 	return mystl::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), lhs.end());
 }
 
-template <typename T>
-bool operator!=(const vector<T>& lhs, const vector<T>& rhs) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+bool operator!=(const vector<T, GrowthPolicy, Alloc>& lhs, const vector<T, GrowthPolicy, Alloc>& rhs) {
 	return !(lhs == rhs);
 }
 
-template <typename T>
-bool operator>(const vector<T>& lhs, const vector<T>& rhs) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+bool operator>(const vector<T, GrowthPolicy, Alloc>& lhs, const vector<T, GrowthPolicy, Alloc>& rhs) {
 	return rhs < lhs;
 }
 
-template <typename T>
-bool operator<=(const vector<T>& lhs, const vector<T>& rhs) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+bool operator<=(const vector<T, GrowthPolicy, Alloc>& lhs, const vector<T, GrowthPolicy, Alloc>& rhs) {
 	return !(rhs < lhs);
 }
 
-template <typename T>
-bool operator>=(const vector<T>& lhs, const vector<T>& rhs) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+bool operator>=(const vector<T, GrowthPolicy, Alloc>& lhs, const vector<T, GrowthPolicy, Alloc>& rhs) {
 	return !(lhs < rhs);
 }
 
 // 重载 mystl 的 swap
-template <typename T>
-void swap(vector<T>& lhs, vector<T>& rhs) {
+template <typename T, typename GrowthPolicy, typename Alloc>
+void swap(vector<T, GrowthPolicy, Alloc>& lhs, vector<T, GrowthPolicy, Alloc>& rhs) {
 	lhs.swap(rhs);
 }
 
+// vector 只保存指向堆内存的指针，可以按字节搬移
+template <typename T, typename GrowthPolicy, typename Alloc>
+struct is_trivially_relocatable<vector<T, GrowthPolicy, Alloc>> : std::true_type {};
+
 } // namespace mystl
 #endif // !MYTINYSTL_VECTOR_H_
 
@@ -0,0 +1,152 @@
+﻿#ifndef MYSTL_BTREE_TEST_H_
+#define MYSTL_BTREE_TEST_H_
+
+// btree test : 测试 btree_map, btree_multimap, btree_set, btree_multiset 的接口，
+// 以及 btree_map 与 mystl::map 在插入、查找、区间扫描下的性能
+
+#include <ctime>
+
+#include "../MySTL/algo.h"
+#include "../MySTL/btree_map.h"
+#include "../MySTL/btree_set.h"
+#include "../MySTL/map.h"
+#include "../MySTL/vector.h"
+#include "map_test.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace btree_test
+{
+
+// 区间扫描的长度
+#define BTREE_SCAN 100
+
+// 累加查找、扫描的结果，防止被编译器优化掉
+long long btree_sink = 0;
+
+// 以 keys 依次插入 Map，再用相同的键查找，最后从随机位置做 keys.size() / BTREE_SCAN 次区间扫描
+// 三个阶段的耗时(ms)依次存入 ms
+template <typename Map>
+void btree_run(const mystl::vector<int>& keys, int ms[3])
+{
+  Map m;
+  long long sum = 0;
+  clock_t start = clock();
+  for (size_t i = 0; i < keys.size(); ++i)
+    m.emplace(keys[i], static_cast<int>(i));
+  clock_t end = clock();
+  ms[0] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+
+  start = clock();
+  for (size_t i = 0; i < keys.size(); ++i)
+    sum += m.find(keys[i])->second;
+  end = clock();
+  ms[1] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+
+  start = clock();
+  for (size_t i = 0; i < keys.size(); i += BTREE_SCAN)
+  {
+    size_t n = BTREE_SCAN;
+    for (auto it = m.lower_bound(keys[i]); it != m.end() && n > 0; ++it, --n)
+      sum += it->second;
+  }
+  end = clock();
+  ms[2] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  btree_sink += sum;
+}
+
+// 输出一格耗时
+void btree_cell(int ms)
+{
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "%dms    |", ms);
+  std::cout << std::setw(WIDE) << buf;
+}
+
+void btree_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[----------------- Run container test : btree ------------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::btree_map<int, int> m1;
+  for (int i = 100; i > 0; --i)
+    m1.emplace(i, i * 2);
+  mystl::btree_map<int, int> m2(m1);
+  FUN_VALUE(m1.size());
+  MAP_FUN_AFTER(m1, m1.erase(m1.find(10), m1.end()));
+  MAP_FUN_AFTER(m1, m1.insert(m1.end(), PAIR(10, 10)));
+  MAP_FUN_AFTER(m1, m1.erase(1));
+  FUN_VALUE(m1.count(2));
+  FUN_VALUE(m1[5]);
+  FUN_VALUE(m1.at(10));
+  MAP_VALUE(*m1.lower_bound(3));
+  MAP_VALUE(*m1.upper_bound(3));
+  MAP_VALUE(*m1.rbegin());
+  MAP_VALUE(*m2.find(50));
+  FUN_VALUE(m2.size());
+  std::cout << std::boolalpha;
+  FUN_VALUE((m1 < m2));
+  FUN_VALUE((m2.find(101) == m2.end()));
+  std::cout << std::noboolalpha;
+  mystl::btree_multimap<int, int> m3;
+  for (int i = 0; i < 10; ++i)
+    m3.emplace(i % 3, i);
+  MAP_COUT(m3);
+  FUN_VALUE(m3.count(1));
+  MAP_FUN_AFTER(m3, m3.erase(1));
+  mystl::btree_set<int> s1{ 5, 3, 1, 3, 5 };
+  mystl::btree_multiset<int> s2{ 5, 3, 1, 3, 5 };
+  COUT(s1);
+  COUT(s2);
+  FUN_VALUE(s2.count(5));
+  FUN_AFTER(s2, s2.erase(s2.begin()));
+  FUN_AFTER(s1, s1.clear());
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[2][3][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    mystl::vector<int> keys(lens[k]);
+    unsigned seed = 1;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      seed = seed * 1103515245u + 12345u;
+      keys[i] = static_cast<int>(seed >> 1);
+    }
+    btree_run<mystl::map<int, int>>(keys, ms[0][k]);
+    btree_run<mystl::btree_map<int, int>>(keys, ms[1][k]);
+  }
+  const char* names[3] = { "insert", "find", "scan" };
+  std::cout << " random keys, scan = " << BTREE_SCAN << " elements from lower_bound" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   map / btree_map   |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (size_t op = 0; op < 3; ++op)
+  {
+    std::cout << "|" << std::setw(14) << names[op] << "  map  |";
+    for (size_t k = 0; k < 3; ++k)
+      btree_cell(ms[0][k][op]);
+    std::cout << "\n|" << std::setw(14) << names[op] << " btree |";
+    for (size_t k = 0; k < 3; ++k)
+      btree_cell(ms[1][k][op]);
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[----------------- End container test : btree ------------------]" << std::endl;
+}
+
+} // namespace btree_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_BTREE_TEST_H_
@@ -0,0 +1,250 @@
+#ifndef MYSTL_CONCURRENT_MAP_TEST_H_
+#define MYSTL_CONCURRENT_MAP_TEST_H_
+
+// concurrent map test : 测试 concurrent_map 的接口，
+// 以及它与读写锁保护的 mystl::map 在查找、插入、区间扫描混合负载下的吞吐量
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../MySTL/concurrent_map.h"
+#include "map_test.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace concurrent_map_test
+{
+
+// 简单的读写锁，读者优先
+class rw_lock
+{
+public:
+  void lock_shared()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !writer_; });
+    ++readers_;
+  }
+  void unlock_shared()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--readers_ == 0)
+      cv_.notify_all();
+  }
+  void lock()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return !writer_ && readers_ == 0; });
+    writer_ = true;
+  }
+  void unlock()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    writer_ = false;
+    cv_.notify_all();
+  }
+
+private:
+  std::mutex              mutex_;
+  std::condition_variable cv_;
+  size_t                  readers_ = 0;
+  bool                    writer_ = false;
+};
+
+// 用读写锁包装的 mystl::map，作为性能对比的基准
+template <typename Key, typename T>
+class locked_map
+{
+public:
+  bool find(const Key& key, T& value)
+  {
+    rw_lock_.lock_shared();
+    auto it = m_.find(key);
+    const bool found = it != m_.end();
+    if (found)
+      value = it->second;
+    rw_lock_.unlock_shared();
+    return found;
+  }
+
+  void insert(const mystl::pair<const Key, T>& value)
+  {
+    rw_lock_.lock();
+    m_.insert(value);
+    rw_lock_.unlock();
+  }
+
+  // 从 key 开始顺序访问 n 个元素
+  T scan(const Key& key, size_t n)
+  {
+    T sum = T();
+    rw_lock_.lock_shared();
+    for (auto it = m_.lower_bound(key); it != m_.end() && n > 0; ++it, --n)
+      sum += it->second;
+    rw_lock_.unlock_shared();
+    return sum;
+  }
+
+private:
+  rw_lock             rw_lock_;
+  mystl::map<Key, T>  m_;
+};
+
+// 对 concurrent_map 做同样的包装
+template <typename Key, typename T>
+class skip_map
+{
+public:
+  bool find(const Key& key, T& value)
+  {
+    auto it = m_.find(key);
+    if (it == m_.end())
+      return false;
+    value = it->second;
+    return true;
+  }
+
+  void insert(const mystl::pair<const Key, T>& value)
+  {
+    m_.insert(value);
+  }
+
+  T scan(const Key& key, size_t n)
+  {
+    T sum = T();
+    for (auto it = m_.lower_bound(key); it != m_.end() && n > 0; ++it, --n)
+      sum += it->second;
+    return sum;
+  }
+
+private:
+  mystl::concurrent_map<Key, T> m_;
+};
+
+// 区间扫描的长度
+#define CONCURRENT_MAP_SCAN 100
+
+// 以 threads 个线程共执行 count 次操作：find_percent% 查找，scan_percent% 扫描，其余插入
+// 键值范围为 [0, count)，开始前预先插入一半的键，返回总耗时(ms)
+template <typename Map>
+long long map_run(size_t threads, size_t count, size_t find_percent, size_t scan_percent)
+{
+  Map m;
+  for (size_t i = 0; i < count; i += 2)
+    m.insert(mystl::make_pair(static_cast<int>(i), static_cast<int>(i)));
+  std::vector<std::thread> workers;
+  std::atomic<bool> go(false);
+  std::atomic<long long> sink(0);
+  for (size_t t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&, t] {
+      // 每个线程使用独立的线性同余序列
+      unsigned seed = static_cast<unsigned>(t * 2654435761u + 1);
+      int value = 0;
+      long long sum = 0;
+      while (!go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+      for (size_t i = t; i < count; i += threads)
+      {
+        seed = seed * 1103515245u + 12345u;
+        const int key = static_cast<int>((seed >> 8) % count);
+        const size_t op = (seed >> 4) % 100;
+        if (op < find_percent)
+          sum += m.find(key, value) ? value : 0;
+        else if (op < find_percent + scan_percent)
+          sum += m.scan(key, CONCURRENT_MAP_SCAN);
+        else
+          m.insert(mystl::make_pair(key, key));
+      }
+      sink += sum;
+    });
+  }
+  const auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& w : workers)
+    w.join();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+// 输出一格耗时
+template <typename Map>
+void map_cell(size_t threads, size_t count, size_t find_percent, size_t scan_percent)
+{
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%lldms |",
+                map_run<Map>(threads, count, find_percent, scan_percent));
+  std::cout << std::setw(WIDE + 2) << buf;
+}
+
+void concurrent_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------- Run container test : concurrent_map -------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::concurrent_map<int, int> m;
+  std::cout << std::boolalpha;
+  FUN_VALUE(m.empty());
+  for (int i = 10; i > 0; --i)
+    m.emplace(i * 2, i);
+  FUN_VALUE(m.insert(mystl::make_pair(4, 0)).second);
+  FUN_VALUE(m.insert(mystl::make_pair(5, 0)).second);
+  FUN_VALUE(m.size());
+  MAP_COUT(m);
+  FUN_VALUE(m.find(6)->second);
+  FUN_VALUE((m.find(7) == m.end()));
+  FUN_VALUE(m.contains(8));
+  FUN_VALUE(m.count(9));
+  MAP_VALUE(*m.lower_bound(7));
+  MAP_VALUE(*m.upper_bound(8));
+  FUN_VALUE((m.upper_bound(20) == m.end()));
+  FUN_VALUE(m.erase(5));
+  FUN_VALUE(m.erase(5));
+  auto r = m.equal_range(10);
+  std::cout << " m.equal_range(10) : from <" << r.first->first << ", " << r.first->second
+    << "> to <" << r.second->first << ", " << r.second->second << ">" << std::endl;
+  MAP_FUN_AFTER(m, m.clear());
+  FUN_VALUE(m.empty());
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t count = LEN3 _S;
+#else
+  const size_t count = LEN2 _S;
+#endif
+  typedef locked_map<int, int>  rw_map;
+  typedef skip_map<int, int>    cc_map;
+  std::cout << " " << count << " operations, scan = " << CONCURRENT_MAP_SCAN << " elements" << std::endl;
+  std::cout << " read-mostly = 90% find 5% scan 5% insert, mixed = 50% find 10% scan 40% insert" << std::endl;
+  std::cout << "|-------------|-------------------------------|-------------------------------|" << std::endl;
+  std::cout << "|             |          read-mostly          |             mixed             |" << std::endl;
+  std::cout << "|   threads   | map + rw_lock | concurrent_map| map + rw_lock | concurrent_map|" << std::endl;
+  std::cout << "|-------------|---------------|---------------|---------------|---------------|" << std::endl;
+  for (size_t threads = 1; threads <= 8; threads *= 2)
+  {
+    std::cout << "|" << std::setw(WIDE - 4) << threads << "   |";
+    map_cell<rw_map>(threads, count, 90, 5);
+    map_cell<cc_map>(threads, count, 90, 5);
+    map_cell<rw_map>(threads, count, 50, 10);
+    map_cell<cc_map>(threads, count, 50, 10);
+    std::cout << std::endl;
+  }
+  std::cout << "|-------------|---------------|---------------|---------------|---------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------- End container test : concurrent_map -------------]" << std::endl;
+}
+
+} // namespace concurrent_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_CONCURRENT_MAP_TEST_H_
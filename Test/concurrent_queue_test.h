@@ -0,0 +1,197 @@
+﻿#ifndef MYSTL_CONCURRENT_QUEUE_TEST_H_
+#define MYSTL_CONCURRENT_QUEUE_TEST_H_
+
+// concurrent queue test : 测试 mpmc_queue, spsc_queue 的接口，
+// 以及它们与加锁的 mystl::queue 在 2 ~ 32 个线程下的吞吐量和延迟
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../MySTL/concurrent_queue.h"
+#include "../MySTL/queue.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace concurrent_queue_test
+{
+
+// 用互斥量包装的 mystl::queue，作为性能对比的基准
+template <typename T>
+class locked_queue
+{
+public:
+  explicit locked_queue(size_t) {}
+
+  void push(const T& value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    q_.push(value);
+  }
+
+  void pop(T& value)
+  {
+    size_t spins = 0;
+    while (true)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!q_.empty())
+        {
+          value = q_.front();
+          q_.pop();
+          return;
+        }
+      }
+      mystl::concurrent_detail::spin_wait(spins);
+    }
+  }
+
+private:
+  std::mutex        mutex_;
+  mystl::queue<T>   q_;
+};
+
+// 队列容量
+#define CONCURRENT_QUEUE_CAP 1024
+
+// 当前时刻，单位纳秒
+inline long long now_ns()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 以 producers 个生产者、consumers 个消费者传递 count 个时间戳
+// 返回总耗时(ms)，并通过 lat 返回所有元素从入队到出队的延迟(ns)
+template <typename Queue>
+long long queue_run(size_t producers, size_t consumers, size_t count,
+                    std::vector<long long>& lat)
+{
+  Queue q(CONCURRENT_QUEUE_CAP);
+  std::vector<std::vector<long long>> lats(consumers);
+  std::vector<std::thread> threads;
+  std::atomic<bool> go(false);
+  for (size_t p = 0; p < producers; ++p)
+  {
+    threads.emplace_back([&, p] {
+      while (!go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+      for (size_t i = p; i < count; i += producers)
+        q.push(now_ns());
+    });
+  }
+  for (size_t c = 0; c < consumers; ++c)
+  {
+    threads.emplace_back([&, c] {
+      const size_t n = count / consumers + (c < count % consumers ? 1 : 0);
+      lats[c].reserve(n);
+      while (!go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+      for (size_t i = 0; i < n; ++i)
+      {
+        long long stamp;
+        q.pop(stamp);
+        lats[c].push_back(now_ns() - stamp);
+      }
+    });
+  }
+  const auto start = now_ns();
+  go.store(true, std::memory_order_release);
+  for (auto& t : threads)
+    t.join();
+  const auto end = now_ns();
+  lat.clear();
+  for (auto& l : lats)
+    lat.insert(lat.end(), l.begin(), l.end());
+  return (end - start) / 1000000;
+}
+
+// 输出一格 "耗时 / 平均延迟 / p99 延迟"
+template <typename Queue>
+void queue_cell(size_t producers, size_t consumers, size_t count)
+{
+  std::vector<long long> lat;
+  const long long ms = queue_run<Queue>(producers, consumers, count, lat);
+  long long sum = 0;
+  for (auto l : lat)
+    sum += l;
+  const size_t p99 = lat.size() * 99 / 100;
+  std::nth_element(lat.begin(), lat.begin() + p99, lat.end());
+  char buf[64];
+  std::snprintf(buf, sizeof(buf), "%lldms %lld/%lldus |", ms,
+                sum / static_cast<long long>(lat.size()) / 1000, lat[p99] / 1000);
+  std::cout << std::setw(WIDE + 6) << buf;
+}
+
+void concurrent_queue_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------ Run container test : concurrent_queue ------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::mpmc_queue<int> q1(5);
+  mystl::spsc_queue<int> q2(8);
+  int v = 0;
+  FUN_VALUE(q1.capacity());
+  FUN_VALUE(q2.capacity());
+  std::cout << std::boolalpha;
+  FUN_VALUE(q1.empty());
+  for (int i = 1; i <= 8; ++i)
+    q1.push(i);
+  FUN_VALUE(q1.try_push(9));
+  FUN_VALUE(q1.size());
+  FUN_VALUE(q1.try_pop(v));
+  FUN_VALUE(v);
+  FUN_VALUE(q1.try_push(9));
+  FUN_VALUE(q2.try_emplace(1));
+  FUN_VALUE(q2.try_push(2));
+  FUN_VALUE(q2.size());
+  FUN_VALUE(q2.try_pop(v));
+  FUN_VALUE(v);
+  q2.pop(v);
+  FUN_VALUE(v);
+  FUN_VALUE(q2.try_pop(v));
+  FUN_VALUE(q2.empty());
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t count = LEN2 _M;
+#else
+  const size_t count = LEN1 _M;
+#endif
+  std::cout << " " << count << " items, cell = total time  avg/p99 latency" << std::endl;
+  std::cout << "|-------------|-------------------|-------------------|-------------------|" << std::endl;
+  std::cout << "|   threads   |  mutex + queue    |    mpmc_queue     |    spsc_queue     |" << std::endl;
+  std::cout << "|-------------|-------------------|-------------------|-------------------|" << std::endl;
+  for (size_t threads = 2; threads <= 32; threads *= 2)
+  {
+    // 生产者和消费者各占一半
+    const size_t producers = threads / 2;
+    const size_t consumers = threads / 2;
+    std::cout << "|" << std::setw(WIDE - 4) << threads << "   |";
+    queue_cell<locked_queue<long long>>(producers, consumers, count);
+    queue_cell<mystl::mpmc_queue<long long>>(producers, consumers, count);
+    if (producers == 1)
+      queue_cell<mystl::spsc_queue<long long>>(producers, consumers, count);
+    else
+      std::cout << std::setw(WIDE + 6) << "-       |";
+    std::cout << std::endl;
+  }
+  std::cout << "|-------------|-------------------|-------------------|-------------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------ End container test : concurrent_queue ------------]" << std::endl;
+}
+
+} // namespace concurrent_queue_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_CONCURRENT_QUEUE_TEST_H_
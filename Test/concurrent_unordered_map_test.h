@@ -0,0 +1,168 @@
+#ifndef MYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
+#define MYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
+
+// concurrent unordered_map test : 测试 concurrent_unordered_map 的接口，
+// 以及它与加锁的 mystl::unordered_map 在读多写少、写密集两种负载下的吞吐量
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../MySTL/concurrent_unordered_map.h"
+#include "../MySTL/unordered_map.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace concurrent_unordered_map_test
+{
+
+// 用互斥量包装的 mystl::unordered_map，作为性能对比的基准
+template <typename Key, typename T>
+class locked_unordered_map
+{
+public:
+  bool find(const Key& key, T& value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = m_.find(key);
+    if (it == m_.end())
+      return false;
+    value = it->second;
+    return true;
+  }
+
+  bool insert(const mystl::pair<const Key, T>& value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return m_.insert(value).second;
+  }
+
+  size_t erase(const Key& key)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return m_.erase(key);
+  }
+
+private:
+  std::mutex                   mutex_;
+  mystl::unordered_map<Key, T> m_;
+};
+
+// 以 threads 个线程各执行 count / threads 次操作，其中 read_percent% 为查找，其余插入、删除各半
+// 键值范围为 [0, count)，开始前预先插入一半的键，返回总耗时(ms)
+template <typename Map>
+long long map_run(size_t threads, size_t count, size_t read_percent)
+{
+  Map m;
+  for (size_t i = 0; i < count; i += 2)
+    m.insert(mystl::make_pair(static_cast<int>(i), static_cast<int>(i)));
+  std::vector<std::thread> workers;
+  std::atomic<bool> go(false);
+  for (size_t t = 0; t < threads; ++t)
+  {
+    workers.emplace_back([&, t] {
+      // 每个线程使用独立的线性同余序列
+      unsigned seed = static_cast<unsigned>(t * 2654435761u + 1);
+      int value = 0;
+      while (!go.load(std::memory_order_acquire))
+        std::this_thread::yield();
+      for (size_t i = t; i < count; i += threads)
+      {
+        seed = seed * 1103515245u + 12345u;
+        const int key = static_cast<int>((seed >> 8) % count);
+        const size_t op = (seed >> 4) % 100;
+        if (op < read_percent)
+          m.find(key, value);
+        else if (op & 1)
+          m.insert(mystl::make_pair(key, key));
+        else
+          m.erase(key);
+      }
+    });
+  }
+  const auto start = std::chrono::steady_clock::now();
+  go.store(true, std::memory_order_release);
+  for (auto& w : workers)
+    w.join();
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+// 输出一格耗时
+template <typename Map>
+void map_cell(size_t threads, size_t count, size_t read_percent)
+{
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%lldms |", map_run<Map>(threads, count, read_percent));
+  std::cout << std::setw(WIDE + 2) << buf;
+}
+
+void concurrent_unordered_map_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------- Run container test : concurrent_unordered_map ---------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::concurrent_unordered_map<int, int> m(100, 4);
+  int v = 0;
+  FUN_VALUE(m.shard_count());
+  std::cout << std::boolalpha;
+  FUN_VALUE(m.empty());
+  for (int i = 0; i < 1000; ++i)
+    m.insert(mystl::make_pair(i, i * 2));
+  FUN_VALUE(m.insert(mystl::make_pair(1, 0)));
+  FUN_VALUE(m.size());
+  FUN_VALUE(m.find(10, v));
+  FUN_VALUE(v);
+  FUN_VALUE(m.insert_or_assign(10, 100));
+  FUN_VALUE(m.find(10, v));
+  FUN_VALUE(v);
+  FUN_VALUE(m.insert_or_assign(1000, 2000));
+  FUN_VALUE(m.erase(10));
+  FUN_VALUE(m.erase(10));
+  FUN_VALUE(m.contains(10));
+  FUN_VALUE(m.count(1000));
+  FUN_VALUE(m.visit(500, [&v](const mystl::pair<const int, int>& p) { v = p.first + p.second; }));
+  FUN_VALUE(v);
+  FUN_VALUE(m.size());
+  m.clear();
+  FUN_VALUE(m.empty());
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t count = LEN3 _S;
+#else
+  const size_t count = LEN2 _S;
+#endif
+  typedef locked_unordered_map<int, int>                locked_map;
+  typedef mystl::concurrent_unordered_map<int, int>     concurrent_map;
+  std::cout << " " << count << " operations, read-mostly = 90% find, write-heavy = 50% find" << std::endl;
+  std::cout << "|-------------|-------------------------------|-------------------------------|" << std::endl;
+  std::cout << "|             |          read-mostly          |          write-heavy          |" << std::endl;
+  std::cout << "|   threads   |    mutex      |  concurrent   |    mutex      |  concurrent   |" << std::endl;
+  std::cout << "|-------------|---------------|---------------|---------------|---------------|" << std::endl;
+  for (size_t threads = 1; threads <= 8; threads *= 2)
+  {
+    std::cout << "|" << std::setw(WIDE - 4) << threads << "   |";
+    map_cell<locked_map>(threads, count, 90);
+    map_cell<concurrent_map>(threads, count, 90);
+    map_cell<locked_map>(threads, count, 50);
+    map_cell<concurrent_map>(threads, count, 50);
+    std::cout << std::endl;
+  }
+  std::cout << "|-------------|---------------|---------------|---------------|---------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------- End container test : concurrent_unordered_map ---------]" << std::endl;
+}
+
+} // namespace concurrent_unordered_map_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_CONCURRENT_UNORDERED_MAP_TEST_H_
@@ -1,11 +1,15 @@
 ﻿#ifndef MYSTL_DEQUE_TEST_H_
 #define MYSTL_DEQUE_TEST_H_
 
-// deque test : 测试 deque 的接口和 push_front/push_back 的性能
+// deque test : 测试 deque 的接口和 push_front/push_back 的性能，
+// 以及按缓冲区分段的 for_each / copy 与 vector、逐元素遍历的对比
 
+#include <ctime>
 #include <deque>
 
 #include "../MySTL/deque.h"
+#include "../MySTL/huge_page_allocator.h"
+#include "../MySTL/vector.h"
 #include "test.h"
 
 namespace mystl
@@ -15,6 +19,61 @@ namespace test
 namespace deque_test
 {
 
+// 遍历、复制的重复次数
+#define DEQUE_SCAN_ROUNDS 20
+
+// 累加遍历的结果，防止被编译器优化掉
+long long deque_sink = 0;
+
+// 累加元素的函数对象
+struct deque_sum
+{
+  long long sum;
+  deque_sum() :sum(0) {}
+  void operator()(int x) { sum += x; }
+};
+
+// 对 n 个元素的 vector 与 deque 各做 DEQUE_SCAN_ROUNDS 次遍历和复制到 vector，耗时(ms)依次存入 ms：
+// vector for_each, deque for_each, deque 逐元素遍历, vector copy, deque copy, deque 逐元素复制
+void deque_scan_run(size_t n, int ms[6])
+{
+  mystl::vector<int> v(n);
+  mystl::deque<int> d(n);
+  for (size_t i = 0; i < n; ++i)
+    v[i] = d[i] = static_cast<int>(i);
+  mystl::vector<int> out(n);
+  long long sum = 0;
+  clock_t start, end;
+  for (int op = 0; op < 6; ++op)
+  {
+    start = clock();
+    for (int r = 0; r < DEQUE_SCAN_ROUNDS; ++r)
+    {
+      switch (op)
+      {
+      case 0: sum += mystl::for_each(v.begin(), v.end(), deque_sum()).sum; break;
+      case 1: sum += mystl::for_each(d.begin(), d.end(), deque_sum()).sum; break;
+      case 2:
+        for (auto it = d.begin(); it != d.end(); ++it)
+          sum += *it;
+        break;
+      case 3: mystl::copy(v.begin(), v.end(), out.begin()); break;
+      case 4: mystl::copy(d.begin(), d.end(), out.begin()); break;
+      default:
+      {
+        auto dst = out.begin();
+        for (auto it = d.begin(); it != d.end(); ++it, ++dst)
+          *dst = *it;
+      }
+      }
+      sum += out[r % n];
+    }
+    end = clock();
+    ms[op] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  }
+  deque_sink += sum;
+}
+
 void deque_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -57,6 +116,14 @@ void deque_test()
   FUN_AFTER(d1, d1.clear());
   FUN_AFTER(d1, d1.shrink_to_fit());
   FUN_AFTER(d1, d1.swap(d4));
+  FUN_AFTER(d1, mystl::fill(d1.begin() + 1, d1.end() - 1, 0));
+  FUN_AFTER(d10, mystl::copy(a, a + 5, d10.begin() + 2));
+  FUN_VALUE(*mystl::find(d10.begin(), d10.end(), 3));
+  mystl::deque<int, 4> d11(d10.begin(), d10.end());
+  COUT(d11);
+  mystl::deque<int, (1 << 19), mystl::huge_page_allocator<int>> d12(d10.begin(), d10.end());
+  FUN_AFTER(d12, d12.push_front(0));
+  FUN_AFTER(d12, d12.erase(d12.begin() + 1, d12.end() - 1));
   FUN_VALUE(*(d1.begin()));
   FUN_VALUE(*(d1.end() - 1));
   FUN_VALUE(*(d1.rbegin()));
@@ -90,6 +157,33 @@ void deque_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[3][6];
+  for (size_t k = 0; k < 3; ++k)
+    deque_scan_run(lens[k], ms[k]);
+  const char* names[6] = {
+    "|   for_each   vector |", "|   for_each    deque |", "|  ++ loop      deque |",
+    "|     copy     vector |", "|     copy      deque |", "|  ++ loop copy deque |" };
+  std::cout << " " << DEQUE_SCAN_ROUNDS << " rounds of sum / copy into a vector, int elements" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   scan / copy       |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (int op = 0; op < 6; ++op)
+  {
+    std::cout << names[op];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", ms[k][op]);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
 #endif
   std::cout << "[----------------- End container test : deque ------------------]" << std::endl;
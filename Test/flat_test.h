@@ -0,0 +1,154 @@
+﻿#ifndef MYSTL_FLAT_TEST_H_
+#define MYSTL_FLAT_TEST_H_
+
+// flat test : 测试 flat_map, flat_multimap, flat_set, flat_multiset 的接口，
+// 以及 flat_map 与 mystl::map 在构建、查找、区间扫描下的性能和每个元素占用的内存
+
+#include <ctime>
+
+#include "../MySTL/algo.h"
+#include "../MySTL/flat_map.h"
+#include "../MySTL/flat_set.h"
+#include "../MySTL/map.h"
+#include "../MySTL/vector.h"
+#include "map_test.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace flat_test
+{
+
+// 区间扫描的长度
+#define FLAT_SCAN 100
+
+// 累加查找、扫描的结果，防止被编译器优化掉
+long long flat_sink = 0;
+
+// 以 values 一次性构建 Map，再逐个查找，最后从随机位置做 values.size() / FLAT_SCAN 次区间扫描
+// 三个阶段的耗时(ms)依次存入 ms
+template <typename Map>
+void flat_run(const mystl::vector<mystl::pair<int, int>>& values, int ms[3])
+{
+  long long sum = 0;
+  clock_t start = clock();
+  Map m(values.begin(), values.end());
+  clock_t end = clock();
+  ms[0] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+
+  start = clock();
+  for (size_t i = 0; i < values.size(); ++i)
+    sum += m.find(values[i].first)->second;
+  end = clock();
+  ms[1] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+
+  start = clock();
+  for (size_t i = 0; i < values.size(); i += FLAT_SCAN)
+  {
+    size_t n = FLAT_SCAN;
+    for (auto it = m.lower_bound(values[i].first); it != m.end() && n > 0; ++it, --n)
+      sum += it->second;
+  }
+  end = clock();
+  ms[2] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  flat_sink += sum;
+}
+
+// 输出一格耗时
+void flat_cell(int ms)
+{
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "%dms    |", ms);
+  std::cout << std::setw(WIDE) << buf;
+}
+
+void flat_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[------------------ Run container test : flat ------------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  mystl::vector<PAIR> v;
+  for (int i = 9; i >= 0; --i)
+    v.push_back(PAIR(i % 5, i));
+  mystl::flat_map<int, int> m1(v.begin(), v.end());
+  mystl::flat_map<int, int> m2{ PAIR(7, 7), PAIR(5, 5), PAIR(6, 6) };
+  MAP_COUT(m1);
+  MAP_FUN_AFTER(m1, m1.insert(m2.begin(), m2.end()));
+  MAP_FUN_AFTER(m1, m1.emplace(3, 30));
+  MAP_FUN_AFTER(m1, m1.emplace_hint(m1.end(), 8, 8));
+  MAP_FUN_AFTER(m1, m1.erase(m1.begin()));
+  MAP_FUN_AFTER(m1, m1.erase(7));
+  FUN_VALUE(m1.count(5));
+  MAP_VALUE(*m1.find(3));
+  MAP_VALUE(*m1.lower_bound(4));
+  MAP_VALUE(*m1.upper_bound(4));
+  FUN_VALUE(m1[9]);
+  MAP_FUN_AFTER(m1, m1[9] = 90);
+  FUN_VALUE(m1.at(6));
+  FUN_VALUE(m1.size());
+  MAP_FUN_AFTER(m1, m1.shrink_to_fit());
+  FUN_VALUE(m1.capacity());
+  mystl::flat_multimap<int, int> m3(v.begin(), v.end());
+  MAP_COUT(m3);
+  FUN_VALUE(m3.count(2));
+  MAP_FUN_AFTER(m3, m3.insert(v.begin(), v.begin() + 3));
+  MAP_FUN_AFTER(m3, m3.erase(4));
+  mystl::flat_set<int> s1{ 5, 3, 1, 3, 5 };
+  mystl::flat_multiset<int> s2{ 5, 3, 1, 3, 5 };
+  COUT(s1);
+  COUT(s2);
+  FUN_VALUE(s2.count(5));
+  FUN_AFTER(s1, s1.insert(4));
+  FUN_AFTER(s2, s2.erase(s2.begin()));
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[2][3][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    mystl::vector<PAIR> values(lens[k]);
+    unsigned seed = 1;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      seed = seed * 1103515245u + 12345u;
+      values[i] = PAIR(static_cast<int>(seed >> 1), static_cast<int>(i));
+    }
+    flat_run<mystl::map<int, int>>(values, ms[0][k]);
+    flat_run<mystl::flat_map<int, int>>(values, ms[1][k]);
+  }
+  const char* names[3] = { "build", "find", "scan" };
+  std::cout << " random keys, build = range constructor, scan = " << FLAT_SCAN
+    << " elements from lower_bound" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   map / flat_map    |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (size_t op = 0; op < 3; ++op)
+  {
+    std::cout << "|" << std::setw(13) << names[op] << "   map  |";
+    for (size_t k = 0; k < 3; ++k)
+      flat_cell(ms[0][k][op]);
+    std::cout << "\n|" << std::setw(13) << names[op] << "  flat  |";
+    for (size_t k = 0; k < 3; ++k)
+      flat_cell(ms[1][k][op]);
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << " bytes per element : map = "
+    << sizeof(mystl::rb_tree_node<mystl::pair<const int, int>>)
+    << ", flat_map = " << sizeof(mystl::pair<int, int>) << std::endl;
+  PASSED;
+#endif
+  std::cout << "[------------------ End container test : flat ------------------]" << std::endl;
+}
+
+} // namespace flat_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_FLAT_TEST_H_
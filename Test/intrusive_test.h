@@ -0,0 +1,263 @@
+﻿#ifndef MYSTL_INTRUSIVE_TEST_H_
+#define MYSTL_INTRUSIVE_TEST_H_
+
+// intrusive test : 测试 intrusive_list, intrusive_set 的接口，
+// 以及侵入式容器与 mystl::list、mystl::set 在插入、遍历或查找、按元素删除下的性能
+
+#include <ctime>
+
+#include "../MySTL/algo.h"
+#include "../MySTL/intrusive.h"
+#include "../MySTL/list.h"
+#include "../MySTL/set.h"
+#include "../MySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace intrusive_test
+{
+
+// 同时嵌有链表挂钩和集合挂钩的元素
+struct item
+{
+  int key;
+  int value;
+  mystl::intrusive_list_hook list_hook;
+  mystl::intrusive_set_hook  set_hook;
+
+  item() :key(0), value(0) {}
+  item(int k, int v) :key(k), value(v) {}
+
+  bool operator<(const item& rhs) const { return key < rhs.key; }
+  bool operator>(const item& rhs) const { return key > rhs.key; }
+};
+
+std::ostream& operator<<(std::ostream& os, const item& x)
+{
+  return os << x.key;
+}
+
+typedef mystl::intrusive_list<item, &item::list_hook>                    item_list;
+typedef mystl::intrusive_set<item, &item::set_hook>                      item_set;
+typedef mystl::intrusive_set<item, &item::set_hook, mystl::greater<item>> item_greater_set;
+
+// 累加遍历、查找的结果，防止被编译器优化掉
+long long intrusive_sink = 0;
+
+// 距 start 的耗时(ms)
+int intrusive_ms(clock_t start)
+{
+  return static_cast<int>(static_cast<double>(clock() - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 链表：依次尾插 items 中的所有元素、遍历一轮、再按 order 的顺序逐个删除，三个阶段的耗时(ms)依次存入 ms
+// mystl::list 复制元素，按元素删除时使用插入时保存下来的迭代器
+void list_run(mystl::vector<item>& items, const mystl::vector<size_t>& order, int ms[2][3])
+{
+  long long sum = 0;
+  {
+    mystl::list<item> l;
+    mystl::vector<mystl::list<item>::iterator> pos(items.size());
+    clock_t start = clock();
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+      l.push_back(items[i]);
+      pos[i] = --l.end();
+    }
+    ms[0][0] = intrusive_ms(start);
+    start = clock();
+    for (auto& x : l)
+      sum += x.value;
+    ms[0][1] = intrusive_ms(start);
+    start = clock();
+    for (size_t i = 0; i < order.size(); ++i)
+      l.erase(pos[order[i]]);
+    ms[0][2] = intrusive_ms(start);
+  }
+  {
+    item_list l;
+    clock_t start = clock();
+    for (size_t i = 0; i < items.size(); ++i)
+      l.push_back(items[i]);
+    ms[1][0] = intrusive_ms(start);
+    start = clock();
+    for (auto& x : l)
+      sum += x.value;
+    ms[1][1] = intrusive_ms(start);
+    start = clock();
+    for (size_t i = 0; i < order.size(); ++i)
+      l.erase(items[order[i]]);
+    ms[1][2] = intrusive_ms(start);
+  }
+  intrusive_sink += sum;
+}
+
+// 集合：依次插入 items 中的所有元素、逐个查找、再按 order 的顺序逐个删除，三个阶段的耗时(ms)依次存入 ms
+// mystl::set 复制元素，按键值删除；intrusive_set 直接摘下元素，不需要查找
+void set_run(mystl::vector<item>& items, const mystl::vector<size_t>& order, int ms[2][3])
+{
+  long long sum = 0;
+  {
+    mystl::set<item> s;
+    clock_t start = clock();
+    for (size_t i = 0; i < items.size(); ++i)
+      s.insert(items[i]);
+    ms[0][0] = intrusive_ms(start);
+    start = clock();
+    for (size_t i = 0; i < items.size(); ++i)
+      sum += s.find(items[i])->value;
+    ms[0][1] = intrusive_ms(start);
+    start = clock();
+    for (size_t i = 0; i < order.size(); ++i)
+      s.erase(items[order[i]]);
+    ms[0][2] = intrusive_ms(start);
+  }
+  {
+    item_set s;
+    clock_t start = clock();
+    for (size_t i = 0; i < items.size(); ++i)
+      s.insert(items[i]);
+    ms[1][0] = intrusive_ms(start);
+    start = clock();
+    for (size_t i = 0; i < items.size(); ++i)
+      sum += s.find(items[i])->value;
+    ms[1][1] = intrusive_ms(start);
+    start = clock();
+    for (size_t i = 0; i < order.size(); ++i)
+      s.erase(items[order[i]]);
+    ms[1][2] = intrusive_ms(start);
+  }
+  intrusive_sink += sum;
+}
+
+// 输出一格耗时
+void intrusive_cell(int ms)
+{
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "%dms    |", ms);
+  std::cout << std::setw(WIDE) << buf;
+}
+
+void intrusive_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[---------------- Run container test : intrusive ---------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  item a[8] = { item(5, 50), item(3, 30), item(8, 80), item(1, 10),
+                item(4, 40), item(7, 70), item(2, 20), item(3, 31) };
+  item_list l1;
+  item_list l2;
+  item_set s1;
+  item_greater_set s2;
+
+  FUN_AFTER(l1, l1.push_back(a[0]));
+  FUN_AFTER(l1, l1.push_back(a[1]));
+  FUN_AFTER(l1, l1.push_front(a[2]));
+  FUN_AFTER(l1, l1.insert(++l1.begin(), a[3]));
+  FUN_AFTER(l1, l1.erase(a[0]));
+  FUN_AFTER(l1, l1.pop_front());
+  FUN_AFTER(l2, l2.push_back(a[4]));
+  FUN_AFTER(l2, l2.push_back(a[5]));
+  FUN_AFTER(l1, l1.splice(l1.end(), l2));
+  FUN_AFTER(l1, l1.splice(l1.begin(), l1, --l1.end()));
+  FUN_VALUE(l1.size());
+  FUN_VALUE(l1.front());
+  FUN_VALUE(l1.back());
+  FUN_VALUE(l1.iterator_to(a[3])->value);
+  std::cout << std::boolalpha;
+  FUN_VALUE(a[0].list_hook.is_linked());
+  FUN_VALUE(a[3].list_hook.is_linked());
+  FUN_AFTER(l1, l1.swap(l2));
+  COUT(l2);
+  FUN_AFTER(l2, l2.clear());
+  FUN_VALUE(a[3].list_hook.is_linked());
+
+  for (int i = 0; i < 7; ++i)
+    s1.insert(a[i]);
+  COUT(s1);
+  FUN_VALUE(s1.insert(a[7]).second);
+  FUN_VALUE(s1.find(a[7])->value);
+  FUN_AFTER(s1, s1.erase(a[0]));
+  FUN_AFTER(s1, s1.erase(s1.begin()));
+  FUN_AFTER(s1, s1.insert(a[0]));
+  FUN_VALUE(s1.count(a[3]));
+  FUN_VALUE(*s1.lower_bound(item(6, 0)));
+  FUN_VALUE(*s1.upper_bound(a[4]));
+  FUN_VALUE(*s1.iterator_to(a[5]));
+  FUN_VALUE(*s1.rbegin());
+  FUN_VALUE(s1.size());
+  FUN_VALUE(a[0].set_hook.is_linked());
+  FUN_VALUE(a[3].set_hook.is_linked());
+  l1.push_back(a[3]);
+  l1.push_back(a[0]);
+  COUT(l1);
+  FUN_AFTER(s1, s1.clear());
+  for (int i = 0; i < 7; ++i)
+    s2.insert(a[i]);
+  COUT(s2);
+  FUN_VALUE(s2.empty());
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[2][3][2][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    // 键值互不相同的元素，以及随机的删除顺序
+    mystl::vector<item> items(lens[k]);
+    mystl::vector<size_t> order(lens[k]);
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+      items[i] = item(static_cast<int>(i), static_cast<int>(i));
+      order[i] = i;
+    }
+    unsigned seed = 1;
+    for (size_t i = items.size(); i > 1; --i)
+    {
+      seed = seed * 1103515245u + 12345u;
+      mystl::swap(items[i - 1].key, items[(seed >> 1) % i].key);
+      seed = seed * 1103515245u + 12345u;
+      mystl::swap(order[i - 1], order[(seed >> 1) % i]);
+    }
+    list_run(items, order, ms[0][k]);
+    set_run(items, order, ms[1][k]);
+  }
+  const char* names[2][3] = {
+    { "list push", "list iterate", "list erase" },
+    { "set insert", "set find", "set erase" } };
+  std::cout << " random keys, erase = every element in random order, by iterator (list),"
+    << " by key (set) or by reference (intrusive)" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  mystl / intrusive  |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (size_t c = 0; c < 2; ++c)
+  {
+    for (size_t op = 0; op < 3; ++op)
+    {
+      std::cout << "|" << std::setw(13) << names[c][op] << "  mystl |";
+      for (size_t k = 0; k < 3; ++k)
+        intrusive_cell(ms[c][k][0][op]);
+      std::cout << "\n|" << std::setw(13) << names[c][op] << "  intru |";
+      for (size_t k = 0; k < 3; ++k)
+        intrusive_cell(ms[c][k][1][op]);
+      std::cout << std::endl;
+    }
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[---------------- End container test : intrusive ---------------]" << std::endl;
+}
+
+} // namespace intrusive_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_INTRUSIVE_TEST_H_
@@ -75,6 +75,8 @@ void list_test()
   FUN_AFTER(l1, l1.sort(mystl::greater<int>()));
   FUN_AFTER(l1, l1.merge(l8, mystl::greater<int>()));
   FUN_AFTER(l1, l1.reverse());
+  FUN_AFTER(l1, l1.sort_by_buffer());
+  FUN_AFTER(l1, l1.sort_by_buffer(mystl::greater<int>()));
   FUN_AFTER(l1, l1.clear());
   FUN_AFTER(l1, l1.swap(l9));
   FUN_VALUE(*l1.begin());
@@ -99,11 +101,7 @@ void list_test()
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   std::cout << "|         sort        |";
-#if LARGER_TEST_DATA_ON
   LIST_SORT_TEST(LEN1 _M, LEN2 _M, LEN3 _M);
-#else
-  LIST_SORT_TEST(LEN1 _S, LEN2 _S, LEN3 _S);
-#endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
@@ -1,10 +1,13 @@
 ﻿#ifndef MYSTL_MAP_TEST_H_
 #define MYSTL_MAP_TEST_H_
 
-// map test : 测试 map, multimap 的接口与它们 insert 的性能
+// map test : 测试 map, multimap 的接口与它们 insert 的性能，以有序区间构建 map 的性能，
+// LRU 冷热迁移中使用节点句柄与否的性能，用 C 风格字符串查找时透明比较函数的效果，
+// 以及重复键值占多数的写入中 try_emplace 与 emplace 的性能
 
 #include <map>
 
+#include "../MySTL/astring.h"
 #include "../MySTL/map.h"
 #include "../MySTL/vector.h"
 #include "test.h"
@@ -42,6 +45,269 @@ namespace map_test
     std::cout << " " << str << " : <" << it.first << "," << it.second << ">\n"; \
 } while(0)
 
+// 以 __VA_ARGS__ 为参数构建 map 的耗时，不计析构
+#define MAP_BUILD_DO_TEST(...) do { \
+    char buf[16]; \
+    clock_t start = clock(); \
+    auto c = new mystl::map<int, int>(__VA_ARGS__); \
+    clock_t end = clock(); \
+    delete c; \
+    int n = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000); \
+    std::snprintf(buf, sizeof(buf), "%dms    |", n); \
+    std::cout << std::setw(WIDE) << buf; \
+} while(0)
+
+// 分别以逐个插入和 sorted_unique 线性构建的方式，用长度为 len1, len2, len3 的有序区间构建 map
+#define MAP_BUILD_TEST(len1, len2, len3) do { \
+    const size_t lens[3] = { len1, len2, len3 }; \
+    mystl::vector<PAIR> vs[3]; \
+    for (size_t k = 0; k < 3; ++k) \
+      for (size_t i = 0; i < lens[k]; ++i) \
+        vs[k].push_back(PAIR(static_cast<int>(i), static_cast<int>(i))); \
+    TEST_LEN(len1, len2, len3, WIDE); \
+    std::cout << "|     range ctor      |"; \
+    for (size_t k = 0; k < 3; ++k) \
+      MAP_BUILD_DO_TEST(vs[k].begin(), vs[k].end()); \
+    std::cout << "\n|    sorted_unique    |"; \
+    for (size_t k = 0; k < 3; ++k) \
+      MAP_BUILD_DO_TEST(mystl::sorted_unique, vs[k].begin(), vs[k].end()); \
+} while(0)
+
+// LRU 冷热迁移中元素的实值，长度足以让字符串在堆上分配
+#define LRU_PAYLOAD "cached-entry-payload-0123456789abcdef"
+
+// 模拟 LRU 缓存在冷、热两个容器间迁移元素：n 个元素起初都在冷容器中，之后按伪随机顺序访问 n 次，
+// 每次把被访问的元素搬到另一个容器。handle 为 true 时以 extract / insert 搬迁节点，
+// 否则把元素移动到新节点后删除原节点。返回耗时(ms)
+template <typename Map>
+int lru_migrate_run(size_t n, bool handle)
+{
+  Map hot, cold;
+  for (size_t i = 0; i < n; ++i)
+    cold.emplace(static_cast<int>(i), mystl::string(LRU_PAYLOAD));
+  unsigned seed = 1;
+  clock_t start = clock();
+  for (size_t i = 0; i < n; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    const int key = static_cast<int>((seed >> 1) % n);
+    auto it = cold.find(key);
+    const bool in_cold = it != cold.end();
+    if (!in_cold)
+      it = hot.find(key);
+    Map& from = in_cold ? cold : hot;
+    Map& to = in_cold ? hot : cold;
+    if (handle)
+    {
+      to.insert(from.extract(it));
+    }
+    else
+    {
+      to.emplace(it->first, mystl::move(it->second));
+      from.erase(it);
+    }
+  }
+  clock_t end = clock();
+  return static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 输出 Map 在 LRU 冷热迁移下两种搬迁方式的耗时
+template <typename Map>
+void lru_migrate_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  const char* names[2] = { "|   erase + emplace   |", "|     node handle     |" };
+  std::cout << " move n random entries between a hot and a cold container" << std::endl;
+  std::cout << "|    lru migration    |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  for (int h = 0; h < 2; ++h)
+  {
+    std::cout << names[h];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", lru_migrate_run<Map>(lens[k], h == 1));
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+// try_emplace 的实值：只能由 int 显式构造，不能复制或移动，要求节点中的值就地构造
+struct pinned
+{
+  int v;
+  explicit pinned(int x) :v(x) {}
+  pinned(const pinned&) = delete;
+  pinned& operator=(const pinned&) = delete;
+};
+
+// 累加查找的结果，防止被编译器优化掉
+long long cstr_lookup_sink = 0;
+
+// 以 keys 构建 Map 后，按伪随机顺序用 const char* 查找 keys.size() 次，返回耗时(ms)
+// Map 的比较(哈希)函数不透明时，每次查找都要先构造一个临时的 mystl::string
+template <typename Map>
+int cstr_lookup_run(const mystl::vector<mystl::string>& keys)
+{
+  Map m;
+  for (size_t i = 0; i < keys.size(); ++i)
+    m.emplace(keys[i], static_cast<int>(i));
+  long long sum = 0;
+  unsigned seed = 1;
+  clock_t start = clock();
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    sum += m.find(keys[(seed >> 1) % keys.size()].c_str())->second;
+  }
+  clock_t end = clock();
+  cstr_lookup_sink += sum;
+  return static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 输出以普通 / 透明比较(哈希)函数的 Map 用 C 风格字符串查找的耗时，names 为两行的行首
+template <typename Plain, typename Transparent>
+void cstr_lookup_test(const char* names[2], size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  int ms[2][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    mystl::vector<mystl::string> keys(lens[k]);
+    for (size_t i = 0; i < lens[k]; ++i)
+    {
+      char buf[32];
+      std::snprintf(buf, sizeof(buf), "lookup-key-%08d", static_cast<int>(i));
+      keys[i] = buf;
+    }
+    ms[0][k] = cstr_lookup_run<Plain>(keys);
+    ms[1][k] = cstr_lookup_run<Transparent>(keys);
+  }
+  std::cout << " find by const char*, string keys" << std::endl;
+  std::cout << "|   c-string lookup   |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  for (int t = 0; t < 2; ++t)
+  {
+    std::cout << names[t];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", ms[t][k]);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+// 重复写入的比例(%)
+#define DUP_RATE 90
+
+// 模拟重复键值占多数的写入：n 次写入的键值取自 n * (100 - DUP_RATE) / 100 个不同的键值，
+// 实值是一个在堆上分配的字符串。try_first 为 true 时使用 try_emplace，否则使用 emplace，返回耗时(ms)
+template <typename Map>
+int dup_ingest_run(size_t n, bool try_first)
+{
+  Map m;
+  const size_t distinct = mystl::max(n * (100 - DUP_RATE) / 100, static_cast<size_t>(1));
+  unsigned seed = 1;
+  clock_t start = clock();
+  for (size_t i = 0; i < n; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    const int key = static_cast<int>((seed >> 1) % distinct);
+    if (try_first)
+      m.try_emplace(key, LRU_PAYLOAD);
+    else
+      m.emplace(key, LRU_PAYLOAD);
+  }
+  clock_t end = clock();
+  return static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 输出 Map 在重复键值占多数的写入下 emplace 与 try_emplace 的耗时
+template <typename Map>
+void dup_ingest_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  const char* names[2] = { "|       emplace       |", "|     try_emplace     |" };
+  int ms[2][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    ms[0][k] = dup_ingest_run<Map>(lens[k], false);
+    ms[1][k] = dup_ingest_run<Map>(lens[k], true);
+  }
+  std::cout << " " << DUP_RATE << "% of the writes hit an existing key" << std::endl;
+  std::cout << "|  duplicate ingest   |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  for (int t = 0; t < 2; ++t)
+  {
+    std::cout << names[t];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", ms[t][k]);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
+// 随机键值逐个插入 n 个元素再 clear，插入与 clear 的耗时(ms)依次存入 ms[0] 与 ms[1]
+template <bool Pooled>
+void pool_run(size_t n, int ms[2])
+{
+  mystl::map<int, int, mystl::less<int>, false, Pooled> m;
+  unsigned seed = 1;
+  clock_t start = clock();
+  for (size_t i = 0; i < n; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    m.emplace(static_cast<int>(seed >> 1), static_cast<int>(i));
+  }
+  ms[0] = static_cast<int>(static_cast<double>(clock() - start) / CLOCKS_PER_SEC * 1000);
+  start = clock();
+  m.clear();
+  ms[1] = static_cast<int>(static_cast<double>(clock() - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 输出 map<int, int> 逐个申请节点与开启节点池时 insert、clear 的耗时
+void pool_test(size_t len1, size_t len2, size_t len3)
+{
+  const size_t lens[3] = { len1, len2, len3 };
+  const char* names[4] = { "|   insert per-node   |", "|   insert pooled     |",
+    "|   clear  per-node   |", "|   clear  pooled     |" };
+  int ms[4][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    int t[2];
+    pool_run<false>(lens[k], t);
+    ms[0][k] = t[0];
+    ms[2][k] = t[1];
+    pool_run<true>(lens[k], t);
+    ms[1][k] = t[0];
+    ms[3][k] = t[1];
+  }
+  std::cout << " map<int, int>, random keys, nodes allocated one by one vs from a per-tree pool" << std::endl;
+  std::cout << "|     node pool       |";
+  TEST_LEN(len1, len2, len3, WIDE);
+  for (int t = 0; t < 4; ++t)
+  {
+    std::cout << names[t];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", ms[t][k]);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+}
+
 void map_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -63,6 +329,7 @@ void map_test()
   mystl::map<int, int> m9{ PAIR(1,1),PAIR(3,2),PAIR(2,3) };
   mystl::map<int, int> m10;
   m10 = { PAIR(1,1),PAIR(3,2),PAIR(2,3) };
+  mystl::map<int, int> m11(mystl::sorted_unique, v.begin(), v.end());
 
   for (int i = 5; i > 0; --i)
   {
@@ -79,6 +346,47 @@ void map_test()
   }
   MAP_FUN_AFTER(m1, m1.insert(v.begin(), v.end()));
   MAP_FUN_AFTER(m1, m1.insert(m1.end(), PAIR(5, 5)));
+  MAP_COUT(m11);
+  MAP_FUN_AFTER(m11, m11.insert(mystl::sorted_unique, m1.begin(), m1.end()));
+  mystl::map<int, int> m12{ PAIR(1,1),PAIR(2,2) };
+  mystl::map<int, int> m13{ PAIR(2,20),PAIR(3,30) };
+  MAP_FUN_AFTER(m12, m12.merge(m13));
+  MAP_COUT(m13);
+  MAP_FUN_AFTER(m12, m13 = m12.extract_range(2, 3));
+  MAP_COUT(m13);
+  MAP_FUN_AFTER(m13, m13.insert(m12.extract(1)));
+  // merge 只重连节点，指向 source 的迭代器仍指向原来的元素：移入的属于 m15，键值重复的留在 m16
+  mystl::map<int, int> m15{ PAIR(1,1),PAIR(2,2) };
+  mystl::map<int, int> m16{ PAIR(2,20),PAIR(3,30) };
+  auto dup = m16.find(2);
+  auto moved = m16.find(3);
+  MAP_FUN_AFTER(m15, m15.merge(m16));
+  MAP_VALUE(*dup);
+  MAP_VALUE(*moved);
+  std::cout << std::boolalpha;
+  FUN_VALUE((dup == m16.begin()));
+  FUN_VALUE((moved == m15.find(3)));
+  std::cout << std::noboolalpha;
+  // 从节点池分配节点：merge 留下的重复元素移回 source 的节点池，摘下的节点可以插入未开启节点池的 map
+  mystl::map<int, int, mystl::less<int>, false, true> m18{ PAIR(4,40),PAIR(5,50),PAIR(6,60) };
+  mystl::map<int, int, mystl::less<int>, false, true> m19{ PAIR(5,5),PAIR(7,70) };
+  MAP_FUN_AFTER(m18, m18.merge(m19));
+  MAP_COUT(m19);
+  MAP_FUN_AFTER(m13, m13.insert(m18.extract(4)));
+  // 节点句柄可以比源容器活得更久
+  auto m17 = new mystl::map<int, int>{ PAIR(7,70),PAIR(8,80) };
+  auto nh = m17->extract(7);
+  delete m17;
+  FUN_VALUE(nh.mapped());
+  MAP_FUN_AFTER(m13, m13.insert(mystl::move(nh)));
+  mystl::map<mystl::string, int, mystl::less<>> m14;
+  m14.emplace("apple", 1);
+  m14.emplace("banana", 2);
+  m14.emplace("cherry", 3);
+  FUN_VALUE(m14.find("banana")->second);
+  FUN_VALUE(m14.count("durian"));
+  FUN_VALUE(m14.lower_bound("b")->second);
+  FUN_VALUE(m14.upper_bound("banana")->second);
   FUN_VALUE(m1.count(1));
   MAP_VALUE(*m1.find(3));
   MAP_VALUE(*m1.lower_bound(3));
@@ -97,6 +405,12 @@ void map_test()
   FUN_VALUE(m1[1]);
   MAP_FUN_AFTER(m1, m1[1] = 3);
   FUN_VALUE(m1.at(1));
+  MAP_FUN_AFTER(m1, m1.try_emplace(1, 10));
+  MAP_FUN_AFTER(m1, m1.try_emplace(4, 40));
+  MAP_FUN_AFTER(m1, m1.insert_or_assign(1, 10));
+  mystl::map<int, pinned> m20;
+  m20.try_emplace(1, 10);
+  FUN_VALUE(m20.try_emplace(1, 20).first->second.v);
   std::cout << std::boolalpha;
   FUN_VALUE(m1.empty());
   std::cout << std::noboolalpha;
@@ -114,6 +428,37 @@ void map_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|    sorted build     |";
+#if LARGER_TEST_DATA_ON
+  MAP_BUILD_TEST(LEN1 _L, LEN2 _L, LEN3 _L);
+#else
+  MAP_BUILD_TEST(LEN1 _M, LEN2 _M, LEN3 _M);
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+#if LARGER_TEST_DATA_ON
+  lru_migrate_test<mystl::map<int, mystl::string>>(LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  lru_migrate_test<mystl::map<int, mystl::string>>(LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+  const char* cstr_names[2] = { "|    less<string>     |", "|       less<>        |" };
+#if LARGER_TEST_DATA_ON
+  cstr_lookup_test<mystl::map<mystl::string, int>, mystl::map<mystl::string, int, mystl::less<>>>(
+    cstr_names, LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  cstr_lookup_test<mystl::map<mystl::string, int>, mystl::map<mystl::string, int, mystl::less<>>>(
+    cstr_names, LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+#if LARGER_TEST_DATA_ON
+  dup_ingest_test<mystl::map<int, mystl::string>>(LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  dup_ingest_test<mystl::map<int, mystl::string>>(LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+#if LARGER_TEST_DATA_ON
+  pool_test(LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  pool_test(LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
   PASSED;
 #endif
   std::cout << "[------------------ End container test : map -------------------]" << std::endl;
@@ -171,6 +516,8 @@ void multimap_test()
   MAP_FUN_AFTER(m1, m1.clear());
   MAP_FUN_AFTER(m1, m1.swap(m9));
   MAP_FUN_AFTER(m1, m1.insert(PAIR(3, 3)));
+  MAP_FUN_AFTER(m1, m1.insert(m10.extract(2)));
+  MAP_FUN_AFTER(m1, m1.merge(m10));
   MAP_VALUE(*m1.begin());
   MAP_VALUE(*m1.rbegin());
   std::cout << std::boolalpha;
@@ -0,0 +1,235 @@
+﻿#ifndef MYSTL_MMAP_VECTOR_TEST_H_
+#define MYSTL_MMAP_VECTOR_TEST_H_
+
+// mmap_vector test : 测试 mmap_vector 的接口，
+// 以及从文本文件解析到 vector 与直接映射 mmap_vector 文件的冷启动加载耗时
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "../MySTL/mmap_vector.h"
+#include "../MySTL/vector.h"
+#include "test.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace mystl
+{
+namespace test
+{
+namespace mmap_vector_test
+{
+
+#if defined(__linux__)
+
+// 测试用的文件，测试结束后删除
+const char* mmap_api_file  = "mystl_mmap_vector_api.bin";
+const char* mmap_text_file = "mystl_mmap_vector_load.txt";
+const char* mmap_bin_file  = "mystl_mmap_vector_load.bin";
+
+// 累加读到的数据，防止被编译器优化掉
+long long mmap_sink = 0;
+
+// 把文件写回磁盘并从页缓存中清除，模拟进程冷启动时数据还不在内存中
+void drop_page_cache(const char* path)
+{
+  const int fd = ::open(path, O_RDONLY);
+  if (fd == -1)
+    return;
+  ::fdatasync(fd);
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  ::close(fd);
+}
+
+// 把同一组 n 个整数分别写成每行一个的文本文件和 mmap_vector 文件
+void mmap_prepare(size_t n)
+{
+  std::FILE* f = std::fopen(mmap_text_file, "w");
+  mystl::mmap_vector<int> v(mmap_bin_file, mystl::mmap_mode::truncate);
+  v.reserve(n);
+  unsigned seed = 1;
+  for (size_t i = 0; i < n; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    const int x = static_cast<int>(seed >> 1);
+    std::fprintf(f, "%d\n", x);
+    v.push_back(x);
+  }
+  std::fclose(f);
+}
+
+// 从 start 到现在经过的墙上时间(ms)，冷启动的耗时主要是等待磁盘，clock() 统计不到
+int mmap_elapsed(std::chrono::steady_clock::time_point start)
+{
+  return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start).count());
+}
+
+// 三种加载方式的耗时(ms)依次存入 ms：
+// 读入文本并逐个解析到 vector，只读打开 mmap_vector，只读打开 mmap_vector 并遍历全部元素
+void mmap_load_run(size_t n, int ms[3])
+{
+  long long sum = 0;
+  drop_page_cache(mmap_text_file);
+  auto start = std::chrono::steady_clock::now();
+  {
+    std::FILE* f = std::fopen(mmap_text_file, "r");
+    std::fseek(f, 0, SEEK_END);
+    const size_t len = static_cast<size_t>(std::ftell(f));
+    std::fseek(f, 0, SEEK_SET);
+    mystl::vector<char> text;
+    text.resize_default_init(len + 1);
+    text[std::fread(text.data(), 1, len, f)] = '\0';
+    std::fclose(f);
+    mystl::vector<int> v;
+    v.reserve(n);
+    char* p = text.data();
+    char* e = p;
+    for (long x = std::strtol(p, &e, 10); e != p; x = std::strtol(p, &e, 10))
+    {
+      v.push_back(static_cast<int>(x));
+      p = e;
+    }
+    sum += v.size() + v.back();
+  }
+  ms[0] = mmap_elapsed(start);
+
+  drop_page_cache(mmap_bin_file);
+  start = std::chrono::steady_clock::now();
+  {
+    mystl::mmap_vector<int> v(mmap_bin_file);
+    sum += v.size();
+  }
+  ms[1] = mmap_elapsed(start);
+
+  drop_page_cache(mmap_bin_file);
+  start = std::chrono::steady_clock::now();
+  {
+    mystl::mmap_vector<int> v(mmap_bin_file);
+    for (auto it = v.begin(); it != v.end(); ++it)
+      sum += *it;
+  }
+  ms[2] = mmap_elapsed(start);
+  mmap_sink += sum;
+}
+
+#endif // __linux__
+
+void mmap_vector_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : mmap_vector ---------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+#if defined(__linux__)
+  int a[] = { 1,2,3,4,5 };
+  std::cout << std::boolalpha;
+  {
+    mystl::mmap_vector<int> v1(mmap_api_file, mystl::mmap_mode::truncate);
+    FUN_VALUE(v1.is_open());
+    FUN_VALUE(v1.read_only());
+    FUN_AFTER(v1, v1.push_back(1));
+    FUN_AFTER(v1, v1.emplace_back(2));
+    FUN_AFTER(v1, v1.insert(v1.begin(), 0));
+    FUN_AFTER(v1, v1.insert(v1.end(), 2, 3));
+    FUN_AFTER(v1, v1.insert(v1.begin() + 1, a, a + 5));
+    FUN_AFTER(v1, v1.emplace(v1.begin(), -1));
+    FUN_AFTER(v1, v1.pop_back());
+    FUN_AFTER(v1, v1.erase(v1.begin()));
+    FUN_AFTER(v1, v1.erase(v1.begin() + 1, v1.begin() + 3));
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.shrink_to_fit());
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.reserve(100));
+    FUN_VALUE(v1.capacity());
+    FUN_AFTER(v1, v1.resize(10, 6));
+    FUN_AFTER(v1, v1.resize(8));
+    FUN_VALUE(v1.front());
+    FUN_VALUE(v1.back());
+    FUN_VALUE(v1[1]);
+    FUN_VALUE(v1.at(2));
+    FUN_VALUE(v1.size());
+    v1.sync();
+  }
+  mystl::mmap_vector<int> v2(mmap_api_file);
+  COUT(v2);
+  FUN_VALUE(v2.read_only());
+  FUN_VALUE(v2.size());
+  FUN_VALUE(v2.capacity());
+  try
+  {
+    v2.push_back(7);
+  }
+  catch (const std::runtime_error& e)
+  {
+    std::cout << " v2.push_back(7) : " << e.what() << std::endl;
+  }
+  try
+  {
+    mystl::mmap_vector<double> v3(mmap_api_file);
+  }
+  catch (const std::runtime_error& e)
+  {
+    std::cout << " mmap_vector<double> v3 : " << e.what() << std::endl;
+  }
+  mystl::mmap_vector<int> v4(mmap_api_file, mystl::mmap_mode::read_write);
+  FUN_AFTER(v4, v4.assign({ 9,8,7 }));
+  mystl::mmap_vector<int> v5(std::move(v4));
+  FUN_VALUE(v4.is_open());
+  COUT(v5);
+  FUN_AFTER(v5, v5.close());
+  FUN_VALUE(v5.is_open());
+  FUN_VALUE(v5.size());
+  std::cout << std::noboolalpha;
+  v2.close();
+  std::remove(mmap_api_file);
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[3][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    mmap_prepare(lens[k]);
+    mmap_load_run(lens[k], ms[k]);
+  }
+  std::remove(mmap_text_file);
+  std::remove(mmap_bin_file);
+  const char* names[3] = {
+    "|  parse into vector  |", "|  open mmap_vector   |", "|  open mmap + scan   |" };
+  std::cout << " load n ints with a cold page cache: text parsed into vector vs mmap_vector file" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   cold start load   |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (int c = 0; c < 3; ++c)
+  {
+    std::cout << names[c];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", ms[k][c]);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+#else
+  std::cout << " mmap_vector is only available on Linux" << std::endl;
+#endif // __linux__
+  std::cout << "[-------------- End container test : mmap_vector ---------------]" << std::endl;
+}
+
+} // namespace mmap_vector_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_MMAP_VECTOR_TEST_H_
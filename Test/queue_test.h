@@ -1,7 +1,7 @@
 ﻿#ifndef MYSTL_QUEUE_TEST_H_
 #define MYSTL_QUEUE_TEST_H_
 
-// queue test : 测试 queue, priority_queue 的接口和它们 push 的性能
+// queue test : 测试 queue, priority_queue 的接口和它们 push 的性能，以及 priority_queue 批量操作的性能
 
 #include <queue>
 
@@ -63,6 +63,84 @@ void p_queue_print(mystl::priority_queue<int> p)
   P_QUEUE_COUT(con);                             \
 } while(0)
 
+// priority_queue 批量操作的性能测试
+// push : 以每批 P_QUEUE_BATCH 个元素压入，直到累计压入 count 个元素
+// pop  : 先压入 count 个元素（不计时），再以每批 P_QUEUE_BATCH 个元素弹出，直到堆为空
+#define P_QUEUE_BATCH 4096
+
+#define P_QUEUE_PUSH_ONE(p, buf, n) do {                      \
+  for (size_t j = 0; j < n; ++j)                              \
+    p.push(buf[j]);                                           \
+} while(0)
+
+#define P_QUEUE_PUSH_BULK(p, buf, n) do {                     \
+  p.push_range(buf, buf + n);                                 \
+} while(0)
+
+#define P_QUEUE_POP_ONE(p, buf, n) do {                       \
+  for (size_t j = 0; j < n && !p.empty(); ++j)                \
+  {                                                           \
+    buf[j] = p.top();                                         \
+    p.pop();                                                  \
+  }                                                           \
+} while(0)
+
+#define P_QUEUE_POP_BULK(p, buf, n) do {                      \
+  p.pop_n(n, buf);                                            \
+} while(0)
+
+#define P_QUEUE_PUSH_DO_TEST(way, count) do {                 \
+  srand((int)time(0));                                        \
+  clock_t start, end;                                         \
+  mystl::priority_queue<int> p;                               \
+  mystl::vector<int> data(count);                             \
+  char buf[10];                                               \
+  for (size_t i = 0; i < count; ++i)                          \
+    data[i] = rand();                                         \
+  start = clock();                                            \
+  for (size_t i = 0; i < count; i += P_QUEUE_BATCH)           \
+    way(p, (data.data() + i), mystl::min(count - i,           \
+                     static_cast<size_t>(P_QUEUE_BATCH)));    \
+  end = clock();                                              \
+  int n = static_cast<int>(static_cast<double>(end - start)   \
+      / CLOCKS_PER_SEC * 1000);                               \
+  std::snprintf(buf, sizeof(buf), "%d", n);                   \
+  std::string t = buf;                                        \
+  t += "ms    |";                                             \
+  std::cout << std::setw(WIDE) << t;                          \
+} while(0)
+
+#define P_QUEUE_POP_DO_TEST(way, count) do {                  \
+  srand((int)time(0));                                        \
+  clock_t start, end;                                         \
+  mystl::priority_queue<int> p;                               \
+  mystl::vector<int> data(P_QUEUE_BATCH);                     \
+  char buf[10];                                               \
+  for (size_t i = 0; i < count; ++i)                          \
+    p.push(rand());                                           \
+  start = clock();                                            \
+  while (!p.empty())                                          \
+    way(p, data.data(), P_QUEUE_BATCH);                       \
+  end = clock();                                              \
+  int n = static_cast<int>(static_cast<double>(end - start)   \
+      / CLOCKS_PER_SEC * 1000);                               \
+  std::snprintf(buf, sizeof(buf), "%d", n);                   \
+  std::string t = buf;                                        \
+  t += "ms    |";                                             \
+  std::cout << std::setw(WIDE) << t;                          \
+} while(0)
+
+#define P_QUEUE_BULK_TEST(op, one, bulk, len1, len2, len3)    \
+  TEST_LEN(len1, len2, len3, WIDE);                           \
+  std::cout << "|     per element     |";                     \
+  P_QUEUE_##op##_DO_TEST(one, len1);                          \
+  P_QUEUE_##op##_DO_TEST(one, len2);                          \
+  P_QUEUE_##op##_DO_TEST(one, len3);                          \
+  std::cout << "\n|        batch        |";                  \
+  P_QUEUE_##op##_DO_TEST(bulk, len1);                         \
+  P_QUEUE_##op##_DO_TEST(bulk, len2);                         \
+  P_QUEUE_##op##_DO_TEST(bulk, len3);
+
 void queue_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -162,6 +240,12 @@ void priority_test()
   }
   P_QUEUE_FUN_AFTER(p1, p1.swap(p4));
   P_QUEUE_FUN_AFTER(p1, p1.clear());
+  P_QUEUE_FUN_AFTER(p1, p1.push_range(a, a + 5));
+  P_QUEUE_FUN_AFTER(p1, p1.push_range(a + 2, a + 5));
+  int top[3] = { 0 };
+  P_QUEUE_FUN_AFTER(p1, p1.pop_n(3, top));
+  COUT(mystl::vector<int>(top, top + 3));
+  P_QUEUE_FUN_AFTER(p1, p1.pop_n(3, top));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -171,6 +255,22 @@ void priority_test()
   CON_TEST_P1(priority_queue<int>, push, rand(), LEN1 _LL, LEN2 _LL, LEN3 _LL);
 #else
   CON_TEST_P1(priority_queue<int>, push, rand(), LEN1 _L, LEN2 _L, LEN3 _L);
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|     push_range      |";
+#if LARGER_TEST_DATA_ON
+  P_QUEUE_BULK_TEST(PUSH, P_QUEUE_PUSH_ONE, P_QUEUE_PUSH_BULK, LEN1 _L, LEN2 _L, LEN3 _L);
+#else
+  P_QUEUE_BULK_TEST(PUSH, P_QUEUE_PUSH_ONE, P_QUEUE_PUSH_BULK, LEN1 _M, LEN2 _M, LEN3 _M);
+#endif
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|        pop_n        |";
+#if LARGER_TEST_DATA_ON
+  P_QUEUE_BULK_TEST(POP, P_QUEUE_POP_ONE, P_QUEUE_POP_BULK, LEN1 _L, LEN2 _L, LEN3 _L);
+#else
+  P_QUEUE_BULK_TEST(POP, P_QUEUE_POP_ONE, P_QUEUE_POP_BULK, LEN1 _M, LEN2 _M, LEN3 _M);
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
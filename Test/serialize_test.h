@@ -0,0 +1,340 @@
+﻿#ifndef MYSTL_SERIALIZE_TEST_H_
+#define MYSTL_SERIALIZE_TEST_H_
+
+// serialize test : 测试 serialize / deserialize 对各容器的往返读写，
+// 以及混合容器状态逐个元素经 iostream 读写与 serialize / deserialize 的耗时
+
+#include <cstdio>
+#include <ctime>
+#include <sstream>
+#include <stdexcept>
+
+#include "../MySTL/astring.h"
+#include "../MySTL/serialize.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace serialize_test
+{
+
+// 由多种容器组成的状态，用来测试往返读写的吞吐
+struct mixed_state
+{
+  mystl::vector<int>            ints;
+  mystl::string                 text;
+  mystl::vector<mystl::string>  words;
+  mystl::map<int, int>          ordered;
+  mystl::unordered_map<int, int> hashed;
+};
+
+} // namespace serialize_test
+} // namespace test
+
+// 自定义类型通过特化 serializer 接入
+template <>
+struct serializer<test::serialize_test::mixed_state>
+{
+  static void save(binary_writer& w, const test::serialize_test::mixed_state& s)
+  {
+    serialize(w, s.ints);
+    serialize(w, s.text);
+    serialize(w, s.words);
+    serialize(w, s.ordered);
+    serialize(w, s.hashed);
+  }
+  static void load(binary_reader& r, test::serialize_test::mixed_state& s)
+  {
+    deserialize(r, s.ints);
+    deserialize(r, s.text);
+    deserialize(r, s.words);
+    deserialize(r, s.ordered);
+    deserialize(r, s.hashed);
+  }
+};
+
+namespace test
+{
+namespace serialize_test
+{
+
+// 生成约 n 个 int 的状态：n 个 int，n 个字符，n / 16 个长 16 的字符串，各 n / 4 个元素的 map 与 unordered_map
+void mixed_fill(mixed_state& s, size_t n)
+{
+  unsigned seed = 1;
+  s.ints.reserve(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    s.ints.push_back(static_cast<int>(seed >> 1));
+  }
+  s.text.resize(n, 'x');
+  for (size_t i = 0; i < n / 16; ++i)
+    s.words.push_back(mystl::string(16, static_cast<char>('a' + i % 26)));
+  for (size_t i = 0; i < n / 4; ++i)
+  {
+    s.ordered.emplace_hint(s.ordered.end(), static_cast<int>(i), static_cast<int>(i * 3));
+    s.hashed.emplace(static_cast<int>(i), static_cast<int>(i * 3));
+  }
+}
+
+template <typename T>
+void put(std::ostream& os, const T& value)
+{
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void get(std::istream& is, T& value)
+{
+  is.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+// 逐个元素经 iostream 写入与读回，读回时逐个插入，不预留空间
+void stream_round_trip(const mixed_state& s, mixed_state& t)
+{
+  std::stringstream ss;
+  put(ss, s.ints.size());
+  for (auto x : s.ints)
+    put(ss, x);
+  put(ss, s.text.size());
+  for (auto c : s.text)
+    put(ss, c);
+  put(ss, s.words.size());
+  for (auto& w : s.words)
+  {
+    put(ss, w.size());
+    for (auto c : w)
+      put(ss, c);
+  }
+  put(ss, s.ordered.size());
+  for (auto& p : s.ordered)
+  {
+    put(ss, p.first);
+    put(ss, p.second);
+  }
+  put(ss, s.hashed.size());
+  for (auto& p : s.hashed)
+  {
+    put(ss, p.first);
+    put(ss, p.second);
+  }
+
+  size_t n = 0;
+  int k = 0, v = 0;
+  char c = 0;
+  get(ss, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    get(ss, k);
+    t.ints.push_back(k);
+  }
+  get(ss, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    get(ss, c);
+    t.text.push_back(c);
+  }
+  get(ss, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    size_t len = 0;
+    get(ss, len);
+    t.words.emplace_back();
+    for (size_t j = 0; j < len; ++j)
+    {
+      get(ss, c);
+      t.words.back().push_back(c);
+    }
+  }
+  get(ss, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    get(ss, k);
+    get(ss, v);
+    t.ordered.emplace(k, v);
+  }
+  get(ss, n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    get(ss, k);
+    get(ss, v);
+    t.hashed.emplace(k, v);
+  }
+}
+
+int serialize_elapsed(clock_t start)
+{
+  return static_cast<int>(static_cast<double>(clock() - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 三种方式的耗时(ms)依次存入 ms：
+// 逐个元素经 iostream 写入并读回，serialize 写入内存，deserialize 从内存读回
+void round_trip_run(size_t n, int ms[3])
+{
+  mixed_state s;
+  mixed_fill(s, n);
+  clock_t start = clock();
+  {
+    mixed_state t;
+    stream_round_trip(s, t);
+  }
+  ms[0] = serialize_elapsed(start);
+
+  mystl::vector<char> buf;
+  start = clock();
+  {
+    mystl::binary_writer w(buf);
+    mystl::serialize(w, s);
+  }
+  ms[1] = serialize_elapsed(start);
+
+  start = clock();
+  {
+    mixed_state t;
+    mystl::binary_reader r(buf.data(), buf.size());
+    mystl::deserialize(r, t);
+  }
+  ms[2] = serialize_elapsed(start);
+}
+
+void serialize_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[--------------- Run container test : serialize ----------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,3,4,5 };
+  mystl::vector<int> v1(a, a + 5);
+  mystl::vector<mystl::string> v2{ "ab", "", "cde" };
+  mystl::list<int> l1(a, a + 5);
+  mystl::deque<int> d1(a, a + 5);
+  mystl::map<int, mystl::string> m1{ {1, "one"}, {2, "two"}, {3, "three"} };
+  mystl::multimap<int, int> m2{ {1, 1}, {1, 2}, {2, 3} };
+  mystl::set<int> s1(a, a + 5);
+  mystl::multiset<int> s2{ 3,1,3,2 };
+  mystl::unordered_map<int, int> u1{ {1, 10}, {2, 20}, {3, 30} };
+  mystl::unordered_set<int> u2(a, a + 5);
+  mystl::string str1("serialize");
+
+  mystl::vector<char> buf;
+  {
+    mystl::binary_writer w(buf);
+    mystl::serialize(w, v1);
+    mystl::serialize(w, v2);
+    mystl::serialize(w, l1);
+    mystl::serialize(w, d1);
+    mystl::serialize(w, m1);
+    mystl::serialize(w, m2);
+    mystl::serialize(w, s1);
+    mystl::serialize(w, s2);
+    mystl::serialize(w, u1);
+    mystl::serialize(w, u2);
+    mystl::serialize(w, str1);
+    FUN_VALUE(w.count());
+  }
+  mystl::vector<int> v3{ 9 };
+  mystl::vector<mystl::string> v4;
+  mystl::list<int> l2;
+  mystl::deque<int> d2;
+  mystl::map<int, mystl::string> m3;
+  mystl::multimap<int, int> m4;
+  mystl::set<int> s3;
+  mystl::multiset<int> s4;
+  mystl::unordered_map<int, int> u3;
+  mystl::unordered_set<int> u4;
+  mystl::string str2;
+  mystl::binary_reader r(buf.data(), buf.size());
+  mystl::deserialize(r, v3);
+  mystl::deserialize(r, v4);
+  mystl::deserialize(r, l2);
+  mystl::deserialize(r, d2);
+  mystl::deserialize(r, m3);
+  mystl::deserialize(r, m4);
+  mystl::deserialize(r, s3);
+  mystl::deserialize(r, s4);
+  mystl::deserialize(r, u3);
+  mystl::deserialize(r, u4);
+  mystl::deserialize(r, str2);
+  std::cout << std::boolalpha;
+  COUT(v3);
+  FUN_VALUE((v4 == v2));
+  COUT(l2);
+  COUT(d2);
+  FUN_VALUE((m3 == m1));
+  FUN_VALUE((m4 == m2));
+  COUT(s3);
+  COUT(s4);
+  FUN_VALUE(u3.size());
+  FUN_VALUE(u3[2]);
+  FUN_VALUE(u4.count(4));
+  STR_COUT(str2);
+  try
+  {
+    mystl::binary_reader r2(buf.data(), 12);
+    mystl::deserialize(r2, v3);
+  }
+  catch (const std::runtime_error& e)
+  {
+    std::cout << " deserialize(r2, v3) : " << e.what() << std::endl;
+  }
+  std::FILE* f = std::tmpfile();
+  if (f != nullptr)
+  {
+    {
+      mystl::binary_writer w(f);
+      w.write_size(uint64_t(1) << 40);  // 元素个数远超文件中的数据
+      mystl::serialize(w, 7);
+    }
+    std::rewind(f);
+    try
+    {
+      mystl::binary_reader r3(f);
+      mystl::deserialize(r3, v3);
+    }
+    catch (const std::runtime_error& e)
+    {
+      std::cout << " deserialize(r3, v3) : " << e.what() << std::endl;
+    }
+    std::fclose(f);
+  }
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[3][3];
+  for (size_t k = 0; k < 3; ++k)
+    round_trip_run(lens[k], ms[k]);
+  const char* names[3] = {
+    "| iostream round trip |", "| serialize to memory |", "|  deserialize state  |" };
+  std::cout << " round trip of a mixed state (vector, string, map, unordered_map) of about n ints" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|  mixed round trip   |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (int c = 0; c < 3; ++c)
+  {
+    std::cout << names[c];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", ms[k][c]);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[--------------- End container test : serialize ----------------]" << std::endl;
+}
+
+} // namespace serialize_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_SERIALIZE_TEST_H_
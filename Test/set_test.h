@@ -1,9 +1,11 @@
 ﻿#ifndef MYSTL_SET_TEST_H_
 #define MYSTL_SET_TEST_H_
 
-// set test : 测试 set, multiset 的接口与它们 insert 的性能
+// set test : 测试 set, multiset 的接口与它们 insert 的性能，set 的 merge 与逐个插入的性能，
+//            以及开启排名的 multiset 的插入和排名查询的性能
 
 #include <set>
+#include <ctime>
 
 #include "../MySTL/set.h"
 #include "test.h"
@@ -15,6 +17,89 @@ namespace test
 namespace set_test
 {
 
+// 排名查询的次数
+#define SET_RANK_QUERY 10
+
+// 累加查询的结果，防止被编译器优化掉
+size_t set_rank_sink = 0;
+
+// 向 Set 插入 n 个随机数，再做 SET_RANK_QUERY 次排名查询，两个阶段的耗时(ms)依次存入 ms
+// 开启排名时用 rank，否则用 mystl::distance(begin(), lower_bound(key))
+template <typename Set>
+void set_rank_run(size_t n, int ms[2], mystl::m_true_type)
+{
+  Set s;
+  srand(1);
+  clock_t start = clock();
+  for (size_t i = 0; i < n; ++i)
+    s.emplace(rand());
+  clock_t end = clock();
+  ms[0] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  start = clock();
+  for (size_t i = 0; i < SET_RANK_QUERY; ++i)
+    set_rank_sink += s.rank(rand());
+  end = clock();
+  ms[1] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+template <typename Set>
+void set_rank_run(size_t n, int ms[2], mystl::m_false_type)
+{
+  Set s;
+  srand(1);
+  clock_t start = clock();
+  for (size_t i = 0; i < n; ++i)
+    s.emplace(rand());
+  clock_t end = clock();
+  ms[0] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  start = clock();
+  for (size_t i = 0; i < SET_RANK_QUERY; ++i)
+    set_rank_sink += mystl::distance(s.begin(), s.lower_bound(rand()));
+  end = clock();
+  ms[1] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 合并时较小一方的元素个数为较大一方的 1 / SET_MERGE_RATIO
+#define SET_MERGE_RATIO 10
+
+// 把 n / SET_MERGE_RATIO 个随机数并入含 n 个随机数的 set，分别用 merge 和逐个 insert，耗时(ms)依次存入 ms
+void set_merge_run(size_t n, int ms[2])
+{
+  mystl::set<int> big, big2;
+  mystl::set<int> small, small2;
+  srand(1);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const int x = rand();
+    big.emplace(x);
+    big2.emplace(x);
+  }
+  for (size_t i = 0; i < n / SET_MERGE_RATIO; ++i)
+  {
+    const int x = rand();
+    small.emplace(x);
+    small2.emplace(x);
+  }
+  clock_t start = clock();
+  big.merge(small);
+  clock_t end = clock();
+  ms[0] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  start = clock();
+  for (auto it = small2.begin(); it != small2.end(); ++it)
+    big2.insert(*it);
+  small2.clear();
+  end = clock();
+  ms[1] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 输出一格耗时
+void set_cell(int ms)
+{
+  char buf[16];
+  std::snprintf(buf, sizeof(buf), "%dms    |", ms);
+  std::cout << std::setw(WIDE) << buf;
+}
+
 void set_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -70,6 +155,18 @@ void set_test()
   std::cout << std::noboolalpha;
   FUN_VALUE(s1.size());
   FUN_VALUE(s1.max_size());
+  mystl::set<int> s11{ 1,3,5,7,9 };
+  mystl::set<int> s12{ 2,3,4,5,6 };
+  mystl::set<int> s13;
+  FUN_AFTER(s11, s11.merge(s12));
+  COUT(s12);
+  FUN_AFTER(s11, s13 = s11.extract_range(3, 6));
+  COUT(s13);
+  FUN_AFTER(s13, s13.subtract(s12));
+  FUN_AFTER(s11, s13 = s11.split(6));
+  FUN_AFTER(s11, s11.join(s13));
+  FUN_AFTER(s11, s11.intersect(mystl::set<int>{ 2,7,8 }));
+  FUN_AFTER(s12, s12.insert(s11.extract(7)));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -82,6 +179,25 @@ void set_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _L, LEN2 _L, LEN3 _L };
+#else
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#endif
+  int ms[3][2];
+  for (size_t k = 0; k < 3; ++k)
+    set_merge_run(lens[k], ms[k]);
+  std::cout << " merge n / " << SET_MERGE_RATIO << " random keys into n random keys" << std::endl;
+  std::cout << "|     set  merge      |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  std::cout << "|               merge |";
+  for (size_t k = 0; k < 3; ++k)
+    set_cell(ms[k][0]);
+  std::cout << "\n|         insert each |";
+  for (size_t k = 0; k < 3; ++k)
+    set_cell(ms[k][1]);
+  std::cout << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
 #endif
   std::cout << "[------------------ End container test : set -------------------]" << std::endl;
@@ -142,6 +258,22 @@ void multiset_test()
   std::cout << std::noboolalpha;
   FUN_VALUE(s1.size());
   FUN_VALUE(s1.max_size());
+  mystl::ranked_multiset<int> s11{ 5,1,3,3,9,7 };
+  COUT(s11);
+  FUN_VALUE(*s11.nth(0));
+  FUN_VALUE(*s11.nth(3));
+  FUN_VALUE(s11.rank(3));
+  FUN_VALUE(s11.rank(4));
+  FUN_VALUE(s11.index_of(s11.find(7)));
+  FUN_VALUE(s11.distance(s11.lower_bound(3), s11.end()));
+  FUN_AFTER(s11, s11.erase(3));
+  FUN_VALUE(*s11.nth(2));
+  mystl::multiset<int> s12{ 1,3,3,5 };
+  mystl::multiset<int> s13{ 3,4 };
+  FUN_AFTER(s12, s12.merge(s13));
+  FUN_AFTER(s12, s13 = s12.split(4));
+  COUT(s13);
+  FUN_AFTER(s12, s12.insert(s13.extract(s13.begin())));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -154,6 +286,32 @@ void multiset_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[2][3][2];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    set_rank_run<mystl::multiset<int>>(lens[k], ms[0][k], mystl::m_false_type());
+    set_rank_run<mystl::ranked_multiset<int>>(lens[k], ms[1][k], mystl::m_true_type());
+  }
+  std::cout << " rank = " << SET_RANK_QUERY << " queries, plain uses distance(begin, lower_bound)" << std::endl;
+  std::cout << "|  multiset / ranked  |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  const char* names[2] = { "emplace", "rank" };
+  for (size_t op = 0; op < 2; ++op)
+  {
+    std::cout << "|" << std::setw(12) << names[op] << "   plain |";
+    for (size_t k = 0; k < 3; ++k)
+      set_cell(ms[0][k][op]);
+    std::cout << "\n|" << std::setw(12) << names[op] << "  ranked |";
+    for (size_t k = 0; k < 3; ++k)
+      set_cell(ms[1][k][op]);
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
   PASSED;
 #endif
   std::cout << "[---------------- End container test : multiset ----------------]" << std::endl;
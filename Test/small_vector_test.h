@@ -0,0 +1,200 @@
+﻿#ifndef MYSTL_SMALL_VECTOR_TEST_H_
+#define MYSTL_SMALL_VECTOR_TEST_H_
+
+// small_vector test : 测试 small_vector 与 span 的接口，
+// 以及大量短生命周期的小向量在 vector 与 small_vector 下的耗时和堆分配次数
+
+#include <ctime>
+
+#include "../MySTL/small_vector.h"
+#include "../MySTL/span.h"
+#include "../MySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace small_vector_test
+{
+
+// 每个短生命周期向量装入的元素个数，循环使用，大多数不超过 8 个
+const size_t small_sizes[16] = { 1, 3, 5, 2, 7, 4, 6, 0, 8, 3, 12, 5, 2, 20, 6, 4 };
+
+// 累加的结果，防止被编译器优化掉
+long long small_sink = 0;
+
+// 同时接受 vector 与 small_vector 的代码
+long long span_sum(mystl::span<const int> s)
+{
+  long long sum = 0;
+  for (auto x : s)
+    sum += x;
+  return sum;
+}
+
+// 依次创建 count 个 Vec，装入 small_sizes 中对应个数的元素后求和并销毁，返回耗时(ms)
+template <typename Vec>
+int small_run(size_t count)
+{
+  long long sum = 0;
+  clock_t start = clock();
+  for (size_t i = 0; i < count; ++i)
+  {
+    Vec v;
+    const size_t n = small_sizes[i & 15];
+    for (size_t j = 0; j < n; ++j)
+      v.push_back(static_cast<int>(i + j));
+    sum += span_sum(v);
+  }
+  clock_t end = clock();
+  small_sink += sum;
+  return static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 与 small_run 相同的操作，统计堆分配的次数：data() 每指向一块对象之外的新空间记一次
+template <typename Vec>
+size_t small_allocs(size_t count)
+{
+  size_t allocs = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    Vec v;
+    const char* self = reinterpret_cast<const char*>(&v);
+    const int* last = nullptr;
+    const size_t n = small_sizes[i & 15];
+    for (size_t j = 0; j <= n; ++j)
+    {
+      const int* p = v.data();
+      const char* q = reinterpret_cast<const char*>(p);
+      if (p != last && p != nullptr && !(q >= self && q < self + sizeof(Vec)))
+        ++allocs;
+      last = p;
+      if (j < n)
+        v.push_back(static_cast<int>(j));
+    }
+  }
+  return allocs;
+}
+
+void small_vector_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : small_vector --------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,3,4,5 };
+  mystl::small_vector<int, 4> v1;
+  mystl::small_vector<int, 4> v2(3);
+  mystl::small_vector<int, 4> v3(6, 1);
+  mystl::small_vector<int, 4> v4(a, a + 5);
+  mystl::small_vector<int, 4> v5(v4);
+  mystl::small_vector<int, 4> v6(std::move(v5));
+  mystl::small_vector<int, 4> v7{ 1,2,3 };
+  mystl::small_vector<int, 4> v8, v9;
+  v8 = v3;
+  v9 = std::move(v7);
+
+  std::cout << std::boolalpha;
+  FUN_AFTER(v1, v1.push_back(1));
+  FUN_AFTER(v1, v1.emplace_back(2));
+  FUN_AFTER(v1, v1.insert(v1.begin(), 0));
+  FUN_VALUE(v1.is_inline());
+  FUN_VALUE(v1.capacity());
+  FUN_AFTER(v1, v1.insert(v1.end(), 2, 3));
+  FUN_VALUE(v1.is_inline());
+  FUN_VALUE(v1.capacity());
+  FUN_AFTER(v1, v1.insert(v1.begin() + 1, a, a + 3));
+  FUN_AFTER(v1, v1.emplace(v1.begin(), -1));
+  FUN_AFTER(v1, v1.pop_back());
+  FUN_AFTER(v1, v1.erase(v1.begin()));
+  FUN_AFTER(v1, v1.erase(v1.begin(), v1.begin() + 4));
+  FUN_AFTER(v1, v1.shrink_to_fit());
+  FUN_VALUE(v1.is_inline());
+  FUN_VALUE(v1.capacity());
+  FUN_AFTER(v1, v1.reserve(10));
+  FUN_VALUE(v1.is_inline());
+  FUN_AFTER(v1, v1.resize(6, 6));
+  FUN_AFTER(v1, v1.swap(v9));
+  FUN_AFTER(v1, v1.assign(a, a + 4));
+  FUN_VALUE(v1.front());
+  FUN_VALUE(v1.back());
+  FUN_VALUE(v1[1]);
+  FUN_VALUE(v1.at(2));
+  FUN_VALUE(v1.size());
+  FUN_VALUE((v1 == v4));
+  FUN_VALUE((v1 < v4));
+  COUT(v2);
+  COUT(v3);
+  COUT(v6);
+  COUT(v8);
+  COUT(v9);
+  FUN_AFTER(v1, v1.clear());
+  FUN_VALUE(v1.empty());
+
+  mystl::vector<int> v10(a, a + 5);
+  mystl::span<const int> s1(v10);
+  mystl::span<const int> s2(v4);
+  mystl::span<int> s3(a);
+  COUT(s1);
+  COUT(s2.subspan(1, 3));
+  COUT(s3.last(2));
+  FUN_VALUE(span_sum(v10));
+  FUN_VALUE(span_sum(v4));
+  FUN_VALUE(span_sum(mystl::make_span(a)));
+  std::cout << std::noboolalpha;
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+  int ms[3][3];
+  size_t allocs[3][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    ms[0][k] = small_run<mystl::vector<int>>(lens[k]);
+    ms[1][k] = small_run<mystl::small_vector<int, 4>>(lens[k]);
+    ms[2][k] = small_run<mystl::small_vector<int, 8>>(lens[k]);
+    allocs[0][k] = small_allocs<mystl::vector<int>>(lens[k]);
+    allocs[1][k] = small_allocs<mystl::small_vector<int, 4>>(lens[k]);
+    allocs[2][k] = small_allocs<mystl::small_vector<int, 8>>(lens[k]);
+  }
+  const char* names[3] = {
+    "|       vector        |", "|   small_vector<4>   |", "|   small_vector<8>   |" };
+  std::cout << " create, push_back 0-20 ints (mostly <= 8), sum through span, destroy" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|   time (vectors)    |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (int c = 0; c < 3; ++c)
+  {
+    std::cout << names[c];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", ms[c][k]);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| heap allocations    |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (int c = 0; c < 3; ++c)
+  {
+    std::cout << names[c];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      char buf[24];
+      std::snprintf(buf, sizeof(buf), "%zu   |", allocs[c][k]);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << std::endl;
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------------- End container test : small_vector --------------]" << std::endl;
+}
+
+} // namespace small_vector_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_SMALL_VECTOR_TEST_H_
@@ -81,6 +81,10 @@ void string_test()
   FUN_VALUE(str.size());
   STR_FUN_AFTER(str, str.resize(20, 'x'));
   FUN_VALUE(str.size());
+  STR_FUN_AFTER(str, str.resize_default_init(5));
+  auto write_tail = [](char* p, size_t n) { p[5] = '-'; p[6] = 'o'; p[7] = 'k'; return n - 2; };
+  STR_FUN_AFTER(str, str.resize_and_overwrite(10, write_tail));
+  FUN_VALUE(str.size());
   STR_FUN_AFTER(str, str.clear());
 
   STR_FUN_AFTER(str, str = "string");
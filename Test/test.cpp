@@ -11,15 +11,25 @@
 #include "algorithm_performance_test.h"
 #include "algorithm_test.h"
 #include "vector_test.h"
+#include "small_vector_test.h"
+#include "mmap_vector_test.h"
 #include "list_test.h"
+#include "unrolled_list_test.h"
+#include "intrusive_test.h"
 #include "deque_test.h"
 #include "queue_test.h"
+#include "concurrent_queue_test.h"
 #include "stack_test.h"
 #include "map_test.h"
 #include "set_test.h"
+#include "btree_test.h"
+#include "flat_test.h"
 #include "unordered_map_test.h"
 #include "unordered_set_test.h"
+#include "concurrent_unordered_map_test.h"
+#include "concurrent_map_test.h"
 #include "string_test.h"
+#include "serialize_test.h"
 
 int main()
 {
@@ -30,20 +40,30 @@ int main()
   RUN_ALL_TESTS();
   algorithm_performance_test::algorithm_performance_test();
   vector_test::vector_test();
+  small_vector_test::small_vector_test();
+  mmap_vector_test::mmap_vector_test();
   list_test::list_test();
+  unrolled_list_test::unrolled_list_test();
+  intrusive_test::intrusive_test();
   deque_test::deque_test();
   queue_test::queue_test();
   queue_test::priority_test();
+  concurrent_queue_test::concurrent_queue_test();
   stack_test::stack_test();
   map_test::map_test();
   map_test::multimap_test();
   set_test::set_test();
   set_test::multiset_test();
+  btree_test::btree_test();
+  flat_test::flat_test();
   unordered_map_test::unordered_map_test();
   unordered_map_test::unordered_multimap_test();
   unordered_set_test::unordered_set_test();
   unordered_set_test::unordered_multiset_test();
+  concurrent_unordered_map_test::concurrent_unordered_map_test();
+  concurrent_map_test::concurrent_map_test();
   string_test::string_test();
+  serialize_test::serialize_test();
 
 #if defined(_MSC_VER) && defined(_DEBUG)
   _CrtDumpMemoryLeaks();
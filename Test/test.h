@@ -613,7 +613,7 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
   std::cout << std::setw(WIDE) << t;                         \
 } while(0)
 
-#define LIST_SORT_DO_TEST(mode, count) do {                  \
+#define LIST_SORT_DO_TEST(mode, fun, count) do {             \
   srand((int)time(0));                                       \
   clock_t start, end;                                        \
   mode::list<int> l;                                         \
@@ -621,7 +621,7 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
   for (size_t i = 0; i < count; ++i)                         \
     l.insert(l.end(), rand());                               \
   start = clock();                                           \
-  l.sort();                                                  \
+  l.fun();                                                   \
   end = clock();                                             \
   int n = static_cast<int>(static_cast<double>(end - start)  \
       / CLOCKS_PER_SEC * 1000);                              \
@@ -685,13 +685,17 @@ void test_len(size_t len1, size_t len2, size_t len3, size_t wide)
 #define LIST_SORT_TEST(len1, len2, len3)                     \
   TEST_LEN(len1, len2, len3, WIDE);                          \
   std::cout << "|         std         |";                    \
-  LIST_SORT_DO_TEST(std, len1);                              \
-  LIST_SORT_DO_TEST(std, len2);                              \
-  LIST_SORT_DO_TEST(std, len3);                              \
+  LIST_SORT_DO_TEST(std, sort, len1);                        \
+  LIST_SORT_DO_TEST(std, sort, len2);                        \
+  LIST_SORT_DO_TEST(std, sort, len3);                        \
   std::cout << "\n|        mystl        |";                  \
-  LIST_SORT_DO_TEST(mystl, len1);                            \
-  LIST_SORT_DO_TEST(mystl, len2);                            \
-  LIST_SORT_DO_TEST(mystl, len3);
+  LIST_SORT_DO_TEST(mystl, sort, len1);                      \
+  LIST_SORT_DO_TEST(mystl, sort, len2);                      \
+  LIST_SORT_DO_TEST(mystl, sort, len3);                      \
+  std::cout << "\n|    mystl buffer     |";                  \
+  LIST_SORT_DO_TEST(mystl, sort_by_buffer, len1);            \
+  LIST_SORT_DO_TEST(mystl, sort_by_buffer, len2);            \
+  LIST_SORT_DO_TEST(mystl, sort_by_buffer, len3);
 
 // 简单测试的宏定义
 #define TEST(testcase_name) \
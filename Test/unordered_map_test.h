@@ -1,9 +1,14 @@
 ﻿#ifndef MYSTL_UNORDERED_MAP_TEST_H_
 #define MYSTL_UNORDERED_MAP_TEST_H_
 
-// unordered_map test : 测试 unordered_map, unordered_multimap 的接口与它们 insert 的性能
+// unordered_map test : 测试 unordered_map, unordered_multimap 的接口与它们 insert 的性能，
+// 一次性 rehash 与渐进式 rehash 下单次插入的尾延迟，LRU 冷热迁移中使用节点句柄与否的性能，
+// 用 C 风格字符串查找时透明哈希函数的效果，以及重复键值占多数的写入中 try_emplace 与 emplace 的性能
 
+#include <algorithm>
+#include <chrono>
 #include <unordered_map>
+#include <vector>
 
 #include "../MySTL/unordered_map.h"
 #include "map_test.h"
@@ -16,6 +21,33 @@ namespace test
 namespace unordered_map_test
 {
 
+// 逐个插入 n 个元素，输出总耗时以及单次插入延迟的 p99 / p999 / max
+void rehash_latency_test(const char* name, bool incremental, size_t n)
+{
+  mystl::unordered_map<int, int> um;
+  um.incremental_rehash(incremental);
+  std::vector<long long> lat(n);
+  long long total = 0;
+  for (size_t i = 0; i < n; ++i)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    um.emplace(static_cast<int>(i), static_cast<int>(i));
+    const auto end = std::chrono::steady_clock::now();
+    lat[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    total += lat[i];
+  }
+  std::sort(lat.begin(), lat.end());
+  char buf[4][32];
+  std::snprintf(buf[0], sizeof(buf[0]), "%lldms", total / 1000000);
+  std::snprintf(buf[1], sizeof(buf[1]), "%.2fus", lat[n * 99 / 100] / 1000.0);
+  std::snprintf(buf[2], sizeof(buf[2]), "%.2fus", lat[n * 999 / 1000] / 1000.0);
+  std::snprintf(buf[3], sizeof(buf[3]), "%.2fms", lat[n - 1] / 1000000.0);
+  std::cout << "|" << name << "|";
+  for (auto& b : buf)
+    std::cout << std::setw(WIDE - 2) << b << " |";
+  std::cout << std::endl;
+}
+
 void unordered_map_test()
 {
   std::cout << "[===============================================================]" << std::endl;
@@ -63,6 +95,12 @@ void unordered_map_test()
   MAP_VALUE(*um1.begin());
   FUN_VALUE(um1.at(1));
   FUN_VALUE(um1[1]);
+  MAP_FUN_AFTER(um1, um1.try_emplace(1, 10));
+  MAP_FUN_AFTER(um1, um1.try_emplace(4, 40));
+  MAP_FUN_AFTER(um1, um1.insert_or_assign(1, 10));
+  mystl::unordered_map<int, map_test::pinned> um20;
+  um20.try_emplace(1, 10);
+  FUN_VALUE(um20.try_emplace(1, 20).first->second.v);
   std::cout << std::boolalpha;
   FUN_VALUE(um1.empty());
   std::cout << std::noboolalpha;
@@ -90,6 +128,40 @@ void unordered_map_test()
   FUN_VALUE(um1.max_load_factor());
   MAP_FUN_AFTER(um1, um1.max_load_factor(1.5f));
   FUN_VALUE(um1.max_load_factor());
+  MAP_FUN_AFTER(um2, um2.insert(um1.extract(3)));
+  MAP_FUN_AFTER(um2, um2.merge(um13));
+  MAP_COUT(um13);
+  mystl::unordered_map<mystl::string, int, mystl::string_hash, mystl::equal_to<>> um15;
+  um15.emplace("apple", 1);
+  um15.emplace("banana", 2);
+  FUN_VALUE(um15.find("banana")->second);
+  FUN_VALUE(um15.count("durian"));
+  std::cout << std::boolalpha;
+  FUN_VALUE(um1.incremental_rehash());
+  MAP_FUN_AFTER(um1, um1.incremental_rehash(true));
+  FUN_VALUE(um1.incremental_rehash());
+  std::cout << std::noboolalpha;
+  for (int i = 10; i < 1000; ++i)
+    um1.emplace(i, i);
+  FUN_VALUE(um1.size());
+  FUN_VALUE(um1.count(500));
+  FUN_VALUE(um1.bucket_count());
+  // 迁移进行中边遍历边删除，每个元素恰好访问一次
+  mystl::unordered_map<int, int> um16;
+  um16.incremental_rehash(true);
+  for (int i = 0; i < 2054; ++i)  // 最后一次插入触发扩容，迁移刚刚开始
+    um16.emplace(i, i);
+  size_t visits = 0;
+  for (auto it = um16.begin(); it != um16.end(); ++visits)
+  {
+    if (it->first % 2 == 0)
+      um16.erase(it++);
+    else
+      ++it;
+  }
+  FUN_VALUE(visits);
+  FUN_VALUE(um16.size());
+  FUN_VALUE(um16.count(1000));
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -102,6 +174,38 @@ void unordered_map_test()
 #endif
   std::cout << std::endl;
   std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t latency_len = LEN3 _M;
+#else
+  const size_t latency_len = LEN2 _M;
+#endif
+  std::cout << " " << latency_len << " emplace, per-call latency" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "|       rehash        |    total    |     p99     |    p999     |     max     |" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|-------------|" << std::endl;
+  rehash_latency_test("      one-shot       ", false, latency_len);
+  rehash_latency_test("     incremental     ", true, latency_len);
+  std::cout << "|---------------------|-------------|-------------|-------------|-------------|" << std::endl;
+#if LARGER_TEST_DATA_ON
+  map_test::lru_migrate_test<mystl::unordered_map<int, mystl::string>>(LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  map_test::lru_migrate_test<mystl::unordered_map<int, mystl::string>>(LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+  const char* cstr_names[2] = { "|    hash<string>     |", "|     string_hash     |" };
+#if LARGER_TEST_DATA_ON
+  map_test::cstr_lookup_test<mystl::unordered_map<mystl::string, int>,
+    mystl::unordered_map<mystl::string, int, mystl::string_hash, mystl::equal_to<>>>(
+    cstr_names, LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  map_test::cstr_lookup_test<mystl::unordered_map<mystl::string, int>,
+    mystl::unordered_map<mystl::string, int, mystl::string_hash, mystl::equal_to<>>>(
+    cstr_names, LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
+#if LARGER_TEST_DATA_ON
+  map_test::dup_ingest_test<mystl::unordered_map<int, mystl::string>>(LEN1 _M, LEN2 _M, LEN3 _M);
+#else
+  map_test::dup_ingest_test<mystl::unordered_map<int, mystl::string>>(LEN1 _S, LEN2 _S, LEN3 _S);
+#endif
   PASSED;
 #endif
   std::cout << "[-------------- End container test : unordered_map -------------]" << std::endl;
@@ -179,6 +283,9 @@ void unordered_multimap_test()
   FUN_VALUE(um1.max_load_factor());
   MAP_FUN_AFTER(um1, um1.max_load_factor(1.5f));
   FUN_VALUE(um1.max_load_factor());
+  MAP_FUN_AFTER(um2, um2.insert(um1.extract(3)));
+  MAP_FUN_AFTER(um2, um2.merge(um13));
+  MAP_COUT(um13);
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -83,6 +83,9 @@ void unordered_set_test()
   FUN_VALUE(us1.max_load_factor());
   FUN_AFTER(us1, us1.max_load_factor(1.5f));
   FUN_VALUE(us1.max_load_factor());
+  FUN_AFTER(us2, us2.insert(us1.extract(3)));
+  FUN_AFTER(us2, us2.merge(us13));
+  COUT(us13);
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
@@ -167,6 +170,9 @@ void unordered_multiset_test()
   FUN_VALUE(us1.max_load_factor());
   FUN_AFTER(us1, us1.max_load_factor(1.5f));
   FUN_VALUE(us1.max_load_factor());
+  FUN_AFTER(us2, us2.insert(us1.extract(3)));
+  FUN_AFTER(us2, us2.merge(us13));
+  COUT(us13);
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
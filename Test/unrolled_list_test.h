@@ -0,0 +1,172 @@
+﻿#ifndef MYSTL_UNROLLED_LIST_TEST_H_
+#define MYSTL_UNROLLED_LIST_TEST_H_
+
+// unrolled_list test : 测试 unrolled_list 的接口，
+// 以及 unrolled_list 与 list、vector 在遍历、中间插入、中间删除下的性能
+
+#include <ctime>
+
+#include "../MySTL/algo.h"
+#include "../MySTL/list.h"
+#include "../MySTL/unrolled_list.h"
+#include "../MySTL/vector.h"
+#include "test.h"
+
+namespace mystl
+{
+namespace test
+{
+namespace unrolled_list_test
+{
+
+// 遍历的轮数，以及在中间位置连续插入、删除的次数
+#define UNROLLED_SCAN_ROUNDS 10
+#define UNROLLED_MID_OPS     10000
+
+// 累加遍历的结果，防止被编译器优化掉
+long long unrolled_sink = 0;
+
+// 在 c 上依次做 UNROLLED_SCAN_ROUNDS 轮遍历、从中间位置连续插入 UNROLLED_MID_OPS 个元素、
+// 再从中间位置连续删除 UNROLLED_MID_OPS 个元素，三个阶段的耗时(ms)依次存入 ms
+template <typename Seq>
+void unrolled_run(Seq& c, int ms[3])
+{
+  long long sum = 0;
+  clock_t start = clock();
+  for (int r = 0; r < UNROLLED_SCAN_ROUNDS; ++r)
+  {
+    for (auto it = c.begin(); it != c.end(); ++it)
+      sum += *it;
+  }
+  clock_t end = clock();
+  ms[0] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+
+  auto it = c.begin();
+  mystl::advance(it, c.size() / 2);
+  start = clock();
+  for (int i = 0; i < UNROLLED_MID_OPS; ++i)
+    it = c.insert(it, i);
+  end = clock();
+  ms[1] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+
+  it = c.begin();
+  mystl::advance(it, c.size() / 2);
+  start = clock();
+  for (int i = 0; i < UNROLLED_MID_OPS; ++i)
+    it = c.erase(it);
+  end = clock();
+  ms[2] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  unrolled_sink += sum + c.size();
+}
+
+void unrolled_list_test()
+{
+  std::cout << "[===============================================================]" << std::endl;
+  std::cout << "[-------------- Run container test : unrolled_list -------------]" << std::endl;
+  std::cout << "[-------------------------- API test ---------------------------]" << std::endl;
+  int a[] = { 1,2,3,4,5 };
+  mystl::unrolled_list<int, 4> l1;
+  mystl::unrolled_list<int, 4> l2(5);
+  mystl::unrolled_list<int, 4> l3(5, 1);
+  mystl::unrolled_list<int, 4> l4(a, a + 5);
+  mystl::unrolled_list<int, 4> l5(l4);
+  mystl::unrolled_list<int, 4> l6(std::move(l5));
+  mystl::unrolled_list<int, 4> l7{ 1,2,3,4,5,6,7,8,9 };
+  mystl::unrolled_list<int, 4> l8;
+  l8 = l3;
+  mystl::unrolled_list<int, 4> l9;
+  l9 = std::move(l3);
+  mystl::unrolled_list<int> l10{ 1,2,3 };
+
+  FUN_AFTER(l1, l1.push_back(1));
+  FUN_AFTER(l1, l1.push_back(2));
+  FUN_AFTER(l1, l1.push_front(0));
+  FUN_AFTER(l1, l1.emplace_back(3));
+  FUN_AFTER(l1, l1.emplace_front(-1));
+  FUN_AFTER(l1, l1.insert(++l1.begin(), 10));
+  FUN_AFTER(l1, l1.emplace(l1.end(), 4));
+  FUN_VALUE(l1.chunk_count());
+  FUN_AFTER(l1, l1.erase(l1.begin()));
+  FUN_AFTER(l1, l1.erase(++l1.begin(), --l1.end()));
+  FUN_VALUE(l1.chunk_count());
+  FUN_AFTER(l1, l1.pop_front());
+  FUN_AFTER(l1, l1.pop_back());
+  FUN_AFTER(l1, l1.splice(l1.end(), l7));
+  FUN_AFTER(l1, l1.splice(++l1.begin(), l4));
+  FUN_VALUE(l1.size());
+  FUN_VALUE(l1.chunk_count());
+  FUN_VALUE(l7.size());
+  FUN_VALUE(l1.front());
+  FUN_VALUE(l1.back());
+  FUN_VALUE(*l1.rbegin());
+  FUN_AFTER(l1, l1.swap(l9));
+  FUN_AFTER(l1, l1.clear());
+  std::cout << std::boolalpha;
+  FUN_VALUE(l1.empty());
+  FUN_VALUE((l6 == l8));
+  FUN_VALUE((l6 < l8));
+  std::cout << std::noboolalpha;
+  COUT(l2);
+  COUT(l6);
+  COUT(l9);
+  FUN_VALUE(l10.chunk_capacity);
+  PASSED;
+#if PERFORMANCE_TEST_ON
+  std::cout << "[--------------------- Performance Testing ---------------------]" << std::endl;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[3][3][3];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    // 三种容器装入同一组有序的随机数，list 由随机序列 sort 得到，节点在内存中是打乱的
+    mystl::vector<int> v(lens[k]);
+    unsigned seed = 1;
+    for (size_t i = 0; i < v.size(); ++i)
+    {
+      seed = seed * 1103515245u + 12345u;
+      v[i] = static_cast<int>(seed >> 1);
+    }
+    mystl::list<int> l(v.begin(), v.end());
+    l.sort();
+    mystl::sort(v.begin(), v.end());
+    mystl::unrolled_list<int> u(v.begin(), v.end());
+    unrolled_run(v, ms[0][k]);
+    unrolled_run(l, ms[1][k]);
+    unrolled_run(u, ms[2][k]);
+  }
+  const char* names[3][3] = {
+    { "|   iterate   vector  |", "|   iterate    list   |", "|   iterate  unrolled |" },
+    { "|  mid insert vector  |", "|  mid insert  list   |", "|  mid insert unrolled|" },
+    { "|  mid erase  vector  |", "|  mid erase   list   |", "|  mid erase  unrolled|" } };
+  std::cout << " iterate = " << UNROLLED_SCAN_ROUNDS << " rounds, mid insert / erase = "
+    << UNROLLED_MID_OPS << " ops at the middle, int elements" << std::endl;
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  std::cout << "| vector/list/unrolled|";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (int op = 0; op < 3; ++op)
+  {
+    for (int c = 0; c < 3; ++c)
+    {
+      std::cout << names[op][c];
+      for (size_t k = 0; k < 3; ++k)
+      {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%dms    |", ms[c][k][op]);
+        std::cout << std::setw(WIDE) << buf;
+      }
+      std::cout << std::endl;
+    }
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|" << std::endl;
+  PASSED;
+#endif
+  std::cout << "[-------------- End container test : unrolled_list -------------]" << std::endl;
+}
+
+} // namespace unrolled_list_test
+} // namespace test
+} // namespace mystl
+#endif // !MYSTL_UNROLLED_LIST_TEST_H_
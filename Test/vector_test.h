@@ -1,10 +1,17 @@
 ﻿#ifndef MYTINYSTL_VECTOR_TEST_H_
 #define MYTINYSTL_VECTOR_TEST_H_
 
-// vector test : 测试 vector 的接口与 push_back 的性能
+// vector test : 测试 vector 的接口与 push_back 的性能，
+// vector<mystl::string> 扩容时按字节搬移与逐个移动构造的耗时，各扩容策略下 push_back 的耗时，
+// resize / resize_default_init / resize_and_overwrite 之后整体覆盖缓冲区的耗时，
+// 以及 vector<double> 使用 4KB 页与大页时顺序、随机访问的耗时
 
+#include <cstring>
+#include <ctime>
 #include <vector>
 
+#include "../MySTL/astring.h"
+#include "../MySTL/huge_page_allocator.h"
 #include "../MySTL/vector.h"
 #include "test.h"
 
@@ -15,6 +22,113 @@ namespace test
 namespace vector_test
 {
 
+// 与 mystl::string 相同，但没有 is_trivially_relocatable 特化，vector 扩容时逐个移动构造再析构
+struct moved_string
+{
+  mystl::string s;
+  explicit moved_string(const mystl::string& x) :s(x) {}
+};
+
+// 逐个 push_back n 个字符串，再把容量扩大一倍，两个阶段的耗时(ms)依次存入 ms
+template <typename T>
+void string_growth(size_t n, int ms[2])
+{
+  mystl::string s("relocate");
+  mystl::vector<T> v;
+  clock_t start = clock();
+  for (size_t i = 0; i < n; ++i)
+    v.push_back(T(s));
+  clock_t end = clock();
+  ms[0] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  start = clock();
+  v.reserve(v.capacity() * 2);
+  end = clock();
+  ms[1] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 不能按字节搬移的 int，vector 扩容时不走 realloc，逐个复制到新空间
+struct copied_int
+{
+  int v;
+  copied_int(int x) :v(x) {}
+  copied_int(const copied_int& rhs) :v(rhs.v) {}
+  copied_int& operator=(const copied_int&) = default;
+};
+
+// 逐个 push_back n 个元素的耗时(ms)
+template <typename Vec>
+int growth_run(size_t n)
+{
+  Vec v;
+  clock_t start = clock();
+  for (size_t i = 0; i < n; ++i)
+    v.push_back(static_cast<int>(i));
+  clock_t end = clock();
+  return static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 模拟 read()：按 64KB 一块把数据写入 [p, p + n)
+void fake_read(char* p, size_t n)
+{
+  static char block[65536] = { 1 };
+  for (size_t off = 0; off < n; off += sizeof(block))
+    std::memcpy(p + off, block, mystl::min(sizeof(block), n - off));
+}
+
+// 累加读到的数据，防止被编译器优化掉
+long long read_sink = 0;
+
+// 新建缓冲区，按 mode 把大小调整为 n 后整体覆盖，返回耗时(ms)
+// mode 0 : resize，1 : resize_default_init，2 : resize_and_overwrite
+template <typename Buf>
+int read_run(size_t n, int mode)
+{
+  clock_t start = clock();
+  Buf b;
+  if (mode == 0)
+  {
+    b.resize(n);
+    fake_read(&b[0], n);
+  }
+  else if (mode == 1)
+  {
+    b.resize_default_init(n);
+    fake_read(&b[0], n);
+  }
+  else
+  {
+    b.resize_and_overwrite(n, [](char* p, size_t k) { fake_read(p, k); return k; });
+  }
+  read_sink += b[n - 1];
+  clock_t end = clock();
+  return static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+}
+
+// 在 n 个 double 上顺序遍历一轮、随机读取 n 次，两个阶段的耗时(ms)依次存入 ms
+template <typename Vec>
+void access_run(size_t n, int ms[2])
+{
+  Vec v(n, 1.0);
+  double sum = 0;
+  clock_t start = clock();
+  for (size_t i = 0; i < n; ++i)
+    sum += v[i];
+  clock_t end = clock();
+  ms[0] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  unsigned long long x = 88172645463325252ull;
+  start = clock();
+  for (size_t i = 0; i < n; ++i)
+  {
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    sum += v[x % n];
+  }
+  end = clock();
+  ms[1] = static_cast<int>(static_cast<double>(end - start) / CLOCKS_PER_SEC * 1000);
+  read_sink += static_cast<long long>(sum);
+}
+
 void vector_test()
 {
   std::cout << "[===============================================================]\n";
@@ -90,6 +204,29 @@ void vector_test()
   FUN_AFTER(v1, v1.shrink_to_fit());
   FUN_VALUE(v1.size());
   FUN_VALUE(v1.capacity());
+  mystl::vector<int, mystl::vector_growth_double> v11;
+  mystl::vector<int, mystl::vector_growth_size_class> v12;
+  FUN_AFTER(v11, v11.insert(v11.end(), 17, 1));
+  FUN_VALUE(v11.capacity());
+  FUN_AFTER(v12, v12.insert(v12.end(), 17, 2));
+  FUN_VALUE(v12.capacity());
+  FUN_AFTER(v12, v12.resize_default_init(5));
+  auto write_tail = [](int* p, size_t n) { for (size_t i = 5; i < n; ++i) p[i] = static_cast<int>(i); return n; };
+  FUN_AFTER(v12, v12.resize_and_overwrite(8, write_tail));
+  mystl::vector<double, mystl::vector_growth_half, mystl::huge_page_allocator<double>> v13(4, 1.5);
+  v13.reserve(1 << 18);
+  FUN_AFTER(v13, v13.push_back(2.5));
+  FUN_VALUE(v13.capacity());
+  {
+    // 复制赋值一个较短的 vector 后容量不变，析构时按大页内存释放
+    mystl::vector<double, mystl::vector_growth_half, mystl::huge_page_allocator<double>> v14(100, 1.0);
+    v13 = v14;
+    FUN_VALUE(v13.size());
+    FUN_VALUE(v13.capacity());
+  }
+  mystl::vector<int, mystl::vector_realloc_at<mystl::vector_growth_half, 0>> v15(v11.begin(), v11.end());
+  FUN_AFTER(v15, v15.shrink_to_fit());
+  FUN_VALUE(v15.capacity());
   PASSED;
 #if PERFORMANCE_TEST_ON
   std::cout << "[--------------------- Performance Testing ---------------------]\n";
@@ -103,6 +240,130 @@ void vector_test()
   std::cout << "\n";
   std::cout << "|---------------------|-------------|-------------|-------------|\n";
   PASSED;
+#if LARGER_TEST_DATA_ON
+  const size_t lens[3] = { LEN1 _M, LEN2 _M, LEN3 _M };
+#else
+  const size_t lens[3] = { LEN1 _S, LEN2 _S, LEN3 _S };
+#endif
+  int ms[2][3][2];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    string_growth<mystl::string>(lens[k], ms[0][k]);
+    string_growth<moved_string>(lens[k], ms[1][k]);
+  }
+  const char* names[2][2] = {
+    { "|  push_back memcpy   |", "|  push_back  move    |" },
+    { "|  reserve x2 memcpy  |", "|  reserve x2  move   |" } };
+  std::cout << " vector<mystl::string> growth, memcpy = is_trivially_relocatable,"
+    << " move = move construct + destroy\n";
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  std::cout << "|   string growth     |";
+  TEST_LEN(lens[0], lens[1], lens[2], WIDE);
+  for (int op = 0; op < 2; ++op)
+  {
+    for (int c = 0; c < 2; ++c)
+    {
+      std::cout << names[op][c];
+      for (size_t k = 0; k < 3; ++k)
+      {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%dms    |", ms[c][k][op]);
+        std::cout << std::setw(WIDE) << buf;
+      }
+      std::cout << "\n";
+    }
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  PASSED;
+#if LARGER_TEST_DATA_ON
+  const size_t glens[3] = { LEN1 _LL, LEN2 _LL, LEN3 _LL };
+#else
+  const size_t glens[3] = { LEN1 _L, LEN2 _L, LEN3 _L };
+#endif
+  std::cout << " push_back int under each growth policy, copied = not relocatable; no realloc = realloc_bytes() 0\n";
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  std::cout << "|   growth policy     |";
+  TEST_LEN(glens[0], glens[1], glens[2], WIDE);
+  const char* gnames[6] = { "|     1.5x  copied    |", "|     1.5x no realloc |", "|     1.5x            |",
+    "|      2x             |", "|     page            |", "|    size class       |" };
+  for (int c = 0; c < 6; ++c)
+  {
+    std::cout << gnames[c];
+    for (size_t k = 0; k < 3; ++k)
+    {
+      int t = 0;
+      switch (c)
+      {
+        case 0: t = growth_run<mystl::vector<copied_int>>(glens[k]); break;
+        case 1: t = growth_run<mystl::vector<int, mystl::vector_realloc_at<mystl::vector_growth_half, 0>>>(glens[k]); break;
+        case 2: t = growth_run<mystl::vector<int>>(glens[k]); break;
+        case 3: t = growth_run<mystl::vector<int, mystl::vector_growth_double>>(glens[k]); break;
+        case 4: t = growth_run<mystl::vector<int, mystl::vector_growth_page>>(glens[k]); break;
+        default: t = growth_run<mystl::vector<int, mystl::vector_growth_size_class>>(glens[k]); break;
+      }
+      char buf[16];
+      std::snprintf(buf, sizeof(buf), "%dms    |", t);
+      std::cout << std::setw(WIDE) << buf;
+    }
+    std::cout << "\n";
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  PASSED;
+  std::cout << " new buffer, resize to n bytes, then overwrite all of it as read() would\n";
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  std::cout << "|   read into buffer  |";
+  TEST_LEN(glens[0], glens[1], glens[2], WIDE);
+  const char* rnames[2][3] = {
+    { "|  vector  resize     |", "|  vector  default    |", "|  vector  overwrite  |" },
+    { "|  string  resize     |", "|  string  default    |", "|  string  overwrite  |" } };
+  for (int c = 0; c < 2; ++c)
+  {
+    for (int mode = 0; mode < 3; ++mode)
+    {
+      std::cout << rnames[c][mode];
+      for (size_t k = 0; k < 3; ++k)
+      {
+        const int t = c == 0 ? read_run<mystl::vector<char>>(glens[k], mode)
+          : read_run<mystl::string>(glens[k], mode);
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%dms    |", t);
+        std::cout << std::setw(WIDE) << buf;
+      }
+      std::cout << "\n";
+    }
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  PASSED;
+  int hms[2][3][2];
+  for (size_t k = 0; k < 3; ++k)
+  {
+    access_run<mystl::vector<double>>(glens[k], hms[0][k]);
+    access_run<mystl::vector<double, mystl::vector_growth_half,
+      mystl::huge_page_allocator<double>>>(glens[k], hms[1][k]);
+  }
+  const char* hnames[2][2] = {
+    { "|  sequential  4KB    |", "|  sequential  huge   |" },
+    { "|  random      4KB    |", "|  random      huge   |" } };
+  std::cout << " vector<double>, one sequential pass and n random reads, 4KB pages vs huge_page_allocator\n";
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  std::cout << "|   page size         |";
+  TEST_LEN(glens[0], glens[1], glens[2], WIDE);
+  for (int op = 0; op < 2; ++op)
+  {
+    for (int c = 0; c < 2; ++c)
+    {
+      std::cout << hnames[op][c];
+      for (size_t k = 0; k < 3; ++k)
+      {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%dms    |", hms[c][k][op]);
+        std::cout << std::setw(WIDE) << buf;
+      }
+      std::cout << "\n";
+    }
+  }
+  std::cout << "|---------------------|-------------|-------------|-------------|\n";
+  PASSED;
 #endif
   std::cout << "[----------------- End container test : vector -----------------]\n";
 }